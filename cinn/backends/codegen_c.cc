@@ -653,6 +653,10 @@ void CodeGenC::PrintRuntimeType(const cinn_type_t &type) {
     os() << "cinn_int32_t()";
   } else if (type == cinn_int64_t()) {
     os() << "cinn_int64_t()";
+  } else if (type == cinn_float16_t()) {
+    os() << "cinn_float16_t()";
+  } else if (type == cinn_bfloat16_t()) {
+    os() << "cinn_bfloat16_t()";
   } else if (type == cinn_float32_t()) {
     os() << "cinn_float32_t()";
   } else if (type == cinn_float64_t()) {
@@ -759,6 +763,18 @@ void CodeGenC::Visit(const ir::intrinsics::ArgsConstruct *op) {
 }
 
 void CodeGenC::Visit(const ir::intrinsics::BuiltinIntrin *op) {
+  if (op->id == llvm::Intrinsic::prefetch) {
+    // __builtin_prefetch(addr, rw, locality) always prefetches to the data cache
+    CHECK_EQ(op->args.size(), 4UL);
+    os() << "__builtin_prefetch(";
+    Print(op->args[0]);
+    os() << ", ";
+    Print(op->args[1]);
+    os() << ", ";
+    Print(op->args[2]);
+    os() << ")";
+    return;
+  }
   os() << op->name << "(";
   if (!op->args.empty()) {
     for (int i = 0; i < op->args.size() - 1; i++) {
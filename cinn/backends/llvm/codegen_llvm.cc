@@ -87,6 +87,11 @@ llvm::Value *EmitComparison(llvm::CmpInst::Predicate predicate,
 
 #define __IR_EMITTER_NOT_IMPLEMENTED(__op) CINN_NOT_IMPLEMENTED
 
+// The tensors sharing memory are bound to the same buffer, so the alias analysis works on buffers rather than tensors.
+std::string BufferNameOf(const ir::_Tensor_ *tensor) {
+  return tensor->buffer.defined() ? tensor->buffer->name : tensor->name;
+}
+
 int NextPowerOfTwo(int x) {
   for (int p2 = 1;; p2 *= 2) {
     if (p2 >= x) {
@@ -232,38 +237,59 @@ llvm::Value *CodeGenLLVM::Visit(const ir::UIntImm *op) {
   return llvm::ConstantInt::get(type, op->value, false);
 }
 
-llvm::Value *CodeGenLLVM::Visit(const ir::FloatImm *op) { return llvm::ConstantFP::get(b_->getFloatTy(), op->value); }
+llvm::Value *CodeGenLLVM::Visit(const ir::FloatImm *op) {
+  if (op->type().is_bfloat16()) {
+    return EmitFloat32ToBFloat16(llvm::ConstantFP::get(b_->getFloatTy(), op->value));
+  }
+  if (op->type().is_float16()) {
+    return llvm::ConstantFP::get(b_->getHalfTy(), op->value);
+  }
+  return llvm::ConstantFP::get(b_->getFloatTy(), op->value);
+}
 
 llvm::Value *CodeGenLLVM::LLVMGenGlobalStringVar(const std::string &data) { return b_->CreateGlobalStringPtr(data); }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::StringImm *op) { return LLVMGenGlobalStringVar(op->value); }
 
+llvm::Value *CodeGenLLVM::EmitArithmeticOp(llvm::Value *lhs, llvm::Value *rhs, char opcode, const Type &type) {
+  if (type.is_bfloat16()) {
+    // bfloat16 is stored as i16, compute in float32 and round the result back
+    auto *ret = EmitBinaryOp(EmitBFloat16ToFloat32(lhs), EmitBFloat16ToFloat32(rhs), opcode, false);
+    return EmitFloat32ToBFloat16(ret);
+  }
+  return EmitBinaryOp(lhs, rhs, opcode, is_integral_type(type));
+}
+
 llvm::Value *CodeGenLLVM::Visit(const ir::Add *op) {
-  return EmitBinaryOp(Visit(&op->a()), Visit(&op->b()), '+', is_integral_type(op->type()));
+  return EmitArithmeticOp(Visit(&op->a()), Visit(&op->b()), '+', op->type());
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::Sub *op) {
-  return EmitBinaryOp(Visit(&op->a()), Visit(&op->b()), '-', is_integral_type(op->type()));
+  return EmitArithmeticOp(Visit(&op->a()), Visit(&op->b()), '-', op->type());
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::Mul *op) {
   auto *lhs = Visit(&op->a());
   auto *rhs = Visit(&op->b());
-  return EmitBinaryOp(lhs, rhs, '*', is_integral_type(op->type()));
+  return EmitArithmeticOp(lhs, rhs, '*', op->type());
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::Div *op) {
-  return EmitBinaryOp(Visit(&op->a()), Visit(&op->b()), '/', is_integral_type(op->type()));
+  return EmitArithmeticOp(Visit(&op->a()), Visit(&op->b()), '/', op->type());
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::Mod *op) {
-  return EmitBinaryOp(Visit(&op->a()), Visit(&op->b()), '%', is_integral_type(op->type()));
+  return EmitArithmeticOp(Visit(&op->a()), Visit(&op->b()), '%', op->type());
 }
 
 #define __IR_EMITTER_DEFINE_CMP_VISITOR(__sop, __uop, __fop) \
   auto *lhs = Visit(&op->a());                               \
   auto *rhs = Visit(&op->b());                               \
   CHECK(op->a().type() == op->b().type());                   \
+  if (op->a().type().is_bfloat16()) {                        \
+    lhs = EmitBFloat16ToFloat32(lhs);                        \
+    rhs = EmitBFloat16ToFloat32(rhs);                        \
+  }                                                          \
   llvm::CmpInst::Predicate predicate;                        \
   if (op->a().type().is_int()) {                             \
     predicate = llvm::CmpInst::ICMP_##__sop;                 \
@@ -301,6 +327,8 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Min *op) {
     p = ICmpSLT(lhs, rhs);
   } else if (op->type().is_uint()) {
     p = ICmpULT(lhs, rhs);
+  } else if (op->type().is_bfloat16()) {
+    p = FCmpOLT(EmitBFloat16ToFloat32(lhs), EmitBFloat16ToFloat32(rhs));
   } else /*float*/ {
     p = FCmpOLT(lhs, rhs);
   }
@@ -317,6 +345,8 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Max *op) {
     p = ICmpSGT(lhs, rhs);
   } else if (op->type().is_uint()) {
     p = ICmpUGT(lhs, rhs);
+  } else if (op->type().is_bfloat16()) {
+    p = FCmpOGT(EmitBFloat16ToFloat32(lhs), EmitBFloat16ToFloat32(rhs));
   } else /*float*/ {
     p = FCmpOGT(lhs, rhs);
   }
@@ -326,6 +356,7 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Max *op) {
 
 llvm::Value *CodeGenLLVM::Visit(const ir::Minus *op) {
   auto *v = Visit(&op->v());
+  if (op->type().is_bfloat16()) return EmitFloat32ToBFloat16(FNeg(EmitBFloat16ToFloat32(v)));
   return (op->type().is_int() || op->type().is_uint()) ? Neg(v) : FNeg(v);
 }
 
@@ -371,6 +402,10 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Cast *op) {
     return Call(callee, std::vector<llvm::Value *>({value}), "pod_value_cast");
   }
 
+  if (from.is_bfloat16() || to.is_bfloat16()) {
+    return EmitBFloat16Cast(value, from, to);
+  }
+
   do {
     if (value->getType() == target) break;
 
@@ -425,6 +460,69 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Cast *op) {
   return value;
 }
 
+namespace {
+
+// Get the type with the same shape(scalar or vector) as \p type but with the element type \p elem_type.
+llvm::Type *WithElementType(llvm::Type *type, llvm::Type *elem_type) {
+  if (auto *vec_type = llvm::dyn_cast<llvm::FixedVectorType>(type)) {
+    return llvm::FixedVectorType::get(elem_type, vec_type->getNumElements());
+  }
+  return elem_type;
+}
+
+}  // namespace
+
+llvm::Value *CodeGenLLVM::EmitBFloat16ToFloat32(llvm::Value *value) {
+  auto *i32_type = WithElementType(value->getType(), b_->getInt32Ty());
+  auto *f32_type = WithElementType(value->getType(), b_->getFloatTy());
+  // a bfloat16 is exactly the upper half of the float32 with the same value
+  auto *bits = b_->CreateShl(b_->CreateZExt(value, i32_type), llvm::ConstantInt::get(i32_type, 16));
+  return BitCast(bits, f32_type);
+}
+
+llvm::Value *CodeGenLLVM::EmitFloat32ToBFloat16(llvm::Value *value) {
+  auto *i32_type = WithElementType(value->getType(), b_->getInt32Ty());
+  auto *i16_type = WithElementType(value->getType(), b_->getInt16Ty());
+  auto *bits     = BitCast(value, i32_type);
+  // round to nearest even: add 0x7fff plus the lowest kept bit, then drop the lower 16 bits
+  auto *lsb     = And(b_->CreateLShr(bits, llvm::ConstantInt::get(i32_type, 16)), llvm::ConstantInt::get(i32_type, 1));
+  auto *rounded = b_->CreateAdd(bits, b_->CreateAdd(lsb, llvm::ConstantInt::get(i32_type, 0x7fff)));
+  auto *result  = b_->CreateTrunc(b_->CreateLShr(rounded, llvm::ConstantInt::get(i32_type, 16)), i16_type);
+  // the rounding may turn a NaN into an infinity, keep it a quiet NaN
+  auto *is_nan = b_->CreateFCmpUNO(value, value);
+  return Select(is_nan, llvm::ConstantInt::get(i16_type, 0x7fc0), result);
+}
+
+llvm::Value *CodeGenLLVM::EmitBFloat16Cast(llvm::Value *value, const Type &from, const Type &to) {
+  if (from.is_bfloat16() && to.is_bfloat16()) return value;
+
+  if (from.is_bfloat16()) {
+    value             = EmitBFloat16ToFloat32(value);
+    auto *target_type = WithElementType(value->getType(), CinnTypeToLLVMType(to.ElementOf(), m_));
+    if (to.is_bool()) {
+      return FCmpONE(value, llvm::ConstantFP::get(value->getType(), 0.));
+    } else if (to.is_int()) {
+      return FPToSI(value, target_type);
+    } else if (to.is_uint()) {
+      return FPToUI(value, target_type);
+    }
+    CHECK(to.is_float()) << "Can't cast bfloat16 to " << to;
+    return FPCast(value, target_type);
+  }
+
+  auto *f32_type = WithElementType(value->getType(), b_->getFloatTy());
+  if (from.is_float()) {
+    value = FPCast(value, f32_type);
+  } else if (from.is_bool() || from.is_uint()) {
+    value = UIToFP(value, f32_type);
+  } else if (from.is_int()) {
+    value = SIToFP(value, f32_type);
+  } else {
+    LOG(FATAL) << "Can't cast " << from << " to bfloat16";
+  }
+  return EmitFloat32ToBFloat16(value);
+}
+
 llvm::Value *CodeGenLLVM::CreateSerialFor(const ir::For *op, int stride) {
   SymbolTableGuard symbol_table_guard(*symbol_table_);
 
@@ -745,21 +843,11 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Load *op) {
     }
      */
     if (auto *load_tensor = op->tensor.as_tensor()) {
-      AddTbaaMetadata(load_inst, load_tensor->name, op->index());
-    }
-
-    {
-      int alignment = op->type().bits();
-      alignment     = 8;
-      CHECK_GT(alignment, 0);
-      load_inst->setAlignment(llvm::Align(std::min(alignment, 8)));
+      AddTbaaMetadata(load_inst, BufferNameOf(load_tensor), op->index());
     }
-
-    // TODO(fc500110): tbaa AliasAnalysis
-    // auto md_tbaa_root      = md_builder_->createTBAARoot("cinn-tbaa");
-    // auto md_tbaa_alias_set = md_builder_->createTBAANode("cinn-alias", md_tbaa_root);
-    // llvm::MDNode *meta     = md_tbaa_alias_set;
-    // load_inst->setMetadata("tbaa", md_builder_->createTBAAStructTagNode(meta, meta, 0));
+    // an element is only known to be aligned to its own size, the alignment of the buffer is attached to the data
+    // pointer instead, see AddBufferDataAttributes
+    load_inst->setAlignment(llvm::Align(std::max(op->type().bits() / 8, 1)));
     return load_inst;
   } else {  // vector load
     Expr dense_strided_ramp = detail::StridedRampBase(op->index(), 1);
@@ -777,7 +865,7 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Load *op) {
       llvm::LoadInst *load_inst = b_->CreateAlignedLoad(ptr, llvm::Align(alignment), "load_vec");
       ret                       = b_->CreateInsertElement(ret, load_inst, ll_const_int32(i));
       if (auto *load_tensor = op->tensor.as_tensor()) {
-        AddTbaaMetadata(load_inst, load_tensor->name, op->index());
+        AddTbaaMetadata(load_inst, BufferNameOf(load_tensor), op->index());
       }
     };
     Scalarize(op->index(), flambda);
@@ -810,18 +898,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
       store_inst->setMetadata("tbaa", md_builder_->createTBAAStructTagNode(meta, meta, 0));
     }
      */
-    {
-      int alignment = op->type().bits();
-      alignment     = 8;
-      CHECK_GT(alignment, 0);
-      store_inst->setAlignment(llvm::Align(std::min(alignment, 8)));
-    }
-    // TODO(fc500110): tbaa AliasAnalysis
-    // auto md_tbaa_root      = md_builder_->createTBAARoot("cinn-tbaa");
-    // auto md_tbaa_alias_set = md_builder_->createTBAANode("cinn-alias", md_tbaa_root);
-    // llvm::MDNode *meta     = md_tbaa_alias_set;
-    // store_inst->setMetadata("tbaa", md_builder_->createTBAAStructTagNode(meta, meta, 0));
-    AddTbaaMetadata(store_inst, op->tensor.as_tensor()->name, op->index());
+    store_inst->setAlignment(llvm::Align(std::max(op->type().bits() / 8, 1)));
+    AddTbaaMetadata(store_inst, BufferNameOf(op->tensor.as_tensor()), op->index());
+    AddNonTemporalMetadata(store_inst, op->tensor, op->index());
     return store_inst;
   } else {  // vector store
     Expr dense_strided_ramp = detail::StridedRampBase(op->index(), 1);
@@ -846,7 +925,8 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
         int alignment = std::max(op->type().ElementOf().bits() / 8, 1);
         llvm::StoreInst *inst =
             b_->CreateAlignedStore(CreateVecSlice(value, offset, lanes), b_->CreatePointerCast(ptr, vtype), alignment);
-        AddTbaaMetadata(inst, op->tensor.as_tensor()->name, base);
+        AddTbaaMetadata(inst, BufferNameOf(op->tensor.as_tensor()), base);
+        AddNonTemporalMetadata(inst, op->tensor, base);
         return inst;
       }
     }
@@ -860,8 +940,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
           b_->CreateAlignedStore(b_->CreateExtractElement(value, i), ptr, llvm::Align(alignment), "store_vec");
       ret = b_->CreateInsertElement(ret, store_inst, ll_const_int32(i));
       if (auto *store_tensor = op->tensor.as_tensor()) {
-        AddTbaaMetadata(store_inst, store_tensor->name, op->index());
+        AddTbaaMetadata(store_inst, BufferNameOf(store_tensor), op->index());
       }
+      AddNonTemporalMetadata(store_inst, op->tensor, op->index());
     };
     Scalarize(op->index(), flambda);
     return ret;
@@ -907,8 +988,12 @@ void appendBody(std::vector<Expr> &new_body, T &&v) {
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::_LoweredFunc_ *op) {
-  auto init_function_state = [this]() { alias_vars_.clear(); };
+  auto init_function_state = [this]() {
+    alias_vars_.clear();
+    buffer_data_handles_.clear();
+  };
   init_function_state();
+  InitBufferAliasScopes(op);
 
   CHECK_EQ(op->alloc_output_buffer_exprs.size(), op->dealloc_output_buffer_exprs.size())
       << "the count of allocation and deallocaton expressions is not match";
@@ -972,6 +1057,7 @@ llvm::Value *CodeGenLLVM::Visit(const ir::_LoweredFunc_ *op) {
   b_->SetInsertPoint(entry);
   Visit(&function_body);
   symbol_table_->Erase("_args");
+  FenceStreamingStores();
   RetVoid();
   return f_;
 }
@@ -1029,9 +1115,12 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Product *op) {
   auto size = op->operands().size();
   if (size == 0) return nullptr;
 
+  bool is_bf16     = op->type().is_bfloat16();
   llvm::Value *ret = Visit(&op->operand(0));
+  if (is_bf16) ret = EmitBFloat16ToFloat32(ret);
   for (int i = 1; i < size; i++) {
     llvm::Value *v = Visit(&op->operand(i));
+    if (is_bf16) v = EmitBFloat16ToFloat32(v);
     if (is_integral_type(op->type())) {
       ret = Mul(ret, v);
     } else {
@@ -1039,6 +1128,7 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Product *op) {
     }
   }
 
+  if (is_bf16) ret = EmitFloat32ToBFloat16(ret);
   return ret;
 }
 
@@ -1046,9 +1136,12 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Sum *op) {
   auto size = op->operands().size();
   if (size == 0) return nullptr;
 
+  bool is_bf16     = op->type().is_bfloat16();
   llvm::Value *ret = Visit(&op->operand(0));
+  if (is_bf16) ret = EmitBFloat16ToFloat32(ret);
   for (int i = 1; i < size; i++) {
     llvm::Value *v = Visit(&op->operand(i));
+    if (is_bf16) v = EmitBFloat16ToFloat32(v);
     if (is_integral_type(op->type())) {
       ret = Add(ret, v);
     } else {  // float
@@ -1056,6 +1149,7 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Sum *op) {
     }
   }
 
+  if (is_bf16) ret = EmitFloat32ToBFloat16(ret);
   return ret;
 }
 
@@ -1155,7 +1249,7 @@ llvm::Value *CodeGenLLVM::DenseVectorLoad(const ir::Load *op) {
     int alignment = std::max(op->type().ElementOf().bits() / 8, 1);
 
     llvm::Instruction *load_inst = b_->CreateAlignedLoad(vec_ptr, llvm::Align(alignment), "load_vec");
-    AddTbaaMetadata(load_inst, op->tensor.as_tensor()->name, op->index());
+    AddTbaaMetadata(load_inst, BufferNameOf(op->tensor.as_tensor()), op->index());
 
     slices.push_back(load_inst);
   }
@@ -1281,6 +1375,92 @@ void CodeGenLLVM::AddTbaaMetadata(llvm::Instruction *inst, absl::string_view buf
 
   tbaa = builder.createTBAAStructTagNode(tbaa, tbaa, 0);
   inst->setMetadata("tbaa", tbaa);
+
+  AddAliasScopeMetadata(inst, std::string(buffer));
+}
+
+void CodeGenLLVM::InitBufferAliasScopes(const ir::_LoweredFunc_ *func) {
+  buffer_alias_scopes_.clear();
+  std::vector<std::string> buffers;
+  auto add_buffer = [&](const std::string &name) {
+    if (std::find(buffers.begin(), buffers.end(), name) == buffers.end()) buffers.push_back(name);
+  };
+  for (auto &arg : func->args) {
+    if (arg.is_buffer()) add_buffer(arg.buffer_arg()->name);
+  }
+  for (auto &buffer : func->temp_bufs) {
+    add_buffer(buffer->name);
+  }
+  if (buffers.size() < 2U) return;
+
+  llvm::MDNode *domain = md_builder_->createAliasScopeDomain(func->name);
+  std::vector<llvm::Metadata *> scopes;
+  for (auto &name : buffers) {
+    scopes.push_back(md_builder_->createAliasScope(func->name + "." + name, domain));
+  }
+  for (int i = 0; i < buffers.size(); i++) {
+    std::vector<llvm::Metadata *> others(scopes.begin(), scopes.begin() + i);
+    others.insert(others.end(), scopes.begin() + i + 1, scopes.end());
+    buffer_alias_scopes_[buffers[i]] = {llvm::MDNode::get(b_->getContext(), {scopes[i]}),
+                                        llvm::MDNode::get(b_->getContext(), others)};
+  }
+}
+
+void CodeGenLLVM::AddAliasScopeMetadata(llvm::Instruction *inst, const std::string &buffer) {
+  auto it = buffer_alias_scopes_.find(buffer);
+  if (it == buffer_alias_scopes_.end()) return;
+  inst->setMetadata(llvm::LLVMContext::MD_alias_scope, it->second.first);
+  inst->setMetadata(llvm::LLVMContext::MD_noalias, it->second.second);
+}
+
+void CodeGenLLVM::AddNonTemporalMetadata(llvm::StoreInst *inst, const Expr &tensor, const Expr &index) {
+  auto *tensor_node = tensor.as_tensor();
+  if (!tensor_node || !tensor_node->buffer.defined() || !tensor_node->buffer->streaming_store) return;
+  if (auto *vec_type = llvm::dyn_cast<llvm::FixedVectorType>(inst->getValueOperand()->getType())) {
+    // the non-temporal vector stores(movntps and the like) fault on an address not aligned to the vector size
+    const auto &buffer   = tensor_node->buffer;
+    int lanes            = vec_type->getNumElements();
+    int store_bytes      = m_->getDataLayout().getTypeStoreSize(vec_type);
+    int buffer_alignment = buffer->data_alignment > 0 ? buffer->data_alignment : CINN_BUFFER_MIN_HOST_ALIGNMENT;
+    if ((store_bytes & (store_bytes - 1)) != 0 || store_bytes > buffer_alignment) return;
+    Expr offset_in_vector = common::AutoSimplify(ir::Mod::Make(index, Expr(lanes)));
+    if (!offset_in_vector.is_constant() || offset_in_vector.get_constant() != 0) return;
+    inst->setAlignment(llvm::Align(store_bytes));
+  }
+  auto *one = llvm::ConstantAsMetadata::get(b_->getInt32(1));
+  inst->setMetadata(llvm::LLVMContext::MD_nontemporal, llvm::MDNode::get(b_->getContext(), {one}));
+  has_streaming_store_ = true;
+}
+
+void CodeGenLLVM::AddBufferDataAttributes(llvm::CallInst *data_handle, const ir::_Buffer_ *buffer) {
+  // the host code never dereferences the memory of a device buffer
+  if (buffer->target.arch == Target::Arch::NVGPU) return;
+
+  // the data pointer of a buffer is unpacked only once in a function, and different buffers never share memory
+  data_handle->addAttribute(llvm::AttributeList::ReturnIndex, llvm::Attribute::NoAlias);
+
+  int element_bytes    = (buffer->dtype.ElementOf().bits() + 7) / 8;
+  int buffer_alignment = buffer->data_alignment > 0 ? buffer->data_alignment : CINN_BUFFER_MIN_HOST_ALIGNMENT;
+  int alignment        = std::max(buffer_alignment, element_bytes);
+  data_handle->addAttribute(llvm::AttributeList::ReturnIndex,
+                            llvm::Attribute::getWithAlignment(b_->getContext(), llvm::Align(alignment)));
+
+  uint64_t bytes = element_bytes;
+  for (auto &dim : buffer->shape) {
+    auto *extent = dim.As<ir::IntImm>();
+    if (!extent) {
+      bytes = 0;
+      break;
+    }
+    bytes *= extent->value;
+  }
+  if (bytes > 0) {
+    data_handle->addDereferenceableAttr(llvm::AttributeList::ReturnIndex, bytes);
+  }
+
+  // the return attributes only describe the call itself, the assumption lets AlignmentFromAssumptions propagate the
+  // alignment to all the addresses computed from the pointer
+  b_->CreateAlignmentAssumption(m_->getDataLayout(), data_handle, alignment);
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::IntrinsicOp *op) {
@@ -1294,15 +1474,29 @@ llvm::Value *CodeGenLLVM::Visit(const ir::IntrinsicOp *op) {
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BufferGetDataHandle *op) {
-  std::vector<llvm::Value *> args({Visit(&op->buffer)});
-  auto *callee = m_->getFunction("cinn_buffer_get_data_handle");
-  return Call(callee, std::move(args));
+  return EmitBufferGetDataHandle(op->buffer, "cinn_buffer_get_data_handle");
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BufferGetDataConstHandle *op) {
-  std::vector<llvm::Value *> args({Visit(&op->buffer)});
-  auto *callee = m_->getFunction("cinn_buffer_get_data_const_handle");
-  return Call(callee, std::move(args));
+  return EmitBufferGetDataHandle(op->buffer, "cinn_buffer_get_data_const_handle");
+}
+
+llvm::Value *CodeGenLLVM::EmitBufferGetDataHandle(const Expr &buffer, const std::string &func_name) {
+  auto *buffer_node = buffer.as_buffer();
+  // the handles are unpacked at the entry of a function, reuse the handle of a buffer if it has been unpacked for
+  // another tensor
+  bool at_entry = f_ && b_->GetInsertBlock() == &f_->getEntryBlock();
+  if (buffer_node && at_entry && buffer_data_handles_.count(buffer_node->name)) {
+    return buffer_data_handles_.at(buffer_node->name);
+  }
+  std::vector<llvm::Value *> args({Visit(&buffer)});
+  auto *callee      = m_->getFunction(func_name);
+  llvm::Value *data = Call(callee, std::move(args));
+  if (buffer_node && at_entry) {
+    AddBufferDataAttributes(llvm::cast<llvm::CallInst>(data), buffer_node);
+    buffer_data_handles_[buffer_node->name] = data;
+  }
+  return data;
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BufferCreate *op) {
@@ -1434,6 +1628,7 @@ llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BuiltinIntrin *op) {
     } else if (func_name == "isnan") {
       CHECK_GE(op->args.size(), 1U);
       llvm::Value *v = Visit(&op->args[0]);
+      if (op->args[0]->type().is_bfloat16()) v = EmitBFloat16ToFloat32(v);
       return b_->CreateFCmpUNO(v, v);
     }
   }
@@ -1442,17 +1637,23 @@ llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BuiltinIntrin *op) {
   int64_t num_signature  = op->arg_nums;
   std::vector<llvm::Value *> arg_value;
   std::vector<llvm::Type *> arg_type;
+  // LLVM has no bfloat16 intrinsics on the i16 storage, call the float32 ones and round the result back
   for (size_t i = 0; i < op->args.size(); ++i) {
     arg_value.push_back(Visit(&op->args[i]));
+    if (op->args[i]->type().is_bfloat16()) {
+      arg_value.back() = EmitBFloat16ToFloat32(arg_value.back());
+    }
     if (i < static_cast<size_t>(num_signature)) {
       arg_type.push_back(arg_value.back()->getType());
     }
   }
   CHECK(!op->args.empty());
   llvm::Type *return_type = CinnTypeToLLVMType(op->type(), m_, true);
-  llvm::Function *fn      = GetIntrinsicDecl(id, return_type, arg_type);
+  if (op->type().is_bfloat16()) return_type = WithElementType(return_type, b_->getFloatTy());
+  llvm::Function *fn = GetIntrinsicDecl(id, return_type, arg_type);
   CHECK(fn) << "Cannot find intrinsic declaration, possible type mismatch: " << llvm::Intrinsic::getName(id, {});
-  return b_->CreateCall(fn, arg_value);
+  llvm::Value *ret = b_->CreateCall(fn, arg_value);
+  return op->type().is_bfloat16() ? EmitFloat32ToBFloat16(ret) : ret;
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::PodValueToX *op) {
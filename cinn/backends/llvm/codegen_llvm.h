@@ -191,6 +191,16 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
   // @}
 
   llvm::Value *EmitBinaryOp(llvm::Value *lhs, llvm::Value *rhs, char opcode, bool is_integral, bool is_signed = true);
+  //! Emit the binary operation of the cinn \p type, bfloat16 operands are computed in float32.
+  llvm::Value *EmitArithmeticOp(llvm::Value *lhs, llvm::Value *rhs, char opcode, const Type &type);
+
+  //! Conversions between bfloat16(stored as i16) and other types, they go through float32 with bit operations so
+  //! that no hardware support is required.
+  // @{
+  llvm::Value *EmitBFloat16ToFloat32(llvm::Value *value);
+  llvm::Value *EmitFloat32ToBFloat16(llvm::Value *value);
+  llvm::Value *EmitBFloat16Cast(llvm::Value *value, const Type &from, const Type &to);
+  // @}
 
   llvm::Value *LLVMGenGlobalStringVar(const std::string &data);
 
@@ -203,16 +213,42 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
 
   /**
    * Mark a load or store with type-based-alias-analysis metadata so that LLVM can optimize by reordering loads and
-   * stores accross different buffers.
+   * stores accross different buffers. The scoped noalias metadata of the buffer is attached as well.
    */
   void AddTbaaMetadata(llvm::Instruction *inst, absl::string_view buffer, Expr index);
 
+  /**
+   * Create one alias scope for each buffer used by a function. Different buffers never overlap, so every load and
+   * store is marked as in the scope of its own buffer and as not aliasing the scopes of all the other buffers.
+   */
+  void InitBufferAliasScopes(const ir::_LoweredFunc_ *func);
+
+  //! Mark a load or store to `buffer` with the scoped noalias metadata created by InitBufferAliasScopes.
+  void AddAliasScopeMetadata(llvm::Instruction *inst, const std::string &buffer);
+
+  /**
+   * Add the alias, memory and alignment facts of a buffer to the data pointer unpacked from it.
+   */
+  void AddBufferDataAttributes(llvm::CallInst *data_handle, const ir::_Buffer_ *buffer);
+
+  //! Mark a store to `tensor` as non-temporal if its buffer is scheduled with Stage::StreamingStore. A vector store is
+  //! marked only if its first element `index` proves the address is aligned to the vector size, which it is set to.
+  void AddNonTemporalMetadata(llvm::StoreInst *inst, const Expr &tensor, const Expr &index);
+
+  //! Order the non-temporal stores emitted in the current function before it returns.
+  virtual void FenceStreamingStores() { has_streaming_store_ = false; }
+
+  //! Unpack the data pointer of `buffer` by calling the runtime function `func_name`.
+  llvm::Value *EmitBufferGetDataHandle(const Expr &buffer, const std::string &func_name);
+
   void InitTarget(const Target &target);
 
   void Scalarize(const Expr &e, std::function<void(int i, llvm::Value *v)> flambda);
 
   llvm::Module *m_;
   llvm::IRBuilder<> *b_;
+  //! Whether a non-temporal store is emitted in the current function.
+  bool has_streaming_store_{false};
   // Current function
   llvm::Function *f_;
 
@@ -221,6 +257,10 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
   // std::shared_ptr<absl::flat_hash_map<std::string, llvm::Value *>> named_vars_;
   std::shared_ptr<SymbolTable> symbol_table_;
   std::unordered_set<ir::_Var_ *> alias_vars_;
+  //! The `!alias.scope` and `!noalias` metadata of each buffer in the current function.
+  absl::flat_hash_map<std::string, std::pair<llvm::MDNode *, llvm::MDNode *>> buffer_alias_scopes_;
+  //! The data pointer of each buffer in the current function, all the tensors bound to a buffer share it.
+  absl::flat_hash_map<std::string, llvm::Value *> buffer_data_handles_;
 
   llvm::MDNode *md_tbaa_root_{nullptr};
   llvm::MDNode *md_tbaa_alias_set_{nullptr};
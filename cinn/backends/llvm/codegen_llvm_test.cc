@@ -492,6 +492,62 @@ TEST(CodeGenLLVM, LowerFunc) {
   } while (false);
 }
 
+TEST(CodeGenLLVM, BufferAliasMetadata) {
+  auto context = std::make_unique<llvm::LLVMContext>();
+  llvm::SMDiagnostic error;
+  std::string runtime_ir(backends::kRuntimeLlvmIr);
+  auto m = llvm::parseAssemblyString(runtime_ir, error, *context);
+  CHECK(m);
+  auto b       = std::make_unique<llvm::IRBuilder<>>(*context);
+  auto emitter = std::make_unique<CodeGenLLVM>(m.get(), b.get());
+
+  auto _x_y_z_z_buf_ = CreateTensor();  // NOLINT
+  auto &x            = std::get<0>(_x_y_z_z_buf_);
+  auto &y            = std::get<1>(_x_y_z_z_buf_);
+  auto &z            = std::get<2>(_x_y_z_z_buf_);
+  auto &z_buf        = std::get<3>(_x_y_z_z_buf_);
+  z->Bind(z_buf);
+
+  auto stages   = CreateStages({x, y, z});
+  auto function = lang::Lower("add1", stages, {x, y, z});
+  ir::Expr func_expr(function);
+  emitter->Visit(&func_expr);
+
+  auto *func = m->getFunction("add1");
+  ASSERT_TRUE(func);
+  int num_memory_insts = 0, num_data_handles = 0, num_assumes = 0;
+  for (auto &block : *func) {
+    for (auto &inst : block) {
+      if (llvm::isa<llvm::LoadInst>(inst) || llvm::isa<llvm::StoreInst>(inst)) {
+        // the loads of the arguments and the buffer fields have no tensor to analyze
+        if (!inst.getMetadata("tbaa")) continue;
+        num_memory_insts++;
+        // three distinct buffers, each access is in one scope and does not alias the other two
+        auto *scope   = inst.getMetadata(llvm::LLVMContext::MD_alias_scope);
+        auto *noalias = inst.getMetadata(llvm::LLVMContext::MD_noalias);
+        ASSERT_TRUE(scope);
+        ASSERT_TRUE(noalias);
+        ASSERT_EQ(scope->getNumOperands(), 1U);
+        ASSERT_EQ(noalias->getNumOperands(), 2U);
+      } else if (auto *call = llvm::dyn_cast<llvm::CallInst>(&inst)) {
+        auto *callee = call->getCalledFunction();
+        if (!callee) continue;
+        if (callee->getName().startswith("cinn_buffer_get_data")) {
+          num_data_handles++;
+          ASSERT_TRUE(call->hasRetAttr(llvm::Attribute::NoAlias));
+          ASSERT_GE(call->getRetAlign()->value(), 16U);
+          ASSERT_EQ(call->getDereferenceableBytes(llvm::AttributeList::ReturnIndex), 3U * 2U * sizeof(float));
+        } else if (callee->getIntrinsicID() == llvm::Intrinsic::assume) {
+          num_assumes++;
+        }
+      }
+    }
+  }
+  ASSERT_EQ(num_memory_insts, 3);
+  ASSERT_EQ(num_data_handles, 3);
+  ASSERT_EQ(num_assumes, 3);
+}
+
 TEST(SymbolTable, test) {
   SymbolTable table;
   ASSERT_EQ(table.num_scopes(), 0UL);
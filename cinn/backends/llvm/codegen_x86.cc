@@ -29,6 +29,7 @@
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/IntrinsicsX86.h"
 #include "llvm/Support/Casting.h"
 
 namespace cinn::backends {
@@ -111,7 +112,11 @@ void CodeGenX86::CreateParallelLaunch(Expr body, int num_task) {
   par_env.penv = penv;
   std::swap(f_, f);
   std::swap(parallel_env_, par_env);
+  bool has_streaming_store = false;
+  std::swap(has_streaming_store_, has_streaming_store);
   this->Visit(&body);
+  FenceStreamingStores();
+  std::swap(has_streaming_store_, has_streaming_store);
   b_->CreateRet(ll_const_int32(0));
   symbol_table_->Erase(task_id_name);
   symbol_table_->Erase(num_task_name);
@@ -122,6 +127,12 @@ void CodeGenX86::CreateParallelLaunch(Expr body, int num_task) {
   b_->SetInsertPoint(launch_end);
 }
 
+void CodeGenX86::FenceStreamingStores() {
+  if (!has_streaming_store_) return;
+  b_->CreateCall(llvm::Intrinsic::getDeclaration(m_, llvm::Intrinsic::x86_sse_sfence));
+  has_streaming_store_ = false;
+}
+
 llvm::Value* CodeGenX86::Visit(const ir::For* op) {
   if (op->is_parallel()) {
     VLOG(3) << "parallel forloop";
@@ -49,6 +49,9 @@ class CodeGenX86 : public CodeGenLLVM {
   // Create parallel launch
   void CreateParallelLaunch(Expr body, int num_task);
 
+  //! The non-temporal stores are weakly ordered, fence them before the results are seen by other threads.
+  void FenceStreamingStores() override;
+
   llvm::Value* PackVars(const std::vector<std::string>& vars, uint64_t* num_bytes);
   void UnpackVars(const std::vector<std::string>& vars, llvm::Value* data);
   llvm::BasicBlock* CheckCallSuccess(llvm::Value* retcode);
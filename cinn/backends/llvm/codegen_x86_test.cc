@@ -15,7 +15,16 @@
 #include "cinn/backends/llvm/codegen_x86.h"
 
 #include <gtest/gtest.h>
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
 
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "cinn/backends/llvm/cinn_runtime_llvm_ir.h"
 #include "cinn/backends/llvm/simple_jit.h"
 #include "cinn/cinn.h"
 #include "cinn/common/test_helper.h"
@@ -68,5 +77,115 @@ TEST(Vectorize, basic) {
   }
 }
 
+TEST(CodeGenX86, streaming_store) {
+  Expr M(64);
+  Expr N(64);
+  Placeholder<float> A("A", {M, N});
+
+  auto B      = Compute({M, N}, [&](Expr i, Expr j) { return A(i, j) * 2.f; }, "B");
+  auto C      = Compute({M, N}, [&](Expr i, Expr j) { return A(i, j) * 3.f; }, "C");
+  auto stages = CreateStages({B, C});
+  // a vector of 16 bytes is aligned in the buffer, one of 32 bytes is not known to be
+  stages[B]->Vectorize(1, 4);
+  stages[B]->StreamingStore();
+  stages[C]->Vectorize(1, 8);
+  stages[C]->StreamingStore();
+
+  auto fn = Lower("fn_streaming", stages, {A, B, C});
+  Module::Builder builder("module", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+
+  llvm::LLVMContext context;
+  llvm::SMDiagnostic error;
+  std::string runtime_ir(kRuntimeLlvmIr);
+  auto m = llvm::parseAssemblyString(runtime_ir, error, context);
+  ASSERT_TRUE(m);
+  llvm::IRBuilder<> b(context);
+  CodeGenX86 emitter(m.get(), &b);
+  emitter.Compile(builder.Build());
+
+  std::string ir;
+  llvm::raw_string_ostream os(ir);
+  m->getFunction("fn_streaming")->print(os);
+  os.flush();
+
+  std::istringstream lines(ir);
+  std::string line;
+  int num_nontemporal = 0;
+  while (std::getline(lines, line)) {
+    if (line.find("!nontemporal") == std::string::npos) continue;
+    num_nontemporal++;
+    EXPECT_NE(line.find("store <4 x float>"), std::string::npos) << line;
+    EXPECT_NE(line.find("align 16"), std::string::npos) << line;
+  }
+  EXPECT_GT(num_nontemporal, 0);
+  // the non-temporal stores are fenced before the function returns
+  EXPECT_NE(ir.find("@llvm.x86.sse.sfence"), std::string::npos);
+}
+
+TEST(Vectorize, bfloat16) {
+  Expr M(64);
+  auto A = lang::CreatePlaceHolder({M}, BFloat16(), "A");
+  auto B = lang::CreatePlaceHolder({M}, BFloat16(), "B");
+
+  auto C      = Compute({M}, [&](Expr i) { return A(i) * B(i) + A(i); });
+  auto stages = CreateStages({C});
+
+  stages[C]->Vectorize(0, 8);
+
+  auto fn = Lower("fn_bf16", stages, {A, B, C});
+
+  Module::Builder builder("module", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+
+  auto jit = SimpleJIT::Create();
+  jit->Link(builder.Build());
+
+  auto* fn_ptr = reinterpret_cast<lower_func_ptr_t>(jit->Lookup("fn_bf16"));
+  ASSERT_TRUE(fn_ptr);
+
+  // a bfloat16 is the upper half of a float32, all the values used here are exact in bfloat16
+  auto to_bf16 = [](float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return static_cast<uint16_t>(bits >> 16);
+  };
+  auto from_bf16 = [](uint16_t x) {
+    uint32_t bits = static_cast<uint32_t>(x) << 16;
+    float ret;
+    std::memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+  };
+
+  auto* A_buf = cinn_buffer_t::new_(cinn_x86_device, cinn_bfloat16_t(), {64}, 32);
+  auto* B_buf = cinn_buffer_t::new_(cinn_x86_device, cinn_bfloat16_t(), {64}, 32);
+  auto* C_buf = cinn_buffer_t::new_(cinn_x86_device, cinn_bfloat16_t(), {64}, 32);
+  cinn_buffer_malloc(nullptr, A_buf);
+  cinn_buffer_malloc(nullptr, B_buf);
+  cinn_buffer_malloc(nullptr, C_buf);
+
+  auto* A_data = reinterpret_cast<uint16_t*>(A_buf->memory);
+  auto* B_data = reinterpret_cast<uint16_t*>(B_buf->memory);
+  auto* C_data = reinterpret_cast<uint16_t*>(C_buf->memory);
+  for (int i = 0; i < 64; i++) {
+    A_data[i] = to_bf16((i % 16) * 0.5f);
+    B_data[i] = to_bf16((i % 7) - 3.f);
+  }
+
+  auto args = common::ArgsBuilder().Add(A_buf).Add(B_buf).Add(C_buf).Build();
+  fn_ptr(reinterpret_cast<void**>(args.data()), args.size());
+
+  for (int i = 0; i < 64; i++) {
+    float a = from_bf16(A_data[i]);
+    float b = from_bf16(B_data[i]);
+    ASSERT_EQ(from_bf16(C_data[i]), a * b + a) << "at " << i;
+  }
+
+  for (auto* buf : {A_buf, B_buf, C_buf}) cinn_buffer_free(nullptr, buf);
+  cinn_buffer_t::delete_(A_buf);
+  cinn_buffer_t::delete_(B_buf);
+  cinn_buffer_t::delete_(C_buf);
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -111,11 +111,13 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   llvm::InitializeNativeTargetAsmPrinter();
   InitializeLLVMPasses();
 
-  auto engine = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true);
+  auto engine      = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true);
+  engine->options_ = config;
 
-  auto compile_layer_creator = [&engine](llvm::orc::JITTargetMachineBuilder jtmb)
+  auto compile_layer_creator = [&engine, &config](llvm::orc::JITTargetMachineBuilder jtmb)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
-    auto machine = llvm::cantFail(jtmb.createTargetMachine());
+    // generate code for the same target that the modules are optimized for
+    auto machine = CreateTargetMachine(config.optimize_options, config.opt_level);
     VLOG(1) << "create llvm compile layer";
     VLOG(1) << "Target Name: " << machine->getTarget().getName();
     VLOG(1) << "Target CPU: " << machine->getTargetCPU().str() << std::endl;
@@ -160,9 +162,8 @@ void ExecutionEngine::Link(const ir::Module &module) {
   VLOG(3) << "ir_emitter->Compile(module) Succeed!";
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
 
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
+  auto *machine = GetTargetMachine(options_.optimize_options, options_.opt_level);
+  LLVMModuleOptimizer optimize(machine, options_.opt_level, options_.optimize_options);
   optimize(m.get());
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
   for (auto &f : *m) {
@@ -44,6 +44,7 @@
 #include <vector>
 
 #include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/ir/module.h"
 
@@ -63,7 +64,7 @@ struct ExecutionOptions {
   bool enable_debug_info{false};
   // TODO(fc500110)
   // int num_compile_threads{1};
-  // bool enable_fast_math;
+  OptimizeOptions optimize_options{OptimizeOptions::FromFlags()};
 };
 
 class ExecutionEngine {
@@ -90,6 +91,7 @@ class ExecutionEngine {
 
  private:
   mutable std::mutex mu_;
+  ExecutionOptions options_;
   llvm::SmallString<0> buffer_;
   std::unique_ptr<llvm::orc::LLJIT> jit_;
   std::unique_ptr<NaiveObjectCache> cache_;
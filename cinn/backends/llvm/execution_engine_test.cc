@@ -325,5 +325,44 @@ TEST(ExecutionEngine, call_extern) {
   }
 }
 
+TEST(ExecutionEngine, optimize_options) {
+  ExecutionOptions options;
+  options.optimize_options.fast_math       = true;
+  options.optimize_options.vectorize_width = 8;
+  options.optimize_options.time_passes     = true;
+
+  ir::Expr M(kM);
+  ir::Expr N(kN);
+  Placeholder<float> x("x", {M, N});
+  Placeholder<float> y("y", {M, N});
+  auto out = Compute(
+      {M, N}, [=](Var i, Var j) { return x(i, j) + y(i, j); }, "out");
+  auto stages = CreateStages({out});
+
+  Module::Builder builder("module0", common::DefaultHostTarget());
+  builder.AddFunction(Lower("elementwise_add", stages, {x, y, out}));
+
+  auto engine = backends::ExecutionEngine::Create(options);
+  engine->Link(builder.Build());
+
+  auto _a_b_c_ = CreateTestBuffer();  // NOLINT
+  auto &a      = std::get<0>(_a_b_c_);
+  auto &b      = std::get<1>(_a_b_c_);
+  auto &c      = std::get<2>(_a_b_c_);
+
+  auto elementwise_add = reinterpret_cast<void (*)(void *, int32_t)>(engine->Lookup("elementwise_add"));
+  ASSERT_TRUE(elementwise_add);
+  cinn_pod_value_t a_arg(a), b_arg(b), c_arg(c);
+  cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+  elementwise_add(args, 3);
+
+  auto *ad = reinterpret_cast<float *>(a->memory);
+  auto *bd = reinterpret_cast<float *>(b->memory);
+  auto *cd = reinterpret_cast<float *>(c->memory);
+  for (int i = 0; i < c->num_elements(); i++) {
+    ASSERT_NEAR(cd[i], ad[i] + bd[i], 1e-5);
+  }
+}
+
 }  // namespace backends
 }  // namespace cinn
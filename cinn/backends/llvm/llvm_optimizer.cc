@@ -14,153 +14,283 @@
 
 #include "cinn/backends/llvm/llvm_optimizer.h"
 
+#include <absl/container/flat_hash_map.h>
+#include <gflags/gflags.h>
 #include <glog/logging.h>
-#include <llvm/ADT/Triple.h>
+#include <llvm/Analysis/AliasAnalysis.h>
 #include <llvm/Analysis/CGSCCPassManager.h>
-#include <llvm/AsmParser/Parser.h>
-#include <llvm/ExecutionEngine/ExecutionEngine.h>
-#include <llvm/ExecutionEngine/JITSymbol.h>
-#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
-#include <llvm/ExecutionEngine/Orc/Core.h>
-#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
-#include <llvm/ExecutionEngine/Orc/IRCompileLayer.h>
-#include <llvm/ExecutionEngine/Orc/LambdaResolver.h>
-#include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
-#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
-#include <llvm/ExecutionEngine/SectionMemoryManager.h>
-#include <llvm/IR/IRBuilder.h>
-#include <llvm/IR/LegacyPassManager.h>
-#include <llvm/IR/Module.h>
+#include <llvm/Analysis/LoopAnalysisManager.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/IR/PassInstrumentation.h>
 #include <llvm/IR/PassManager.h>
-#include <llvm/IRReader/IRReader.h>
+#include <llvm/MC/MCSubtargetInfo.h>
+#include <llvm/MC/SubtargetFeature.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/Error.h>
-#include <llvm/Support/MemoryBuffer.h>
-#include <llvm/Support/SmallVectorMemoryBuffer.h>
-#include <llvm/Support/SourceMgr.h>
-#include <llvm/Support/TargetRegistry.h>
-#include <llvm/Support/TargetSelect.h>
-#include <llvm/Support/raw_ostream.h>
-#include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
-#include <llvm/Transforms/IPO.h>
-#include <llvm/Transforms/IPO/PassManagerBuilder.h>
-#include <llvm/Transforms/InstCombine/InstCombine.h>
-#include <llvm/Transforms/Scalar.h>
-#include <llvm/Transforms/Scalar/GVN.h>
-#include <llvm/Transforms/Scalar/NewGVN.h>
-#include <llvm/Transforms/Scalar/Reassociate.h>
-#include <llvm/Transforms/Scalar/SimplifyCFG.h>
-#include <llvm/Transforms/Vectorize.h>
 
 #include <algorithm>
+#include <chrono>  // NOLINT
+#include <map>
 #include <memory>
+#include <sstream>
 #include <string>
-#include <type_traits>
 #include <utility>
+#include <vector>
 
-#include "llvm/Support/CodeGen.h"
+#include "cinn/utils/string.h"
+
+DEFINE_bool(cinn_llvm_fast_math, false, "Whether to allow LLVM to reassociate, contract and approximate float math.");
+DEFINE_string(cinn_llvm_target_cpu, "", "The target cpu of LLVM backend, e.g. skylake-avx512, the host's if empty.");
+DEFINE_string(cinn_llvm_target_features, "", "The comma separated target features of LLVM backend, e.g. +avx2,+fma.");
+DEFINE_int32(cinn_llvm_vectorize_width, 0, "The vectorize width hint of the innermost loops, 0 lets LLVM decide.");
+DEFINE_int32(cinn_llvm_interleave_count, 0, "The interleave count hint of the innermost loops, 0 lets LLVM decide.");
+DEFINE_bool(cinn_llvm_time_passes, false, "Whether to log the time spent in each LLVM pass.");
 
 namespace cinn::backends {
 
 namespace {
-template <typename PassManagerT>
-class CustomPassManager : public PassManagerT {
+
+#if LLVM_VERSION_MAJOR >= 14
+using OptimizationLevel = llvm::OptimizationLevel;
+#else
+using OptimizationLevel = llvm::PassBuilder::OptimizationLevel;
+#endif
+
+// Accumulate the time spent in each pass, excluding the time of the passes nested in it.
+class PassTimer {
  public:
-  template <typename... Ts>
-  explicit CustomPassManager(bool print_passes, Ts &&... ts)
-      : PassManagerT(std::forward<Ts>(ts)...), print_passes_(print_passes) {}
-
-  void add(llvm::Pass *pass) override {
-    if (print_passes_) {
-      if (is_function_pass_manager_) {
-        VLOG(1) << "llvm run function pass[" << std::string(pass->getPassName()) << "]";
-      }
+  void Register(llvm::PassInstrumentationCallbacks *callbacks) {
+#if LLVM_VERSION_MAJOR >= 12
+    callbacks->registerBeforeNonSkippedPassCallback([this](llvm::StringRef, llvm::Any) { Start(); });
+    callbacks->registerAfterPassCallback(
+        [this](llvm::StringRef pass, llvm::Any, const llvm::PreservedAnalyses &) { Stop(pass); });
+    callbacks->registerAfterPassInvalidatedCallback(
+        [this](llvm::StringRef pass, const llvm::PreservedAnalyses &) { Stop(pass); });
+#else
+    callbacks->registerBeforePassCallback([this](llvm::StringRef, llvm::Any) {
+      Start();
+      return true;
+    });
+    callbacks->registerAfterPassCallback([this](llvm::StringRef pass, llvm::Any) { Stop(pass); });
+    callbacks->registerAfterPassInvalidatedCallback([this](llvm::StringRef pass) { Stop(pass); });
+#endif
+  }
 
-      if (is_module_pass_manager_) {
-        VLOG(1) << "llvm run module pass[" << std::string(pass->getPassName()) << "]";
-      }
+  void Report(const std::string &module_name) const {
+    std::vector<std::pair<std::string, Record>> records(records_.begin(), records_.end());
+    std::sort(records.begin(), records.end(), [](auto &a, auto &b) { return a.second.ms > b.second.ms; });
+    double total_ms = 0;
+    for (auto &record : records) total_ms += record.second.ms;
+
+    std::stringstream ss;
+    ss << "LLVM passes of module [" << module_name << "] take " << total_ms << " ms:\n";
+    for (auto &record : records) {
+      ss << utils::StringFormat("%10.3f ms %6.2f%% %6d  ",
+                                record.second.ms,
+                                total_ms > 0 ? record.second.ms / total_ms * 100 : 0.,
+                                record.second.count)
+         << record.first << "\n";
     }
-    // static bool add_pass = true;
-    // if (add_pass) {
-    //  PassManagerT::add(pass);
-    //}
-
-    // if (std::string(pass->getPassName()) == "Loop Vectorization") {
-    //  return;
-    //}
-    PassManagerT::add(pass);
+    LOG(INFO) << ss.str();
   }
 
-  void run(llvm::Function &f) {  // NOLINT
-    if (is_function_pass_manager_) {
-      PassManagerT::run(f);
-    }
+ private:
+  using Clock = std::chrono::steady_clock;
+  struct Record {
+    double ms{0};
+    int count{0};
+  };
+  struct Frame {
+    Clock::time_point start;
+    double nested_ms{0};
+  };
+
+  void Start() { stack_.push_back({Clock::now(), 0}); }
+
+  void Stop(llvm::StringRef pass) {
+    CHECK(!stack_.empty());
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - stack_.back().start).count();
+    auto &record = records_[pass.str()];
+    record.ms += ms - stack_.back().nested_ms;
+    record.count++;
+    stack_.pop_back();
+    if (!stack_.empty()) stack_.back().nested_ms += ms;
   }
 
-  void run(llvm::Module &m) {  // NOLINT
-    if (is_module_pass_manager_) {
-      PassManagerT::run(m);
+  std::vector<Frame> stack_;
+  std::map<std::string, Record> records_;
+};
+
+llvm::CodeGenOpt::Level GetCodeGenOptLevel(int opt_level) {
+  if (opt_level <= 0) return llvm::CodeGenOpt::None;
+  if (opt_level == 1) return llvm::CodeGenOpt::Less;
+  if (opt_level == 2) return llvm::CodeGenOpt::Default;
+  return llvm::CodeGenOpt::Aggressive;
+}
+
+// Set the loop metadata of the vectorizer hints, the existing properties of the loop are kept.
+void AddLoopHints(llvm::Loop *loop, int vectorize_width, int interleave_count) {
+  auto &ctx = loop->getHeader()->getContext();
+  // the first operand of a loop id refers to itself
+  llvm::SmallVector<llvm::Metadata *, 4> operands{nullptr};
+  if (auto *loop_id = loop->getLoopID()) {
+    for (unsigned i = 1; i < loop_id->getNumOperands(); i++) {
+      operands.push_back(loop_id->getOperand(i));
     }
   }
+  auto add_hint = [&](const char *name, int value) {
+    if (value <= 0) return;
+    operands.push_back(llvm::MDNode::get(
+        ctx,
+        {llvm::MDString::get(ctx, name),
+         llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx), value))}));
+  };
+  add_hint("llvm.loop.vectorize.width", vectorize_width);
+  add_hint("llvm.loop.interleave.count", interleave_count);
 
- private:
-  static constexpr bool is_function_pass_manager_ =
-      std::is_same<llvm::legacy::FunctionPassManager, PassManagerT>::value;
-  static constexpr bool is_module_pass_manager_ = std::is_same<llvm::legacy::PassManager, PassManagerT>::value;
-  bool print_passes_;
-};
+  auto *new_loop_id = llvm::MDNode::getDistinct(ctx, operands);
+  new_loop_id->replaceOperandWith(0, new_loop_id);
+  loop->setLoopID(new_loop_id);
+}
 
-using CustomFunctionPassManager = CustomPassManager<llvm::legacy::FunctionPassManager>;
-using CustomModulePassManager   = CustomPassManager<llvm::legacy::PassManager>;
 }  // namespace
 
-LLVMModuleOptimizer::LLVMModuleOptimizer(llvm::TargetMachine *machine,
-                                         int opt_level,
-                                         llvm::FastMathFlags fast_math_flags,
-                                         bool print_passes)
-    : opt_level_(opt_level), print_passes_(print_passes), machine_(machine) {}
+OptimizeOptions OptimizeOptions::FromFlags() {
+  OptimizeOptions options;
+  options.fast_math        = FLAGS_cinn_llvm_fast_math;
+  options.target_cpu       = FLAGS_cinn_llvm_target_cpu;
+  options.target_features  = FLAGS_cinn_llvm_target_features;
+  options.vectorize_width  = FLAGS_cinn_llvm_vectorize_width;
+  options.interleave_count = FLAGS_cinn_llvm_interleave_count;
+  options.time_passes      = FLAGS_cinn_llvm_time_passes;
+  return options;
+}
+
+std::unique_ptr<llvm::TargetMachine> CreateTargetMachine(const OptimizeOptions &options, int opt_level) {
+  auto builder = llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost());
+  if (!options.target_cpu.empty()) {
+    // the features of the host cpu may be missing on the target cpu
+    builder.setCPU(options.target_cpu);
+    builder.getFeatures() = llvm::SubtargetFeatures();
+  }
+  if (!options.target_features.empty()) {
+    builder.addFeatures(llvm::SubtargetFeatures(options.target_features).getFeatures());
+  }
+  builder.setCodeGenOptLevel(GetCodeGenOptLevel(opt_level));
+  if (options.fast_math) {
+    auto &target_options               = builder.getOptions();
+    target_options.UnsafeFPMath        = true;
+    target_options.NoInfsFPMath        = true;
+    target_options.NoNaNsFPMath        = true;
+    target_options.NoSignedZerosFPMath = true;
+    target_options.AllowFPOpFusion     = llvm::FPOpFusion::Fast;
+  }
+  auto machine = llvm::cantFail(builder.createTargetMachine());
+  VLOG(1) << "Create llvm target machine, cpu: " << machine->getTargetCPU().str()
+          << ", features: " << machine->getTargetFeatureString().str();
+  return machine;
+}
+
+llvm::TargetMachine *GetTargetMachine(const OptimizeOptions &options, int opt_level) {
+  thread_local absl::flat_hash_map<std::string, std::unique_ptr<llvm::TargetMachine>> machines;
+  std::string key = utils::StringFormat("%s;%s;%d;%d",
+                                        options.target_cpu.c_str(),
+                                        options.target_features.c_str(),
+                                        static_cast<int>(options.fast_math),
+                                        static_cast<int>(GetCodeGenOptLevel(opt_level)));
+  auto &machine = machines[key];
+  if (!machine) {
+    machine = CreateTargetMachine(options, opt_level);
+  }
+  return machine.get();
+}
+
+int GetVectorBits(const OptimizeOptions &options) {
+  auto *machine = GetTargetMachine(options);
+  auto arch     = machine->getTargetTriple().getArch();
+  if (arch != llvm::Triple::x86 && arch != llvm::Triple::x86_64) return 128;
+  // the features implied by the target cpu are included in the subtarget
+  const auto *subtarget = machine->getMCSubtargetInfo();
+  if (subtarget->checkFeatures("+avx512f")) return 512;
+  if (subtarget->checkFeatures("+avx")) return 256;
+  return 128;
+}
+
+LLVMModuleOptimizer::LLVMModuleOptimizer(llvm::TargetMachine *machine, int opt_level, const OptimizeOptions &options)
+    : machine_(machine), opt_level_(opt_level), options_(options) {
+  CHECK(machine_);
+}
+
+void LLVMModuleOptimizer::AnnotateModule(llvm::Module *m) {
+  bool add_loop_hints = options_.vectorize_width > 0 || options_.interleave_count > 0;
+  for (auto &f : *m) {
+    if (f.isDeclaration()) continue;
+    if (options_.fast_math) {
+      for (auto *attr : {"unsafe-fp-math", "no-infs-fp-math", "no-nans-fp-math", "no-signed-zeros-fp-math"}) {
+        f.addFnAttr(attr, "true");
+      }
+      for (auto &inst : llvm::instructions(f)) {
+        if (llvm::isa<llvm::FPMathOperator>(inst)) inst.setFast(true);
+      }
+    }
+    if (add_loop_hints) {
+      llvm::DominatorTree dom_tree(f);
+      llvm::LoopInfo loop_info(dom_tree);
+      for (auto *loop : loop_info.getLoopsInPreorder()) {
+        if (loop->getSubLoops().empty()) {
+          AddLoopHints(loop, options_.vectorize_width, options_.interleave_count);
+        }
+      }
+    }
+  }
+}
 
 void LLVMModuleOptimizer::operator()(llvm::Module *m) {
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  auto fpm = std::make_unique<CustomFunctionPassManager>(print_passes_, m);
-  // fpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
-  // fpm->add(llvm::createInstructionCombiningPass());
-  // fpm->add(llvm::createReassociatePass());
-  // fpm->add(llvm::createGVNPass());
-  // fpm->add(llvm::createCFGSimplificationPass());
-  // fpm->add(llvm::createSROAPass());
-  // fpm->add(llvm::createEarlyCSEPass());
-  // fpm->add(llvm::createLowerExpectIntrinsicPass());
-  // fpm->add(llvm::createCallSiteSplittingPass());
-  // fpm->add(llvm::createLoopVectorizePass());
-  // fpm->add(llvm::createSLPVectorizerPass());
-  // fpm->add(llvm::createLoadStoreVectorizerPass());
-  // fpm->add(llvm::createLoopUnrollPass());
-
-  auto mpm = std::make_unique<CustomModulePassManager>(print_passes_);
-  // mpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
-  // LOG(INFO) << "llvm run pass: target machine: name[" << machine_->getTarget().getName() << "]";
-  // LOG(INFO) << "llvm run pass: target machine: cpu[" << machine_->getTargetCPU().str() << "]";
-  fpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
-  mpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
-  auto builder           = std::make_unique<llvm::PassManagerBuilder>();
-  builder->OptLevel      = opt_level_;
-  builder->Inliner       = llvm::createFunctionInliningPass();
-  builder->LoopVectorize = true;
-  builder->SLPVectorize  = true;
-#if LLVM_VERSION_MAJOR >= 11
-  machine->adjustPassManager(*builder);
-#endif
-  builder->populateFunctionPassManager(*fpm);
-  builder->populateModulePassManager(*mpm);
+  // the cost models of the vectorizers depend on the data layout of the target
+  m->setTargetTriple(machine_->getTargetTriple().str());
+  m->setDataLayout(machine_->createDataLayout());
+  if (opt_level_ <= 0) return;
+  AnnotateModule(m);
+
+  llvm::PipelineTuningOptions tuning_options;
+  tuning_options.LoopVectorization = true;
+  tuning_options.SLPVectorization  = true;
+  llvm::PassInstrumentationCallbacks callbacks;
+  PassTimer timer;
+  if (options_.time_passes) {
+    timer.Register(&callbacks);
+  }
+  llvm::PassBuilder pass_builder(machine_, tuning_options, llvm::None, &callbacks);
 
-  fpm->doInitialization();
-  std::for_each(m->begin(), m->end(), [&fpm](auto &fn) { fpm->run(fn); });
-  fpm->doFinalization();
+  llvm::LoopAnalysisManager loop_analysis_manager;
+  llvm::FunctionAnalysisManager function_analysis_manager;
+  llvm::CGSCCAnalysisManager cgscc_analysis_manager;
+  llvm::ModuleAnalysisManager module_analysis_manager;
+  function_analysis_manager.registerPass([&] { return pass_builder.buildDefaultAAPipeline(); });
+  pass_builder.registerModuleAnalyses(module_analysis_manager);
+  pass_builder.registerCGSCCAnalyses(cgscc_analysis_manager);
+  pass_builder.registerFunctionAnalyses(function_analysis_manager);
+  pass_builder.registerLoopAnalyses(loop_analysis_manager);
+  pass_builder.crossRegisterProxies(
+      loop_analysis_manager, function_analysis_manager, cgscc_analysis_manager, module_analysis_manager);
 
-  mpm->run(*m);
+  OptimizationLevel level = opt_level_ == 1 ? OptimizationLevel::O1
+                            : opt_level_ == 2 ? OptimizationLevel::O2
+                                              : OptimizationLevel::O3;
+  llvm::ModulePassManager module_pass_manager = pass_builder.buildPerModuleDefaultPipeline(level);
+  module_pass_manager.run(*m, module_analysis_manager);
+
+  if (options_.time_passes) {
+    timer.Report(m->getModuleIdentifier());
+  }
 }
 
 }  // namespace cinn::backends
@@ -14,30 +14,60 @@
 
 #pragma once
 
-#include <llvm/IR/Instruction.h>
-#include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
-#include <llvm/Pass.h>
 #include <llvm/Target/TargetMachine.h>
 
-#include <functional>
+#include <memory>
+#include <string>
 
 namespace cinn::backends {
 
-// TODO(fc500110): define class OptimizeOptions
+struct OptimizeOptions {
+  //! Allow reassociating, contracting and approximating float operations, which lets LLVM vectorize the float
+  //! reductions and fuse multiplies and adds.
+  bool fast_math{false};
+  //! The target cpu, e.g. "skylake-avx512", and the comma separated target features, e.g. "+avx2,+fma". The host's
+  //! are used if both are empty, setting them produces the same code on every machine of a heterogeneous fleet.
+  std::string target_cpu;
+  std::string target_features;
+  //! Hints for the loop vectorizer applied to every innermost loop, 0 lets LLVM decide. NOTE a vectorize width also
+  //! allows LLVM to reorder the float reductions in the loop.
+  int vectorize_width{0};
+  int interleave_count{0};
+  //! Log the time spent in each pass after optimizing a module.
+  bool time_passes{false};
+
+  //! The default options, which can be set for the whole process by the `cinn_llvm_*` flags.
+  static OptimizeOptions FromFlags();
+};
+
+/**
+ * Get the target machine described by `options`. Creating a target machine costs about as much as optimizing a small
+ * module, so it is created once and reused by all the later modules. A target machine is not thread-safe, each thread
+ * owns a cache of its own.
+ */
+llvm::TargetMachine *GetTargetMachine(const OptimizeOptions &options, int opt_level = 3);
+
+//! Create a target machine described by `options` which is owned by the caller.
+std::unique_ptr<llvm::TargetMachine> CreateTargetMachine(const OptimizeOptions &options, int opt_level = 3);
+
+//! Get the width in bits of the widest vector registers of the cpu described by `options`, which may not be the host.
+int GetVectorBits(const OptimizeOptions &options);
 
 // llvm module optimizer
 class LLVMModuleOptimizer final {
  public:
-  explicit LLVMModuleOptimizer(llvm::TargetMachine *machine,
-                               int opt_level,
-                               llvm::FastMathFlags fast_math_flags,
-                               bool print_passes = false);
+  LLVMModuleOptimizer(llvm::TargetMachine *machine, int opt_level, const OptimizeOptions &options = {});
+
   void operator()(llvm::Module *m);
 
  private:
+  //! Apply the fast-math flags and the vectorizer hints of `options_` to the functions of `m`.
+  void AnnotateModule(llvm::Module *m);
+
   llvm::TargetMachine *machine_;
   int opt_level_{};
-  bool print_passes_{};
+  OptimizeOptions options_;
 };
+
 }  // namespace cinn::backends
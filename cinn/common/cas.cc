@@ -14,14 +14,20 @@
 
 #include "cinn/common/cas.h"
 
+#include <gflags/gflags.h>
+
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 
 #include "cinn/common/arithmatic.h"
 #include "cinn/common/ir_util.h"
 #include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_arena.h"
 #include "cinn/ir/ir_mutator.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
@@ -29,11 +35,169 @@
 #include "cinn/optim/ir_copy.h"
 #include "cinn/utils/string.h"
 
+DEFINE_bool(cinn_cas_simplify_cache, true, "Whether to cache the results of the CAS simplification.");
+
 namespace cinn {
 namespace common {
 using namespace ir;  // NOLINT
 
+namespace {
+
+// Drop all the cached results when the cache grows beyond this size.
+constexpr size_t kMaxSimplifyCacheSize = 1 << 16;
+
+absl::flat_hash_map<std::string, Expr>& SimplifyCache() {
+  thread_local absl::flat_hash_map<std::string, Expr> cache;
+  return cache;
+}
+
+/**
+ * Generate the key of an expression for the AutoSimplify cache. Only the nodes which can appear in an index are
+ * supported, the other expressions are not cached.
+ */
+class SimplifyKeyBuilder {
+ public:
+  explicit SimplifyKeyBuilder(const absl::flat_hash_map<std::string, CasInterval>& var_intervals)
+      : var_intervals_(var_intervals) {}
+
+  bool operator()(const Expr& u, std::string* key) {
+    std::map<std::string, int64_t> coeffs;
+    int64_t constant = 0;
+    if (u.type().is_int() && CollectAffine(u, 1, u.type(), &coeffs, &constant)) {
+      // the intervals only matter to the division and modulo, which are not affine
+      os_ << "affine " << u.type() << ": " << constant;
+      for (auto& item : coeffs) {
+        if (item.second != 0) os_ << " + " << item.second << " * " << item.first;
+      }
+    } else {
+      os_ << "expr ";
+      if (!Build(u)) return false;
+      for (auto& var : vars_) {
+        auto it = var_intervals_.find(var);
+        if (it != var_intervals_.end()) os_ << " " << var << " in " << it->second;
+      }
+    }
+    *key = os_.str();
+    return true;
+  }
+
+ private:
+  // Collect `scale * e` to the linear form `constant + sum(coeffs[var] * var)`. The constant coefficients are only
+  // collected from a product with a variable or a subtraction of a variable, the CAS does not expand the products of
+  // sums, so expanding them here might merge two expressions which the CAS simplifies differently.
+  bool CollectAffine(const Expr& e, int64_t scale, Type type, std::map<std::string, int64_t>* coeffs, int64_t* constant) {
+    if (e.type() != type) return false;
+    if (auto* imm = e.As<IntImm>()) {
+      *constant += scale * imm->value;
+      return true;
+    }
+    if (auto* var = e.As<_Var_>()) {
+      if (var->is_reduce_axis) return false;
+      (*coeffs)[var->name] += scale;
+      return true;
+    }
+    if (auto* add = e.As<Add>()) {
+      return CollectAffine(add->a(), scale, type, coeffs, constant) &&
+             CollectAffine(add->b(), scale, type, coeffs, constant);
+    }
+    if (auto* sub = e.As<Sub>()) {
+      return (sub->b().As<IntImm>() || sub->b().As<_Var_>()) && CollectAffine(sub->a(), scale, type, coeffs, constant) &&
+             CollectAffine(sub->b(), -scale, type, coeffs, constant);
+    }
+    if (auto* mul = e.As<Mul>()) {
+      if (mul->a().As<IntImm>() && mul->b().As<_Var_>()) {
+        return CollectAffine(mul->b(), scale * mul->a().As<IntImm>()->value, type, coeffs, constant);
+      }
+      if (mul->b().As<IntImm>() && mul->a().As<_Var_>()) {
+        return CollectAffine(mul->a(), scale * mul->b().As<IntImm>()->value, type, coeffs, constant);
+      }
+    }
+    return false;
+  }
+
+  bool Build(const Expr& e) {
+    switch (e.node_type()) {
+      case IrNodeTy::IntImm:
+        os_ << e.As<IntImm>()->value << ":" << e.type();
+        return true;
+      case IrNodeTy::UIntImm:
+        os_ << e.As<UIntImm>()->value << ":" << e.type();
+        return true;
+      case IrNodeTy::FloatImm:
+        os_ << std::hexfloat << e.As<FloatImm>()->value << std::defaultfloat << ":" << e.type();
+        return true;
+      case IrNodeTy::_Var_: {
+        auto* var = e.As<_Var_>();
+        if (var->is_reduce_axis) return false;
+        os_ << var->name << ":" << e.type();
+        vars_.insert(var->name);
+        return true;
+      }
+      case IrNodeTy::Cast:
+        os_ << "cast<" << e.type() << ">(";
+        if (!Build(e.As<Cast>()->v())) return false;
+        os_ << ")";
+        return true;
+      case IrNodeTy::Minus:
+      case IrNodeTy::Not:
+        os_ << e.node_type() << "(";
+        if (!Build(e->operands[0])) return false;
+        os_ << ")";
+        return true;
+#define BINARY_OP(op__) case IrNodeTy::op__:
+        BINARY_OP(Add)
+        BINARY_OP(Sub)
+        BINARY_OP(Mul)
+        BINARY_OP(Div)
+        BINARY_OP(Mod)
+        BINARY_OP(Min)
+        BINARY_OP(Max)
+        BINARY_OP(EQ)
+        BINARY_OP(NE)
+        BINARY_OP(LT)
+        BINARY_OP(LE)
+        BINARY_OP(GT)
+        BINARY_OP(GE)
+        BINARY_OP(And)
+        BINARY_OP(Or)
+#undef BINARY_OP
+        os_ << e.node_type() << "(";
+        if (!Build(e->operands[0])) return false;
+        os_ << ", ";
+        if (!Build(e->operands[1])) return false;
+        os_ << ")";
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  const absl::flat_hash_map<std::string, CasInterval>& var_intervals_;
+  std::stringstream os_;
+  std::set<std::string> vars_;
+};
+
+}  // namespace
+
+void ClearAutoSimplifyCache() { SimplifyCache().clear(); }
+
+size_t AutoSimplifyCacheSize() { return SimplifyCache().size(); }
+
 Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals) {
+  // the CAS returns a copy of the constants and variables
+  if (u.is_constant() || u.As<_Var_>()) return optim::IRCopy(u);
+
+  std::string key;
+  SimplifyKeyBuilder key_builder(var_intervals);
+  bool cacheable = FLAGS_cinn_cas_simplify_cache && key_builder(u, &key);
+  if (cacheable) {
+    auto it = SimplifyCache().find(key);
+    if (it != SimplifyCache().end()) {
+      // IRCopy drops the bounds of the variables as the CAS does, so the copy equals the result of the CAS
+      return optim::IRCopy(it->second);
+    }
+  }
+
   u = detail::ConvertCinnToCAS(u);
   absl::flat_hash_map<std::string, CasInterval> s_var_intervals;
   for (auto& item : var_intervals) {
@@ -47,6 +211,15 @@ Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& v
   }
   u = CasSimplify(u, s_var_intervals);
   u = detail::ConvertCasToCinn(u);
+
+  if (cacheable) {
+    auto& cache = SimplifyCache();
+    if (cache.size() >= kMaxSimplifyCacheSize) cache.clear();
+    // the caller may modify the result in place, and the cache outlives the IrArenaScope of the lowering, so the
+    // stored copy is allocated from the heap
+    ir::IrHeapScope heap;
+    cache.emplace(std::move(key), optim::IRCopy(u));
+  }
   return u;
 }
 
@@ -82,8 +82,21 @@ struct CasInterval {
 
 using cas_intervals_t = absl::flat_hash_map<std::string, CasInterval>;
 
+/**
+ * Simplify an expression with the CAS.
+ *
+ * The results are cached per thread, keyed by the structure of `u` and the intervals of its variables. An affine
+ * expression, such as `i * 32 + j`, is keyed by its canonical linear form instead, so the equal index expressions
+ * written in different orders share one entry.
+ */
 Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals = {});
 
+//! Clear the AutoSimplify cache of the current thread, and get the number of cached results.
+// @{
+void ClearAutoSimplifyCache();
+size_t AutoSimplifyCacheSize();
+// @}
+
 //! Simplify a CAS expression.
 Expr CasSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals = {});
 
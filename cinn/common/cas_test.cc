@@ -14,15 +14,19 @@
 
 #include "cinn/common/cas.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include "cinn/cinn.h"
 #include "cinn/common/common.h"
 #include "cinn/common/ir_util.h"
+#include "cinn/ir/ir_arena.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/utils/string.h"
 
+DECLARE_bool(cinn_cas_simplify_cache);
+
 namespace cinn {
 namespace common {
 
@@ -453,5 +457,46 @@ TEST(CAS, cond) {
   }
 }
 
+TEST(CAS, SimplifyCache) {
+  Var x = ir::_Var_::Make("x", Int(32));
+  Var y = ir::_Var_::Make("y", Int(32));
+  ClearAutoSimplifyCache();
+
+  // the affine expressions are keyed by their linear forms
+  auto u1 = AutoSimplify(Expr(2) + Expr(x) * 2 + y);
+  EXPECT_EQ(GetStreamCnt(u1), "(2 + ((2 * x) + y))");
+  EXPECT_EQ(AutoSimplifyCacheSize(), 1UL);
+  auto u2 = AutoSimplify(Expr(y) + (Expr(x) + 1) + (Expr(x) + 1) - x + Expr(x) * 0);
+  EXPECT_EQ(GetStreamCnt(u2), "(2 + ((2 * x) + y))");
+  EXPECT_EQ(AutoSimplifyCacheSize(), 1UL);
+
+  // the other expressions are keyed by their structures and the intervals of their variables
+  common::cas_intervals_t var_intervals;
+  var_intervals.emplace("y", common::CasInterval(0, 31));
+  auto u3 = AutoSimplify((Expr(x) * 32 + y) / 32, var_intervals);
+  EXPECT_EQ(GetStreamCnt(u3), "x");
+  auto u4 = AutoSimplify((Expr(x) * 32 + y) / 32);
+  EXPECT_NE(GetStreamCnt(u4), "x");
+  EXPECT_EQ(AutoSimplifyCacheSize(), 3UL);
+
+  // the result can be modified without changing the cache
+  ASSERT_TRUE(u3.As<_Var_>());
+  u3.As<_Var_>()->name = "z";
+  EXPECT_EQ(GetStreamCnt(AutoSimplify((Expr(x) * 32 + y) / 32, var_intervals)), "x");
+
+  // the cached copies are not allocated from the arena, which they would keep alive after the lowering
+  gflags::FlagSaver flag_saver;
+  ir::IrArenaScope arena;
+  Expr u = Expr(x) * 2 + y;
+  FLAGS_cinn_cas_simplify_cache = false;
+  AutoSimplify(u);
+  int64_t num_uncached = arena.num_allocated();
+  FLAGS_cinn_cas_simplify_cache = true;
+  ClearAutoSimplifyCache();
+  AutoSimplify(u);
+  EXPECT_EQ(AutoSimplifyCacheSize(), 1UL);
+  EXPECT_EQ(arena.num_allocated() - num_uncached, num_uncached);
+}
+
 }  // namespace common
 }  // namespace cinn
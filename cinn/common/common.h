@@ -36,8 +36,10 @@ using common::Shared;
 using common::UniqName;
 
 // Type related.
+using common::BFloat16;
 using common::Bool;
 using common::Float;
+using common::Float16;
 using common::Int;
 using common::UInt;
 using common::Void;
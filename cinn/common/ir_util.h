@@ -108,9 +108,9 @@ Expr make_const(Type t, T v) {
     }
   } else {
     if (t.type() == Type::type_t::Int) {
-      return make_shared<ir::IntImm>(t, v);
+      return ir::MakeIntImm(t, v);
     } else {
-      return make_shared<ir::FloatImm>(t, v);
+      return ir::MakeFloatImm(t, v);
     }
   }
   return Expr();
@@ -21,10 +21,11 @@ namespace common {
 
 struct Type::Storage {
   Storage() = default;
-  Storage(type_t t, int b, int w) : type_(t), bits_(b), lanes_(w) {}
+  Storage(type_t t, int b, int w, specific_type_t st) : type_(t), bits_(b), lanes_(w), specific_type_(st) {}
 
   type_t type_{type_t::Unk};
   cpp_type_t cpp_type_{cpp_type_t::None};
+  specific_type_t specific_type_{specific_type_t::None};
 
   //! How many bits per element.
   int bits_{};
@@ -54,7 +55,11 @@ std::ostream &operator<<(std::ostream &os, const Type &t) {
       break;
 
     case Type::type_t::Float:
-      os << "float" << t.bits();
+      if (t.is_bfloat16()) {
+        os << "bfloat16";
+      } else {
+        os << "float" << t.bits();
+      }
       break;
     case Type::type_t::Void:
       os << "void";
@@ -179,12 +184,23 @@ Type Type::with_bits(int x) const {
   CHECK(is_primitive());
   Type type               = *this;
   type.GetStorage().bits_ = x;
+  // the 16-bit float format makes no sense for other widths
+  if (x != 16) {
+    type.GetStorage().specific_type_ = specific_type_t::None;
+  } else if (type.is_float() && type.specific_type() == specific_type_t::None) {
+    type.GetStorage().specific_type_ = specific_type_t::FP16;
+  }
   return type;
 }
 
 Type Type::with_type(Type::type_t x) const {
   Type type               = *this;
   type.GetStorage().type_ = x;
+  if (x != type_t::Float) {
+    type.GetStorage().specific_type_ = specific_type_t::None;
+  } else if (type.bits() == 16 && type.specific_type() == specific_type_t::None) {
+    type.GetStorage().specific_type_ = specific_type_t::FP16;
+  }
   return type;
 }
 
@@ -229,7 +245,10 @@ bool Type::valid() const {
   return true;
 }
 
-Type::Type(Type::type_t t, int b, int w) : storage_(new Storage(t, b, w)) {}
+Type::Type(Type::type_t t, int b, int w, specific_type_t st) : storage_(new Storage(t, b, w, st)) {
+  CHECK(st == specific_type_t::None || (t == type_t::Float && b == 16))
+      << "Only 16-bit float types can specify the float16 or bfloat16 format";
+}
 bool Type::is_primitive() const { return !is_unk() && type() != type_t::Customized; }
 bool Type::is_customized() const { return !is_unk() && type() == type_t::Customized; }
 bool Type::is_unk() const { return type() == type_t::Unk; }
@@ -238,6 +257,8 @@ bool Type::is_void() const { return type() == type_t::Void; }
 bool Type::is_vector() const { return lanes() > 1; }
 bool Type::is_scalar() const { return lanes() == 1; }
 bool Type::is_float(int bits) const { return type() == type_t::Float && (bits < 0 || bits == this->bits()); }
+bool Type::is_float16() const { return is_float(16) && specific_type() == specific_type_t::FP16; }
+bool Type::is_bfloat16() const { return is_float(16) && specific_type() == specific_type_t::BF16; }
 bool Type::is_uint(int bits) const { return type() == type_t::UInt && (bits < 0 || bits == this->bits()); }
 bool Type::is_int(int bits) const { return type() == type_t::Int && (bits < 0 || bits == this->bits()); }
 bool Type::is_integer(int bits) const {
@@ -259,9 +280,11 @@ Type::type_t Type::type() const { return GetStorage().type_; }
 int Type::bits() const { return GetStorage().bits_; }
 int Type::lanes() const { return GetStorage().lanes_; }
 Type::cpp_type_t Type::cpp_type() const { return GetStorage().cpp_type_; }
+Type::specific_type_t Type::specific_type() const { return GetStorage().specific_type_; }
 bool Type::operator==(const Type &other) const {
   return type() == other.type() && bits() == other.bits() && lanes() == other.lanes() &&
-         GetStorage().cpp_type_ == other.GetStorage().cpp_type_ && customized_type() == other.customized_type();
+         specific_type() == other.specific_type() && GetStorage().cpp_type_ == other.GetStorage().cpp_type_ &&
+         customized_type() == other.customized_type();
 }
 bool Type::is_string() const { return type() == type_t::String; }
 
@@ -280,6 +303,10 @@ const Type &F16() {
   static auto t = Float(16);
   return t;
 }
+const Type &BF16() {
+  static auto t = BFloat16();
+  return t;
+}
 const Type &F32() {
   static auto t = Float(32);
   return t;
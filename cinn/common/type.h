@@ -51,8 +51,15 @@ struct Type {
     HandleHandle = 1 << 2,  // pointer of pointer, such as `cinn_buffer_t**`.
   };
 
+  //! The 16-bit floating point formats share type_t::Float with the same bits, this tells them apart.
+  enum class specific_type_t : int8_t {
+    None = -1,
+    FP16,  // IEEE 754 half precision, 5 exponent bits and 10 mantissa bits.
+    BF16,  // brain floating point, the upper 16 bits of a float32.
+  };
+
   Type();
-  Type(type_t t, int b, int w);
+  Type(type_t t, int b, int w, specific_type_t st = specific_type_t::None);
   Type(const Type& other);
   explicit Type(Type&& other);
   Type& operator=(const Type& other);
@@ -69,6 +76,8 @@ struct Type {
   CINN_NODISCARD bool is_vector() const;
   CINN_NODISCARD bool is_scalar() const;
   CINN_NODISCARD bool is_float(int bits = -1) const;
+  CINN_NODISCARD bool is_float16() const;
+  CINN_NODISCARD bool is_bfloat16() const;
   CINN_NODISCARD bool is_int(int bits = -1) const;
   CINN_NODISCARD bool is_integer(int bits = -1) const;
   CINN_NODISCARD bool is_uint(int bits = -1) const;
@@ -104,6 +113,7 @@ struct Type {
   int bits() const;
   int lanes() const;
   cpp_type_t cpp_type() const;
+  specific_type_t specific_type() const;
   // @}
 
   //! Compare two types for equality.
@@ -140,13 +150,18 @@ struct Type {
 inline Type Void() { return Type(Type::type_t ::Void, 1, 0); }
 inline Type Int(int bits, int lanes = 1) { return Type(Type::type_t ::Int, bits, lanes); }
 inline Type UInt(int bits, int lanes = 1) { return Type(Type::type_t ::UInt, bits, lanes); }
-inline Type Float(int bits, int lanes = 1) { return Type(Type::type_t ::Float, bits, lanes); }
+inline Type Float(int bits, int lanes = 1) {
+  return Type(Type::type_t ::Float, bits, lanes, bits == 16 ? Type::specific_type_t::FP16 : Type::specific_type_t::None);
+}
+inline Type Float16(int lanes = 1) { return Float(16, lanes); }
+inline Type BFloat16(int lanes = 1) { return Type(Type::type_t ::Float, 16, lanes, Type::specific_type_t::BF16); }
 inline Type Bool(int lanes = 1) { return Type(Type::type_t ::UInt, 1, lanes); }
 inline Type String() { return Type(Type::type_t::String, 1, 1); }
 
 //! Builtin native types as global singletons.
 // @{
 const Type& F16();
+const Type& BF16();
 const Type& F32();
 const Type& F64();
 const Type& I8();
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include "cinn/utils/string.h"
+
 namespace cinn::common {
 
 TEST(Type, basic) {
@@ -28,4 +30,19 @@ TEST(Type, basic) {
   LOG(INFO) << type_of<float>();
 }
 
+TEST(Type, half) {
+  ASSERT_TRUE(F16().is_float(16));
+  ASSERT_TRUE(F16().is_float16());
+  ASSERT_FALSE(F16().is_bfloat16());
+  ASSERT_TRUE(BF16().is_float(16));
+  ASSERT_TRUE(BF16().is_bfloat16());
+  ASSERT_NE(F16(), BF16());
+  ASSERT_EQ(Float(16), F16());
+  ASSERT_EQ(BFloat16(4).ElementOf(), BF16());
+  ASSERT_FALSE(BF16().with_bits(32).is_bfloat16());
+  ASSERT_FALSE(BF16().with_type(Type::type_t::Int).is_bfloat16());
+  ASSERT_EQ(utils::GetStreamCnt(BF16()), "bfloat16");
+  ASSERT_EQ(utils::GetStreamCnt(F16()), "float16");
+}
+
 }  // namespace cinn::common
@@ -0,0 +1,242 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "cinn/backends/cuda_util.h"
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+
+size_t NumBytes(hlir::framework::Tensor tensor) {
+  const auto& type = tensor->type();
+  return static_cast<size_t>(tensor->shape().numel()) * ((type.bits() + 7) / 8) * type.lanes();
+}
+
+bool OnGPU(hlir::framework::Tensor tensor) { return tensor->get_buffer()->target().arch == Target::Arch::NVGPU; }
+
+void CopyBytes(void* dst, bool dst_on_gpu, const void* src, bool src_on_gpu, size_t bytes) {
+  if (!dst_on_gpu && !src_on_gpu) {
+    std::memcpy(dst, src, bytes);
+    return;
+  }
+#ifdef CINN_WITH_CUDA
+  auto kind = dst_on_gpu ? (src_on_gpu ? cudaMemcpyDeviceToDevice : cudaMemcpyHostToDevice) : cudaMemcpyDeviceToHost;
+  CUDA_CALL(cudaMemcpy(dst, src, bytes, kind));
+#else
+  LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+#endif
+}
+
+}  // namespace
+
+Batcher::Batcher(const std::map<int, std::shared_ptr<Interpreter>>& interpreters,
+                 const std::vector<std::string>& feed_names,
+                 const std::vector<std::string>& fetch_names,
+                 const Options& options)
+    : interpreters_(interpreters), feed_names_(feed_names), fetch_names_(fetch_names), options_(options) {
+  CHECK(!interpreters_.empty()) << "Batcher needs the programs of at least one batch size";
+  int max_batch_size = interpreters_.rbegin()->first;
+  if (options_.max_batch_size <= 0) options_.max_batch_size = max_batch_size;
+  CHECK_LE(options_.max_batch_size, max_batch_size) << "No program is large enough for the max batch size";
+  CHECK_GT(options_.num_workers, 0);
+  for (auto& item : interpreters_) {
+    auto check_batch_dim = [&](const std::string& name) {
+      auto shape = item.second->GetTensor(name)->shape().data();
+      CHECK(!shape.empty() && shape[0] == item.first)
+          << "The first dimension of " << name << " is not the batch size " << item.first;
+      return shape;
+    };
+    for (auto& name : fetch_names_) check_batch_dim(name);
+    for (auto& name : feed_names_) {
+      auto shape = check_batch_dim(name);
+      if (item.first != interpreters_.begin()->first) continue;
+      feed_sample_shapes_.emplace_back(shape.begin() + 1, shape.end());
+      feed_types_.push_back(item.second->GetTensor(name)->type());
+    }
+  }
+  for (int i = 0; i < options_.num_workers; i++) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+Batcher::~Batcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+std::string Batcher::CheckFeeds(const std::vector<hlir::framework::Tensor>& feeds) const {
+  std::ostringstream error;
+  if (feeds.size() != feed_names_.size()) {
+    error << "The number of feeds " << feeds.size() << " is different with the number of feed names "
+          << feed_names_.size();
+    return error.str();
+  }
+  int batch_size = -1;
+  for (size_t i = 0; i < feeds.size(); i++) {
+    auto shape = feeds[i]->shape().data();
+    if (shape.empty()) {
+      error << "The feed " << feed_names_[i] << " has no batch dimension";
+    } else if (batch_size != -1 && shape[0] != batch_size) {
+      error << "The feeds of a request should have the same batch size";
+    } else if (shape[0] <= 0 || shape[0] > options_.max_batch_size) {
+      error << "The batch size " << shape[0] << " of the request is out of (0, " << options_.max_batch_size << "]";
+    } else if (std::vector<int>(shape.begin() + 1, shape.end()) != feed_sample_shapes_[i]) {
+      error << "The shape of the feed " << feed_names_[i] << " is different with the model's";
+    } else if (!feed_types_[i].is_unk() && feeds[i]->type() != feed_types_[i]) {
+      error << "The type " << feeds[i]->type() << " of the feed " << feed_names_[i] << " is different with the model's "
+            << feed_types_[i];
+    } else if (OnGPU(feeds[i]) || !feeds[i]->buffer()->memory) {
+      error << "The feed " << feed_names_[i] << " should be a host tensor with data";
+    } else {
+      batch_size = shape[0];
+      continue;
+    }
+    return error.str();
+  }
+  return "";
+}
+
+std::future<std::vector<hlir::framework::Tensor>> Batcher::Submit(std::vector<hlir::framework::Tensor> feeds) {
+  auto request = std::make_unique<Request>();
+  auto fetches = request->fetches.get_future();
+  // a bad request fails alone instead of aborting the workers serving the others
+  std::string error = CheckFeeds(feeds);
+  if (!error.empty()) {
+    request->fetches.set_exception(std::make_exception_ptr(std::invalid_argument(error)));
+    return fetches;
+  }
+  int batch_size = feeds[0]->shape().data()[0];
+
+  request->feeds      = std::move(feeds);
+  request->batch_size = batch_size;
+  request->arrival    = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK(!stop_) << "The batcher is stopped";
+    queue_.push_back(std::move(request));
+    num_queued_samples_ += batch_size;
+  }
+  cv_.notify_all();
+  return fetches;
+}
+
+void Batcher::WorkerLoop() {
+  // the execution contexts share the compiled code and the weights, but not the activations with the other workers
+  std::map<int, std::unique_ptr<Interpreter::ExecutionContext>> contexts;
+  for (auto& item : interpreters_) {
+    contexts[item.first] = item.second->CreateExecutionContext();
+  }
+
+  while (true) {
+    std::vector<std::unique_ptr<Request>> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+      // wait until the batch is full or the first request reaches the deadline, which is not waited on stopping
+      auto deadline = queue_.front()->arrival + options_.max_delay;
+      cv_.wait_until(lock, deadline, [this] {
+        return stop_ || queue_.empty() || num_queued_samples_ >= options_.max_batch_size;
+      });
+      int num_samples = 0;
+      while (!queue_.empty() && num_samples + queue_.front()->batch_size <= options_.max_batch_size) {
+        num_samples += queue_.front()->batch_size;
+        num_queued_samples_ -= queue_.front()->batch_size;
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+    }
+    // the requests may be taken by another worker while waiting
+    if (!batch.empty()) RunBatch(&batch, &contexts);
+  }
+}
+
+void Batcher::RunBatch(std::vector<std::unique_ptr<Request>>* batch,
+                       std::map<int, std::unique_ptr<Interpreter::ExecutionContext>>* contexts) {
+  int num_samples = 0;
+  for (auto& request : *batch) num_samples += request->batch_size;
+  // the smallest program which fits the batch, the samples left are not used
+  auto it = contexts->lower_bound(num_samples);
+  CHECK(it != contexts->end());
+  int batch_size = it->first;
+  auto& context  = it->second;
+  VLOG(3) << "Run " << batch->size() << " requests of " << num_samples << " samples with batch size " << batch_size;
+
+  // the feeds are checked on submitting, a request which still doesn't fit the program fails alone
+  auto fits_program = [&](const std::unique_ptr<Request>& request) {
+    for (int i = 0; i < feed_names_.size(); i++) {
+      auto tensor = context->GetTensor(feed_names_[i]);
+      if (tensor->buffer()->memory &&
+          NumBytes(request->feeds[i]) == NumBytes(tensor) / batch_size * request->batch_size) {
+        continue;
+      }
+      request->fetches.set_exception(std::make_exception_ptr(
+          std::invalid_argument("The feed " + feed_names_[i] + " doesn't fit the program of batch size " +
+                                std::to_string(batch_size))));
+      return false;
+    }
+    return true;
+  };
+  batch->erase(std::stable_partition(batch->begin(), batch->end(), fits_program), batch->end());
+  if (batch->empty()) return;
+
+  for (int i = 0; i < feed_names_.size(); i++) {
+    auto tensor = context->GetTensor(feed_names_[i]);
+    auto* data  = tensor->buffer()->memory;
+    for (auto& request : *batch) {
+      auto& feed = request->feeds[i];
+      CopyBytes(data, OnGPU(tensor), feed->buffer()->memory, false, NumBytes(feed));
+      data += NumBytes(feed);
+    }
+  }
+
+  context->Run();
+
+  std::vector<std::vector<hlir::framework::Tensor>> fetches(batch->size());
+  for (auto& name : fetch_names_) {
+    // the batch dimension of the fetches is checked on constructing
+    auto tensor = context->GetTensor(name);
+    size_t sample_bytes = NumBytes(tensor) / batch_size;
+    const auto* data    = tensor->buffer()->memory;
+    for (int i = 0; i < batch->size(); i++) {
+      auto shape = tensor->shape().data();
+      shape[0]   = (*batch)[i]->batch_size;
+      hlir::framework::Tensor fetch;
+      fetch->Resize(hlir::framework::Shape(shape));
+      void* fetch_data = fetch->mutable_data(common::DefaultHostTarget(), tensor->type());
+      CopyBytes(fetch_data, false, data, OnGPU(tensor), NumBytes(fetch));
+      data += NumBytes(fetch);
+      fetches[i].push_back(fetch);
+    }
+  }
+  for (int i = 0; i < batch->size(); i++) {
+    (*batch)[i]->fetches.set_value(std::move(fetches[i]));
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
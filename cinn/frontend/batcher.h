@@ -0,0 +1,122 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/frontend/interpreter.h"
+#include "cinn/hlir/framework/tensor.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * Batcher serves many small requests of a model with few large batches. The requests are queued and coalesced up to
+ * a max batch size or until the first one has waited for a max delay. Then the batch runs once in the smallest
+ * compiled program that fits it, and the fetches are scattered back to the requests.
+ *
+ * The programs for the different batch sizes are the Interpreters loading the same model with the first dimension
+ * of the inputs set to the batch size. Each worker thread runs the batches in its own execution contexts of them.
+ *
+ * Usage:
+ * \code
+ * std::map<int, std::shared_ptr<Interpreter>> interpreters;
+ * for (int batch_size : {1, 4, 16}) {
+ *   interpreters[batch_size] = std::make_shared<Interpreter>(input_names, shapes_of_batch(batch_size));
+ *   interpreters[batch_size]->LoadPaddleModel(model_dir, target);
+ * }
+ * Batcher batcher(interpreters, input_names, fetch_names);
+ * auto fetches = batcher.Submit({input_tensor}).get();
+ * \endcode
+ */
+class Batcher {
+ public:
+  struct Options {
+    //! The max number of samples in a batch, 0 means the largest batch size of the programs.
+    int max_batch_size{0};
+    //! The max time the first request of a batch waits for the others.
+    std::chrono::microseconds max_delay{1000};
+    //! The number of threads running the batches.
+    int num_workers{1};
+  };
+
+  Batcher(const std::map<int, std::shared_ptr<Interpreter>>& interpreters,
+          const std::vector<std::string>& feed_names,
+          const std::vector<std::string>& fetch_names,
+          const Options& options);
+  Batcher(const std::map<int, std::shared_ptr<Interpreter>>& interpreters,
+          const std::vector<std::string>& feed_names,
+          const std::vector<std::string>& fetch_names)
+      : Batcher(interpreters, feed_names, fetch_names, Options()) {}
+
+  //! Run the queued requests and stop the workers.
+  ~Batcher();
+
+  /**
+   * Queue a request, it is thread safe.
+   * @param feeds The host tensors of the feeds in the order of the feed names, their first dimension is the number of
+   * samples in the request.
+   * @return The host tensors of the fetches of this request. It holds a std::invalid_argument instead if the feeds
+   * don't match the model.
+   */
+  std::future<std::vector<hlir::framework::Tensor>> Submit(std::vector<hlir::framework::Tensor> feeds);
+
+ private:
+  struct Request {
+    std::vector<hlir::framework::Tensor> feeds;
+    int batch_size;
+    std::chrono::steady_clock::time_point arrival;
+    std::promise<std::vector<hlir::framework::Tensor>> fetches;
+  };
+
+  //! Check the feeds of a request against the model, return the error or an empty string if they are valid.
+  std::string CheckFeeds(const std::vector<hlir::framework::Tensor>& feeds) const;
+
+  void WorkerLoop();
+
+  void RunBatch(std::vector<std::unique_ptr<Request>>* batch,
+                std::map<int, std::unique_ptr<Interpreter::ExecutionContext>>* contexts);
+
+  std::map<int, std::shared_ptr<Interpreter>> interpreters_;
+  std::vector<std::string> feed_names_;
+  std::vector<std::string> fetch_names_;
+  Options options_;
+  //! The shape of one sample and the type of each feed of the model.
+  std::vector<std::vector<int>> feed_sample_shapes_;
+  std::vector<common::Type> feed_types_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  //! The number of samples in the queue.
+  int num_queued_samples_{0};
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(Batcher);
+};
+
+}  // namespace frontend
+}  // namespace cinn
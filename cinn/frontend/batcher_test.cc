@@ -0,0 +1,109 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/batcher.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "cinn/runtime/use_extern_funcs.h"
+
+DEFINE_string(model_dir, "", "");
+
+namespace cinn::frontend {
+
+namespace {
+
+// the programs of different batch sizes may sum up in different orders
+void ExpectNear(const float* result, const std::vector<float>& expected) {
+  for (int i = 0; i < expected.size(); i++) {
+    EXPECT_NEAR(result[i], expected[i], 1e-4);
+  }
+}
+
+}  // namespace
+
+TEST(Batcher, basic) {
+  auto target = common::DefaultHostTarget();
+  std::map<int, std::shared_ptr<Interpreter>> interpreters;
+  for (int batch_size : {1, 2, 4}) {
+    std::vector<hlir::framework::shape_t> input_shapes{{batch_size, 30}};
+    interpreters[batch_size] = std::make_shared<Interpreter>(std::vector<std::string>{"A"}, input_shapes);
+    interpreters[batch_size]->LoadPaddleModel(FLAGS_model_dir, target);
+  }
+
+  auto make_feed = [&](int batch_size, float value) {
+    hlir::framework::Tensor tensor;
+    tensor->Resize(hlir::framework::Shape({batch_size, 30}));
+    auto* data = tensor->mutable_data<float>(target);
+    for (int i = 0; i < tensor->shape().numel(); i++) data[i] = value + i % 30 * 0.1f;
+    return tensor;
+  };
+  auto expected = [&](float value) {
+    auto& interpreter = interpreters[1];
+    auto input        = interpreter->GetTensor("A");
+    auto feed         = make_feed(1, value);
+    std::copy(feed->data<float>(), feed->data<float>() + 30, input->mutable_data<float>(target));
+    interpreter->Run();
+    auto fetch = interpreter->GetTensor("fc_0.tmp_2");
+    return std::vector<float>(fetch->data<float>(), fetch->data<float>() + fetch->shape().numel());
+  };
+
+  Batcher::Options options;
+  // long enough to coalesce all the requests submitted below
+  options.max_delay   = std::chrono::seconds(1);
+  options.num_workers = 2;
+  Batcher batcher(interpreters, {"A"}, {"fc_0.tmp_2"}, options);
+
+  std::vector<std::future<std::vector<hlir::framework::Tensor>>> futures;
+  for (int i = 0; i < 3; i++) {
+    futures.push_back(batcher.Submit({make_feed(1, i)}));
+  }
+  // a request of two samples
+  futures.push_back(batcher.Submit({make_feed(2, 3)}));
+
+  for (int i = 0; i < 3; i++) {
+    auto fetches = futures[i].get();
+    ASSERT_EQ(fetches.size(), 1UL);
+    ASSERT_EQ(fetches[0]->shape().data()[0], 1);
+    ExpectNear(fetches[0]->data<float>(), expected(i));
+  }
+  auto fetches = futures[3].get();
+  ASSERT_EQ(fetches[0]->shape().data()[0], 2);
+  int sample_size = fetches[0]->shape().numel() / 2;
+  auto sample     = expected(3);
+  ASSERT_EQ(sample_size, sample.size());
+  for (int i = 0; i < 2; i++) {
+    ExpectNear(fetches[0]->data<float>() + i * sample_size, sample);
+  }
+
+  // the requests which don't match the model fail alone, the batcher keeps serving the others
+  hlir::framework::Tensor bad_shape;
+  bad_shape->Resize(hlir::framework::Shape({1, 31}));
+  bad_shape->mutable_data<float>(target);
+  hlir::framework::Tensor bad_type;
+  bad_type->Resize(hlir::framework::Shape({1, 30}));
+  bad_type->mutable_data<int>(target);
+  EXPECT_THROW(batcher.Submit({bad_shape}).get(), std::invalid_argument);
+  EXPECT_THROW(batcher.Submit({bad_type}).get(), std::invalid_argument);
+  EXPECT_THROW(batcher.Submit({make_feed(8, 0)}).get(), std::invalid_argument);
+  EXPECT_THROW(batcher.Submit({}).get(), std::invalid_argument);
+  auto good = batcher.Submit({make_feed(1, 0)}).get();
+  ExpectNear(good[0]->data<float>(), expected(0));
+}
+
+}  // namespace cinn::frontend
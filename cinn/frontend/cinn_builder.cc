@@ -149,5 +149,17 @@ std::vector<Variable> CinnBuilder::BnGradBiasScale(const Variable& x, const Vari
   return instr.GetOutputs();
 }
 
+std::vector<Variable> CinnBuilder::BnGradBiasScale(const Variable& x,
+                                                   const Variable& x_mean,
+                                                   const Variable& y_grad,
+                                                   const Variable& relu_out) {
+  Instruction instr("bn_grad_bias_scale", {x, x_mean, y_grad, relu_out});
+  instr.SetAttr("dim", std::vector<int>{0, 2, 3});
+  instr.SetAttr("keep_dim", false);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutputs();
+}
+
 }  // namespace frontend
 }  // namespace cinn
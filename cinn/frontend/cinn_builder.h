@@ -132,6 +132,15 @@ class CinnBuilder : public BaseBuilder {
   std::vector<Variable> BnMeanVariance(const Variable& x);
 
   std::vector<Variable> BnGradBiasScale(const Variable& x, const Variable& x_mean, const Variable& y_grad);
+
+  /**
+   * The same as BnGradBiasScale(x, x_mean, y_grad), but y_grad is the grad of the output of a relu after batch norm.
+   * The grad of relu, y_grad * (relu_out > 0), is computed in the same pass over the tensors.
+   */
+  std::vector<Variable> BnGradBiasScale(const Variable& x,
+                                        const Variable& x_mean,
+                                        const Variable& y_grad,
+                                        const Variable& relu_out);
 };
 
 }  // namespace frontend
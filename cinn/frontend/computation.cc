@@ -14,6 +14,12 @@
 
 #include "cinn/frontend/computation.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include "cinn/frontend/program_pass.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/graph_compiler.h"
@@ -23,6 +29,46 @@
 namespace cinn {
 namespace frontend {
 
+namespace {
+
+void CopyHostToTensor(const Target &target, hlir::framework::Tensor t, const void *data, size_t size) {
+  void *tdata = reinterpret_cast<void *>(t->mutable_data<float>(target));
+  CHECK_EQ(size, t->shape().numel() * sizeof(float));
+  if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaMemcpy(tdata, data, size, cudaMemcpyHostToDevice));
+#else
+    CINN_NOT_IMPLEMENTED
+#endif
+  } else if (target.arch == Target::Arch::X86) {
+    memcpy(tdata, data, size);
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
+void CopyTensorToHost(const Target &target, hlir::framework::Tensor t, void *data, size_t size) {
+  void *tdata = reinterpret_cast<void *>(t->mutable_data<float>(target));
+  CHECK_EQ(size, t->shape().numel() * sizeof(float));
+  if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaMemcpy(data, tdata, size, cudaMemcpyDeviceToHost));
+#else
+    CINN_NOT_IMPLEMENTED
+#endif
+  } else if (target.arch == Target::Arch::X86) {
+    memcpy(data, tdata, size);
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
+size_t TensorBytes(const hlir::framework::Tensor &t) { return t->shape().numel() * sizeof(float); }
+
+}  // namespace
+
+class AsyncExecutor;
+
 struct ComputationContext {
   Target target;
   void *stream;
@@ -33,10 +79,173 @@ struct ComputationContext {
 
   CinnComputation::CompileOptions compile_options;
 
+  std::vector<std::string> input_names;
   std::vector<hlir::framework::Tensor> inputs;
   std::vector<hlir::framework::Tensor> outputs;
   std::unordered_map<std::string, Variable> varmap;
   std::unordered_map<std::string, std::string> varmap_paddle2program;
+
+  // created by the first ExecuteAsync, declared last to stop its thread before the others are destroyed
+  std::once_flag async_once;
+  std::unique_ptr<AsyncExecutor> async_executor;
+
+  // the name of the variable in the program of a tensor of the program or the paddle model
+  std::string GetTensorName(const std::string &tname) const {
+    if (scope->FindVar(tname)) return tname;
+    auto it = varmap_paddle2program.find(tname);
+    if (it == varmap_paddle2program.end()) {
+      LOG(FATAL) << "No variable called [" << tname
+                 << "] found in computation\nThe existing vars: " << utils::Join(scope->var_names(), ", ");
+    }
+    return it->second;
+  }
+};
+
+/**
+ * The pipeline of ExecuteAsync. Each buffer is an execution scope of the program, a request takes a free one, copies
+ * its inputs into it and is queued, the worker thread runs the queued requests one by one, then the copier thread
+ * copies their outputs and gives back their buffers. So the input copies of the next requests and the output copies
+ * of the previous one overlap with the running one, which takes three buffers.
+ */
+class AsyncExecutor {
+ public:
+  explicit AsyncExecutor(const ComputationContext *ctx) : ctx_(ctx) {
+    CHECK(ctx->compile_options.with_instantiate_variables)
+        << "ExecuteAsync requires the variables instantiated by the compilation";
+    CHECK_GT(ctx->compile_options.num_async_buffers, 0);
+    for (int i = 0; i < ctx->compile_options.num_async_buffers; i++) {
+      scopes_.push_back(ctx->program->CreateExecutionScope(ctx->input_names));
+      free_buffers_.push_back(i);
+    }
+    worker_ = std::thread(&AsyncExecutor::WorkerLoop, this);
+    copier_ = std::thread(&AsyncExecutor::CopierLoop, this);
+  }
+
+  //! Run the queued requests, copy their outputs and stop the threads.
+  ~AsyncExecutor() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    queued_cv_.notify_one();
+    worker_.join();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      worker_stopped_ = true;
+    }
+    executed_cv_.notify_one();
+    copier_.join();
+  }
+
+  std::future<void> Submit(const std::map<std::string, const void *> &inputs,
+                           const std::map<std::string, void *> &outputs,
+                           std::function<void()> callback) {
+    // only the feeds are in the memory of an execution scope, the others, e.g. the weights, are shared by all the
+    // requests, and a feed not given would keep the data of a previous request
+    std::map<std::string, const void *> feeds;
+    for (auto &item : inputs) {
+      auto name = ctx_->GetTensorName(item.first);
+      CHECK(std::find(ctx_->input_names.begin(), ctx_->input_names.end(), name) != ctx_->input_names.end())
+          << "ExecuteAsync can only feed the inputs of the program, but " << item.first << " is not an input";
+      feeds[name] = item.second;
+    }
+    for (auto &name : ctx_->input_names) {
+      CHECK(feeds.count(name)) << "The input " << name << " of ExecuteAsync is not given";
+    }
+
+    auto request      = std::make_unique<Request>();
+    request->callback = std::move(callback);
+    for (auto &item : outputs) {
+      request->outputs.emplace_back(ctx_->GetTensorName(item.first), item.second);
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      free_cv_.wait(lock, [this] { return !free_buffers_.empty(); });
+      request->buffer = free_buffers_.front();
+      free_buffers_.pop_front();
+    }
+    auto &scope = *scopes_[request->buffer];
+    for (auto &item : feeds) {
+      auto tensor = scope.GetTensor(item.first);
+      CopyHostToTensor(ctx_->target, tensor, item.second, TensorBytes(tensor));
+    }
+
+    auto done = request->done.get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(std::move(request));
+    }
+    queued_cv_.notify_one();
+    return done;
+  }
+
+ private:
+  struct Request {
+    int buffer;
+    std::vector<std::pair<std::string, void *>> outputs;
+    std::function<void()> callback;
+    std::promise<void> done;
+  };
+
+  void WorkerLoop() {
+    while (true) {
+      std::unique_ptr<Request> request;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queued_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        request = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      ctx_->program->ExecuteInScope(*scopes_[request->buffer], ctx_->stream);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        executed_.push_back(std::move(request));
+      }
+      executed_cv_.notify_one();
+    }
+  }
+
+  void CopierLoop() {
+    while (true) {
+      std::unique_ptr<Request> request;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        executed_cv_.wait(lock, [this] { return worker_stopped_ || !executed_.empty(); });
+        if (executed_.empty()) return;
+        request = std::move(executed_.front());
+        executed_.pop_front();
+      }
+      auto &scope = *scopes_[request->buffer];
+      for (auto &item : request->outputs) {
+        auto tensor = scope.GetTensor(item.first);
+        CopyTensorToHost(ctx_->target, tensor, item.second, TensorBytes(tensor));
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_buffers_.push_back(request->buffer);
+      }
+      free_cv_.notify_one();
+      if (request->callback) request->callback();
+      request->done.set_value();
+    }
+  }
+
+  const ComputationContext *ctx_;
+  std::vector<std::shared_ptr<hlir::framework::Scope>> scopes_;
+
+  std::mutex mutex_;
+  std::condition_variable free_cv_;
+  std::condition_variable queued_cv_;
+  std::condition_variable executed_cv_;
+  std::deque<int> free_buffers_;
+  // the requests to run, and the requests run whose outputs are to copy
+  std::deque<std::unique_ptr<Request>> queue_;
+  std::deque<std::unique_ptr<Request>> executed_;
+  bool stop_{false};
+  bool worker_stopped_{false};
+  std::thread worker_;
+  std::thread copier_;
 };
 
 std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
@@ -49,16 +258,24 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
   ctx->stream          = stream;
   ctx->target          = target;
   ctx->compile_options = options;
+  std::unordered_set<std::string> fetch_var_ids;
+  for (auto &out : outputs) {
+    fetch_var_ids.insert(out->id);
+  }
   if (ctx->compile_options.use_decomposer) {
+    ApplyPass(&program, fetch_var_ids, "BatchNormReluGradFusion");
     ProgramPass::Apply(&program, target, {"Decomposer"});
   }
   ctx->graph.reset(new hlir::framework::Graph(program, target));
+  // the passes should not fuse away the fetched vars
+  ctx->graph->attrs["fetch_var_ids"] = std::make_shared<absl::any>(fetch_var_ids);
 
   if (ctx->compile_options.use_default_passes) {
     hlir::framework::ApplyPass(ctx->graph.get(), "InferShape");
 
 #ifndef CINN_WITH_CUDA
     if (target.arch == Target::Arch::X86) {
+      hlir::framework::ApplyPass(ctx->graph.get(), "DepthwisePointwiseFusion");
       hlir::framework::ApplyPass(ctx->graph.get(), "AlterLayout");
     }
 #endif
@@ -72,17 +289,13 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
   ctx->scope = hlir::framework::BuildScope(target, ctx->graph, scope);
   ctx->graph_compiler.reset(new hlir::framework::GraphCompiler(target, ctx->scope, ctx->graph));
 
-  std::unordered_set<std::string> fetch_var_ids;
-  for (auto &out : outputs) {
-    fetch_var_ids.insert(out->id);
-  }
-
   ctx->program = ctx->graph_compiler->Build(options, std::move(fetch_var_ids)).runtime_program;
   if (ctx->compile_options.do_prerun) {
     ctx->program->PreRun();
   }
 
   for (auto &in_v : program.GetInputs()) {
+    ctx->input_names.push_back(in_v->id);
     hlir::framework::Tensor t = ctx->scope->GetTensor(in_v->id);
     ctx->inputs.push_back(t);
   }
@@ -180,34 +393,11 @@ void CinnComputation::SetTensorData(const std::string &tname, void *data, size_t
 }
 
 void CinnComputation::SetTensorData(hlir::framework::Tensor &t, void *data, size_t size) {
-  void *tdata = reinterpret_cast<void *>(t->mutable_data<float>(context_->target));
-  CHECK_EQ(size, t->shape().numel() * sizeof(float));
-  if (context_->target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-    CUDA_CALL(cudaMemcpy(tdata, data, size, cudaMemcpyHostToDevice));
-#else
-    CINN_NOT_IMPLEMENTED
-#endif
-  } else if (context_->target.arch == Target::Arch::X86) {
-    memcpy(tdata, data, size);
-  } else {
-    CINN_NOT_IMPLEMENTED
-  }
+  CopyHostToTensor(context_->target, t, data, size);
 }
+
 void CinnComputation::GetTensorData(hlir::framework::Tensor &t, void *data, size_t size) {
-  void *tdata = reinterpret_cast<void *>(t->mutable_data<float>(context_->target));
-  CHECK_EQ(size, t->shape().numel() * sizeof(float));
-  if (context_->target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-    CUDA_CALL(cudaMemcpy(data, tdata, size, cudaMemcpyDeviceToHost));
-#else
-    CINN_NOT_IMPLEMENTED
-#endif
-  } else if (context_->target.arch == Target::Arch::X86) {
-    memcpy(data, tdata, size);
-  } else {
-    CINN_NOT_IMPLEMENTED
-  }
+  CopyTensorToHost(context_->target, t, data, size);
 }
 
 void CinnComputation::GetTensorData(const std::string &tname, void *data, size_t size) {
@@ -220,20 +410,20 @@ std::vector<hlir::framework::Tensor> CinnComputation::GetInputTensors() { return
 std::vector<hlir::framework::Tensor> CinnComputation::GetOutputTensors() { return context_->outputs; }
 
 hlir::framework::Tensor CinnComputation::GetTensor(const std::string &tname) {
-  if (context_->scope->FindVar(tname)) {
-    return context_->scope->GetTensor(tname);
-  }
-  auto it = context_->varmap_paddle2program.find(tname);
-  if (it == context_->varmap_paddle2program.end()) {
-    LOG(FATAL) << "No variable called [" << tname
-               << "] found in computation\nThe existing vars: " << utils::Join(context_->scope->var_names(), ", ");
-  }
-  return context_->scope->GetTensor(it->second);
+  return context_->scope->GetTensor(context_->GetTensorName(tname));
 }
 
 void CinnComputation::Execute(const std::map<std::string, cinn_pod_value_t> *name2podargs) {
   context_->program->Execute(name2podargs, context_->stream);
 }
 
+std::future<void> CinnComputation::ExecuteAsync(const std::map<std::string, const void *> &inputs,
+                                                const std::map<std::string, void *> &outputs,
+                                                std::function<void()> callback) {
+  std::call_once(context_->async_once,
+                 [this] { context_->async_executor = std::make_unique<AsyncExecutor>(context_.get()); });
+  return context_->async_executor->Submit(inputs, outputs, std::move(callback));
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <functional>
+#include <future>
 #include <iostream>
 
 #include "cinn/frontend/base_builder.h"
@@ -31,6 +33,8 @@ class CinnComputation {
     bool do_prerun          = true;
     bool use_default_passes = true;
     std::vector<std::string> passes;
+    //! The max number of requests of ExecuteAsync in flight, each of them has its own inputs, outputs and temporaries.
+    int num_async_buffers = 2;
   };
 
   inline static CompileOptions DefaultCompileOptions() {
@@ -40,6 +44,7 @@ class CinnComputation {
     options.passes                     = {};
     options.do_prerun                  = true;
     options.use_default_passes         = true;
+    options.num_async_buffers          = 2;
     return options;
   }
 
@@ -150,9 +155,28 @@ class CinnComputation {
 
   /**
    * run the compiled program
+   * @param name2podargs the arguments of the program instead of the variables in its scope, the memory of a host
+   * buffer should be aligned to hlir::framework::Buffer::kMinHostAlignment
    */
   void Execute(const std::map<std::string, cinn_pod_value_t> *name2podargs = nullptr);
 
+  /**
+   * run the compiled program asynchronously in a pipeline of CompileOptions::num_async_buffers execution scopes.
+   * the inputs are copied into a free scope by the calling thread, so they overlap with the running requests, then
+   * a background thread runs the requests in the order of submission and another one copies their outputs, so the
+   * output copies overlap with the next request.
+   * it blocks when all the scopes are in flight. it requires with_instantiate_variables, and it is thread safe.
+   * @param inputs the names of all the inputs of the program and the host buffers to copy from, the other tensors,
+   *               e.g. the weights, are shared by the requests and can't be fed
+   * @param outputs the names of the tensors to fetch and the host buffers to copy to, they should be valid until the
+   *                request is done
+   * @param callback called after the outputs of this request are copied
+   * @return the future which is ready after the outputs of this request are copied
+   */
+  std::future<void> ExecuteAsync(const std::map<std::string, const void *> &inputs,
+                                 const std::map<std::string, void *> &outputs,
+                                 std::function<void()> callback = nullptr);
+
  private:
   std::shared_ptr<ComputationContext> context_;
 };
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+
 #include "cinn/common/target.h"
 #include "cinn/frontend/cinn_builder.h"
 #include "cinn/frontend/decomposer/use_decomposer.h"
@@ -103,6 +105,50 @@ TEST(cinn_computation, basic_cpu) {
   }
 }
 
+TEST(cinn_computation, execute_async_cpu) {
+  NetBuilder builder("basic");
+  constexpr int M = 32;
+  constexpr int N = 24;
+
+  auto a = builder.CreateInput(Float(32), {M, N}, "A");
+  auto b = builder.CreateInput(Float(32), {M, N}, "B");
+  auto c = builder.Add(a, b);
+  auto d = builder.Add(a, c);
+
+  auto target = common::DefaultHostTarget();
+  auto comp   = CinnComputation::BuildAndCompile(target, builder);
+
+  // more requests than the buffers, so the later ones wait for the earlier ones
+  constexpr int kRequests = 5;
+  std::vector<std::vector<float>> hostA(kRequests, std::vector<float>(M * N));
+  std::vector<std::vector<float>> hostB(kRequests, std::vector<float>(M * N));
+  std::vector<std::vector<float>> hostD(kRequests, std::vector<float>(M * N));
+  std::vector<std::future<void>> futures;
+  std::atomic<int> num_callbacks{0};
+  for (int r = 0; r < kRequests; r++) {
+    for (int i = 0; i < M * N; i++) {
+      hostA[r][i] = static_cast<float>(rand()) / INT_MAX + r;
+      hostB[r][i] = static_cast<float>(rand()) / INT_MAX;
+    }
+    futures.push_back(comp->ExecuteAsync({{"A", hostA[r].data()}, {"B", hostB[r].data()}},
+                                         {{d->id, hostD[r].data()}},
+                                         [&num_callbacks] { num_callbacks++; }));
+  }
+  for (int r = 0; r < kRequests; r++) {
+    futures[r].get();
+    for (int i = 0; i < M * N; i++) {
+      ASSERT_NEAR(hostD[r][i], hostA[r][i] * 2 + hostB[r][i], 1e-5);
+    }
+  }
+  ASSERT_EQ(num_callbacks, kRequests);
+
+  // every input should be fed, and only the inputs can be fed
+  ASSERT_DEATH(comp->ExecuteAsync({{"A", hostA[0].data()}}, {{d->id, hostD[0].data()}}), "");
+  ASSERT_DEATH(comp->ExecuteAsync({{"A", hostA[0].data()}, {"B", hostB[0].data()}, {c->id, hostB[0].data()}},
+                                  {{d->id, hostD[0].data()}}),
+               "");
+}
+
 #ifdef CINN_WITH_CUDA
 TEST(cinn_computation, basic_gpu) {
   NetBuilder builder("basic");
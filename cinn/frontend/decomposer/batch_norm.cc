@@ -57,40 +57,55 @@ struct BatchNormHelper {
     return builder->BroadcastTo(builder->ConstScalar<T>(value, common::UniqName(name)), shape, {0});
   }
 
-  std::vector<Variable> MeanAndVariance(Variable x) {
+  // The fused reduce ops read the tensors once for both of their sums, they support NCHW only on x86.
+  bool UseFusedReduce() const {
 #ifdef CINN_WITH_CUDA
-    // To optimize the bn forward by merge the reduce computation of mean and variance,
-    // build a fusion op 'BnMeanVariance' by hand as the fusion pass is not support now.
-    // When the fusion pass is rebuild, this op is to be removed.
-    auto vars               = builder->BnMeanVariance(x);
-    auto element_count_1d_0 = GetTensorFromScalar<float>(element_count, "element_count", param_shape);
-    auto element_count_1d_1 = GetTensorFromScalar<float>(element_count, "element_count", param_shape);
-    auto mean               = builder->Div(vars[0], element_count_1d_0);
-    auto mean_squre         = builder->Div(vars[1], element_count_1d_1);
-
-    auto variance = builder->Sub(mean_squre, builder->Mul(mean, builder->Identity(mean)));
+    return true;
 #else
+    return channel_dim == 1;
+#endif
+  }
+
+  std::vector<Variable> MeanAndVariance(Variable x) {
+    if (UseFusedReduce()) {
+      // To optimize the bn forward by merge the reduce computation of mean and variance,
+      // build a fusion op 'BnMeanVariance' by hand as the fusion pass is not support now.
+      // When the fusion pass is rebuild, this op is to be removed.
+      auto vars               = builder->BnMeanVariance(x);
+      auto element_count_1d_0 = GetTensorFromScalar<float>(element_count, "element_count", param_shape);
+      auto element_count_1d_1 = GetTensorFromScalar<float>(element_count, "element_count", param_shape);
+      auto mean               = builder->Div(vars[0], element_count_1d_0);
+      auto mean_squre         = builder->Div(vars[1], element_count_1d_1);
+
+      auto variance = builder->Sub(mean_squre, builder->Mul(mean, builder->Identity(mean)));
+      return {mean, variance};
+    }
     // mean = reduce_sum(x) / nhw, shape = [c]
     auto mean = Mean(x);
     // variance = reduce_sum(x * x) / nhw - mean * mean, shape = [c], simplified by equation: E(x^2) - [E(x)]^2
-    auto variance    = Variance(x, mean);
-#endif
+    auto variance = Variance(x, mean);
     return {mean, variance};
   }
 
   std::vector<Variable> GradBiasAndScale(Variable x, Variable x_mean, Variable y_grad) {
-#ifdef CINN_WITH_CUDA
-    // Using fusion op "BnGradBiasScale" as the same reason with "BnMeanVariance".
-    // It also will be removed.
-    return builder->BnGradBiasScale(x, x_mean, y_grad);
-#else
+    if (UseFusedReduce()) {
+      // Using fusion op "BnGradBiasScale" as the same reason with "BnMeanVariance".
+      // It also will be removed.
+      return builder->BnGradBiasScale(x, x_mean, y_grad);
+    }
     auto mean_4d     = builder->BroadcastTo(x_mean, x->shape, {channel_dim});
     auto x_mean_diff = builder->Sub(x, mean_4d);
     // bias_grad = reduce_sum(y_grad), shape = [c]
     auto bias_grad                     = Reduce(y_grad);
     auto sum_of_y_grad_mul_x_mean_diff = Reduce(builder->Mul(y_grad, x_mean_diff));
     return {bias_grad, sum_of_y_grad_mul_x_mean_diff};
-#endif
+  }
+
+  // relu_grad = out > 0 ? dout : 0
+  Variable ReluGrad(Variable dout, Variable out) {
+    auto zero_4d   = GetTensorFromScalar<float>(0.f, "zero", x_shape);
+    auto condition = builder->Compare(out, zero_4d, ComparisonKind::kGt);
+    return builder->Select(condition, dout, zero_4d);
   }
 
   // mean = reduce_sum(x) / nhw
@@ -201,12 +216,13 @@ void batch_norm_train(const Instruction& instr, const DecomposerContext& context
 }
 
 void batch_norm_grad(const Instruction& instr, const DecomposerContext& context) {
-  CHECK_EQ(instr->inputs.size(), 5UL) << " The number of the given inputs is not equal to the required "
-                                      << instr->op_type;
+  // the 6th input is the output of the relu after batch norm, then the 1st input is the grad of the relu's output
+  CHECK(instr->inputs.size() == 5UL || instr->inputs.size() == 6UL)
+      << " The number of the given inputs is not equal to the required " << instr->op_type;
   CHECK_EQ(instr->outputs.size(), 3UL) << " The number of the given outputs is not equal to the required"
                                        << instr->op_type;
 
-  auto& y_grad        = instr->inputs[0];
+  auto y_grad         = instr->inputs[0];
   auto& x             = instr->inputs[1];
   auto& scale         = instr->inputs[2];
   auto& save_mean     = instr->inputs[3];
@@ -218,7 +234,17 @@ void batch_norm_grad(const Instruction& instr, const DecomposerContext& context)
   CinnBuilder* builder = context.builder();
   BatchNormHelper helper(builder, x->shape, scale->shape, layout, "batch_norm_grad");
 
-  auto vars                          = helper.GradBiasAndScale(x, save_mean, y_grad);
+  std::vector<Variable> vars;
+  if (instr->inputs.size() == 6UL) {
+    auto& relu_out = instr->inputs[5];
+    auto relu_grad = helper.ReluGrad(y_grad, relu_out);
+    // the fused reduce op computes the grad of relu by itself instead of reading relu_grad
+    vars   = helper.UseFusedReduce() ? builder->BnGradBiasScale(x, save_mean, y_grad, relu_out)
+                                     : helper.GradBiasAndScale(x, save_mean, relu_grad);
+    y_grad = relu_grad;
+  } else {
+    vars = helper.GradBiasAndScale(x, save_mean, y_grad);
+  }
   auto bias_grad                     = vars[0];
   auto sum_of_y_grad_mul_x_mean_diff = vars[1];
 
@@ -36,6 +36,9 @@ struct Interpreter::Impl {
              const Target& target,
              const std::string& model_name = "");
 
+  //! Get the tensor called \p name in \p scope, \p name can be the name in the Paddle model as well.
+  hlir::framework::Tensor GetTensor(const hlir::framework::Scope& scope, const std::string& name) const;
+
  private:
   friend class Interpreter;
 
@@ -75,14 +78,35 @@ void Interpreter::LoadPaddleModel(const std::string& model_dir,
 void Interpreter::Run() { impl_->runtime_program_->Execute(); }
 
 hlir::framework::Tensor Interpreter::GetTensor(const std::string& name) {
-  if (impl_->scope_->FindVar(name)) return impl_->scope_->GetTensor(name);
+  return impl_->GetTensor(*impl_->scope_, name);
+}
+
+hlir::framework::Tensor Interpreter::Impl::GetTensor(const hlir::framework::Scope& scope,
+                                                     const std::string& name) const {
+  if (scope.FindVar(name)) return scope.GetTensor(name);
 
-  auto it = impl_->var_map_paddle_to_cinn_.find(name);
-  if (it == impl_->var_map_paddle_to_cinn_.end()) {
+  auto it = var_map_paddle_to_cinn_.find(name);
+  if (it == var_map_paddle_to_cinn_.end()) {
     LOG(FATAL) << "No variable called [" << name
-               << "] found in executor\nThe existing vars: " << utils::Join(impl_->scope_->var_names(), ", ");
+               << "] found in executor\nThe existing vars: " << utils::Join(scope.var_names(), ", ");
+  }
+  return scope.GetTensor(it->second);
+}
+
+std::unique_ptr<Interpreter::ExecutionContext> Interpreter::CreateExecutionContext() const {
+  CHECK(impl_->runtime_program_) << "The model should be loaded before creating execution contexts";
+  std::vector<std::string> feed_names;
+  for (auto& name : impl_->input_names_) {
+    feed_names.push_back(impl_->var_map_.at(name)->id);
   }
-  return impl_->scope_->GetTensor(it->second);
+  auto scope = impl_->runtime_program_->CreateExecutionScope(feed_names);
+  return std::unique_ptr<ExecutionContext>(new ExecutionContext(impl_, std::move(scope)));
+}
+
+void Interpreter::ExecutionContext::Run() { impl_->runtime_program_->ExecuteInScope(*scope_); }
+
+hlir::framework::Tensor Interpreter::ExecutionContext::GetTensor(const std::string& name) {
+  return impl_->GetTensor(*scope_, name);
 }
 
 void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
@@ -105,12 +129,20 @@ void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
 
   VLOG(3) << "Program:\n" << *program_;
 
-  auto graph                 = std::make_shared<hlir::framework::Graph>(*program_, target);
-  graph->attrs["model_name"] = std::make_shared<absl::any>(model_name);
+  std::unordered_set<std::string> fetch_var_ids;
+  for (auto& name : fetch_names_) {
+    CHECK(var_map_.count(name)) << "var_map finds no fetch var " << name;
+    fetch_var_ids.insert(var_map_.at(name)->id);
+  }
+
+  auto graph                    = std::make_shared<hlir::framework::Graph>(*program_, target);
+  graph->attrs["model_name"]    = std::make_shared<absl::any>(model_name);
+  graph->attrs["fetch_var_ids"] = std::make_shared<absl::any>(fetch_var_ids);
 
   hlir::framework::ApplyPass(graph.get(), "InferShape");
 #ifndef CINN_WITH_CUDA
   if (target.arch == Target::Arch::X86) {
+    hlir::framework::ApplyPass(graph.get(), "DepthwisePointwiseFusion");
     hlir::framework::ApplyPass(graph.get(), "AlterLayout");
   }
 #endif
@@ -119,12 +151,6 @@ void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
   // Target target = common::DefaultHostTarget();
   scope_ = hlir::framework::BuildScope(target, graph, scope_);
 
-  std::unordered_set<std::string> fetch_var_ids;
-  for (auto& name : fetch_names_) {
-    CHECK(var_map_.count(name)) << "var_map finds no fetch var " << name;
-    fetch_var_ids.insert(var_map_.at(name)->id);
-  }
-
   graph_compiler_.reset(new hlir::framework::GraphCompiler(target, scope_, graph));
   hlir::framework::GraphCompiler::CompileOptions options;
   options.with_instantiate_variables = true;
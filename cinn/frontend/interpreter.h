@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cinn/frontend/syntax.h"
@@ -32,6 +33,8 @@ namespace frontend {
  */
 class Interpreter final {
  public:
+  class ExecutionContext;
+
   Interpreter(const std::vector<std::string>& input_names, const std::vector<hlir::framework::shape_t>& input_shapes);
 
   /**
@@ -53,11 +56,40 @@ class Interpreter final {
 
   std::shared_ptr<hlir::framework::Scope> scope();
 
+  /**
+   * Create a context to run the loaded model in. The contexts share the compiled code and the weights with the
+   * interpreter, and own only the memory of the inputs and the intermediate variables, so a thread serving requests
+   * can create its own one cheaply. The contexts can run at the same time, each one by a single thread at a time.
+   */
+  std::unique_ptr<ExecutionContext> CreateExecutionContext() const;
+
   ~Interpreter();
 
  private:
   class Impl;
-  std::unique_ptr<Impl> impl_;
+  // shared with the execution contexts, which may outlive the interpreter
+  std::shared_ptr<Impl> impl_;
+};
+
+/**
+ * The per-thread state to run a model loaded by an Interpreter.
+ */
+class Interpreter::ExecutionContext final {
+ public:
+  /**
+   * Run the model with the inputs set in this context.
+   */
+  void Run();
+
+  hlir::framework::Tensor GetTensor(const std::string& name);
+
+ private:
+  friend class Interpreter;
+  ExecutionContext(std::shared_ptr<const Impl> impl, std::shared_ptr<hlir::framework::Scope> scope)
+      : impl_(std::move(impl)), scope_(std::move(scope)) {}
+
+  std::shared_ptr<const Impl> impl_;
+  std::shared_ptr<hlir::framework::Scope> scope_;
 };
 
 }  // namespace frontend
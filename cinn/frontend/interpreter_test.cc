@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 #include "cinn/runtime/use_extern_funcs.h"
 
 DEFINE_string(model_dir, "", "");
@@ -31,4 +35,45 @@ TEST(Interpreter, basic) {
   executor.GetTensor("fc_0.tmp_2");
 }
 
+TEST(Interpreter, execution_context) {
+  auto target = common::DefaultHostTarget();
+  Interpreter executor({"A"}, {{1, 30}});
+  executor.LoadPaddleModel(FLAGS_model_dir, target);
+
+  auto fill = [&](hlir::framework::Tensor tensor, float value) {
+    auto* data = tensor->mutable_data<float>(target);
+    std::fill(data, data + tensor->shape().numel(), value);
+  };
+  auto get = [](hlir::framework::Tensor tensor) {
+    return std::vector<float>(tensor->data<float>(), tensor->data<float>() + tensor->shape().numel());
+  };
+
+  const int num_threads = 4;
+  std::vector<std::vector<float>> expected(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    fill(executor.GetTensor("A"), i + 1.f);
+    executor.Run();
+    expected[i] = get(executor.GetTensor("fc_0.tmp_2"));
+  }
+
+  std::vector<std::vector<float>> results(num_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i] {
+      auto context = executor.CreateExecutionContext();
+      fill(context->GetTensor("A"), i + 1.f);
+      for (int k = 0; k < 10; k++) context->Run();
+      results[i] = get(context->GetTensor("fc_0.tmp_2"));
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (int i = 0; i < num_threads; i++) {
+    EXPECT_EQ(results[i], expected[i]);
+  }
+
+  // the inputs are owned by each context
+  auto context = executor.CreateExecutionContext();
+  EXPECT_NE(context->GetTensor("A")->data<float>(), executor.GetTensor("A")->data<float>());
+}
+
 }  // namespace cinn::frontend
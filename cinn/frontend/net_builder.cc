@@ -38,6 +38,16 @@ NETBUILDER_BINARY_OP_DEF(Div, divide)
 NETBUILDER_BINARY_OP_DEF(Matmul, matmul)
 NETBUILDER_BINARY_OP_DEF(ReluGrad, relu_grad)
 
+Variable NetBuilder::Matmul(const Variable& a, const Variable& b, bool trans_a, bool trans_b, float alpha) {
+  Instruction instr("matmul", {a, b});
+  instr.SetAttr("trans_a", trans_a);
+  instr.SetAttr("trans_b", trans_b);
+  instr.SetAttr("alpha", alpha);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 Variable NetBuilder::Mul(const Variable& a, const Variable& b, int x_num_col_dims, int y_num_col_dims) {
   Instruction instr("mul", {a, b});
   instr.SetAttr("x_num_col_dims", x_num_col_dims);
@@ -228,6 +238,16 @@ Variable NetBuilder::Softmax(const Variable& a, int axis, const std::string& dat
   return instr.GetOutput(0);
 }
 
+std::vector<Variable> NetBuilder::LayerNorm(
+    const Variable& a, const Variable& scale, const Variable& bias, float epsilon, int begin_norm_axis) {
+  Instruction instr("layer_norm", {a, scale, bias});
+  instr.SetAttr("epsilon", epsilon);
+  instr.SetAttr("begin_norm_axis", begin_norm_axis);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutputs();
+}
+
 Variable NetBuilder::DropoutInfer(const Variable& a, float dropout_prob, const std::string& dropout_implementation) {
   Instruction instr("dropout_infer", {a});
   instr.SetAttr("dropout_prob", dropout_prob);
@@ -267,5 +287,56 @@ std::vector<Variable> NetBuilder::Conv2dGrad(const Variable& dy,
   return instr.GetOutputs();
 }
 
+Variable NetBuilder::Quantize(const Variable& a, float scale, int zero_point) {
+  Instruction instr("quantize", {a});
+  instr.SetAttr("scale", scale);
+  instr.SetAttr("zero_point", zero_point);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::Dequantize(const Variable& a, float scale, int zero_point) {
+  Instruction instr("dequantize", {a});
+  instr.SetAttr("scale", scale);
+  instr.SetAttr("zero_point", zero_point);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::Requantize(const Variable& a, float in_scale, float out_scale, int zero_point) {
+  Instruction instr("requantize", {a});
+  instr.SetAttr("in_scale", in_scale);
+  instr.SetAttr("out_scale", out_scale);
+  instr.SetAttr("zero_point", zero_point);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::QuantizedMatmul(const Variable& a, const Variable& b, bool trans_a, bool trans_b) {
+  Instruction instr("quantized_matmul", {a, b});
+  instr.SetAttr("trans_a", trans_a);
+  instr.SetAttr("trans_b", trans_b);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::QuantizedConv2d(const Variable& a,
+                                     const Variable& b,
+                                     const std::vector<int>& strides,
+                                     const std::vector<int>& paddings,
+                                     const std::vector<int>& dilations) {
+  Instruction instr("quantized_conv2d", {a, b});
+  instr.SetAttr("stride", strides);
+  instr.SetAttr("padding", paddings);
+  instr.SetAttr("dilation", dilations);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 }  // namespace frontend
 }  // namespace cinn
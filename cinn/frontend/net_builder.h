@@ -50,6 +50,12 @@ class NetBuilder : public BaseBuilder {
   NETBUILDER_BINARY_OP_FOREACH(NETBUILDER_BINARY_OP_DECL)
 #undef NETBUILDER_BINARY_OP_DECL
 
+  /**
+   * (Batched) matrix multiplication over the last two dimensions, the operands are transposed first if \p trans_a or
+   * \p trans_b is true.
+   */
+  Variable Matmul(const Variable& a, const Variable& b, bool trans_a, bool trans_b, float alpha = 1.0f);
+
   /**
    * Multiply two matrix.
    */
@@ -154,6 +160,17 @@ class NetBuilder : public BaseBuilder {
 
   Variable Softmax(const Variable& a, int axis = -1, const std::string& data_format = "AnyLayout");
 
+  /**
+   * Layer normalization over the dimensions from begin_norm_axis to the last one.
+   * scale and bias are 1-D tensors whose size is the product of the normalized dimensions.
+   * outputs={y, mean, variance}
+   */
+  std::vector<Variable> LayerNorm(const Variable& a,
+                                  const Variable& scale,
+                                  const Variable& bias,
+                                  float epsilon       = 1e-5f,
+                                  int begin_norm_axis = 1);
+
   Variable DropoutInfer(const Variable& a,
                         float dropout_prob                        = 0.5f,
                         const std::string& dropout_implementation = "downgrade_in_infer");
@@ -171,6 +188,35 @@ class NetBuilder : public BaseBuilder {
                                    const std::string& data_format       = "NCHW",
                                    const std::string& padding_algorithm = "EXPLICIT");
 
+  /**
+   * Quantize a float32 variable to int8: out = clip(round(a / scale) + zero_point, -128, 127).
+   */
+  Variable Quantize(const Variable& a, float scale, int zero_point = 0);
+
+  /**
+   * Dequantize an int8 or int32 variable to float32: out = (a - zero_point) * scale.
+   */
+  Variable Dequantize(const Variable& a, float scale, int zero_point = 0);
+
+  /**
+   * Rescale an int32 accumulator with step in_scale to int8 with step out_scale.
+   */
+  Variable Requantize(const Variable& a, float in_scale, float out_scale, int zero_point = 0);
+
+  /**
+   * Multiply two int8 matrix and accumulate the result in int32.
+   */
+  Variable QuantizedMatmul(const Variable& a, const Variable& b, bool trans_a = false, bool trans_b = false);
+
+  /**
+   * The int8 convolution2D layer with NCHW input and int32 output, groups are not supported.
+   */
+  Variable QuantizedConv2d(const Variable& a,
+                           const Variable& b,
+                           const std::vector<int>& strides   = {1, 1},
+                           const std::vector<int>& paddings  = {0, 0},
+                           const std::vector<int>& dilations = {1, 1});
+
   template <typename T>
   Variable FillConstant(const std::vector<int>& shape, float value, const std::string& name, bool force_cpu = false) {
     Instruction instr("fill_constant");
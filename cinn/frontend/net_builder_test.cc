@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <random>
 #include <vector>
@@ -69,6 +70,17 @@ void SetRandData(hlir::framework::Tensor tensor, Target target) {
 #endif
 }
 
+std::vector<float> GetData(hlir::framework::Tensor tensor, Target target) {
+  size_t num_ele = tensor->shape().numel();
+  std::vector<float> data(num_ele);
+#ifdef CINN_WITH_CUDA
+  cudaMemcpy(data.data(), tensor->data<float>(), num_ele * sizeof(float), cudaMemcpyDeviceToHost);
+#else
+  std::copy(tensor->data<float>(), tensor->data<float>() + num_ele, data.begin());
+#endif
+  return data;
+}
+
 template <typename T, typename Alloc = std::allocator<T>>
 std::ostream& operator<<(std::ostream& os, const std::vector<T, Alloc>& vec) {
   os << "{ ";
@@ -189,5 +201,160 @@ TEST(net_build, program_execute_reverse) {
   runtime_program->Execute();
 }
 
+TEST(net_build, program_execute_softmax) {
+  const int M = 32;
+  const int N = 100;
+
+  NetBuilder builder("net_builder");
+  Placeholder input    = builder.CreateInput(Float(32), {M, N}, "In");
+  Variable softmax_out = builder.Softmax(input, 1);
+  auto program         = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto input_tensor = scope->GetTensor(std::string(input.id()));
+  auto* input_data  = input_tensor->mutable_data<float>(target);
+  // large inputs overflow exp without subtracting the row max
+  std::vector<float> host_input(M * N);
+  for (int i = 0; i < M * N; i++) {
+    host_input[i] = static_cast<float>(i % N) * 10.f;
+  }
+#ifdef CINN_WITH_CUDA
+  cudaMemcpy(input_data, host_input.data(), M * N * sizeof(float), cudaMemcpyHostToDevice);
+#else
+  std::copy(host_input.begin(), host_input.end(), input_data);
+#endif
+  runtime_program->Execute();
+
+  auto out_data = GetData(scope->GetTensor(std::string(softmax_out->id)), target);
+  for (int i = 0; i < M; i++) {
+    float row_max = host_input[i * N + N - 1];
+    float sum     = 0.f;
+    for (int j = 0; j < N; j++) {
+      sum += std::exp(host_input[i * N + j] - row_max);
+    }
+    for (int j = 0; j < N; j++) {
+      ASSERT_NEAR(out_data[i * N + j], std::exp(host_input[i * N + j] - row_max) / sum, 1e-5);
+    }
+  }
+}
+
+TEST(net_build, program_execute_layer_norm) {
+  const int B         = 4;
+  const int S         = 16;
+  const int H         = 64;
+  const float epsilon = 1e-5f;
+
+  NetBuilder builder("net_builder");
+  Placeholder input = builder.CreateInput(Float(32), {B, S, H}, "X");
+  Placeholder scale = builder.CreateInput(Float(32), {H}, "Scale");
+  Placeholder bias  = builder.CreateInput(Float(32), {H}, "Bias");
+  auto outs         = builder.LayerNorm(input, scale, bias, epsilon, 2);
+  ASSERT_EQ(outs.size(), 3UL);
+  auto program = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  SetRandData(scope->GetTensor(std::string(input.id())), target);
+  SetRandData(scope->GetTensor(std::string(scale.id())), target);
+  SetRandData(scope->GetTensor(std::string(bias.id())), target);
+  runtime_program->Execute();
+
+  auto x_data     = GetData(scope->GetTensor(std::string(input.id())), target);
+  auto scale_data = GetData(scope->GetTensor(std::string(scale.id())), target);
+  auto bias_data  = GetData(scope->GetTensor(std::string(bias.id())), target);
+  auto out_data   = GetData(scope->GetTensor(std::string(outs[0]->id)), target);
+  auto mean_data  = GetData(scope->GetTensor(std::string(outs[1]->id)), target);
+  for (int i = 0; i < B * S; i++) {
+    float mean = 0.f;
+    for (int j = 0; j < H; j++) {
+      mean += x_data[i * H + j];
+    }
+    mean /= H;
+    float variance = 0.f;
+    for (int j = 0; j < H; j++) {
+      variance += (x_data[i * H + j] - mean) * (x_data[i * H + j] - mean);
+    }
+    variance /= H;
+    ASSERT_NEAR(mean_data[i], mean, 1e-5);
+    for (int j = 0; j < H; j++) {
+      float expect = (x_data[i * H + j] - mean) / std::sqrt(variance + epsilon) * scale_data[j] + bias_data[j];
+      ASSERT_NEAR(out_data[i * H + j], expect, 1e-4);
+    }
+  }
+}
+
+void CheckReduceSum(const std::vector<int>& shape, const std::vector<int>& dim, bool keep_dim) {
+  NetBuilder builder("net_builder");
+  Placeholder input = builder.CreateInput(Float(32), shape, "X");
+  Variable out      = builder.ReduceSum(input, dim, keep_dim);
+  auto program      = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  SetRandData(scope->GetTensor(std::string(input.id())), target);
+  runtime_program->Execute();
+
+  auto x_data   = GetData(scope->GetTensor(std::string(input.id())), target);
+  auto out_data = GetData(scope->GetTensor(std::string(out->id)), target);
+  // compute the reference by accumulating each input element into its output element
+  std::vector<double> expect(out_data.size(), 0.);
+  std::vector<int> indice(shape.size(), 0);
+  for (float x : x_data) {
+    int offset = 0;
+    for (int idx = 0; idx < shape.size(); ++idx) {
+      if (std::find(dim.begin(), dim.end(), idx) == dim.end()) {
+        offset = offset * shape[idx] + indice[idx];
+      }
+    }
+    expect[offset] += x;
+    for (int idx = shape.size() - 1; idx >= 0 && ++indice[idx] == shape[idx]; --idx) {
+      indice[idx] = 0;
+    }
+  }
+  for (int idx = 0; idx < out_data.size(); ++idx) {
+    ASSERT_NEAR(out_data[idx], expect[idx], 1e-3 * std::max(1., std::abs(expect[idx])));
+  }
+}
+
+TEST(net_build, program_execute_reduce_sum) {
+  // the inner axes are reduced
+  CheckReduceSum({32, 16, 64}, {1, 2}, false);
+  CheckReduceSum({32, 16, 64}, {2}, true);
+  // the outer axes are reduced
+  CheckReduceSum({64, 32, 24}, {0, 1}, false);
+  CheckReduceSum({64, 32, 24}, {0}, true);
+  // too few outputs, reduced by several threads
+  CheckReduceSum({128, 256}, {0, 1}, false);
+  CheckReduceSum({8, 64, 64, 8}, {0, 2, 3}, false);
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -0,0 +1,69 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/op_mapper_registry.h"
+#include "cinn/frontend/op_mappers/common_utils.h"
+
+namespace cinn {
+namespace frontend {
+namespace op_mappers {
+
+void LayerNormOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x = ctx.GetVar(op_desc.Input("X").front());
+
+  auto epsilon         = utils::GetAttrOrDefault<float>(op_desc, "epsilon", 1e-5f);
+  auto begin_norm_axis = utils::GetAttrOrDefault<int>(op_desc, "begin_norm_axis", 1);
+
+  int rank = x->shape.size();
+  if (begin_norm_axis < 0) {
+    begin_norm_axis += rank;
+  }
+  CHECK(begin_norm_axis >= 0 && begin_norm_axis < rank) << "The begin_norm_axis of layer_norm is out of range.";
+  int norm_size = 1;
+  for (int i = begin_norm_axis; i < rank; i++) {
+    norm_size *= x->shape[i];
+  }
+  // Scale and Bias are optional in Paddle, the missing ones are the identity transform
+  auto get_affine_var = [&](const std::string& input_name, float default_value) {
+    if (op_desc.Input(input_name).empty()) {
+      return ctx.Builder()->FillConstant<float>(
+          {norm_size}, default_value, common::UniqName("layer_norm_" + input_name));
+    }
+    CHECK_EQ(op_desc.Input(input_name).size(), 1UL);
+    return ctx.GetVar(op_desc.Input(input_name).front());
+  };
+  auto scale = get_affine_var("Scale", 1.0f);
+  auto bias  = get_affine_var("Bias", 0.0f);
+
+  auto outs = ctx.Builder()->LayerNorm(x, scale, bias, epsilon, begin_norm_axis);
+  std::vector<std::string> output_names = {"Y", "Mean", "Variance"};
+  CHECK_EQ(outs.size(), output_names.size()) << "layer_norm API's should return " << output_names.size()
+                                             << " Variables!";
+  for (int i = 0; i < outs.size(); i++) {
+    CHECK_EQ(op_desc.Output(output_names[i]).size(), 1UL);
+    auto out_name = op_desc.Output(output_names[i]).front();
+    ctx.AddVar(out_name, outs[i]);
+    ctx.AddVarModelToProgram(out_name, outs[i]->id);
+  }
+}
+
+}  // namespace op_mappers
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(layer_norm) {
+  CINN_REGISTER_OP_MAPPER(layer_norm, cinn::frontend::op_mappers::LayerNormOpMapper)
+  return true;
+}
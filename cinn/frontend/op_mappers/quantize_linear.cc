@@ -0,0 +1,134 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef CINN_WITH_CUDA
+#include "cinn/backends/cuda_util.h"
+#endif
+#include "cinn/frontend/op_mapper_registry.h"
+#include "cinn/frontend/op_mappers/common_utils.h"
+
+namespace cinn {
+namespace frontend {
+namespace op_mappers {
+
+// Paddle quantized models carry their (already calibrated) abs-max scale as a persistable
+// tensor, so the value is read from the scope when building the program instead of being
+// computed at runtime.
+float GetQuantScale(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("Scale").size(), 1UL);
+  auto scale_name = cinn::utils::TransValidVarName(op_desc.Input("Scale").front());
+  auto* var       = ctx.Scope().FindVar(scale_name);
+  CHECK(var) << "The scale [" << scale_name << "] of op [" << op_desc.Type()
+             << "] should be a persistable variable of the model";
+  auto& tensor = absl::get<hlir::framework::Tensor>(*var);
+  CHECK_EQ(tensor->shape().numel(), 1U) << "Op [" << op_desc.Type()
+                                        << "] with channel-wise scales is not implemented yet!";
+  float scale = 0.f;
+  if (ctx.Target().arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaMemcpy(&scale, tensor->data<float>(), sizeof(float), cudaMemcpyDeviceToHost));
+#else
+    LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+#endif
+  } else {
+    scale = *tensor->data<float>();
+  }
+
+  // Paddle maps [-scale, scale] to [-bnt, bnt], CINN's scale is the real value of one integer unit.
+  auto bit_length = utils::GetAttrOrDefault<int>(op_desc, "bit_length", 8);
+  CHECK_EQ(bit_length, 8) << "Only int8 quantization is supported in op [" << op_desc.Type() << "]";
+  float bnt = static_cast<float>((1 << (bit_length - 1)) - 1);
+  return scale / bnt;
+}
+
+// Paddle saves the quantized weights as integral values in a float tensor. Convert the persistable tensor in the scope
+// to int8 in place once when building the program, instead of casting it with a quantize op at every run. The weights
+// of a quantized model are only read by dequantize_linear, so no op reads the float values later.
+void ConvertWeightToInt8(const std::string& name, const OpMapperContext& ctx) {
+  auto* var = ctx.Scope().FindVar(cinn::utils::TransValidVarName(name));
+  if (!var) return;
+  auto& tensor = absl::get<hlir::framework::Tensor>(*var);
+  if (!tensor->type().is_float(32)) return;
+
+  size_t numel = tensor->shape().numel();
+  std::vector<float> data(numel);
+  if (ctx.Target().arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaMemcpy(data.data(), tensor->data<float>(), numel * sizeof(float), cudaMemcpyDeviceToHost));
+#else
+    LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+#endif
+  } else {
+    std::copy(tensor->data<float>(), tensor->data<float>() + numel, data.begin());
+  }
+  std::vector<int8_t> int8_data(numel);
+  for (size_t i = 0; i < numel; i++) {
+    int8_data[i] = static_cast<int8_t>(std::max(-128.f, std::min(127.f, std::round(data[i]))));
+  }
+  // the int8 values fit in the memory of the float tensor, which is reused
+  auto* int8_memory = tensor->mutable_data(ctx.Target(), Int(8));
+  if (ctx.Target().arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaMemcpy(int8_memory, int8_data.data(), numel, cudaMemcpyHostToDevice));
+#endif
+  } else {
+    std::copy(int8_data.begin(), int8_data.end(), reinterpret_cast<int8_t*>(int8_memory));
+  }
+  VLOG(4) << "Convert the quantized weight [" << name << "] to int8";
+}
+
+void QuantizeLinearOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x_name = op_desc.Input("X").front();
+  auto x      = ctx.GetVar(x_name);
+  auto scale  = GetQuantScale(op_desc, ctx);
+
+  auto out = ctx.Builder()->Quantize(x, scale);
+  CHECK_EQ(op_desc.Output("Y").size(), 1UL);
+  auto out_name = op_desc.Output("Y").front();
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+void DequantizeLinearOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x_name = op_desc.Input("X").front();
+  ConvertWeightToInt8(x_name, ctx);
+  auto x     = ctx.GetVar(x_name);
+  auto scale = GetQuantScale(op_desc, ctx);
+
+  // the dequantize op always consumes integer data, a float input which is not a weight is cast at runtime
+  if (x->type.is_float(32)) {
+    x = ctx.Builder()->Quantize(x, 1.0f);
+  }
+  auto out = ctx.Builder()->Dequantize(x, scale);
+  CHECK_EQ(op_desc.Output("Y").size(), 1UL);
+  auto out_name = op_desc.Output("Y").front();
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+}  // namespace op_mappers
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(quantize_linear) {
+  CINN_REGISTER_OP_MAPPER(quantize_linear, cinn::frontend::op_mappers::QuantizeLinearOpMapper)
+  CINN_REGISTER_OP_MAPPER(dequantize_linear, cinn::frontend::op_mappers::DequantizeLinearOpMapper)
+  return true;
+}
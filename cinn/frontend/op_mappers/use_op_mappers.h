@@ -22,6 +22,7 @@ CINN_USE_REGISTER(mul)
 CINN_USE_REGISTER(slice)
 CINN_USE_REGISTER(relu)
 CINN_USE_REGISTER(softmax)
+CINN_USE_REGISTER(layer_norm)
 CINN_USE_REGISTER(scale)
 CINN_USE_REGISTER(batchnorm)
 CINN_USE_REGISTER(dropout)
@@ -30,3 +31,4 @@ CINN_USE_REGISTER(pool2d)
 CINN_USE_REGISTER(conv2d)
 CINN_USE_REGISTER(transpose)
 CINN_USE_REGISTER(reshape)
+CINN_USE_REGISTER(quantize_linear)
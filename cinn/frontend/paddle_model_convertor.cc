@@ -23,6 +23,8 @@
 #include "cinn/frontend/op_mappers/use_op_mappers.h"
 #include "cinn/frontend/paddle/cpp/program_desc.h"
 #include "cinn/frontend/paddle/model_parser.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
 #include "cinn/frontend/var_type_utils.h"
 #include "cinn/hlir/op/use_ops.h"
 
@@ -91,7 +93,20 @@ Program PaddleModelConvertor::operator()(const std::string& model_dir, bool is_c
     auto* op_desc = block_desc->GetOp<paddle::cpp::OpDesc>(i);
     RunOp(*op_desc, ctx);
   }
-  return builder.Build();
+  auto program = builder.Build();
+  // run the int8 kernels directly on the quantized weights and activations of the model, mul reads its weight through
+  // a reshape instead of a transpose with cuDNN
+#ifdef CINN_WITH_CUDNN
+  bool cudnn_mul = target_.arch == common::Target::Arch::NVGPU;
+#else
+  bool cudnn_mul = false;
+#endif
+  ApplyPass(&program, GetFetchIds(), cudnn_mul ? "FoldQuantizeCudnnMul" : "FoldQuantize");
+  // remove the duplicated and the identity instructions left by the op mappers
+  ApplyPass(&program, GetFetchIds(), "SimplifyProgram");
+  // read the transposed operands of matmul in place instead of copying them
+  ApplyPass(&program, GetFetchIds(), "TransposeFolding");
+  return program;
 }
 
 }  // namespace frontend
@@ -0,0 +1,88 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/program_pass.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+/*
+ * In the backward of conv + batch_norm + relu, relu_grad reads the grad of the relu's output and writes the grad of
+ * batch norm's output, which is read again by the reductions of batch_norm_grad. `BatchNormReluGradFusion` removes
+ * the relu_grad whose output is used only by a batch_norm_grad, and passes the relu's output to batch_norm_grad as
+ * its 6th input instead. Then the decomposer of batch_norm_grad computes the grad of relu in the same pass as the
+ * reductions. It should be applied before the Decomposer.
+ */
+void BatchNormReluGradFusion(Program* program, const std::unordered_set<std::string>& fetch_ids) {
+  std::unordered_map<std::string, int> uses;
+  std::unordered_map<std::string, int> producers;
+  for (int i = 0; i < program->size(); i++) {
+    const auto& instr = (*program)[i];
+    for (const auto& in : instr->inputs) {
+      uses[in->id]++;
+    }
+    for (const auto& out : instr->outputs) {
+      producers[out->id] = i;
+    }
+  }
+
+  std::unordered_set<int> remove_idxs;
+  for (int i = 0; i < program->size(); i++) {
+    auto& instr = (*program)[i];
+    if (instr->op_type != "batch_norm_grad" || instr->inputs.size() != 5U) continue;
+    const auto& y_grad = instr->inputs[0];
+    auto it            = producers.find(y_grad->id);
+    if (it == producers.end() || (*program)[it->second]->op_type != "relu_grad") continue;
+    if (uses.at(y_grad->id) != 1 || fetch_ids.count(y_grad->id)) continue;
+
+    const auto& relu_grad = (*program)[it->second];
+    VLOG(2) << "Fuse " << relu_grad << " into " << instr;
+    // relu_grad(dout, out)
+    auto inputs = instr->inputs;
+    inputs[0]   = relu_grad->inputs[0];
+    inputs.push_back(relu_grad->inputs[1]);
+    instr.SetInputs(inputs);
+    remove_idxs.insert(it->second);
+  }
+  VLOG(2) << "Total fuse " << remove_idxs.size() << " relu_grad into batch_norm_grad.";
+  if (remove_idxs.empty()) return;
+
+  CinnBuilder builder("batch_norm_relu_grad_fusion_builder");
+  for (auto& var : program->GetInputs()) {
+    builder.CreateInput(var);
+  }
+  for (int i = 0; i < program->size(); i++) {
+    if (remove_idxs.count(i)) continue;
+    builder.AppendInstruction((*program)[i]);
+  }
+  *program = builder.Build();
+}
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(BatchNormReluGradFusion) {
+  CINN_REGISTER_PROGRAM_PASS_FUNCTION(BatchNormReluGradFusion)
+      .set_body(cinn::frontend::pass::BatchNormReluGradFusion);
+
+  return true;
+}
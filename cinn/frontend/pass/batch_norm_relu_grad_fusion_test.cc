@@ -0,0 +1,134 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "cinn/frontend/decomposer/use_decomposer.h"
+#include "cinn/frontend/decomposer_registry.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn::frontend {
+
+namespace {
+
+constexpr int N = 2, C = 16, H = 8, W = 8;
+
+// y_grad = relu_grad(dout, relu_out), x_grad, scale_grad, bias_grad = batch_norm_grad(y_grad, x, ...)
+std::pair<Program, std::vector<std::string>> CreateProgram(const std::string& data_layout = "NCHW") {
+  std::vector<int> x_shape = data_layout == "NCHW" ? std::vector<int>{N, C, H, W} : std::vector<int>{N, H, W, C};
+  NetBuilder builder("net_builder");
+  auto dout          = builder.CreateInput(Float(32), x_shape, "DOut");
+  auto relu_out      = builder.CreateInput(Float(32), x_shape, "ReluOut");
+  auto x             = builder.CreateInput(Float(32), x_shape, "X");
+  auto scale         = builder.CreateInput(Float(32), {C}, "Scale");
+  auto save_mean     = builder.CreateInput(Float(32), {C}, "SaveMean");
+  auto save_variance = builder.CreateInput(Float(32), {C}, "SaveVariance");
+  auto y_grad        = builder.ReluGrad(dout, relu_out);
+  auto grads         = builder.BatchNormGrad(y_grad, x, scale, save_mean, save_variance, 1e-5f, data_layout);
+  return {builder.Build(), {grads[0]->id, grads[1]->id, grads[2]->id}};
+}
+
+// The index in NHWC of the element at `index` in NCHW.
+int NHWCIndex(int index) {
+  int w = index % W, h = index / W % H, c = index / (W * H) % C, n = index / (W * H * C);
+  return ((n * H + h) * W + w) * C + c;
+}
+
+// Run the program on the same random inputs for either layout, the results are in NCHW.
+std::vector<std::vector<float>> RunProgram(Program* program,
+                                           const std::vector<std::string>& fetch_ids,
+                                           bool fuse,
+                                           const std::string& data_layout = "NCHW") {
+  Target target = common::DefaultHostTarget();
+  if (fuse) {
+    ApplyPass(program, {fetch_ids.begin(), fetch_ids.end()}, "BatchNormReluGradFusion");
+  }
+  ProgramPass::Apply(program, target, {"Decomposer"});
+  auto graph = std::make_shared<hlir::framework::Graph>(*program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  bool nhwc = data_layout == "NHWC";
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (auto& name : {"DOut", "ReluOut", "X", "Scale", "SaveMean", "SaveVariance"}) {
+    auto tensor = scope->GetTensor(name);
+    auto* data  = tensor->mutable_data<float>(target);
+    bool is_x   = tensor->shape().numel() == N * C * H * W;
+    for (int i = 0; i < tensor->shape().numel(); i++) {
+      data[nhwc && is_x ? NHWCIndex(i) : i] = std::string(name) == "SaveVariance" ? dist(engine) + 2.f : dist(engine);
+    }
+  }
+  runtime_program->Execute();
+
+  std::vector<std::vector<float>> results;
+  for (auto& id : fetch_ids) {
+    auto tensor = scope->GetTensor(id);
+    bool is_x   = tensor->shape().numel() == N * C * H * W;
+    std::vector<float> result(tensor->shape().numel());
+    for (size_t i = 0; i < result.size(); i++) {
+      result[i] = tensor->data<float>()[nhwc && is_x ? NHWCIndex(i) : i];
+    }
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
+}  // namespace
+
+TEST(BatchNormReluGradFusion, fuse) {
+  auto program = CreateProgram().first;
+  ApplyPass(&program, {}, "BatchNormReluGradFusion");
+  ASSERT_EQ(program.size(), 1UL);
+  ASSERT_EQ(program[0]->op_type, "batch_norm_grad");
+  ASSERT_EQ(program[0]->inputs.size(), 6UL);
+  ASSERT_EQ(program[0]->inputs[0]->id, "DOut");
+  ASSERT_EQ(program[0]->inputs[5]->id, "ReluOut");
+}
+
+TEST(BatchNormReluGradFusion, keep_fetched) {
+  auto program = CreateProgram().first;
+  ApplyPass(&program, {program[0]->outputs[0]->id}, "BatchNormReluGradFusion");
+  ASSERT_EQ(program.size(), 2UL);
+  ASSERT_EQ(program[1]->inputs.size(), 5UL);
+}
+
+TEST(BatchNormReluGradFusion, same_results) {
+  // the decomposer uses the fused bn_grad_bias_scale for NCHW on x86, but the plain reductions for NHWC
+  auto reference = CreateProgram("NHWC");
+  auto fused     = CreateProgram();
+  auto expected  = RunProgram(&reference.first, reference.second, false, "NHWC");
+  auto results   = RunProgram(&fused.first, fused.second, true);
+  ASSERT_EQ(results.size(), expected.size());
+  for (size_t i = 0; i < results.size(); i++) {
+    ASSERT_EQ(results[i].size(), expected[i].size());
+    for (size_t j = 0; j < results[i].size(); j++) {
+      ASSERT_NEAR(results[i][j], expected[i][j], 1e-4);
+    }
+  }
+}
+
+}  // namespace cinn::frontend
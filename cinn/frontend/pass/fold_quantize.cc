@@ -0,0 +1,212 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+namespace {
+
+template <typename T>
+T GetAttrOrDefault(const Instruction& instr, const std::string& key, const T& default_value) {
+  auto it = instr->attrs.find(key);
+  return it == instr->attrs.end() ? default_value : absl::get<T>(it->second);
+}
+
+// Return the dequantize instruction which produces `var`, or nullptr when `var` is not a
+// zero-point free dequantize output.
+const Instruction* FindDequantize(const std::unordered_map<std::string, const Instruction*>& producers,
+                                  const Variable& var) {
+  auto it = producers.find(var->id);
+  if (it == producers.end()) return nullptr;
+  const auto& instr = *it->second;
+  if (instr->op_type != "dequantize" || !instr->inputs[0]->type.is_int(8)) return nullptr;
+  if (GetAttrOrDefault<int>(instr, "zero_point", 0) != 0) return nullptr;
+  return it->second;
+}
+
+// mul reads the weight of a Paddle model through a transpose, or through a reshape swapping the two dimensions with
+// cuDNN (see op_mappers/mul.cc), so that `mul(x, view)` computes `x * w` where `w` is the weight before the view.
+// Return the dequantize which produces `w`, or nullptr when `var` is not such a view. The reshape is only such a view
+// for the cuDNN mul, so it is looked through only if `cudnn_mul` is true.
+const Instruction* FindMulWeightDequantize(const std::unordered_map<std::string, const Instruction*>& producers,
+                                           const Variable& var,
+                                           bool cudnn_mul) {
+  auto it = producers.find(var->id);
+  if (it == producers.end()) return nullptr;
+  const auto& instr = *it->second;
+  if (instr->inputs.size() != 1U) return nullptr;
+  const auto& in = instr->inputs[0];
+  if (in->shape.size() != 2U || var->shape != std::vector<int>({in->shape[1], in->shape[0]})) return nullptr;
+  if (instr->op_type == "transpose") {
+    if (GetAttrOrDefault<std::vector<int>>(instr, "axis", {}) != std::vector<int>({1, 0})) return nullptr;
+  } else if (instr->op_type != "reshape" || !cudnn_mul) {
+    return nullptr;
+  }
+  return FindDequantize(producers, in);
+}
+
+// Try to rewrite `instr` into an int8 kernel followed by one dequantize op. Returns false
+// if the pattern does not match and `instr` should be kept as it is. The ids of the weight views of mul looked
+// through are added to `folded_views`.
+bool TryFoldQuantize(const Instruction& instr,
+                     const std::unordered_map<std::string, const Instruction*>& producers,
+                     bool cudnn_mul,
+                     NetBuilder* builder,
+                     std::unordered_set<std::string>* folded_views) {
+  // only the first output carries the result, mul's second output is a temporary buffer
+  if (instr->inputs.size() != 2U || instr->outputs.empty()) return false;
+  const auto* dequant_a = FindDequantize(producers, instr->inputs[0]);
+  const auto* dequant_b = FindDequantize(producers, instr->inputs[1]);
+  // mul(x, view(w)) computes x * w, while mul(x, w) computes x * w^T
+  bool through_view = false;
+  if (instr->op_type == "mul" && !dequant_b) {
+    dequant_b    = FindMulWeightDequantize(producers, instr->inputs[1], cudnn_mul);
+    through_view = dequant_b != nullptr;
+  }
+  if (!dequant_a || !dequant_b) return false;
+
+  const auto& qa = (*dequant_a)->inputs[0];
+  const auto& qb = (*dequant_b)->inputs[0];
+  // the product of two int8 values with steps scale_a and scale_b has step scale_a * scale_b
+  float scale = GetAttrOrDefault<float>(*dequant_a, "scale", 1.f) * GetAttrOrDefault<float>(*dequant_b, "scale", 1.f);
+
+  Variable acc;
+  if (instr->op_type == "matmul") {
+    if (qa->shape.size() != qb->shape.size() || (qa->shape.size() != 2U && qa->shape.size() != 3U)) return false;
+    scale *= GetAttrOrDefault<float>(instr, "alpha", 1.f);
+    acc = builder->QuantizedMatmul(qa,
+                                   qb,
+                                   GetAttrOrDefault<bool>(instr, "trans_a", false),
+                                   GetAttrOrDefault<bool>(instr, "trans_b", false));
+  } else if (instr->op_type == "mul") {
+    if (qa->shape.size() != 2U || qb->shape.size() != 2U) return false;
+    if (GetAttrOrDefault<int>(instr, "x_num_col_dims", 1) != 1 ||
+        GetAttrOrDefault<int>(instr, "y_num_col_dims", 1) != 1)
+      return false;
+    acc = builder->QuantizedMatmul(qa, qb, false, !through_view);
+    if (through_view) {
+      folded_views->insert(instr->inputs[1]->id);
+    }
+  } else if (instr->op_type == "conv2d") {
+    if (GetAttrOrDefault<int>(instr, "groups", 1) != 1 ||
+        GetAttrOrDefault<std::string>(instr, "data_format", "NCHW") != "NCHW" ||
+        GetAttrOrDefault<std::string>(instr, "padding_algorithm", "EXPLICIT") != "EXPLICIT")
+      return false;
+    acc = builder->QuantizedConv2d(qa,
+                                   qb,
+                                   GetAttrOrDefault<std::vector<int>>(instr, "stride", {1, 1}),
+                                   GetAttrOrDefault<std::vector<int>>(instr, "padding", {0, 0}),
+                                   GetAttrOrDefault<std::vector<int>>(instr, "dilation", {1, 1}));
+  } else {
+    return false;
+  }
+  auto out = builder->Dequantize(acc, scale);
+  // keep the original output name so that the following instructions and fetch_ids still work
+  out.set_id(instr->outputs[0]->id);
+  VLOG(2) << "Fold instruction into int8 kernel: " << instr;
+  return true;
+}
+
+void FoldQuantizeImpl(Program* program, const std::unordered_set<std::string>& fetch_ids, bool cudnn_mul) {
+  std::unordered_map<std::string, const Instruction*> producers;
+  for (int i = 0; i < program->size(); i++) {
+    const auto& instr = (*program)[i];
+    for (const auto& out : instr->outputs) {
+      producers[out->id] = &instr;
+    }
+  }
+
+  NetBuilder builder("fold_quantize_builder");
+  for (auto& var : program->GetInputs()) {
+    builder.CreateInput(var);
+  }
+  int fold_num = 0;
+  std::unordered_set<std::string> folded_views;
+  for (int i = 0; i < program->size(); i++) {
+    const auto& instr = (*program)[i];
+    if (TryFoldQuantize(instr, producers, cudnn_mul, &builder, &folded_views)) {
+      fold_num++;
+    } else {
+      builder.AppendInstruction(instr);
+    }
+  }
+  VLOG(2) << "Total fold " << fold_num << " instructions into int8 kernels.";
+  if (fold_num == 0) return;
+  auto folded = builder.Build();
+
+  CinnBuilder cleaner("fold_quantize_cleaner");
+  for (auto& var : folded.GetInputs()) {
+    cleaner.CreateInput(var);
+  }
+  absl::flat_hash_set<std::string> inputs;
+  absl::flat_hash_set<int> remove_idxs;
+  for (int i = folded.size() - 1; i >= 0; --i) {
+    const auto& instr = folded[i];
+    const auto& out_id = instr->outputs[0]->id;
+    bool removable     = instr->op_type == "dequantize" || folded_views.count(out_id);
+    if (removable && !inputs.count(out_id) && !fetch_ids.count(out_id)) {
+      remove_idxs.insert(i);
+      continue;
+    }
+    for (const auto& in : instr->inputs) {
+      inputs.insert(in->id);
+    }
+  }
+  for (int i = 0; i < folded.size(); i++) {
+    if (remove_idxs.count(i)) continue;
+    cleaner.AppendInstruction(folded[i]);
+  }
+  *program = cleaner.Build();
+}
+
+}  // namespace
+
+/*
+ * A quantized model computes `op(dequantize(qa), dequantize(qb))` in float. For matmul, mul
+ * and conv2d the dequantize can be moved behind the op because they are bilinear, so
+ * `FoldQuantize` replaces the pattern with an int8 kernel accumulating in int32 followed by
+ * a single dequantize. The weight of mul may be read through a transpose.
+ * Dequantize instructions and weight views which are no longer used are removed.
+ */
+void FoldQuantize(Program* program, const std::unordered_set<std::string>& fetch_ids) {
+  FoldQuantizeImpl(program, fetch_ids, false);
+}
+
+/*
+ * The same as `FoldQuantize` for the programs running on NVGPU with cuDNN, where the weight of mul
+ * may also be read through a reshape swapping its two dimensions.
+ */
+void FoldQuantizeCudnnMul(Program* program, const std::unordered_set<std::string>& fetch_ids) {
+  FoldQuantizeImpl(program, fetch_ids, true);
+}
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(FoldQuantize) {
+  CINN_REGISTER_PROGRAM_PASS_FUNCTION(FoldQuantize).set_body(cinn::frontend::pass::FoldQuantize);
+  CINN_REGISTER_PROGRAM_PASS_FUNCTION(FoldQuantizeCudnnMul).set_body(cinn::frontend::pass::FoldQuantizeCudnnMul);
+
+  return true;
+}
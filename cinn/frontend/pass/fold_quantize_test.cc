@@ -0,0 +1,311 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn::frontend {
+
+namespace {
+
+std::vector<float> SetRandData(hlir::framework::Tensor tensor, Target target) {
+  auto* data = tensor->mutable_data<float>(target);
+  std::random_device seed;
+  std::default_random_engine engine(seed());
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  size_t num_ele = tensor->shape().numel();
+  std::vector<float> random_data(num_ele);
+  for (size_t i = 0; i < num_ele; i++) {
+    random_data[i] = dist(engine);
+  }
+
+#ifdef CINN_WITH_CUDA
+  cudaMemcpy(data, random_data.data(), num_ele * sizeof(float), cudaMemcpyHostToDevice);
+#else
+  std::copy(random_data.begin(), random_data.end(), data);
+#endif
+  return random_data;
+}
+
+std::vector<float> GetData(hlir::framework::Tensor tensor, Target target) {
+  size_t num_ele = tensor->shape().numel();
+  std::vector<float> data(num_ele);
+#ifdef CINN_WITH_CUDA
+  cudaMemcpy(data.data(), tensor->data<float>(), num_ele * sizeof(float), cudaMemcpyDeviceToHost);
+#else
+  std::copy(tensor->data<float>(), tensor->data<float>() + num_ele, data.begin());
+#endif
+  return data;
+}
+
+int QuantizeRef(float x, float scale) { return std::max(-128, std::min(127, static_cast<int>(std::round(x / scale)))); }
+
+int CountOp(const Program& program, const std::string& op_type) {
+  int count = 0;
+  for (int i = 0; i < program.size(); i++) {
+    if (program[i]->op_type == op_type) count++;
+  }
+  return count;
+}
+
+// run the program with random inputs, return the data of the inputs followed by the data of the float output
+std::vector<std::vector<float>> RunWithRandInputs(const Program& program,
+                                                  const std::vector<std::string>& input_ids,
+                                                  const std::string& out_id) {
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  std::vector<std::vector<float>> datas;
+  for (const auto& id : input_ids) {
+    datas.push_back(SetRandData(scope->GetTensor(id), target));
+  }
+  runtime_program->Execute();
+  datas.push_back(GetData(scope->GetTensor(out_id), target));
+  return datas;
+}
+
+// run the program with random X [M, K] and Y [K, N], and check the output is the product of the quantized X and Y
+void RunAndCheck(const Program& program, const std::string& out_id, int M, int K, int N, float scale_x, float scale_y) {
+  auto datas     = RunWithRandInputs(program, {"X", "Y"}, out_id);
+  auto& x_data   = datas[0];
+  auto& y_data   = datas[1];
+  auto& out_data = datas[2];
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      int acc = 0;
+      for (int k = 0; k < K; k++) {
+        acc += QuantizeRef(x_data[i * K + k], scale_x) * QuantizeRef(y_data[k * N + j], scale_y);
+      }
+      ASSERT_NEAR(out_data[i * N + j], acc * scale_x * scale_y, 1e-4);
+    }
+  }
+}
+
+// run the program with random X [N, C, H, W] and W [F, C, KH, KW], and check the output is the convolution of the
+// quantized X and W
+void RunAndCheckConv2d(const Program& program,
+                       const std::string& out_id,
+                       const std::vector<int>& x_shape,
+                       const std::vector<int>& w_shape,
+                       int stride,
+                       int padding,
+                       int dilation,
+                       float scale_x,
+                       float scale_w) {
+  auto datas     = RunWithRandInputs(program, {"X", "W"}, out_id);
+  auto& x_data   = datas[0];
+  auto& w_data   = datas[1];
+  auto& out_data = datas[2];
+  int n = x_shape[0], c = x_shape[1], h = x_shape[2], w = x_shape[3];
+  int f = w_shape[0], kh = w_shape[2], kw = w_shape[3];
+  int oh = (h + 2 * padding - dilation * (kh - 1) - 1) / stride + 1;
+  int ow = (w + 2 * padding - dilation * (kw - 1) - 1) / stride + 1;
+  ASSERT_EQ(out_data.size(), static_cast<size_t>(n * f * oh * ow));
+  for (int in = 0; in < n; in++) {
+    for (int ff = 0; ff < f; ff++) {
+      for (int y = 0; y < oh; y++) {
+        for (int x = 0; x < ow; x++) {
+          int acc = 0;
+          for (int rc = 0; rc < c; rc++) {
+            for (int ry = 0; ry < kh; ry++) {
+              for (int rx = 0; rx < kw; rx++) {
+                int iy = y * stride + ry * dilation - padding;
+                int ix = x * stride + rx * dilation - padding;
+                if (iy < 0 || iy >= h || ix < 0 || ix >= w) continue;
+                acc += QuantizeRef(x_data[((in * c + rc) * h + iy) * w + ix], scale_x) *
+                       QuantizeRef(w_data[((ff * c + rc) * kh + ry) * kw + rx], scale_w);
+              }
+            }
+          }
+          ASSERT_NEAR(out_data[((in * f + ff) * oh + y) * ow + x], acc * scale_x * scale_w, 1e-4);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(FoldQuantize, fold_matmul) {
+  const int M = 16, K = 32, N = 24;
+  const float scale_x = 0.01f, scale_y = 0.02f;
+
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {M, K}, "X");
+  auto y       = builder.CreateInput(Float(32), {K, N}, "Y");
+  auto dq_x    = builder.Dequantize(builder.Quantize(x, scale_x), scale_x);
+  auto dq_y    = builder.Dequantize(builder.Quantize(y, scale_y), scale_y);
+  auto out     = builder.Matmul(dq_x, dq_y);
+  auto program = builder.Build();
+  ApplyPass(&program, {out->id}, "FoldQuantize");
+  ASSERT_EQ(program.size(), 4UL);
+  ASSERT_EQ(CountOp(program, "matmul"), 0);
+  ASSERT_EQ(CountOp(program, "quantized_matmul"), 1);
+  ASSERT_EQ(CountOp(program, "dequantize"), 1);
+  RunAndCheck(program, out->id, M, K, N, scale_x, scale_y);
+}
+
+// the mul of Paddle models reads the weight through a transpose
+TEST(FoldQuantize, fold_mul_through_transpose) {
+  const int M = 16, K = 32, N = 24;
+  const float scale_x = 0.01f, scale_y = 0.02f;
+
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {M, K}, "X");
+  auto y       = builder.CreateInput(Float(32), {K, N}, "Y");
+  auto dq_x    = builder.Dequantize(builder.Quantize(x, scale_x), scale_x);
+  auto dq_y    = builder.Dequantize(builder.Quantize(y, scale_y), scale_y);
+  auto out     = builder.Mul(dq_x, builder.Transpose(dq_y, {1, 0}));
+  auto program = builder.Build();
+  ApplyPass(&program, {out->id}, "FoldQuantize");
+  ASSERT_EQ(CountOp(program, "mul"), 0);
+  ASSERT_EQ(CountOp(program, "transpose"), 0);
+  ASSERT_EQ(CountOp(program, "quantized_matmul"), 1);
+  ASSERT_EQ(CountOp(program, "dequantize"), 1);
+  RunAndCheck(program, out->id, M, K, N, scale_x, scale_y);
+}
+
+// the mul of Paddle models reads the weight through a reshape swapping its dimensions with cuDNN
+TEST(FoldQuantize, cant_fold_mul_through_reshape) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {16, 32}, "X");
+  auto y       = builder.CreateInput(Float(32), {32, 24}, "Y");
+  auto dq_x    = builder.Dequantize(builder.Quantize(x, 0.01f), 0.01f);
+  auto dq_y    = builder.Dequantize(builder.Quantize(y, 0.02f), 0.02f);
+  auto out     = builder.Mul(dq_x, builder.Reshape(dq_y, {24, 32}));
+  auto program = builder.Build();
+
+  // the reshape is not a transpose for the mul of the other targets
+  ApplyPass(&program, {out->id}, "FoldQuantize");
+  ASSERT_EQ(CountOp(program, "mul"), 1);
+  ASSERT_EQ(CountOp(program, "quantized_matmul"), 0);
+}
+
+#ifdef CINN_WITH_CUDNN
+TEST(FoldQuantize, fold_mul_through_reshape_cudnn) {
+  const int M = 16, K = 32, N = 24;
+  const float scale_x = 0.01f, scale_y = 0.02f;
+
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {M, K}, "X");
+  auto y       = builder.CreateInput(Float(32), {K, N}, "Y");
+  auto dq_x    = builder.Dequantize(builder.Quantize(x, scale_x), scale_x);
+  auto dq_y    = builder.Dequantize(builder.Quantize(y, scale_y), scale_y);
+  auto out     = builder.Mul(dq_x, builder.Reshape(dq_y, {N, K}));
+  auto program = builder.Build();
+  ApplyPass(&program, {out->id}, "FoldQuantizeCudnnMul");
+  ASSERT_EQ(CountOp(program, "mul"), 0);
+  ASSERT_EQ(CountOp(program, "reshape"), 0);
+  ASSERT_EQ(CountOp(program, "quantized_matmul"), 1);
+  ASSERT_EQ(CountOp(program, "dequantize"), 1);
+  RunAndCheck(program, out->id, M, K, N, scale_x, scale_y);
+}
+#endif
+
+TEST(FoldQuantize, fold_conv2d) {
+  const std::vector<int> x_shape = {2, 8, 10, 10}, w_shape = {16, 8, 3, 3};
+  const float scale_x = 0.01f, scale_w = 0.02f;
+
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), x_shape, "X");
+  auto w       = builder.CreateInput(Float(32), w_shape, "W");
+  auto dq_x    = builder.Dequantize(builder.Quantize(x, scale_x), scale_x);
+  auto dq_w    = builder.Dequantize(builder.Quantize(w, scale_w), scale_w);
+  auto out     = builder.Conv2d(dq_x, dq_w, {1, 1}, {1, 1});
+  auto program = builder.Build();
+  ApplyPass(&program, {out->id}, "FoldQuantize");
+  ASSERT_EQ(CountOp(program, "conv2d"), 0);
+  ASSERT_EQ(CountOp(program, "quantized_conv2d"), 1);
+  ASSERT_EQ(CountOp(program, "dequantize"), 1);
+  RunAndCheckConv2d(program, out->id, x_shape, w_shape, 1, 1, 1, scale_x, scale_w);
+}
+
+TEST(QuantizedOps, quantized_conv2d) {
+  const std::vector<int> x_shape = {1, 4, 17, 17}, w_shape = {8, 4, 3, 3};
+  const float scale_x = 0.01f, scale_w = 0.02f;
+
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), x_shape, "X");
+  auto w       = builder.CreateInput(Float(32), w_shape, "W");
+  auto q_x     = builder.Quantize(x, scale_x);
+  auto q_w     = builder.Quantize(w, scale_w);
+  auto out     = builder.Dequantize(builder.QuantizedConv2d(q_x, q_w, {2, 2}, {0, 0}, {2, 2}), scale_x * scale_w);
+  auto program = builder.Build();
+  RunAndCheckConv2d(program, out->id, x_shape, w_shape, 2, 0, 2, scale_x, scale_w);
+}
+
+TEST(QuantizedOps, requantize) {
+  const int M = 16, K = 32, N = 24;
+  const float scale_x = 0.01f, scale_y = 0.02f, scale_out = 0.05f;
+
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {M, K}, "X");
+  auto y       = builder.CreateInput(Float(32), {K, N}, "Y");
+  auto acc     = builder.QuantizedMatmul(builder.Quantize(x, scale_x), builder.Quantize(y, scale_y));
+  auto out     = builder.Dequantize(builder.Requantize(acc, scale_x * scale_y, scale_out), scale_out);
+  auto program = builder.Build();
+
+  auto datas     = RunWithRandInputs(program, {"X", "Y"}, out->id);
+  auto& x_data   = datas[0];
+  auto& y_data   = datas[1];
+  auto& out_data = datas[2];
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      int acc = 0;
+      for (int k = 0; k < K; k++) {
+        acc += QuantizeRef(x_data[i * K + k], scale_x) * QuantizeRef(y_data[k * N + j], scale_y);
+      }
+      // the requantized output is the float product rounded to the step of the output and saturated
+      float expected = std::max(-128 * scale_out, std::min(127 * scale_out, acc * scale_x * scale_y));
+      ASSERT_NEAR(out_data[i * N + j], expected, scale_out * 0.5f + 1e-4);
+    }
+  }
+}
+
+TEST(FoldQuantize, cant_fold_float_input) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {16, 32});
+  auto y       = builder.CreateInput(Float(32), {32, 24});
+  auto dq_x    = builder.Dequantize(builder.Quantize(x, 0.01f), 0.01f);
+  auto out     = builder.Matmul(dq_x, y);
+  auto program = builder.Build();
+
+  size_t before_size = program.size();
+  ApplyPass(&program, {out->id}, "FoldQuantize");
+  ASSERT_EQ(program.size(), before_size);
+  ASSERT_EQ(CountOp(program, "matmul"), 1);
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,269 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/program_pass.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+namespace {
+
+template <typename T>
+T GetAttrOrDefault(const Instruction& instr, const std::string& key, const T& default_value) {
+  auto it = instr->attrs.find(key);
+  return it == instr->attrs.end() ? default_value : absl::get<T>(it->second);
+}
+
+bool SameVar(const Variable& a, const Variable& b) { return a->type == b->type && a->shape == b->shape; }
+
+class ProgramSimplifier {
+ public:
+  ProgramSimplifier(Program* program, const std::unordered_set<std::string>& fetch_ids)
+      : program_(program), fetch_ids_(fetch_ids) {}
+
+  void operator()();
+
+ private:
+  // Return the instruction which produces `var`, or nullptr when `var` is an input of the program.
+  const Instruction* Producer(const Variable& var) const {
+    auto it = producers_.find(var->id);
+    return it == producers_.end() ? nullptr : it->second;
+  }
+
+  // Whether `var` is produced by a fill_constant of `value`, maybe broadcasted.
+  bool IsConstant(const Variable& var, float value) const;
+
+  // Replace the uses of the outputs of `instr` with `vars`. Returns false if an output is fetched, then
+  // `instr` has to be kept.
+  bool ReplaceOutputs(const Instruction& instr, const std::vector<Variable>& vars);
+
+  // The algebraic rules, return true if `instr` is replaced by its operand and can be removed.
+  bool SimplifyScale(Instruction* instr);
+  bool SimplifyReshape(Instruction* instr);
+  bool SimplifyTranspose(Instruction* instr);
+  bool SimplifyElementwise(Instruction* instr);
+
+  // Return true if `instr` computes the same values as a previous instruction and can be removed.
+  bool EliminateCommonSubexpr(const Instruction& instr);
+
+  Program* program_;
+  const std::unordered_set<std::string>& fetch_ids_;
+  std::unordered_map<std::string, const Instruction*> producers_;
+  // the variables which the removed outputs are replaced with
+  std::unordered_map<std::string, Variable> replaced_;
+  // the instructions of the same op type and inputs
+  std::unordered_map<std::string, std::vector<const Instruction*>> exprs_;
+};
+
+bool ProgramSimplifier::IsConstant(const Variable& var, float value) const {
+  const auto* producer = Producer(var);
+  if (producer && (*producer)->op_type == "broadcast_to") producer = Producer((*producer)->inputs[0]);
+  if (!producer || (*producer)->op_type != "fill_constant") return false;
+  return GetAttrOrDefault<float>(*producer, "value", 0.f) == value;
+}
+
+bool ProgramSimplifier::ReplaceOutputs(const Instruction& instr, const std::vector<Variable>& vars) {
+  CHECK_EQ(instr->outputs.size(), vars.size());
+  for (const auto& out : instr->outputs) {
+    if (fetch_ids_.count(out->id)) return false;
+  }
+  for (int i = 0; i < vars.size(); i++) {
+    replaced_[instr->outputs[i]->id] = vars[i];
+  }
+  VLOG(2) << "Remove instruction: " << instr;
+  return true;
+}
+
+bool ProgramSimplifier::SimplifyScale(Instruction* instr) {
+  auto scale = GetAttrOrDefault<float>(*instr, "scale", 1.f);
+  auto bias  = GetAttrOrDefault<float>(*instr, "bias", 0.f);
+  if (!GetAttrOrDefault<bool>(*instr, "bias_after_scale", true)) bias *= scale;
+  // scale(scale(x, s1, b1), s2, b2) = scale(x, s1 * s2, b1 * s2 + b2)
+  const auto* producer = Producer((*instr)->inputs[0]);
+  if (producer && (*producer)->op_type == "scale" && (*instr)->outputs[0]->type.is_float()) {
+    auto inner_scale = GetAttrOrDefault<float>(*producer, "scale", 1.f);
+    auto inner_bias  = GetAttrOrDefault<float>(*producer, "bias", 0.f);
+    if (!GetAttrOrDefault<bool>(*producer, "bias_after_scale", true)) inner_bias *= inner_scale;
+    bias  = inner_bias * scale + bias;
+    scale = inner_scale * scale;
+    instr->SetInputs({(*producer)->inputs[0]});
+    instr->SetAttr("scale", scale);
+    instr->SetAttr("bias", bias);
+    instr->SetAttr("bias_after_scale", true);
+  }
+  if (scale != 1.f || bias != 0.f || !SameVar((*instr)->inputs[0], (*instr)->outputs[0])) return false;
+  return ReplaceOutputs(*instr, {(*instr)->inputs[0]});
+}
+
+bool ProgramSimplifier::SimplifyReshape(Instruction* instr) {
+  const auto* producer = Producer((*instr)->inputs[0]);
+  if (producer && (*producer)->op_type == "reshape") {
+    // the shape attribute may have -1 or 0, so take the inferred one
+    instr->SetInputs({(*producer)->inputs[0]});
+    instr->SetAttr("shape", (*instr)->outputs[0]->shape);
+  }
+  if (!SameVar((*instr)->inputs[0], (*instr)->outputs[0])) return false;
+  return ReplaceOutputs(*instr, {(*instr)->inputs[0]});
+}
+
+bool ProgramSimplifier::SimplifyTranspose(Instruction* instr) {
+  auto axis            = instr->GetAttrs<std::vector<int>>("axis");
+  const auto* producer = Producer((*instr)->inputs[0]);
+  if (producer && (*producer)->op_type == "transpose") {
+    // out[i] = in[axis[i]] and in[j] = x[inner_axis[j]], so out[i] = x[inner_axis[axis[i]]]
+    auto inner_axis = producer->GetAttrs<std::vector<int>>("axis");
+    CHECK_EQ(inner_axis.size(), axis.size());
+    std::vector<int> fused_axis(axis.size());
+    for (int i = 0; i < axis.size(); i++) {
+      fused_axis[i] = inner_axis[axis[i]];
+    }
+    axis = fused_axis;
+    instr->SetInputs({(*producer)->inputs[0]});
+    instr->SetAttr("axis", axis);
+  }
+  for (int i = 0; i < axis.size(); i++) {
+    if (axis[i] != i) return false;
+  }
+  return ReplaceOutputs(*instr, {(*instr)->inputs[0]});
+}
+
+bool ProgramSimplifier::SimplifyElementwise(Instruction* instr) {
+  const auto& op_type = (*instr)->op_type;
+  float identity      = op_type == "elementwise_add" ? 0.f : 1.f;
+  const auto& inputs  = (*instr)->inputs;
+  const auto& out     = (*instr)->outputs[0];
+  for (int i = 0; i < 2; i++) {
+    // the other operand may be broadcasted to the shape of the output
+    if (IsConstant(inputs[i], identity) && SameVar(inputs[1 - i], out)) {
+      return ReplaceOutputs(*instr, {inputs[1 - i]});
+    }
+  }
+  return false;
+}
+
+bool ProgramSimplifier::EliminateCommonSubexpr(const Instruction& instr) {
+  std::string key = instr->op_type;
+  for (const auto& in : instr->inputs) {
+    key += "," + in->id;
+  }
+  auto& candidates = exprs_[key];
+  for (const auto* candidate : candidates) {
+    if ((*candidate)->attrs == instr->attrs && (*candidate)->outputs.size() == instr->outputs.size()) {
+      return ReplaceOutputs(instr, (*candidate)->outputs);
+    }
+  }
+  candidates.push_back(&instr);
+  return false;
+}
+
+void ProgramSimplifier::operator()() {
+  std::unordered_map<std::string, int> origin_uses;
+  for (int i = 0; i < program_->size(); i++) {
+    for (const auto& in : (*program_)[i]->inputs) {
+      origin_uses[in->id]++;
+    }
+  }
+
+  std::vector<bool> removed(program_->size(), false);
+  for (int i = 0; i < program_->size(); i++) {
+    auto& instr = (*program_)[i];
+    for (auto& in : instr->inputs) {
+      auto it = replaced_.find(in->id);
+      if (it != replaced_.end()) in = it->second;
+    }
+    const auto& op_type = instr->op_type;
+    if (op_type == "scale") {
+      removed[i] = SimplifyScale(&instr);
+    } else if (op_type == "reshape") {
+      removed[i] = SimplifyReshape(&instr);
+    } else if (op_type == "transpose") {
+      removed[i] = SimplifyTranspose(&instr);
+    } else if (op_type == "elementwise_add" || op_type == "elementwise_mul") {
+      removed[i] = SimplifyElementwise(&instr);
+    }
+    if (!removed[i]) removed[i] = EliminateCommonSubexpr(instr);
+    if (removed[i]) continue;
+    for (const auto& out : instr->outputs) {
+      producers_[out->id] = &instr;
+    }
+  }
+
+  // remove the instructions whose outputs were used only by the rewritten or removed instructions
+  std::unordered_map<std::string, int> uses;
+  for (int i = program_->size() - 1; i >= 0; --i) {
+    const auto& instr = (*program_)[i];
+    if (removed[i]) continue;
+    bool used = false, origin_used = false;
+    for (const auto& out : instr->outputs) {
+      used        = used || uses.count(out->id) || fetch_ids_.count(out->id);
+      origin_used = origin_used || origin_uses.count(out->id);
+    }
+    if (!used && origin_used) {
+      VLOG(2) << "Remove dead instruction: " << instr;
+      removed[i] = true;
+      continue;
+    }
+    for (const auto& in : instr->inputs) {
+      uses[in->id]++;
+    }
+  }
+
+  CinnBuilder builder("simplify_program_builder");
+  for (auto& var : program_->GetInputs()) {
+    builder.CreateInput(var);
+  }
+  int remove_num = 0;
+  for (int i = 0; i < program_->size(); i++) {
+    if (removed[i]) {
+      remove_num++;
+      continue;
+    }
+    builder.AppendInstruction((*program_)[i]);
+  }
+  VLOG(2) << "Total remove " << remove_num << " instructions.";
+  *program_ = builder.Build();
+}
+
+}  // namespace
+
+/*
+ * Programs converted from models or expanded by the decomposers have many redundant instructions.
+ * `SimplifyProgram` applies the algebraic rules below in one pass over the program:
+ *   - scale(scale(x)) is folded into one scale, and a scale by 1 without bias is removed;
+ *   - reshape(reshape(x)) is folded into one reshape, and a reshape to the same shape is removed;
+ *   - transpose(transpose(x)) is folded into one transpose, and it is removed if the axes cancel;
+ *   - x + 0 and x * 1 are removed, the constant is a fill_constant, maybe broadcasted.
+ * Then an instruction with the same op type, inputs and attributes as a previous one is removed
+ * by common subexpression elimination. The outputs in `fetch_ids` are always kept.
+ */
+void SimplifyProgram(Program* program, const std::unordered_set<std::string>& fetch_ids) {
+  ProgramSimplifier simplifier(program, fetch_ids);
+  simplifier();
+}
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(SimplifyProgram) {
+  CINN_REGISTER_PROGRAM_PASS_FUNCTION(SimplifyProgram).set_body(cinn::frontend::pass::SimplifyProgram);
+
+  return true;
+}
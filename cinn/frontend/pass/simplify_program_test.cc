@@ -0,0 +1,110 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/hlir/op/use_ops.h"
+
+namespace cinn::frontend {
+
+namespace {
+
+int CountOp(const Program& program, const std::string& op_type) {
+  int count = 0;
+  for (int i = 0; i < program.size(); i++) {
+    if (program[i]->op_type == op_type) count++;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(SimplifyProgram, common_subexpr) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {32, 16});
+  auto scale_1 = builder.Scale(x, 2.f, 1.f);
+  auto scale_2 = builder.Scale(x, 2.f, 1.f);
+  auto scale_3 = builder.Scale(x, 3.f, 1.f);
+  auto add_1   = builder.ElementwiseAdd(scale_1, scale_3);
+  auto add_2   = builder.ElementwiseAdd(scale_2, scale_3);
+  auto out     = builder.ElementwiseMul(add_1, add_2);
+  auto program = builder.Build();
+
+  LOG(INFO) << program;
+  ApplyPass(&program, {out->id}, "SimplifyProgram");
+  LOG(INFO) << program;
+  ASSERT_EQ(program.size(), 4UL);
+  ASSERT_EQ(CountOp(program, "scale"), 2);
+  ASSERT_EQ(CountOp(program, "elementwise_add"), 1);
+  ASSERT_EQ(program[3]->inputs[0]->id, program[3]->inputs[1]->id);
+}
+
+TEST(SimplifyProgram, keep_fetched) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {32, 16});
+  auto scale_1 = builder.Scale(x, 2.f, 1.f);
+  auto scale_2 = builder.Scale(x, 2.f, 1.f);
+  auto program = builder.Build();
+
+  ApplyPass(&program, {scale_1->id, scale_2->id}, "SimplifyProgram");
+  ASSERT_EQ(program.size(), 2UL);
+}
+
+TEST(SimplifyProgram, fold_chains) {
+  NetBuilder builder("net_builder");
+  auto x           = builder.CreateInput(Float(32), {4, 8, 16});
+  auto reshape_1   = builder.Reshape(x, {32, 16});
+  auto reshape_2   = builder.Reshape(reshape_1, {4, -1});
+  auto transpose_1 = builder.Transpose(x, {2, 0, 1});
+  auto transpose_2 = builder.Transpose(transpose_1, {1, 2, 0});
+  auto scale_1     = builder.Scale(transpose_2, 2.f, 1.f);
+  auto scale_2     = builder.Scale(scale_1, 0.5f, -0.5f);
+  auto program     = builder.Build();
+
+  LOG(INFO) << program;
+  ApplyPass(&program, {reshape_2->id, scale_2->id}, "SimplifyProgram");
+  LOG(INFO) << program;
+  // the transposes cancel and the scales are folded into an identity, but the fetched output is kept
+  ASSERT_EQ(program.size(), 2UL);
+  ASSERT_EQ(CountOp(program, "reshape"), 1);
+  ASSERT_EQ(CountOp(program, "transpose"), 0);
+  ASSERT_EQ(CountOp(program, "scale"), 1);
+  for (int i = 0; i < program.size(); i++) {
+    ASSERT_EQ(program[i]->inputs[0]->id, std::string(x.id()));
+  }
+  ASSERT_EQ(program[0].GetAttrs<std::vector<int>>("shape"), std::vector<int>({4, 128}));
+}
+
+TEST(SimplifyProgram, identity_element) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {32, 16});
+  auto zero    = builder.FillConstant<float>({32, 16}, 0.f, "zero");
+  auto one     = builder.FillConstant<float>({1}, 1.f, "one");
+  auto add     = builder.ElementwiseAdd(x, zero);
+  auto mul     = builder.ElementwiseMul(one, add);
+  auto out     = builder.Relu(mul);
+  auto program = builder.Build();
+
+  LOG(INFO) << program;
+  ApplyPass(&program, {out->id}, "SimplifyProgram");
+  LOG(INFO) << program;
+  ASSERT_EQ(program.size(), 1UL);
+  ASSERT_EQ(program[0]->op_type, "relu");
+  ASSERT_EQ(program[0]->inputs[0]->id, std::string(x.id()));
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,160 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+namespace {
+
+template <typename T>
+T GetAttrOrDefault(const Instruction& instr, const std::string& key, const T& default_value) {
+  auto it = instr->attrs.find(key);
+  return it == instr->attrs.end() ? default_value : absl::get<T>(it->second);
+}
+
+// Return the input of the transpose which produces `var` if it only swaps the last two dimensions of a matrix or
+// a batch of matrices, otherwise return `var` itself.
+Variable SkipTranspose(const std::unordered_map<std::string, const Instruction*>& producers,
+                       const Variable& var,
+                       bool* folded) {
+  *folded = false;
+  auto it = producers.find(var->id);
+  if (it == producers.end() || (*it->second)->op_type != "transpose") return var;
+  auto axis = it->second->GetAttrs<std::vector<int>>("axis");
+  int dims  = axis.size();
+  if (dims != 2 && dims != 3) return var;
+  for (int i = 0; i < dims - 2; i++) {
+    if (axis[i] != i) return var;
+  }
+  if (axis[dims - 2] != dims - 1 || axis[dims - 1] != dims - 2) return var;
+  *folded = true;
+  return (*it->second)->inputs[0];
+}
+
+// Try to absorb the transposes of the inputs of `instr` into the trans_a and trans_b attributes of matmul. Returns
+// false if no transpose is folded and `instr` should be kept as it is.
+bool TryFoldTranspose(const Instruction& instr,
+                      const std::unordered_map<std::string, const Instruction*>& producers,
+                      const std::unordered_map<std::string, int>& uses,
+                      const std::unordered_set<std::string>& fetch_ids,
+                      NetBuilder* builder) {
+  if (instr->inputs.size() != 2U) return false;
+  bool trans_a = false, trans_b = false;
+  float alpha  = 1.f;
+  if (instr->op_type == "matmul") {
+    trans_a = GetAttrOrDefault<bool>(instr, "trans_a", false);
+    trans_b = GetAttrOrDefault<bool>(instr, "trans_b", false);
+    alpha   = GetAttrOrDefault<float>(instr, "alpha", 1.f);
+  } else if (instr->op_type == "mul") {
+    if (instr->inputs[0]->shape.size() != 2U || instr->inputs[1]->shape.size() != 2U) return false;
+    if (GetAttrOrDefault<int>(instr, "x_num_col_dims", 1) != 1 || GetAttrOrDefault<int>(instr, "y_num_col_dims", 1) != 1)
+      return false;
+    // mul computes a * b^T, and its second output is a temporary buffer which no one should read
+    if (uses.count(instr->outputs[1]->id) || fetch_ids.count(instr->outputs[1]->id)) return false;
+    trans_b = true;
+  } else {
+    return false;
+  }
+
+  bool folded_a = false, folded_b = false;
+  auto a = SkipTranspose(producers, instr->inputs[0], &folded_a);
+  auto b = SkipTranspose(producers, instr->inputs[1], &folded_b);
+  if (!folded_a && !folded_b) return false;
+
+  auto out = builder->Matmul(a, b, trans_a != folded_a, trans_b != folded_b, alpha);
+  // keep the original output name so that the following instructions and fetch_ids still work
+  out.set_id(instr->outputs[0]->id);
+  VLOG(2) << "Fold transposes into instruction: " << instr;
+  return true;
+}
+
+}  // namespace
+
+/*
+ * A transpose which swaps the last two dimensions of an input of matmul or mul is a strided copy of the whole
+ * tensor. `TransposeFolding` absorbs it into the trans_a and trans_b attributes of matmul instead, so the matmul
+ * kernel reads the original tensor in the transposed order. Transposes which are no longer used are removed.
+ */
+void TransposeFolding(Program* program, const std::unordered_set<std::string>& fetch_ids) {
+  std::unordered_map<std::string, const Instruction*> producers;
+  std::unordered_map<std::string, int> uses;
+  for (int i = 0; i < program->size(); i++) {
+    const auto& instr = (*program)[i];
+    for (const auto& out : instr->outputs) {
+      producers[out->id] = &instr;
+    }
+    for (const auto& in : instr->inputs) {
+      uses[in->id]++;
+    }
+  }
+
+  NetBuilder builder("transpose_folding_builder");
+  for (auto& var : program->GetInputs()) {
+    builder.CreateInput(var);
+  }
+  int fold_num = 0;
+  for (int i = 0; i < program->size(); i++) {
+    const auto& instr = (*program)[i];
+    if (TryFoldTranspose(instr, producers, uses, fetch_ids, &builder)) {
+      fold_num++;
+    } else {
+      builder.AppendInstruction(instr);
+    }
+  }
+  VLOG(2) << "Total fold transposes into " << fold_num << " instructions.";
+  if (fold_num == 0) return;
+  auto folded = builder.Build();
+
+  CinnBuilder cleaner("transpose_folding_cleaner");
+  for (auto& var : folded.GetInputs()) {
+    cleaner.CreateInput(var);
+  }
+  absl::flat_hash_set<std::string> inputs;
+  absl::flat_hash_set<int> remove_idxs;
+  for (int i = folded.size() - 1; i >= 0; --i) {
+    const auto& instr = folded[i];
+    if (instr->op_type == "transpose" && !inputs.count(instr->outputs[0]->id) &&
+        !fetch_ids.count(instr->outputs[0]->id)) {
+      remove_idxs.insert(i);
+      continue;
+    }
+    for (const auto& in : instr->inputs) {
+      inputs.insert(in->id);
+    }
+  }
+  for (int i = 0; i < folded.size(); i++) {
+    if (remove_idxs.count(i)) continue;
+    cleaner.AppendInstruction(folded[i]);
+  }
+  *program = cleaner.Build();
+}
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(TransposeFolding) {
+  CINN_REGISTER_PROGRAM_PASS_FUNCTION(TransposeFolding).set_body(cinn::frontend::pass::TransposeFolding);
+
+  return true;
+}
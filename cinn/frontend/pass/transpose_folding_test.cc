@@ -0,0 +1,147 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn::frontend {
+
+namespace {
+
+std::vector<float> SetRandData(hlir::framework::Tensor tensor, Target target) {
+  auto* data = tensor->mutable_data<float>(target);
+  std::random_device seed;
+  std::default_random_engine engine(seed());
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  size_t num_ele = tensor->shape().numel();
+  std::vector<float> random_data(num_ele);
+  for (size_t i = 0; i < num_ele; i++) {
+    random_data[i] = dist(engine);
+  }
+
+#ifdef CINN_WITH_CUDA
+  cudaMemcpy(data, random_data.data(), num_ele * sizeof(float), cudaMemcpyHostToDevice);
+#else
+  std::copy(random_data.begin(), random_data.end(), data);
+#endif
+  return random_data;
+}
+
+std::vector<float> GetData(hlir::framework::Tensor tensor, Target target) {
+  size_t num_ele = tensor->shape().numel();
+  std::vector<float> data(num_ele);
+#ifdef CINN_WITH_CUDA
+  cudaMemcpy(data.data(), tensor->data<float>(), num_ele * sizeof(float), cudaMemcpyDeviceToHost);
+#else
+  std::copy(tensor->data<float>(), tensor->data<float>() + num_ele, data.begin());
+#endif
+  return data;
+}
+
+int CountOp(const Program& program, const std::string& op_type) {
+  int count = 0;
+  for (int i = 0; i < program.size(); i++) {
+    if (program[i]->op_type == op_type) count++;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(TransposeFolding, fold_matmul) {
+  const int M = 16, K = 32, N = 24;
+
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {K, M}, "X");
+  auto y       = builder.CreateInput(Float(32), {N, K}, "Y");
+  auto out     = builder.Matmul(builder.Transpose(x, {1, 0}), builder.Transpose(y, {1, 0}));
+  auto program = builder.Build();
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+  LOG(INFO) << program;
+  ApplyPass(&program, {out->id}, "TransposeFolding");
+  LOG(INFO) << program;
+  ASSERT_EQ(program.size(), 1UL);
+  ASSERT_EQ(CountOp(program, "transpose"), 0);
+  ASSERT_TRUE(program[0].GetAttrs<bool>("trans_a"));
+  ASSERT_TRUE(program[0].GetAttrs<bool>("trans_b"));
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto x_data = SetRandData(scope->GetTensor("X"), target);
+  auto y_data = SetRandData(scope->GetTensor("Y"), target);
+  runtime_program->Execute();
+
+  auto out_data = GetData(scope->GetTensor(out->id), target);
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      float acc = 0.f;
+      for (int k = 0; k < K; k++) {
+        acc += x_data[k * M + i] * y_data[j * K + k];
+      }
+      ASSERT_NEAR(out_data[i * N + j], acc, 1e-4);
+    }
+  }
+}
+
+TEST(TransposeFolding, fold_mul) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {16, 32});
+  auto y       = builder.CreateInput(Float(32), {32, 24});
+  auto y_t     = builder.Transpose(y, {1, 0});
+  auto out     = builder.Mul(x, y_t);
+  auto program = builder.Build();
+
+  ApplyPass(&program, {out->id}, "TransposeFolding");
+  ASSERT_EQ(program.size(), 1UL);
+  ASSERT_EQ(program[0]->op_type, "matmul");
+  ASSERT_FALSE(program[0].GetAttrs<bool>("trans_a"));
+  ASSERT_FALSE(program[0].GetAttrs<bool>("trans_b"));
+  ASSERT_EQ(program[0]->outputs[0]->id, out->id);
+  ASSERT_EQ(program[0]->outputs[0]->shape, std::vector<int>({16, 24}));
+}
+
+TEST(TransposeFolding, keep_fetched_transpose) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {2, 32, 16});
+  auto y       = builder.CreateInput(Float(32), {2, 32, 24});
+  auto x_t     = builder.Transpose(x, {0, 2, 1});
+  auto out     = builder.Matmul(x_t, y);
+  auto program = builder.Build();
+
+  ApplyPass(&program, {x_t->id, out->id}, "TransposeFolding");
+  ASSERT_EQ(program.size(), 2UL);
+  ASSERT_EQ(CountOp(program, "transpose"), 1);
+  ASSERT_EQ(CountOp(program, "matmul"), 1);
+}
+
+}  // namespace cinn::frontend
@@ -16,5 +16,9 @@
 
 #include "cinn/common/macros.h"
 
+CINN_USE_REGISTER(BatchNormReluGradFusion)
 CINN_USE_REGISTER(Decomposer)
+CINN_USE_REGISTER(FoldQuantize)
 CINN_USE_REGISTER(RemoveIdentity)
+CINN_USE_REGISTER(SimplifyProgram)
+CINN_USE_REGISTER(TransposeFolding)
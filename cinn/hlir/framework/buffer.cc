@@ -14,11 +14,13 @@
 
 #include "cinn/hlir/framework/buffer.h"
 
+#include <utility>
+
 namespace cinn {
 namespace hlir {
 namespace framework {
 
-void Buffer::Resize(uint32_t size) {
+void Buffer::Resize(uint64_t size) {
   if (size_ > 0) {
     Free();
     size_ = 0;
@@ -31,7 +33,7 @@ void Buffer::Resize(uint32_t size) {
   }
 }
 
-void Buffer::Resize(uint32_t alignment, uint32_t size) {
+void Buffer::Resize(uint32_t alignment, uint64_t size) {
   if (size_ > 0) {
     Free();
     size_ = 0;
@@ -49,17 +51,28 @@ void Buffer::SetTarget(const common::Target& target) {
   memory_mng_cache_ = MemoryManager::Global().RetrieveSafely(target_.arch);
 }
 
-void Buffer::ResizeLazy(uint32_t size) {
+void Buffer::BindExternal(void* memory, size_t size, const common::Target& target, std::shared_ptr<void> owner) {
+  CHECK(memory) << "Can not bind a null memory to the buffer";
+  Free();
+  if (target.arch != target_.arch) SetTarget(target);
+  data_.memory      = reinterpret_cast<uint8_t*>(memory);
+  data_.memory_size = size;
+  size_             = size;
+  is_external_      = true;
+  external_owner_   = std::move(owner);
+}
+
+void Buffer::ResizeLazy(uint64_t size) {
   if (size <= size_) return;
   Resize(size);
 }
 
-void Buffer::ResizeLazy(uint32_t alignment, uint32_t size) {
+void Buffer::ResizeLazy(uint32_t alignment, uint64_t size) {
   if (size <= size_) return;
   Resize(alignment, size);
 }
 
-void Buffer::Resize(uint32_t size, const common::Target& target) {
+void Buffer::Resize(uint64_t size, const common::Target& target) {
   if (target.arch != target_.arch) {
     Free();
     SetTarget(target);
@@ -67,7 +80,7 @@ void Buffer::Resize(uint32_t size, const common::Target& target) {
   Resize(size);
 }
 
-void Buffer::Resize(uint32_t alignment, uint32_t size, const common::Target& target) {
+void Buffer::Resize(uint32_t alignment, uint64_t size, const common::Target& target) {
   if (target.arch != target_.arch) {
     Free();
     SetTarget(target);
@@ -75,7 +88,7 @@ void Buffer::Resize(uint32_t alignment, uint32_t size, const common::Target& tar
   Resize(alignment, size);
 }
 
-void Buffer::ResizeLazy(uint32_t size, const common::Target& target) {
+void Buffer::ResizeLazy(uint64_t size, const common::Target& target) {
   if (target.arch != target_.arch) {
     Free();
     SetTarget(target);
@@ -83,7 +96,7 @@ void Buffer::ResizeLazy(uint32_t size, const common::Target& target) {
   ResizeLazy(size);
 }
 
-void Buffer::ResizeLazy(uint32_t alignment, uint32_t size, const common::Target& target) {
+void Buffer::ResizeLazy(uint32_t alignment, uint64_t size, const common::Target& target) {
   if (target.arch != target_.arch) {
     Free();
     SetTarget(target);
@@ -36,39 +36,64 @@ struct Buffer final {
   explicit Buffer(const common::Target& target) { SetTarget(target); }
 
   //! Resize the memory hold by this buffer *exactlly* to \p size.
-  void Resize(uint32_t size);
-  void Resize(uint32_t alignment, uint32_t size);
+  void Resize(uint64_t size);
+  void Resize(uint32_t alignment, uint64_t size);
 
   //! Lazily resize the memory.
-  void ResizeLazy(uint32_t size);
-  void ResizeLazy(uint32_t alignment, uint32_t size);
+  void ResizeLazy(uint64_t size);
+  void ResizeLazy(uint32_t alignment, uint64_t size);
 
   //! Resize the memory to \p size in target \p target.
-  void Resize(uint32_t size, const common::Target& target);
-  void Resize(uint32_t alignment, uint32_t size, const common::Target& target);
+  void Resize(uint64_t size, const common::Target& target);
+  void Resize(uint32_t alignment, uint64_t size, const common::Target& target);
 
   //! Lazily resize the memory to \p size in target \p target.
-  void ResizeLazy(uint32_t size, const common::Target& target);
-  void ResizeLazy(uint32_t alignment, uint32_t size, const common::Target& target);
+  void ResizeLazy(uint64_t size, const common::Target& target);
+  void ResizeLazy(uint32_t alignment, uint64_t size, const common::Target& target);
 
   void SetTarget(const common::Target& target);
+  const common::Target& target() const { return target_; }
+
+  /**
+   * Use the external memory \p memory of \p size bytes in target \p target instead of allocating it, e.g. the memory
+   * of a numpy array or a DLPack tensor. The buffer never frees the memory, it holds \p owner instead until it is
+   * freed, resized to a larger size or bound to other memory.
+   *
+   * The cinn_buffer_t is modified in place, so the instructions which cached its address see the new memory.
+   */
+  void BindExternal(void* memory, size_t size, const common::Target& target, std::shared_ptr<void> owner = nullptr);
+
+  //! Whether the memory is bound by BindExternal.
+  bool is_external() const { return is_external_; }
 
   const cinn_buffer_t* data() const { return &data_; }
   cinn_buffer_t* data() { return &data_; }
 
-  //! Free all the memory owned by this buffer.
+  //! Free all the memory owned by this buffer, or release the external memory.
   void Free() {
     if (!data_.memory) return;
-    memory_mng_cache_->free(data_.memory);
+    if (is_external_) {
+      is_external_ = false;
+      external_owner_.reset();
+    } else {
+      memory_mng_cache_->free(data_.memory);
+    }
+    data_.memory      = nullptr;
+    data_.memory_size = 0;
+    size_             = 0;
   }
 
+  //! The alignment the generated host code assumes for the memory of a buffer argument, the external memory should
+  //! be aligned to it as well.
+  static constexpr int kMinHostAlignment = CINN_BUFFER_MIN_HOST_ALIGNMENT;
+
  private:
-  inline void* Malloc(uint32_t size) CINN_RESULT_SHOULD_USE {
+  inline void* Malloc(uint64_t size) CINN_RESULT_SHOULD_USE {
     CHECK(memory_mng_cache_) << "Should set target first";
     return memory_mng_cache_->malloc(size);
   }
 
-  inline void* AlignedAlloc(uint32_t alignment, uint32_t size) CINN_RESULT_SHOULD_USE {
+  inline void* AlignedAlloc(uint32_t alignment, uint64_t size) CINN_RESULT_SHOULD_USE {
     CHECK(memory_mng_cache_) << "Should set target first";
     return memory_mng_cache_->aligned_alloc(alignment, size);
   }
@@ -80,10 +105,14 @@ struct Buffer final {
   common::Target target_;
 
   //! Number of bytes of this buffer.
-  uint32_t size_{};
+  uint64_t size_{};
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! Whether the memory is external, and the object keeping the external memory alive.
+  bool is_external_{false};
+  std::shared_ptr<void> external_owner_;
 };
 
 }  // namespace framework
@@ -14,16 +14,33 @@
 
 #include "cinn/hlir/framework/graph_compiler.h"
 
+#include <gflags/gflags.h>
+
+#include <functional>
+#include <map>
 #include <memory>
+#include <numeric>
+#include <sstream>
 #include <unordered_set>
 
 #include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/common/context.h"
 #include "cinn/hlir/framework/instruction.h"
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/pe/schedule.h"
+#include "cinn/ir/ir_arena.h"
 #include "cinn/lang/lower.h"
 #include "cinn/poly/stage.h"
+#include "cinn/utils/string.h"
+
+DEFINE_bool(cinn_reuse_identical_group_func,
+            true,
+            "Whether to compile the groups with the same structure, attributes, dtypes and shapes only once.");
+DEFINE_bool(cinn_ir_arena, true, "Whether to allocate the IR nodes created by lowering and compiling from an arena.");
+DEFINE_bool(cinn_ir_hash_cons_constants,
+            false,
+            "Whether the equal integer and float immediates created by lowering share one IR node.");
 
 namespace cinn {
 namespace hlir {
@@ -52,6 +69,38 @@ void AddAttrs(const absl::flat_hash_map<std::string, AttrType>& attrs_store,
   }
 }
 
+namespace {
+
+// Whether the variables of \p dtype can be created in the scope and read by the lowered functions.
+bool IsSupportedVarType(const Type& dtype) {
+  return dtype == Float(32) || dtype.is_float16() || dtype.is_bfloat16() || dtype.is_bool() || dtype == Int(32) ||
+         dtype == Int(8) || dtype == UInt(8);
+}
+
+// Bind the memory of the views in \p scope to the parts of the memory of the variables they view.
+void BindViewVars(const Scope& scope, const ViewVarMap& view_vars) {
+  absl::flat_hash_set<std::string> bound;
+  std::function<void(const std::string&)> bind = [&](const std::string& name) {
+    if (!bound.insert(name).second) return;
+    const auto& view = view_vars.at(name);
+    // the variable viewed may be a view as well, e.g. the output of a concat which is an input of another concat
+    if (view_vars.count(view.first)) bind(view.first);
+    auto tensor      = scope.GetTensor(name);
+    auto base        = scope.GetTensor(view.first)->get_buffer();
+    const auto& type = tensor->type();
+    size_t size      = tensor->shape().numel() * ((type.bits() + 7) / 8) * type.lanes();
+    CHECK(base->data()->memory) << "The memory of " << view.first << " viewed by " << name << " is not allocated";
+    CHECK_LE(view.second + size, base->data()->memory_size) << "The view " << name << " is out of " << view.first;
+    // the view keeps the buffer it views alive
+    tensor->get_buffer()->BindExternal(base->data()->memory + view.second, size, base->target(), base);
+  };
+  for (auto& item : view_vars) {
+    bind(item.first);
+  }
+}
+
+}  // namespace
+
 Program::Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_ptr<Instruction>>&& instrs)
     : scope_(scope) {
   for (auto& ins : instrs) {
@@ -63,6 +112,68 @@ Program::Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_pt
   }
 }
 
+Program::~Program() {
+  stop_compile_ = true;
+  WaitBackgroundCompile();
+}
+
+void Program::StartBackgroundCompile(const std::vector<std::string>& priority) {
+  CHECK(!compile_thread_.joinable()) << "The background compiling has started";
+  std::vector<std::shared_ptr<LazyKernel>> kernels;
+  std::unordered_set<LazyKernel*> visited;
+  for (auto* instrs : {&instrs_, &prerun_instrs_}) {
+    for (auto& ins : *instrs) {
+      auto& kernel = ins->lazy_kernel();
+      if (kernel && !kernel->compiled() && visited.insert(kernel.get()).second) {
+        kernels.push_back(kernel);
+      }
+    }
+  }
+  if (kernels.empty()) return;
+  absl::flat_hash_map<std::string, int> name2rank;
+  for (int i = 0; i < priority.size(); i++) {
+    name2rank.try_emplace(priority[i], i);
+  }
+  auto rank = [&](const std::shared_ptr<LazyKernel>& kernel) {
+    auto it = name2rank.find(kernel->name());
+    return it == name2rank.end() ? static_cast<int>(priority.size()) : it->second;
+  };
+  std::stable_sort(kernels.begin(), kernels.end(), [&](const auto& a, const auto& b) { return rank(a) < rank(b); });
+  VLOG(2) << "Compile " << kernels.size() << " lazy kernels in the background";
+  // the kernels are shared with the thread, so they outlive the instructions if being compiled
+  compile_thread_ = std::thread([this, kernels = std::move(kernels)] {
+    for (auto& kernel : kernels) {
+      if (stop_compile_) break;
+      kernel->Compile();
+    }
+  });
+}
+
+void Program::WaitBackgroundCompile() {
+  if (compile_thread_.joinable()) {
+    compile_thread_.join();
+  }
+}
+
+std::vector<std::string> Program::GetLazyCompileProfile() const {
+  std::vector<std::pair<int64_t, std::string>> runs;
+  std::unordered_set<LazyKernel*> visited;
+  for (auto* instrs : {&prerun_instrs_, &instrs_}) {
+    for (auto& ins : *instrs) {
+      auto& kernel = ins->lazy_kernel();
+      if (kernel && kernel->first_run() >= 0 && visited.insert(kernel.get()).second) {
+        runs.emplace_back(kernel->first_run(), kernel->name());
+      }
+    }
+  }
+  std::sort(runs.begin(), runs.end());
+  std::vector<std::string> profile;
+  for (auto& run : runs) {
+    profile.push_back(run.second);
+  }
+  return profile;
+}
+
 void Program::PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
   for (auto& ins : prerun_instrs_) {
     ins->Run(name2podargs);
@@ -209,6 +320,82 @@ void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podarg
 #endif
 }
 
+std::shared_ptr<Scope> Program::CreateExecutionScope(const std::vector<std::string>& feed_names) const {
+  // the variables sharing a buffer, e.g. the output of reshape, should share the new buffer as well
+  absl::flat_hash_set<const Buffer*> written_buffers;
+  for (auto& name : feed_names) {
+    written_buffers.insert(scope_->GetTensor(name)->get_buffer().get());
+  }
+  for (auto& ins : instrs_) {
+    if (ins->function_name() == "no_run") continue;
+    for (auto& out_args : ins->GetOutArgs()) {
+      for (auto& name : out_args) {
+        written_buffers.insert(scope_->GetTensor(name)->get_buffer().get());
+      }
+    }
+  }
+
+  // a view shares the memory with the variable it views, so they are written together
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto& item : view_vars_) {
+      const Buffer* view = scope_->GetTensor(item.first)->get_buffer().get();
+      const Buffer* base = scope_->GetTensor(item.second.first)->get_buffer().get();
+      if (written_buffers.count(view) != written_buffers.count(base)) {
+        written_buffers.insert(view);
+        written_buffers.insert(base);
+        changed = true;
+      }
+    }
+  }
+
+  auto scope = std::make_shared<Scope>();
+  absl::flat_hash_map<const Buffer*, std::shared_ptr<Buffer>> new_buffers;
+  for (auto& name : scope_->var_names()) {
+    auto src_tensor = scope_->GetTensor(std::string(name.data(), name.size()));
+    auto* var       = scope->Var<Tensor>(std::string(name.data(), name.size()));
+    auto& tensor    = absl::get<Tensor>(*var);
+    tensor->set_type(src_tensor->type());
+    const Buffer* src_buffer = src_tensor->get_buffer().get();
+    if (!written_buffers.count(src_buffer)) {
+      tensor->Resize(src_tensor->shape());
+      tensor->set_buffer(src_tensor->get_buffer());
+      continue;
+    }
+    auto& buffer = new_buffers[src_buffer];
+    if (!buffer) {
+      const auto& target = src_buffer->target();
+      // the Buffer doesn't free its memory by itself
+      buffer.reset(new Buffer(target), [](Buffer* x) {
+        x->Free();
+        delete x;
+      });
+      uint64_t size = src_buffer->data()->memory_size;
+      if (target == common::DefaultHostTarget()) {
+        buffer->ResizeLazy(1024, size);
+      } else {
+        buffer->ResizeLazy(size);
+      }
+    }
+    tensor->set_buffer(buffer);
+    tensor->Resize(src_tensor->shape());
+  }
+  BindViewVars(*scope, view_vars_);
+  VLOG(3) << "Create execution scope with " << new_buffers.size() << " new buffers";
+  return scope;
+}
+
+void Program::ExecuteInScope(const Scope& scope, void* stream) const {
+  for (auto& ins : instrs_) {
+    ins->RunInScope(scope, stream);
+  }
+#ifdef CINN_WITH_CUDA
+  if (instrs_[0]->target_.arch == Target::Arch::NVGPU && stream == nullptr) {
+    CUDA_CALL(cudaDeviceSynchronize());
+  }
+#endif
+}
+
 void Program::ExecuteTest(int repeat_) {
   cinn::utils::Timer timer1;
   for (int i = 0; i < 100; i++) {
@@ -275,6 +462,109 @@ const std::string& GraphCompiler::GetOrGenFullFuncName(const std::string& prefix
   return prefix2full_namemap_.at(prefix);
 }
 
+std::string GraphCompiler::GenGroupFuncName(const std::vector<Node*>& group) const {
+  CHECK(!group.empty());
+  if (group.size() == 1) {
+    return GenOpFuncName(group[0]);
+  }
+  std::string fuse_name = "fn_";
+  for (auto* node : group) {
+    fuse_name += node->id() + "_";
+  }
+  return fuse_name + "fused";
+}
+
+namespace {
+
+// print an attribute exactly, float attributes are printed in hex so that
+// different values never get the same signature
+struct AttrSignatureVisitor {
+  std::ostream& os;
+  explicit AttrSignatureVisitor(std::ostream& os) : os(os) {}
+
+  void operator()(bool v) { os << "b" << v; }
+  void operator()(int v) { os << "i" << v; }
+  void operator()(float v) { os << "f" << std::hexfloat << v << std::defaultfloat; }
+  void operator()(const std::string& v) { os << "s" << v.size() << ":" << v; }
+  template <typename T>
+  void operator()(const std::vector<T>& vs) {
+    os << "[";
+    for (const auto& v : vs) {
+      (*this)(static_cast<T>(v));
+      os << ",";
+    }
+    os << "]";
+  }
+};
+
+}  // namespace
+
+std::string GraphCompiler::GenGroupSignature(const std::vector<Node*>& group) const {
+  auto& shape_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  // number the variables in the order they are first used, so that only the
+  // topology of the group instead of the variable names is recorded
+  absl::flat_hash_map<const NodeData*, int> var_index;
+  std::stringstream ss;
+  auto print_var = [&](const NodeData* var) {
+    int index = var_index.try_emplace(var, static_cast<int>(var_index.size())).first->second;
+    ss << "%" << index << ":" << dtype_dict.at(var->id()) << "[" << utils::Join(shape_dict.at(var->id()), ",") << "]";
+    // fetched variables are kept as outputs instead of being inlined
+    if (fetch_var_ids_.count(var->id())) ss << "!";
+    ss << " ";
+  };
+  for (auto* node : group) {
+    ss << node->op()->name << "(";
+    for (auto& link : node->inlinks_in_order(true)) {
+      print_var(link->source()->safe_as<NodeData>());
+    }
+    ss << ") -> (";
+    for (auto& link : node->outlinks_in_order(true)) {
+      print_var(link->sink()->safe_as<NodeData>());
+    }
+    ss << ") {";
+    std::map<std::string, const AttrType*> sorted_attrs;
+    for (auto& attr : node->attrs.attr_store) {
+      sorted_attrs.emplace(attr.first, &attr.second);
+    }
+    AttrSignatureVisitor visitor(ss);
+    for (auto& attr : sorted_attrs) {
+      ss << attr.first << "=";
+      absl::visit(visitor, *attr.second);
+      ss << ";";
+    }
+    ss << "}\n";
+  }
+  return ss.str();
+}
+
+namespace {
+
+// create the placeholder of the input variable `id` of a node
+ir::Tensor CreateInputPlaceholder(const std::string& id, const shape_t& shape, const Type& dtype) {
+  CHECK(IsSupportedVarType(dtype)) << "The dtype " << dtype << " of node " << id << " is not implemented yet!";
+  std::vector<Expr> expr_shape;
+  for (int dim : shape) {
+    expr_shape.push_back(Expr(dim));
+  }
+  return lang::CreatePlaceHolder(expr_shape, dtype, id);
+}
+
+// compile the lowered functions into a module of their own, whose code is kept alive by the returned compiler
+std::shared_ptr<backends::Compiler> CompileModule(const Target& target,
+                                                  const std::vector<ir::LoweredFunc>& lowered_func,
+                                                  void* stream) {
+  ir::Module::Builder builder(UniqName("module"), target);
+  for (auto& func : lowered_func) {
+    builder.AddFunction(func);
+  }
+  std::shared_ptr<backends::Compiler> compiler = backends::Compiler::Create(target);
+  compiler->Build(builder.Build(), "", stream);
+  return compiler;
+}
+
+}  // namespace
+
 std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const Node* node) {
   auto& strategy   = Operator::GetAttrs<StrategyFunction>("CINNStrategy");
   auto& shape_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
@@ -287,16 +577,7 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const Node* node) {
     std::string input_id = i->source()->as<NodeData>()->id();
     auto in_shape        = shape_dict.at(input_id);
     Type dtype           = dtype_dict.at(input_id);
-    CHECK(dtype == Float(32) || dtype.is_bool() || dtype == Int(32))
-        << "The dtype of node " << input_id << " is not float or bool or int! Other dtype is not implemented yet.";
-    ir::Tensor temp;
-    if (dtype == Float(32)) {
-      temp = lang::Placeholder<float>(input_id, in_shape);
-    } else if (dtype.is_bool()) {
-      temp = lang::Placeholder<bool>(input_id, in_shape);
-    } else if (dtype == Int(32)) {
-      temp = lang::Placeholder<int>(input_id, in_shape);
-    }
+    ir::Tensor temp      = CreateInputPlaceholder(input_id, in_shape, dtype);
     inputs.push_back(temp);
     cinn_inputs.push_back(common::CINNValue(temp));
   }
@@ -361,8 +642,7 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const std::vector<Node*>&
   std::vector<ir::Tensor> inputs;
   std::vector<ir::Tensor> outputs;
   poly::StageMap stages;
-  int index             = 0;
-  std::string fuse_name = "fn_";
+  int index = 0;
   std::unordered_set<NodeData*> in_vars;
   std::unordered_set<NodeData*> out_vars;
   absl::flat_hash_map<NodeData*, Expr> temp_var_map;
@@ -373,7 +653,6 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const std::vector<Node*>&
     std::vector<ir::Tensor> temp_inputs;
     std::vector<common::CINNValue> cinn_inputs;
     std::vector<std::vector<int>> output_shapes;
-    fuse_name += node->id() + "_";
     for (auto& link : node->inlinks_in_order(true)) {
       auto source = link->source();
       CHECK(source);
@@ -388,16 +667,7 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const std::vector<Node*>&
         std::string input_id = source_data->id();
         auto in_shape        = shape_dict.at(input_id);
         Type dtype           = dtype_dict.at(input_id);
-        CHECK(dtype == Float(32) || dtype.is_bool() || dtype == Int(32))
-            << "The dtype of node " << input_id << " is not float or bool or int! Other dtype is not implemented yet.";
-        ir::Tensor temp_in;
-        if (dtype == Float(32)) {
-          temp_in = lang::Placeholder<float>(input_id, in_shape);
-        } else if (dtype.is_bool()) {
-          temp_in = lang::Placeholder<bool>(input_id, in_shape);
-        } else if (dtype == Int(32)) {
-          temp_in = lang::Placeholder<int>(input_id, in_shape);
-        }
+        ir::Tensor temp_in   = CreateInputPlaceholder(input_id, in_shape, dtype);
         inputs.push_back(temp_in);
         temp_inputs.push_back(temp_in);
         cinn_inputs.push_back(common::CINNValue(temp_in));
@@ -490,7 +760,7 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const std::vector<Node*>&
     }
     index++;
   }
-  fuse_name += "fused";
+  std::string fuse_name = GenGroupFuncName(nodes);
   VLOG(3) << "fuse_name: " << fuse_name;
   // args order: inputs + final output + fetch outputs + other no_fused outputs
   for (auto& tensor : outputs) {
@@ -608,44 +878,144 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   auto& edges      = std::get<1>(topo_order);
 
   auto& groups = graph_->groups;
-
-  if (!groups.empty()) {
-    for (int i = 0; i < groups.size(); i++) {
-      std::vector<ir::LoweredFunc> lowered_func;
-      if (groups[i].size() == 1) {
-        lowered_func = GetOpFunc(groups[i][0]);
-      } else {
-        lowered_func = GetOpFunc(groups[i]);
-      }
-      this->ProcessFunction(lowered_func);
-    }
-  } else {
+  if (groups.empty()) {
     VLOG(3) << "not run opfusion pass";
     for (auto& node : nodes) {
       auto op_node = node->safe_as<Node>();
       if (op_node) {
-        auto lowered_func = GetOpFunc(op_node);
-        this->ProcessFunction(lowered_func);
-        graph_->groups.push_back({op_node});
+        groups.push_back({op_node});
       }
     }
   }
 
+  // the attached code replaces the code of the whole module
+  bool lazy = options.lazy_compile && options.attached_code.empty();
+
+  // the lowering and compiling session creates and drops lots of IR nodes, the lowered functions of the lazy kernels
+  // are compiled and dropped on other threads, so they are not allocated from the arena of this thread
+  std::unique_ptr<ir::IrArenaScope> arena;
+  if (FLAGS_cinn_ir_arena && !lazy) {
+    arena = std::make_unique<ir::IrArenaScope>(FLAGS_cinn_ir_hash_cons_constants);
+  }
+
+  // the attached code replaces the code of the whole module
+  bool use_kernel_cache = KernelCache::Enabled() && options.attached_code.empty();
+  auto kernel_cache_key = [&](const std::string& signature) {
+    std::stringstream ss;
+    ss << target_ << "\n";
+    // a CUDA kernel runs on the stream it is compiled with
+    if (target_.arch == Target::Arch::NVGPU) ss << "stream " << stream << "\n";
+    // the LLVM options set by the `cinn_llvm_*` flags change the code of an x86 kernel
+    if (target_.arch == Target::Arch::X86) {
+      auto llvm_options = backends::OptimizeOptions::FromFlags();
+      ss << "fast_math " << llvm_options.fast_math << ", target_cpu " << llvm_options.target_cpu
+         << ", target_features " << llvm_options.target_features << ", vectorize_width "
+         << llvm_options.vectorize_width << ", interleave_count " << llvm_options.interleave_count << "\n";
+    }
+    ss << signature;
+    return ss.str();
+  };
+  // the keys and functions to add to the KernelCache, each of them is compiled into a module of its own so that a
+  // cached kernel keeps only its own code alive
+  std::vector<std::pair<std::string, ir::LoweredFunc>> kernels_to_cache;
+
+  int reused_num = 0, cached_num = 0, lowered_num = 0;
+  for (auto& group : groups) {
+    std::string signature;
+    if (FLAGS_cinn_reuse_identical_group_func || use_kernel_cache) {
+      signature = GenGroupSignature(group);
+    }
+    if (FLAGS_cinn_reuse_identical_group_func) {
+      auto it   = signature2func_name_.find(signature);
+      if (it != signature2func_name_.end()) {
+        // the instructions of this group look up their function by this name
+        prefix2full_namemap_[GenGroupFuncName(group)] = it->second;
+        VLOG(3) << "Group " << GenGroupFuncName(group) << " reuses function " << it->second;
+        reused_num++;
+        continue;
+      }
+    }
+    if (use_kernel_cache) {
+      KernelCache::Kernel kernel;
+      if (KernelCache::Global().Lookup(kernel_cache_key(signature), &kernel)) {
+        // the kernel was named by another graph compiler, so it may collide with a function of this one
+        std::string alias                             = UniqName("cached_fn");
+        prefix2full_namemap_[GenGroupFuncName(group)] = alias;
+        VLOG(3) << "Group " << GenGroupFuncName(group) << " uses the cached kernel " << kernel.fn_name << " as "
+                << alias;
+        if (FLAGS_cinn_reuse_identical_group_func) {
+          signature2func_name_.emplace(signature, alias);
+        }
+        cached_kernels_[alias] = std::move(kernel);
+        cached_num++;
+        continue;
+      }
+    }
+    lowered_num++;
+    std::vector<ir::LoweredFunc> lowered_func;
+    if (group.size() == 1) {
+      lowered_func = GetOpFunc(group[0]);
+    } else {
+      lowered_func = GetOpFunc(group);
+    }
+    // the arguments of the sub kernels are bound to the variables by name, so
+    // only a group lowered to a single function can be shared
+    std::string cache_key;
+    if (lowered_func.size() == 1) {
+      if (FLAGS_cinn_reuse_identical_group_func) {
+        signature2func_name_.emplace(signature, lowered_func[0]->name);
+      }
+      if (use_kernel_cache) {
+        cache_key = kernel_cache_key(signature);
+      }
+    }
+    if (lazy || cache_key.empty()) {
+      this->ProcessFunction(lowered_func);
+    }
+    if (lazy) {
+      auto kernel = CreateLazyKernel(GenGroupFuncName(group), lowered_func, cache_key, stream);
+      for (auto& func : lowered_func) {
+        lazy_kernels_[func->name] = kernel;
+      }
+    } else if (!cache_key.empty()) {
+      kernels_to_cache.emplace_back(std::move(cache_key), lowered_func[0]);
+    }
+  }
+  VLOG(2) << reused_num << " of " << groups.size() << " groups reuse the function of an identical group";
+  if (use_kernel_cache) {
+    auto stats = KernelCache::Global().GetStats();
+    VLOG(2) << cached_num << " of " << groups.size() << " groups use the cached kernels, the kernel cache has "
+            << stats.size << " kernels and a hit rate " << stats.HitRate();
+  }
+
   // compile the module
   if (!compiler_) {
     compiler_ = backends::Compiler::Create(target_);
   }
 
-  auto build_module = m_builder_.Build();
+  // all the groups may use the cached kernels, and the lazy kernels and the kernels to cache are compiled in their own
+  // modules
+  if (!lazy && lowered_num > static_cast<int>(kernels_to_cache.size())) {
+    auto build_module = m_builder_.Build();
 
-  if (this->target_.arch == Target::Arch::X86) {
-    CodeGenCX86 codegen(this->target_, CodeGenCX86::Feature::AVX512);
-    codegen.SetInlineBuiltinCodes(false);
-    auto out = codegen.Compile(build_module, CodeGenC::OutputKind::CImpl);
-    VLOG(3) << "[X86] C Code is:\n" << out;
-  }
+    if (this->target_.arch == Target::Arch::X86) {
+      CodeGenCX86 codegen(this->target_, CodeGenCX86::Feature::AVX512);
+      codegen.SetInlineBuiltinCodes(false);
+      auto out = codegen.Compile(build_module, CodeGenC::OutputKind::CImpl);
+      VLOG(3) << "[X86] C Code is:\n" << out;
+    }
 
-  compiler_->Build(build_module, options.attached_code, stream);
+    compiler_->Build(build_module, options.attached_code, stream);
+  }
+  for (auto& item : kernels_to_cache) {
+    const auto& fn_name = item.second->name;
+    auto compiler       = CompileModule(target_, {item.second}, stream);
+    KernelCache::Kernel kernel{compiler, fn_name, compiler->Lookup(fn_name)};
+    CHECK(kernel.fn) << "Function " << fn_name << " is not compiled";
+    KernelCache::Global().Insert(item.first, kernel);
+    cached_kernels_[fn_name] = std::move(kernel);
+  }
+  arena.reset();
   auto instructions = BuildInstructions();
   RemoveInvalidVariables(instructions);
   if (options.with_buffer_handle_instruction_inserted) {
@@ -656,6 +1026,7 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   if (options.with_instantiate_variables) {
     VLOG(3) << "Initantiate all variables on compile-time";
     // All variables reside in scope_, so traverse it to instantiate each one
+    auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
     for (auto& name : scope_->var_names()) {
       auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
       auto& tensor = absl::get<Tensor>(*var);
@@ -665,17 +1036,175 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
         auto& src_tensor  = absl::get<Tensor>(*src_var);
         VLOG(3) << name << " shares buffer with " << src_var_name;
         tensor->set_buffer(src_tensor->get_buffer());
+      } else if (view_vars_map_.count(name)) {
+        // bound after the memory of all the other variables is allocated
+        tensor->set_type(dtype_dict.at(name));
+      } else if (dtype_dict.count(name)) {
+        tensor->mutable_data(target_, dtype_dict.at(name));
       } else {
         tensor->mutable_data<float>(target_);
       }
     }
+    BindViewVars(*scope_, view_vars_map_);
   }
 
   GraphCompiler::CompilationResult result;
   result.runtime_program.reset(new Program(scope_, std::move(instructions)));
+  if (options.with_instantiate_variables) {
+    result.runtime_program->SetViewVars(view_vars_map_);
+  }
+  // a CUDA module is loaded into the context of the thread compiling it
+  if (lazy && options.background_compile && target_.arch == Target::Arch::X86) {
+    result.runtime_program->StartBackgroundCompile(options.lazy_compile_order);
+  }
   return result;
 }
 
+std::shared_ptr<LazyKernel> GraphCompiler::CreateLazyKernel(const std::string& name,
+                                                            const std::vector<ir::LoweredFunc>& lowered_func,
+                                                            const std::string& cache_key,
+                                                            void* stream) {
+  auto compile = [target = target_, lowered_func, cache_key, stream]() {
+    auto compiler = CompileModule(target, lowered_func, stream);
+    LazyKernel::Functions functions;
+    for (auto& func : lowered_func) {
+      auto* fn = compiler->Lookup(func->name);
+      CHECK(fn) << "Function " << func->name << " is not compiled";
+      functions.fns[func->name] = fn;
+    }
+    if (!cache_key.empty()) {
+      const auto& fn_name = lowered_func[0]->name;
+      KernelCache::Global().Insert(cache_key, {compiler, fn_name, functions.fns.at(fn_name)});
+    }
+    functions.owner = std::move(compiler);
+    return functions;
+  };
+  return std::make_shared<LazyKernel>(name, std::move(compile));
+}
+
+bool GraphCompiler::AddViewVars(const Node* node) {
+  auto& shape_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& inlinks    = node->inlinks_in_order();
+  auto& outlinks   = node->outlinks_in_order();
+  if (inlinks.empty() || outlinks.size() != 1U) return false;
+  const auto* out_data = outlinks[0]->sink()->safe_as<NodeData>();
+  const auto& out_id   = out_data->id();
+  const auto& shape    = shape_dict.at(out_id);
+
+  auto type_bytes = [&](const std::string& id) {
+    const auto& type = dtype_dict.at(id);
+    return static_cast<uint64_t>((type.bits() + 7) / 8 * type.lanes());
+  };
+  auto num_bytes = [&](const std::string& id) {
+    const auto& dims = shape_dict.at(id);
+    return std::accumulate(dims.begin(), dims.end(), uint64_t(1), std::multiplies<uint64_t>()) * type_bytes(id);
+  };
+  // the output of a pre_run instruction is only computed in the scope of the program, an execution scope shares its
+  // memory instead of computing it again
+  auto is_pre_run = [](const NodeData* data) {
+    auto& attrs = data->source_node->attrs.attr_store;
+    return attrs.count("pre_run") && absl::get<bool>(attrs.at("pre_run"));
+  };
+  // the memory of a variable is only rebound once, it can't be a feed or a weight whose memory may be bound to the
+  // external memory later, a constant computed by pre_run, nor share the buffer with the output of reshape
+  auto can_bind = [&](const NodeData* data) {
+    if (!data->source_node.get() || data->is_const() || is_pre_run(data) || view_vars_map_.count(data->id())) {
+      return false;
+    }
+    for (auto& item : reuse_vars_map_) {
+      if (item.first == data->id() || item.second == data->id()) return false;
+    }
+    return true;
+  };
+  // the generated host code assumes the memory of every buffer argument is aligned
+  auto is_aligned = [](uint64_t offset) { return offset % Buffer::kMinHostAlignment == 0; };
+
+  if (node->op()->name == "concat") {
+    int axis = 0;
+    if (node->attrs.attr_store.count("axis")) {
+      axis = absl::get<int>(node->attrs.attr_store.at("axis"));
+    }
+    if (axis < 0) axis += shape.size();
+    // the inputs are contiguous parts of the output only if the dimensions before the axis are all 1
+    for (int i = 0; i < axis; i++) {
+      if (shape[i] != 1) return false;
+    }
+    std::vector<std::pair<std::string, uint64_t>> views;
+    absl::flat_hash_set<std::string> in_ids;
+    uint64_t offset = 0;
+    for (auto& link : inlinks) {
+      const auto* in_data = link->source()->safe_as<NodeData>();
+      if (!can_bind(in_data) || !in_ids.insert(in_data->id()).second || !is_aligned(offset)) return false;
+      views.emplace_back(in_data->id(), offset);
+      offset += num_bytes(in_data->id());
+    }
+    for (auto& view : views) {
+      VLOG(3) << view.first << " is a view of " << out_id << " at byte " << view.second;
+      view_vars_map_[view.first] = {out_id, view.second};
+    }
+    return true;
+  }
+
+  CHECK_EQ(node->op()->name, "slice");
+  const auto* in_data = inlinks[0]->source()->safe_as<NodeData>();
+  // the memory of the output of reshape may be a feed's
+  if (!can_bind(out_data) || !in_data->source_node.get() || in_data->is_const() || is_pre_run(in_data) ||
+      reuse_vars_map_.count(in_data->id())) {
+    return false;
+  }
+  const auto& in_shape = shape_dict.at(in_data->id());
+  if (in_shape.size() != shape.size()) return false;
+  std::vector<int> starts(in_shape.size(), 0);
+  auto slice_starts = absl::get<std::vector<int>>(node->attrs.attr_store.at("starts"));
+  std::vector<int> axes;
+  if (node->attrs.attr_store.count("axes")) {
+    axes = absl::get<std::vector<int>>(node->attrs.attr_store.at("axes"));
+  } else {
+    for (int i = 0; i < slice_starts.size(); i++) axes.push_back(i);
+  }
+  for (int i = 0; i < axes.size(); i++) {
+    int start = slice_starts[i] < 0 ? slice_starts[i] + in_shape[axes[i]] : slice_starts[i];
+    starts[axes[i]] = std::min(std::max(start, 0), in_shape[axes[i]]);
+  }
+  // the output is a contiguous part of the input only if the dimensions after the first one larger than 1 are not
+  // sliced
+  int first = 0;
+  while (first < shape.size() && shape[first] == 1) first++;
+  for (int i = first + 1; i < shape.size(); i++) {
+    if (shape[i] != in_shape[i]) return false;
+  }
+  uint64_t offset = 0, stride = type_bytes(out_id);
+  for (int i = in_shape.size() - 1; i >= 0; i--) {
+    offset += starts[i] * stride;
+    stride *= in_shape[i];
+  }
+  if (!is_aligned(offset)) return false;
+  VLOG(3) << out_id << " is a view of " << in_data->id() << " at byte " << offset;
+  view_vars_map_[out_id] = {in_data->id(), offset};
+  return true;
+}
+
+void GraphCompiler::SetFunc(Instruction* instr, const std::string& func_name) {
+  auto it = lazy_kernels_.find(func_name);
+  if (it != lazy_kernels_.end()) {
+    instr->SetLoweredFunc(nullptr, func_name);
+    instr->SetLazyKernel(it->second);
+    return;
+  }
+  auto* fn = LookupFunc(func_name);
+  CHECK(fn) << "Function " << func_name << " is not compiled";
+  instr->SetLoweredFunc(fn, func_name);
+}
+
+lower_func_ptr_t GraphCompiler::LookupFunc(const std::string& func_name) {
+  auto it = cached_kernels_.find(func_name);
+  if (it != cached_kernels_.end()) {
+    return it->second.fn;
+  }
+  return compiler_->Lookup(func_name);
+}
+
 void GraphCompiler::SetSubKernels(Instruction* instr, const std::string& func_name) {
   int i                   = 1;
   std::string new_op_func = func_name + "_" + std::to_string(i);
@@ -685,9 +1214,7 @@ void GraphCompiler::SetSubKernels(Instruction* instr, const std::string& func_na
     instr->AddOutArgs(function2output_args_[func_name]);
   }
   while (function2input_args_.count(new_op_func) != 0) {
-    auto* fn2 = compiler_->Lookup(new_op_func);
-    CHECK(fn2);
-    instr->SetLoweredFunc(fn2, new_op_func);
+    SetFunc(instr, new_op_func);
     instr->AddInArgs(function2input_args_[new_op_func]);
     instr->AddOutArgs(function2output_args_[new_op_func]);
     i++;
@@ -716,6 +1243,11 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
         std::string out_id      = outlinks[0]->sink()->safe_as<NodeData>()->id();
         reuse_vars_map_[out_id] = in_id;
         instr_name              = "no_run";
+      } else if ((instr_name == "concat" || instr_name == "slice") && compile_options_.with_instantiate_variables &&
+                 AddViewVars(node)) {
+        // the producers of the inputs of concat write the output directly, and the output of slice is read from
+        // the input in place
+        instr_name = "no_run";
       }
       auto instr = std::unique_ptr<Instruction>(
           new Instruction(target_, scope_.get(), OpGetInputNames(node), OpGetOutputNames(node), instr_name));
@@ -856,9 +1388,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
         }
       }
       std::string op_func_name = GetOrGenFullFuncName(GenOpFuncName(node));
-      auto* fn                 = compiler_->Lookup(op_func_name);
-      CHECK(fn);
-      instr->SetLoweredFunc(fn, op_func_name);
+      SetFunc(instr.get(), op_func_name);
 
       // As some instruction like reduce, will generate more than one kernel.
       // So try to find the rest kernel, if it exist.
@@ -874,12 +1404,10 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
       std::vector<std::string> inputNames;
       std::vector<std::string> outputNames;
       std::unordered_set<std::string> names_set;
-      int count             = 0;
-      std::string fuse_name = "fn_";
+      int count = 0;
       for (int i = 0; i < group.size(); i++) {
         auto node = group[i];
         CHECK(node);
-        fuse_name += node->id() + "_";
         auto temp_inputnames = OpGetInputNames(node);
         for (int j = 0; j < temp_inputnames.size(); j++) {
           if (!names_set.count(temp_inputnames[j])) {
@@ -906,7 +1434,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
           }
         }
       }
-      fuse_name += "fused";
+      std::string fuse_name = GenGroupFuncName(group);
       VLOG(3) << "In buildInstructions, fuse_name is : " << fuse_name;
       VLOG(3) << "input_names: " << utils::Join(inputNames, ", ");
       VLOG(3) << "out_names: " << utils::Join(outputNames, ", ");
@@ -914,9 +1442,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
       auto instr =
           std::unique_ptr<Instruction>(new Instruction(target_, scope_.get(), inputNames, outputNames, fuse_name));
 
-      auto* fn = compiler_->Lookup(fuse_name);
-      CHECK(fn);
-      instr->SetLoweredFunc(fn, fuse_name);
+      SetFunc(instr.get(), fuse_name);
       // As some situation like reduce,will generate more than one kernel.
       // So try to find the rest kernel, if it exist.
       SetSubKernels(instr.get(), fuse_name);
@@ -1095,9 +1621,10 @@ std::shared_ptr<Scope> BuildScope(Target target, const std::shared_ptr<Graph>& g
     }
     VLOG(3) << "Tensor [" << iter.first << "] resize to " << utils::Join(shape, ",");
     tensor->Resize(Shape{shape});
-    CHECK(dtype_dict.at(iter.first) == Float(32) || dtype_dict.at(iter.first).is_bool() ||
-          dtype_dict.at(iter.first) == Int(32))
-        << "The dtype of node " << iter.first << " is not float or bool or int! Other dtype is not implemented yet.";
+    const auto& dtype = dtype_dict.at(iter.first);
+    CHECK(IsSupportedVarType(dtype)) << "The dtype " << dtype << " of node " << iter.first
+                                     << " is not implemented yet!";
+    tensor->set_type(dtype);
   }
   return scope;
 }
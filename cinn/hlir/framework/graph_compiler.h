@@ -16,9 +16,11 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -28,6 +30,7 @@
 #include "cinn/common/macros.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/kernel_cache.h"
 #include "cinn/hlir/framework/op_strategy.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/ir/lowered_func.h"
@@ -38,6 +41,10 @@ namespace cinn {
 namespace hlir {
 namespace framework {
 
+//! Map a variable whose memory is a part of the memory of another variable, e.g. an input of concat, to the name of
+//! that variable and the byte offset of the part.
+using ViewVarMap = absl::flat_hash_map<std::string, std::pair<std::string, uint64_t>>;
+
 /**
  * The Program is the runtime instance for running a computation.
  */
@@ -50,6 +57,9 @@ class Program {
    */
   Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_ptr<Instruction>>&& instrs);
 
+  //! Stop the background compiling and wait for the kernel being compiled.
+  ~Program();
+
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr);
 
   void Export(const std::vector<std::string>& persistent_vars, const std::string& filename);
@@ -61,11 +71,43 @@ class Program {
 
   void ExecuteTest(int repeat_);
 
+  /**
+   * Create a scope to execute the program in by ExecuteInScope. The variables which are written by the program or
+   * fed by \p feed_names get new memory, the others, e.g. the weights, share the memory with the program's scope.
+   */
+  std::shared_ptr<Scope> CreateExecutionScope(const std::vector<std::string>& feed_names) const;
+
+  /**
+   * Execute the program with the variables in \p scope created by CreateExecutionScope. It can be called from many
+   * threads at the same time with different scopes.
+   */
+  void ExecuteInScope(const Scope& scope, void* stream = nullptr) const;
+
   /**
    * Get the number of instructions.
    */
   size_t size() const { return instrs_.size(); }
 
+  /**
+   * Compile the lazy kernels of the instructions in a background thread, the ones named in \p priority first, then the
+   * others in the order of the instructions. The instructions running before their kernels are compiled in the
+   * background compile them by themselves.
+   */
+  void StartBackgroundCompile(const std::vector<std::string>& priority = {});
+
+  //! Wait until the background compiling finishes.
+  void WaitBackgroundCompile();
+
+  /**
+   * Get the names of the lazy kernels which have run, in the order of their first runs. It can be passed to the
+   * `lazy_compile_order` of the GraphCompiler compiling the same graph later, so that the kernels in the hot path
+   * are compiled first.
+   */
+  std::vector<std::string> GetLazyCompileProfile() const;
+
+  //! Set the views created by the GraphCompiler, which are kept in the scopes created by CreateExecutionScope.
+  void SetViewVars(const ViewVarMap& view_vars) { view_vars_ = view_vars; }
+
   const std::vector<std::unique_ptr<Instruction>>& GetPreRunInstructions() { return prerun_instrs_; }
   const std::vector<std::unique_ptr<Instruction>>& GetRunInstructions() { return instrs_; }
 
@@ -76,6 +118,10 @@ class Program {
   std::vector<std::unique_ptr<Instruction>> prerun_instrs_;
   // only runtime instructions
   std::vector<std::unique_ptr<Instruction>> instrs_;
+  ViewVarMap view_vars_;
+
+  std::thread compile_thread_;
+  std::atomic<bool> stop_compile_{false};
 };
 
 /**
@@ -94,12 +140,19 @@ class GraphCompiler final {
     std::string attached_code                    = "";
     bool with_instantiate_variables              = false;
     bool with_buffer_handle_instruction_inserted = false;
+    // lower the groups in Build, but compile their kernels on the first run instead
+    bool lazy_compile                            = false;
+    // compile the lazy kernels in a background thread after Build, only on x86
+    bool background_compile                      = true;
+    // the names of the lazy kernels to compile first in the background, e.g. Program::GetLazyCompileProfile()
+    std::vector<std::string> lazy_compile_order;
   };
 
   // Compile with a packing option and result, to be extended easily.
   CompilationResult Build(const CompileOptions& options,
                           std::unordered_set<std::string>&& fetch_var_ids = {},
                           void* stream                                    = nullptr);
+  // the kernels taken from the KernelCache or compiled lazily are not in the exported object
   void ExportObject(const std::string& path) { compiler_->ExportObject(path); }
 
   std::unique_ptr<Program> Build(const std::string& code = "");
@@ -117,6 +170,13 @@ class GraphCompiler final {
 
   std::string GenOpFuncName(const Node* node) const { return "fn_" + node->id(); }
 
+  std::string GenGroupFuncName(const std::vector<Node*>& group) const;
+
+  // describe what a group computes: the op types, attributes, dtypes and shapes of its nodes
+  // and how they are connected, but not the names of its variables, so that the groups with
+  // the same signature can share one compiled function
+  std::string GenGroupSignature(const std::vector<Node*>& group) const;
+
   // append a unique number at the end of the function name to distinguish
   // different functions from graphs whose structures are same
   const std::string& GetOrGenFullFuncName(const std::string& prefix);
@@ -145,9 +205,23 @@ class GraphCompiler final {
   // applying on variables after no instruction will use them anymore
   void InsertBufferHandlers(std::vector<std::unique_ptr<Instruction>>* instructions);
 
+  // make the inputs of a concat views of its output, or the output of a slice a view of its input, when they are
+  // contiguous and aligned parts of the memory, then the node needn't run. Returns false if the node should run.
+  bool AddViewVars(const Node* node);
+
  private:
   void ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_func);
   void SetSubKernels(Instruction* instr, const std::string& func_name);
+  // find a function compiled by this compiler or taken from the KernelCache
+  lower_func_ptr_t LookupFunc(const std::string& func_name);
+  // set the function to the instruction, or the lazy kernel compiling it in the lazy mode
+  void SetFunc(Instruction* instr, const std::string& func_name);
+  // create the lazy kernel compiling the functions of a group in their own module, and add it to the KernelCache
+  // with \p cache_key if it is not empty
+  std::shared_ptr<LazyKernel> CreateLazyKernel(const std::string& name,
+                                               const std::vector<ir::LoweredFunc>& lowered_func,
+                                               const std::string& cache_key,
+                                               void* stream);
   Target target_;
   std::shared_ptr<Graph> graph_;
   std::shared_ptr<Scope> scope_;
@@ -159,10 +233,19 @@ class GraphCompiler final {
   std::unordered_set<std::string> fetch_var_ids_;
 
   absl::flat_hash_map<std::string, std::string> prefix2full_namemap_;
+  // map a group signature to the name of the function lowered from it
+  absl::flat_hash_map<std::string, std::string> signature2func_name_;
   // map dst reuse var to the src var sharing buffer
   absl::flat_hash_map<std::string, std::string> reuse_vars_map_;
+  // map a var to the var whose memory it is a part of
+  ViewVarMap view_vars_map_;
+
+  // map the unique alias of a function taken from the KernelCache, or the name of a function added to it, to the kernel
+  absl::flat_hash_map<std::string, KernelCache::Kernel> cached_kernels_;
+  // map the name of a function to the lazy kernel compiling it in the lazy mode
+  absl::flat_hash_map<std::string, std::shared_ptr<LazyKernel>> lazy_kernels_;
 
-  std::unique_ptr<backends::Compiler> compiler_;
+  std::shared_ptr<backends::Compiler> compiler_;
   CompileOptions compile_options_;
 
   ir::Module::Builder m_builder_;
@@ -14,13 +14,20 @@
 
 #include "cinn/hlir/framework/graph_compiler.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <functional>
+
 #include "cinn/frontend/net_builder.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/string.h"
+
+DECLARE_int32(cinn_kernel_cache_capacity);
 
 namespace cinn {
 namespace hlir {
@@ -114,6 +121,270 @@ TEST(GraphCompilerTest, TestInsertBufferHandlers) {
             used_variable_names);
 }
 
+TEST(GraphCompilerTest, TestReuseIdenticalGroupFunc) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {4, 16}, "A");
+  auto b = builder.CreateInput(Float(32), {4, 16}, "B");
+  auto c = builder.CreateInput(Float(32), {4, 16}, "C");
+  // the two add + relu pairs only differ in variable names, the last relu has another shape
+  auto d      = builder.Relu(builder.ElementwiseAdd(a, b));
+  auto e      = builder.Relu(builder.ElementwiseAdd(d, c));
+  builder.Relu(builder.ReduceSum(e, {1}));
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  auto scope  = BuildScope(target, graph);
+
+  // without OpFusion every op is a group
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program     = gc.Build();
+  const auto& instructions = runtime_program->GetRunInstructions();
+  ASSERT_EQ(instructions.size(), 6);
+  EXPECT_EQ(instructions[0]->GetFnNames(), instructions[2]->GetFnNames());
+  EXPECT_EQ(instructions[1]->GetFnNames(), instructions[3]->GetFnNames());
+  EXPECT_NE(instructions[0]->GetFnNames(), instructions[1]->GetFnNames());
+  EXPECT_NE(instructions[1]->GetFnNames(), instructions[5]->GetFnNames());
+
+  std::vector<std::vector<float>> inputs(3, std::vector<float>(64));
+  for (int k = 0; k < 3; k++) {
+    auto* data = scope->GetTensor(std::string(1, 'A' + k))->mutable_data<float>(target);
+    for (int i = 0; i < 64; i++) {
+      inputs[k][i] = data[i] = static_cast<float>((i * 7 + k * 5) % 13) - 6.f;
+    }
+  }
+  runtime_program->Execute();
+
+  auto* d_data = scope->GetTensor(d->id)->data<float>();
+  auto* e_data = scope->GetTensor(e->id)->data<float>();
+  for (int i = 0; i < 64; i++) {
+    float d_ref = std::max(inputs[0][i] + inputs[1][i], 0.f);
+    ASSERT_FLOAT_EQ(d_data[i], d_ref);
+    ASSERT_FLOAT_EQ(e_data[i], std::max(d_ref + inputs[2][i], 0.f));
+  }
+}
+
+TEST(GraphCompilerTest, TestKernelCache) {
+  gflags::FlagSaver flag_saver;
+  auto target      = common::DefaultHostTarget();
+  auto build_graph = [&](int batch) {
+    frontend::NetBuilder builder("test");
+    auto a = builder.CreateInput(Float(32), {batch, 16}, "A");
+    auto b = builder.CreateInput(Float(32), {batch, 16}, "B");
+    auto c = builder.Relu(builder.ElementwiseAdd(a, b));
+    return std::make_pair(std::make_shared<Graph>(builder.Build(), target), c->id);
+  };
+  KernelCache::Global().Clear();
+
+  // the second compiler takes both kernels from the cache instead of compiling them
+  std::vector<std::unique_ptr<Program>> programs;
+  for (int k = 0; k < 2; k++) {
+    auto graph_out = build_graph(4);
+    auto scope     = BuildScope(target, graph_out.first);
+    GraphCompiler gc(target, scope, graph_out.first);
+    programs.push_back(gc.Build());
+    auto* a_data = scope->GetTensor("A")->mutable_data<float>(target);
+    auto* b_data = scope->GetTensor("B")->mutable_data<float>(target);
+    for (int i = 0; i < 64; i++) {
+      a_data[i] = static_cast<float>((i * 7) % 13) - 6.f;
+      b_data[i] = static_cast<float>(k);
+    }
+    programs.back()->Execute();
+    auto* out_data = scope->GetTensor(graph_out.second)->data<float>();
+    for (int i = 0; i < 64; i++) {
+      ASSERT_FLOAT_EQ(out_data[i], std::max(a_data[i] + b_data[i], 0.f));
+    }
+  }
+  auto stats = KernelCache::Global().GetStats();
+  EXPECT_EQ(stats.misses, 2UL);
+  EXPECT_EQ(stats.hits, 2UL);
+  EXPECT_EQ(stats.size, 2UL);
+  const auto& instrs0 = programs[0]->GetRunInstructions();
+  const auto& instrs1 = programs[1]->GetRunInstructions();
+  ASSERT_EQ(instrs0.size(), instrs1.size());
+  for (size_t i = 0; i < instrs0.size(); i++) {
+    // the cached kernels are looked up by a unique alias in the second compiler
+    auto fn_names = instrs1[i]->GetFnNames();
+    ASSERT_EQ(fn_names.size(), 1UL);
+    EXPECT_TRUE(utils::Startswith(fn_names[0], "cached_fn")) << fn_names[0];
+    EXPECT_NE(fn_names, instrs0[i]->GetFnNames());
+  }
+
+  // the programs own the kernels they use
+  KernelCache::Global().Clear();
+  for (auto& program : programs) {
+    program->Execute();
+  }
+
+  // only the most recently used kernel is kept
+  FLAGS_cinn_kernel_cache_capacity = 1;
+  auto graph_out                   = build_graph(8);
+  GraphCompiler gc(target, BuildScope(target, graph_out.first), graph_out.first);
+  gc.Build();
+  stats = KernelCache::Global().GetStats();
+  EXPECT_EQ(stats.misses, 2UL);
+  EXPECT_EQ(stats.size, 1UL);
+  EXPECT_EQ(stats.evictions, 1UL);
+  KernelCache::Global().Clear();
+}
+
+TEST(GraphCompilerTest, TestLazyCompile) {
+  gflags::FlagSaver flag_saver;
+  frontend::NetBuilder builder("test");
+  auto a      = builder.CreateInput(Float(32), {4, 16}, "A");
+  auto b      = builder.CreateInput(Float(32), {4, 16}, "B");
+  auto c      = builder.Relu(builder.ElementwiseAdd(a, b));
+  auto d      = builder.ReduceSum(c, {1});
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  // the kernels taken from the cache are not lazy
+  FLAGS_cinn_kernel_cache_capacity = 0;
+
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  options.lazy_compile               = true;
+  options.background_compile         = false;
+  auto scope                         = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program     = gc.Build(options).runtime_program;
+  const auto& instructions = runtime_program->GetRunInstructions();
+  ASSERT_EQ(instructions.size(), 3);
+  for (auto& instr : instructions) {
+    ASSERT_NE(instr->lazy_kernel(), nullptr);
+    EXPECT_FALSE(instr->lazy_kernel()->compiled());
+  }
+  EXPECT_TRUE(runtime_program->GetLazyCompileProfile().empty());
+
+  auto* a_data = scope->GetTensor("A")->mutable_data<float>(target);
+  auto* b_data = scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < 64; i++) {
+    a_data[i] = static_cast<float>((i * 7) % 13) - 6.f;
+    b_data[i] = 1.f;
+  }
+  runtime_program->Execute();
+  auto* d_data = scope->GetTensor(d->id)->data<float>();
+  for (int i = 0; i < 4; i++) {
+    float sum = 0.f;
+    for (int j = 0; j < 16; j++) {
+      sum += std::max(a_data[i * 16 + j] + b_data[i * 16 + j], 0.f);
+    }
+    ASSERT_FLOAT_EQ(d_data[i], sum);
+  }
+  auto profile = runtime_program->GetLazyCompileProfile();
+  ASSERT_EQ(profile.size(), instructions.size());
+  for (size_t i = 0; i < profile.size(); i++) {
+    EXPECT_EQ(profile[i], instructions[i]->lazy_kernel()->name());
+  }
+
+  // compile the kernels in the background, in the order of the profile
+  options.background_compile = true;
+  options.lazy_compile_order = profile;
+  GraphCompiler gc_background(target, scope, graph);
+  auto background_program = gc_background.Build(options).runtime_program;
+  background_program->WaitBackgroundCompile();
+  for (auto& instr : background_program->GetRunInstructions()) {
+    EXPECT_TRUE(instr->lazy_kernel()->compiled());
+  }
+  EXPECT_TRUE(background_program->GetLazyCompileProfile().empty());
+}
+
+TEST(GraphCompilerTest, TestConcatSliceViews) {
+  frontend::NetBuilder builder("test");
+  auto a      = builder.CreateInput(Float(32), {1, 8, 4}, "A");
+  auto b      = builder.CreateInput(Float(32), {1, 4, 4}, "B");
+  auto relu_a = builder.Relu(a);
+  auto relu_b = builder.Relu(b);
+  auto c      = builder.Concat({relu_a, relu_b}, 1);
+  auto d      = builder.Slice(c, {1}, {4}, {12});
+  auto e      = builder.Relu(d);
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  auto scope  = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  // relu writes into the concat output, and the slice output is a part of it, so neither concat nor slice runs
+  int num_no_run = 0;
+  for (auto& instr : runtime_program->GetRunInstructions()) {
+    if (instr->function_name() == "no_run") num_no_run++;
+  }
+  ASSERT_EQ(num_no_run, 2);
+  auto* c_memory = scope->GetTensor(c->id)->buffer()->memory;
+  ASSERT_EQ(scope->GetTensor(relu_a->id)->buffer()->memory, c_memory);
+  ASSERT_EQ(scope->GetTensor(relu_b->id)->buffer()->memory, c_memory + 8 * 4 * sizeof(float));
+  ASSERT_EQ(scope->GetTensor(d->id)->buffer()->memory, c_memory + 4 * 4 * sizeof(float));
+
+  auto run_and_check = [&](const Scope& run_scope, float bias, const std::function<void()>& run) {
+    std::vector<float> concat;
+    for (auto name : {"A", "B"}) {
+      auto tensor = run_scope.GetTensor(name);
+      auto* data  = tensor->mutable_data<float>(target);
+      for (int i = 0; i < tensor->shape().numel(); i++) {
+        data[i] = static_cast<float>((i * 7) % 13) - 6.f + bias;
+        concat.push_back(data[i]);
+      }
+    }
+    run();
+    auto* e_data = run_scope.GetTensor(e->id)->data<float>();
+    for (int i = 0; i < 32; i++) {
+      ASSERT_FLOAT_EQ(e_data[i], std::max(concat[16 + i], 0.f));
+    }
+  };
+  run_and_check(*scope, 0.f, [&] { runtime_program->Execute(); });
+  // the views of an execution scope are in its own memory
+  auto exec_scope = runtime_program->CreateExecutionScope({"A", "B"});
+  ASSERT_EQ(exec_scope->GetTensor(relu_a->id)->buffer()->memory, exec_scope->GetTensor(c->id)->buffer()->memory);
+  ASSERT_NE(exec_scope->GetTensor(c->id)->buffer()->memory, c_memory);
+  run_and_check(*exec_scope, 3.f, [&] { runtime_program->ExecuteInScope(*exec_scope); });
+}
+
+TEST(GraphCompilerTest, TestConcatPreRunInput) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {1, 8, 4}, "A");
+  auto w = builder.CreateInput(Float(32), {1, 4, 4}, "W");
+  w.set_const(true);
+  auto relu_a = builder.Relu(a);
+  // computed once by PreRun in the scope of the program
+  auto relu_w = builder.Relu(w);
+  auto c      = builder.Concat({relu_a, relu_w}, 1);
+  auto e      = builder.Relu(c);
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  ApplyPass(graph.get(), "ConstPropagate");
+  auto scope = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  ASSERT_EQ(runtime_program->GetPreRunInstructions().size(), 1UL);
+  // the constant is not a view of the concat output, which is written by every execution scope, so concat runs
+  auto* c_memory = scope->GetTensor(c->id)->buffer()->memory;
+  ASSERT_NE(scope->GetTensor(relu_w->id)->buffer()->memory, c_memory + 8 * 4 * sizeof(float));
+  for (auto& instr : runtime_program->GetRunInstructions()) {
+    ASSERT_NE(instr->function_name(), "no_run");
+  }
+
+  auto fill = [&](const Scope& run_scope, const std::string& name, float bias) {
+    auto tensor = run_scope.GetTensor(name);
+    auto* data  = tensor->mutable_data<float>(target);
+    std::vector<float> values;
+    for (int i = 0; i < tensor->shape().numel(); i++) {
+      data[i] = static_cast<float>((i * 7) % 13) - 6.f + bias;
+      values.push_back(data[i]);
+    }
+    return values;
+  };
+  auto w_data = fill(*scope, "W", 1.f);
+  runtime_program->PreRun();
+
+  auto exec_scope = runtime_program->CreateExecutionScope({"A"});
+  auto a_data     = fill(*exec_scope, "A", 2.f);
+  runtime_program->ExecuteInScope(*exec_scope);
+  auto concat = a_data;
+  concat.insert(concat.end(), w_data.begin(), w_data.end());
+  auto* e_data = exec_scope->GetTensor(e->id)->data<float>();
+  for (size_t i = 0; i < concat.size(); i++) {
+    ASSERT_FLOAT_EQ(e_data[i], std::max(concat[i], 0.f));
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
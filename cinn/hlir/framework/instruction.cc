@@ -15,11 +15,38 @@
 #include "cinn/hlir/framework/instruction.h"
 
 #include "cinn/common/test_helper.h"
+#include "cinn/hlir/framework/buffer.h"
 
 namespace cinn {
 namespace hlir {
 namespace framework {
 
+namespace {
+// the order of the first run of the lazy kernels
+std::atomic<int64_t> lazy_kernel_run_counter{0};
+}  // namespace
+
+void LazyKernel::Compile() {
+  std::call_once(compile_once_, [this] {
+    VLOG(3) << "Compile the lazy kernel " << name_;
+    functions_ = compile_();
+    // release the lowered functions captured by the thunk
+    compile_ = nullptr;
+    compiled_.store(true, std::memory_order_release);
+  });
+}
+
+lower_func_ptr_t LazyKernel::Lookup(const std::string& fn_name) {
+  if (first_run_.load(std::memory_order_relaxed) < 0) {
+    int64_t not_run = -1;
+    first_run_.compare_exchange_strong(not_run, lazy_kernel_run_counter.fetch_add(1));
+  }
+  if (!compiled()) Compile();
+  auto it = functions_.fns.find(fn_name);
+  CHECK(it != functions_.fns.end()) << "Function " << fn_name << " is not compiled by the lazy kernel " << name_;
+  return it->second;
+}
+
 std::vector<cinn_pod_value_t>& Instruction::PreparePodArgs(
     int i, const std::map<std::string, cinn_pod_value_t>* name2podargs) {
   if (args_cached_.size() > i)
@@ -34,7 +61,15 @@ std::vector<cinn_pod_value_t>& Instruction::PreparePodArgs(
   if (name2podargs != nullptr) {
     for (auto& arg : all_args) {
       CHECK_NE(name2podargs->count(arg), 0) << "Argument [" << arg << "] not found in the name2podargs";
-      builder.Add(name2podargs->at(arg));
+      const auto& value = name2podargs->at(arg);
+      // the host kernels assume the alignment of the memory of their buffer arguments, which the memory owned by
+      // the caller may not have
+      if (target_.arch != Target::Arch::NVGPU && value.type_code() == ::cinn_type_code<cinn_buffer_t*>()) {
+        auto* buffer = static_cast<cinn_buffer_t*>(value);
+        CHECK_EQ(reinterpret_cast<uintptr_t>(buffer->memory) % Buffer::kMinHostAlignment, 0)
+            << "The memory of argument [" << arg << "] should be aligned to " << Buffer::kMinHostAlignment << " bytes";
+      }
+      builder.Add(value);
     }
   } else {
     for (auto& arg : all_args) {
@@ -73,10 +108,38 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     args_cached_.clear();
   }
 
+  Launch([&](int i) -> std::vector<cinn_pod_value_t>& { return PreparePodArgs(i, name2podargs); }, dryrun, stream);
+}
+
+void Instruction::RunInScope(const Scope& scope, void* stream) const {
+  CHECK(finalized_flag_) << "Instruction must be finalized before run";
+  if (function_name_ == "no_run") {
+    VLOG(2) << "skip instruction";
+    return;
+  }
+
+  std::vector<std::vector<cinn_pod_value_t>> args(fn_.size());
+  for (int i = 0; i < fn_.size(); i++) {
+    common::ArgsBuilder builder;
+    for (auto* arg_names : {&in_args_[i], &out_args_[i]}) {
+      for (auto& arg : *arg_names) {
+        auto* var = scope.FindVar(arg);
+        CHECK(var) << "Argument [" << arg << "] not found in the scope";
+        builder.Add(absl::get<Tensor>(*var)->buffer());
+      }
+    }
+    args[i] = builder.Build();
+  }
+  Launch([&](int i) -> std::vector<cinn_pod_value_t>& { return args[i]; }, false, stream);
+}
+
+void Instruction::Launch(const std::function<std::vector<cinn_pod_value_t>&(int)>& get_args,
+                         bool dryrun,
+                         void* stream) const {
   VLOG(2) << "Run function " << function_name_;
 
 #ifdef CINN_WITH_CUDNN
-  auto& pod_args = PreparePodArgs(0, name2podargs);
+  auto& pod_args = get_args(0);
   // Here conv2d and depthwise_conv2d are implemented by one cudnn api cudnnConvolutionForward
   if ((function_name_ == "conv2d" || function_name_ == "depthwise_conv2d") && target_.arch == Target::Arch::NVGPU) {
     if (str_attrs[0] == "forward") {
@@ -124,28 +187,26 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     CHECK_EQ(pod_args.size(), 4);
     runtime::cuda::cinn_gpu_cublas_mul(attrs, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream));
   } else {
-    int i = 0;
     VLOG(2) << "Runing extern function " << function_name_;
-    for (auto& it_fn : fn_) {
-      auto& pod_args = PreparePodArgs(i, name2podargs);
+    for (int i = 0; i < fn_.size(); i++) {
+      auto& pod_args = get_args(i);
+      auto it_fn     = GetFunc(i);
       CHECK(it_fn) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
       if (!dryrun) {
         it_fn(pod_args.data(), pod_args.size());
       }
-      i++;
     }
   }
 #else
-  int i = 0;
   CHECK_EQ(fn_names_.size(), fn_.size());
   VLOG(3) << "fn_ size is " << fn_.size() << ", function_name_ is : " << function_name_;
-  for (auto& it_fn : fn_) {
-    auto& pod_args = PreparePodArgs(i, name2podargs);
+  for (int i = 0; i < fn_.size(); i++) {
+    auto& pod_args = get_args(i);
+    auto it_fn     = GetFunc(i);
     CHECK(it_fn) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
     if (!dryrun) {
       it_fn(pod_args.data(), pod_args.size());
     }
-    i++;
   }
 #endif
 }
@@ -14,7 +14,13 @@
 
 #pragma once
 
+#include <absl/container/flat_hash_map.h>
+
+#include <atomic>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -31,6 +37,50 @@ namespace cinn {
 namespace hlir {
 namespace framework {
 
+/**
+ * LazyKernel holds the compile thunk of the functions of one or more instructions, which is called on the first run
+ * of the instructions or by the background compiling of the Program, so that the kernels used only on rare paths don't
+ * delay the start-up. It compiles only once and is thread-safe.
+ */
+class LazyKernel {
+ public:
+  struct Functions {
+    absl::flat_hash_map<std::string, lower_func_ptr_t> fns;
+    // the owner of the compiled code, which lives as long as the functions are used
+    std::shared_ptr<void> owner;
+  };
+  //! Compile the functions and return their addresses by name.
+  using compile_t = std::function<Functions()>;
+
+  /**
+   * Constructor.
+   * @param name The name identifying the kernel in the compile profile, which is stable for the same graph.
+   * @param compile The compile thunk.
+   */
+  LazyKernel(const std::string& name, compile_t compile) : name_(name), compile_(std::move(compile)) {}
+
+  const std::string& name() const { return name_; }
+
+  //! Compile the functions if they are not compiled yet.
+  void Compile();
+
+  bool compiled() const { return compiled_.load(std::memory_order_acquire); }
+
+  //! Get the function of \p fn_name to run, compile the functions first if needed.
+  lower_func_ptr_t Lookup(const std::string& fn_name);
+
+  //! The order of the first run of this kernel among all the lazy kernels in the process, -1 if not run yet.
+  int64_t first_run() const { return first_run_.load(std::memory_order_relaxed); }
+
+ private:
+  std::string name_;
+  compile_t compile_;
+  std::once_flag compile_once_;
+  std::atomic<bool> compiled_{false};
+  Functions functions_;
+  std::atomic<int64_t> first_run_{-1};
+};
+
 /**
  * Instruction is the basic executable element in runtime, it holds a pointer to the JIT-compiled LoweredFunc, and
  * collect the cinn_buffer of the inputs and outputs from the scope, prepare the arguments and finally pass them into
@@ -64,6 +114,17 @@ class Instruction {
     fn_names_.push_back(name);
   }
 
+  /**
+   * Set the lazy kernel compiling the functions whose addresses are not set, i.e. set to null by SetLoweredFunc.
+   * @param kernel The lazy kernel, all the functions of an instruction are compiled by the same one.
+   */
+  void SetLazyKernel(const std::shared_ptr<LazyKernel>& kernel) {
+    CHECK(!lazy_kernel_ || lazy_kernel_ == kernel) << "The functions of an instruction should be in one lazy kernel";
+    lazy_kernel_ = kernel;
+  }
+
+  const std::shared_ptr<LazyKernel>& lazy_kernel() const { return lazy_kernel_; }
+
   // explicitly finalize the instruction, and can't append function again after call it
   void Finalize();
 
@@ -74,6 +135,12 @@ class Instruction {
            bool dryrun                                                 = false,
            void* stream                                                = nullptr);
 
+  /**
+   * Run the Instruction with the arguments taken from \p scope instead of the scope it is built with. It does not
+   * modify the instruction, so an instruction can run on many scopes from many threads at the same time.
+   */
+  void RunInScope(const Scope& scope, void* stream = nullptr) const;
+
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr) {
     CHECK_EQ(fn_.size(), 4);
     if (fn_.size() > 1 && fn_.size() != in_args_.size()) {
@@ -92,7 +159,7 @@ class Instruction {
         VLOG(3) << "PreRun " << i << "-th function of fn_:" << fn_names_[i];
         flag           = i;
         auto& pod_args = PreparePodArgs(i, name2podargs);
-        auto it_fn     = fn_[i];
+        auto it_fn     = GetFunc(i);
         CHECK(it_fn) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
         it_fn(pod_args.data(), pod_args.size());
 #ifdef CINN_WITH_CUDA
@@ -114,6 +181,7 @@ class Instruction {
   std::vector<std::vector<std::string>> GetInArgs() { return in_args_; }
   std::vector<std::vector<std::string>> GetOutArgs() { return out_args_; }
   std::vector<std::string> GetFnNames() { return fn_names_; }
+  const std::string& function_name() const { return function_name_; }
   void AddInArgs(const std::vector<std::string>& in_args) { in_args_.push_back(in_args); }
   void AddOutArgs(const std::vector<std::string>& out_args) { out_args_.push_back(out_args); }
   std::vector<int> attrs;
@@ -124,6 +192,15 @@ class Instruction {
  protected:
   std::vector<cinn_pod_value_t>& PreparePodArgs(int i, const std::map<std::string, cinn_pod_value_t>* name2podargs);
 
+  //! Get the address of the i-th function, which is compiled first if it is in the lazy kernel.
+  lower_func_ptr_t GetFunc(int i) const {
+    if (fn_[i] || !lazy_kernel_) return fn_[i];
+    return lazy_kernel_->Lookup(fn_names_[i]);
+  }
+
+  //! Call the functions, the arguments of the i-th function are returned by \p get_args(i).
+  void Launch(const std::function<std::vector<cinn_pod_value_t>&(int)>& get_args, bool dryrun, void* stream) const;
+
  private:
   bool finalized_flag_ = false;
   Scope* scope_{};
@@ -135,6 +212,7 @@ class Instruction {
 
   std::vector<lower_func_ptr_t> fn_{};
   std::vector<std::string> fn_names_;
+  std::shared_ptr<LazyKernel> lazy_kernel_;
 };
 
 }  // namespace framework
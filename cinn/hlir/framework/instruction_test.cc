@@ -155,6 +155,16 @@ TEST(Instruction, RunWithRawPodArgs) {
   instr.Run(&name2podargs);
   // check instruction run correctly
   check_equal_by_element();
+
+  // case 3: the memory owned by the caller should have the alignment the kernel assumes
+  name2podargs.clear();
+  count = 0;
+  for (const auto& name : std::vector<std::string>({"x", "y", "z"})) {
+    name2podargs.emplace(name, &args_buffer.at(count++));
+  }
+  args_buffer[0].memory += sizeof(float);
+  ASSERT_DEATH(instr.Run(&name2podargs), "aligned");
+  args_buffer[0].memory -= sizeof(float);
 }
 
 #ifdef CINN_WITH_CUDNN
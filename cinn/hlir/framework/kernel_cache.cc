@@ -0,0 +1,86 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/kernel_cache.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+
+DEFINE_int32(cinn_kernel_cache_capacity,
+             1024,
+             "The max number of the compiled kernels shared by the GraphCompilers in the process, 0 disables it.");
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+KernelCache& KernelCache::Global() {
+  static KernelCache cache;
+  return cache;
+}
+
+bool KernelCache::Enabled() { return FLAGS_cinn_kernel_cache_capacity > 0; }
+
+bool KernelCache::Lookup(const std::string& key, Kernel* kernel) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = key2kernel_.find(key);
+  if (it == key2kernel_.end()) {
+    stats_.misses++;
+    return false;
+  }
+  stats_.hits++;
+  lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+  *kernel = it->second->second;
+  return true;
+}
+
+void KernelCache::Insert(const std::string& key, Kernel kernel) {
+  CHECK(kernel.compiler && kernel.fn) << "The kernel " << kernel.fn_name << " to cache is not compiled";
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = key2kernel_.find(key);
+  if (it != key2kernel_.end()) {
+    it->second->second = std::move(kernel);
+    lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+    return;
+  }
+  lru_list_.emplace_front(key, std::move(kernel));
+  key2kernel_.emplace(key, lru_list_.begin());
+  // the evicted kernels are still alive in the programs using them
+  while (lru_list_.size() > static_cast<size_t>(std::max(FLAGS_cinn_kernel_cache_capacity, 0))) {
+    VLOG(3) << "Evict the kernel " << lru_list_.back().second.fn_name << " from the kernel cache";
+    key2kernel_.erase(lru_list_.back().first);
+    lru_list_.pop_back();
+    stats_.evictions++;
+  }
+}
+
+KernelCache::Stats KernelCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.size  = lru_list_.size();
+  return stats;
+}
+
+void KernelCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  key2kernel_.clear();
+  lru_list_.clear();
+  stats_ = Stats();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,91 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "cinn/backends/compiler.h"
+#include "cinn/common/macros.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * KernelCache is a process-wide LRU cache of the compiled kernels, which lets the GraphCompilers in the same process
+ * share the kernel of a group instead of lowering and compiling it again. The key describes everything the kernel
+ * depends on, i.e. the target and the signature of the group: its ops, attributes, dtypes and shapes. The number of
+ * kernels is bounded by the flag `cinn_kernel_cache_capacity`, and 0 disables the cache.
+ */
+class KernelCache {
+ public:
+  struct Kernel {
+    // the compiler owning the module of the kernel, which is kept alive as long as the kernel is used. The module
+    // holds no other function, so that the capacity bounds the code kept alive by the cache.
+    std::shared_ptr<backends::Compiler> compiler;
+    std::string fn_name;
+    lower_func_ptr_t fn{nullptr};
+  };
+
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    size_t size{0};
+
+    double HitRate() const { return hits + misses == 0 ? 0. : static_cast<double>(hits) / (hits + misses); }
+  };
+
+  static KernelCache& Global();
+
+  //! Whether the cache is enabled, i.e. its capacity is larger than 0.
+  static bool Enabled();
+
+  /**
+   * Find the kernel of \p key and mark it as the most recently used one.
+   * @return true if found, then \p kernel is set to it.
+   */
+  bool Lookup(const std::string& key, Kernel* kernel);
+
+  //! Insert or update the kernel of \p key, and evict the least recently used kernels beyond the capacity.
+  void Insert(const std::string& key, Kernel kernel);
+
+  Stats GetStats() const;
+
+  //! Drop all the kernels and reset the statistics.
+  void Clear();
+
+ private:
+  KernelCache() = default;
+
+  mutable std::mutex mutex_;
+  // the most recently used kernel is at the front
+  std::list<std::pair<std::string, Kernel>> lru_list_;
+  absl::flat_hash_map<std::string, std::list<std::pair<std::string, Kernel>>::iterator> key2kernel_;
+  Stats stats_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(KernelCache);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -72,6 +72,18 @@ class _Tensor_ : public Object {
     return reinterpret_cast<T*>(buffer_->data()->memory);
   }
 
+  //! Same as mutable_data<T>, but the element type \p type is known at runtime only.
+  inline void* mutable_data(const Target& target, const Type& type) {
+    set_type(type);
+    uint64_t size = static_cast<uint64_t>(shape_.numel()) * ((type.bits() + 7) / 8) * type.lanes();
+    if (target == common::DefaultHostTarget()) {
+      buffer_->ResizeLazy(1024, size, target);
+    } else {
+      buffer_->ResizeLazy(size, target);
+    }
+    return buffer_->data()->memory;
+  }
+
   template <typename T>
   const T* data() const {
     return reinterpret_cast<T*>(buffer_->data()->memory);
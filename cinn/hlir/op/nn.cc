@@ -15,6 +15,7 @@
 #include "cinn/hlir/pe/nn.h"
 
 #include <functional>
+#include <numeric>
 
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -22,6 +23,7 @@
 #include "cinn/hlir/pe/broadcast.h"
 #include "cinn/hlir/pe/elementwise.h"
 #include "cinn/hlir/pe/schedule.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/layout.h"
 #include "cinn/poly/stage.h"
@@ -960,6 +962,250 @@ std::vector<Type> InferDtypeForDepthwiseConv2d(const std::vector<Type> &inputs_t
   return res;
 }
 
+std::shared_ptr<OpStrategy> StrategyForDepthwisePointwisePack(const framework::NodeAttr &attrs,
+                                                              const std::vector<ir::Tensor> &inputs,
+                                                              const std::vector<Type> &out_type,
+                                                              const std::vector<std::vector<int>> &output_shapes,
+                                                              const Target &target) {
+  float epsilon = 0.00001f;
+  int ic_bn     = -1;
+  int oc_bn     = -1;
+  if (attrs.attr_store.find("epsilon") != attrs.attr_store.end()) {
+    epsilon = absl::get<float>(attrs.attr_store.at("epsilon"));
+  }
+  if (attrs.attr_store.find("ic_bn") != attrs.attr_store.end()) {
+    ic_bn = absl::get<int>(attrs.attr_store.at("ic_bn"));
+  }
+  if (attrs.attr_store.find("oc_bn") != attrs.attr_store.end()) {
+    oc_bn = absl::get<int>(attrs.attr_store.at("oc_bn"));
+  }
+
+  framework::CINNCompute depthwise_pointwise_pack_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of depthwise_pointwise_pack compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK(a.size() == 2U || a.size() == 6U) << "depthwise_pointwise_pack compute should have 2 or 6 inputs\n";
+    CHECK(ic_bn > 0 && oc_bn > 0) << "depthwise_pointwise_pack op should have the ic_bn and oc_bn attrs\n";
+    std::vector<ir::Tensor> input_tensors;
+    for (int i = 0; i < a.size(); i++) {
+      Expr A = a[i];
+      CHECK(A.as_tensor());
+      input_tensors.push_back(A.as_tensor_ref());
+    }
+    // inputs: depthwise weight, pointwise weight, [scale, bias, mean, variance]
+    std::vector<ir::Tensor> bn_params(input_tensors.begin() + 2, input_tensors.end());
+    auto out = pe::DepthwisePointwisePack(input_tensors[0],
+                                          input_tensors[1],
+                                          bn_params,
+                                          epsilon,
+                                          ic_bn,
+                                          oc_bn,
+                                          UniqName("T_depthwise_pointwise_pack"));
+
+    auto stages = CreateStages(input_tensors);
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule depthwise_pointwise_pack_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of depthwise_pointwise_pack schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 4UL);
+    poly::StageMap stages = arg_pack.back();
+    for (size_t i = 0; i < output_shapes.size(); i++) {
+      Expr out = arg_pack[i];
+      CHECK(out.as_tensor());
+      pe::ScheduleInjectiveCPU(stages[out.as_tensor_ref()], output_shapes[i], target);
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of depthwise_pointwise_pack op is empty! Please check.";
+  if (out_type[0] == Float(32)) {
+    strategy->AddImpl(depthwise_pointwise_pack_compute,
+                      depthwise_pointwise_pack_schedule,
+                      "strategy.depthwise_pointwise_pack.x86",
+                      1);
+  } else {
+    LOG(FATAL) << "depthwise_pointwise_pack op with dtype != float32 is not implemented yet!";
+  }
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForDepthwisePointwisePack(const std::vector<shape_t> &inputs_shape,
+                                                         const framework::AttrMapType &attrs) {
+  CHECK(inputs_shape.size() == 2U || inputs_shape.size() == 6U)
+      << "depthwise_pointwise_pack op should have 2 or 6 inputs! Please check again.";
+  CHECK_EQ(inputs_shape[0].size(), 4U) << "The depthwise weight's shape should be 4! Please check again.";
+  CHECK_EQ(inputs_shape[1].size(), 4U) << "The pointwise weight's shape should be 4! Please check again.";
+  CHECK(attrs.count("ic_bn") && attrs.count("oc_bn")) << "depthwise_pointwise_pack op should have ic_bn and oc_bn";
+  int ic_bn = absl::get<int>(attrs.at("ic_bn"));
+  int oc_bn = absl::get<int>(attrs.at("oc_bn"));
+  int ic    = inputs_shape[0][0];
+  int oc    = inputs_shape[1][0];
+  CHECK(ic_bn > 0 && ic % ic_bn == 0) << "ic_bn " << ic_bn << " should divide the channels " << ic;
+  CHECK(oc_bn > 0 && oc % oc_bn == 0) << "oc_bn " << oc_bn << " should divide the output channels " << oc;
+  return {{ic / ic_bn, inputs_shape[0][2], inputs_shape[0][3], ic_bn},
+          {ic / ic_bn, ic_bn},
+          {oc / oc_bn, ic / ic_bn, ic_bn, oc_bn}};
+}
+
+std::vector<Type> InferDtypeForDepthwisePointwisePack(const std::vector<Type> &inputs_type,
+                                                      const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  std::vector<Type> res{inputs_type[0], inputs_type[0], inputs_type[0]};
+  return res;
+}
+
+std::vector<std::vector<std::string>> InferLayoutForDepthwisePointwisePack(
+    const std::vector<framework::shape_t> &input_shapes,
+    const std::vector<std::string> &input_layouts,
+    const framework::NodeAttr &attrs,
+    const Target &target) {
+  CHECK(input_layouts.size() == 2U || input_layouts.size() == 6U)
+      << "The input's layouts size is not 2 or 6! Please check again.";
+  // the packed weights are only read by depthwise_pointwise_conv2d
+  return {{"", "", ""}, input_layouts};
+}
+
+std::shared_ptr<OpStrategy> StrategyForDepthwisePointwiseConv2d(const framework::NodeAttr &attrs,
+                                                                const std::vector<ir::Tensor> &inputs,
+                                                                const std::vector<Type> &out_type,
+                                                                const std::vector<std::vector<int>> &output_shapes,
+                                                                const Target &target) {
+  std::vector<int> padding = {0, 0};
+  std::vector<int> stride  = {1, 1};
+  std::string activation;
+  if (attrs.attr_store.find("padding") != attrs.attr_store.end()) {
+    padding = absl::get<std::vector<int>>(attrs.attr_store.at("padding"));
+  }
+  if (attrs.attr_store.find("stride") != attrs.attr_store.end()) {
+    stride = absl::get<std::vector<int>>(attrs.attr_store.at("stride"));
+  }
+  if (attrs.attr_store.find("activation") != attrs.attr_store.end()) {
+    activation = absl::get<std::string>(attrs.attr_store.at("activation"));
+  }
+
+  framework::CINNCompute depthwise_pointwise_conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of depthwise_pointwise_conv2d compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK_EQ(a.size(), 4U) << "depthwise_pointwise_conv2d compute should have 4 inputs\n";
+    CHECK_EQ(padding.size(), 2) << "The size of padding in depthwise_pointwise_conv2d op is not 2! Please check.\n";
+    CHECK_EQ(stride.size(), 2) << "The size of stride in depthwise_pointwise_conv2d op is not 2! Please check.\n";
+    CHECK(target.arch == Target::Arch::X86) << "depthwise_pointwise_conv2d op is only used in x86";
+    std::vector<ir::Tensor> input_tensors;
+    for (int i = 0; i < a.size(); i++) {
+      Expr A = a[i];
+      CHECK(A.as_tensor());
+      input_tensors.push_back(A.as_tensor_ref());
+    }
+    // inputs: x, packed depthwise weight, depthwise bias, packed pointwise weight
+    auto out = pe::DepthwisePointwiseConv2d_NCHW(input_tensors[0],
+                                                 input_tensors[1],
+                                                 input_tensors[2],
+                                                 input_tensors[3],
+                                                 activation,
+                                                 padding[0],
+                                                 padding[1],
+                                                 stride[0],
+                                                 stride[1],
+                                                 UniqName("T_depthwise_pointwise_conv2d_out"));
+
+    auto stages = CreateStages(input_tensors);
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule depthwise_pointwise_conv2d_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of depthwise_pointwise_conv2d schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 5UL);
+    poly::StageMap stages = arg_pack.back();
+    Expr res              = arg_pack[0];
+    Expr packed_out       = arg_pack[1];
+    Expr dw_out           = arg_pack[2];
+    Expr input_pad        = arg_pack[3];
+    CHECK(res.as_tensor());
+    CHECK(packed_out.as_tensor());
+    CHECK(dw_out.as_tensor());
+    CHECK(input_pad.as_tensor());
+    pe::DepthwisePointwiseConv2d_Schedule_CPU(stages,
+                                              res.as_tensor_ref(),
+                                              packed_out.as_tensor_ref(),
+                                              dw_out.as_tensor_ref(),
+                                              input_pad.as_tensor_ref(),
+                                              target);
+    // the other tensors are temporary, the depthwise output only lives in the buffer of one output row
+    *ret = CINNValuePack{{arg_pack[0], CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of depthwise_pointwise_conv2d op is empty! Please check.";
+  if (out_type[0] == Float(32)) {
+    strategy->AddImpl(depthwise_pointwise_conv2d_compute,
+                      depthwise_pointwise_conv2d_schedule,
+                      "strategy.depthwise_pointwise_conv2d.x86",
+                      1);
+  } else {
+    LOG(FATAL) << "depthwise_pointwise_conv2d op with dtype != float32 is not implemented yet!";
+  }
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForDepthwisePointwiseConv2d(const std::vector<shape_t> &inputs_shape,
+                                                           const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 4U) << "depthwise_pointwise_conv2d op should have 4 inputs! Please check again.";
+  CHECK_EQ(inputs_shape[0].size(), 4U) << "The input tensor's shape should be 4! Please check again.";
+  CHECK_EQ(inputs_shape[1].size(), 4U) << "The packed depthwise weight's shape should be 4! Please check again.";
+  CHECK_EQ(inputs_shape[3].size(), 4U) << "The packed pointwise weight's shape should be 4! Please check again.";
+  std::vector<int> padding = {0, 0};
+  std::vector<int> stride  = {1, 1};
+  if (attrs.find("padding") != attrs.end()) {
+    padding = absl::get<std::vector<int>>(attrs.at("padding"));
+  }
+  if (attrs.find("stride") != attrs.end()) {
+    stride = absl::get<std::vector<int>>(attrs.at("stride"));
+  }
+  CHECK_EQ(padding.size(), 2U) << "The size of padding in depthwise_pointwise_conv2d op is not 2! Please check.";
+  CHECK_EQ(stride.size(), 2U) << "The size of stride in depthwise_pointwise_conv2d op is not 2! Please check.";
+  // packed depthwise weight: [C / ic_bn, kh, kw, ic_bn], packed pointwise weight: [O / oc_bn, C / ic_bn, ic_bn, oc_bn]
+  int out_shape_c = inputs_shape[3][0] * inputs_shape[3][3];
+  int out_shape_h = (inputs_shape[0][2] - inputs_shape[1][1] + 2 * padding[0]) / stride[0] + 1;
+  int out_shape_w = (inputs_shape[0][3] - inputs_shape[1][2] + 2 * padding[1]) / stride[1] + 1;
+  return {{inputs_shape[0][0], out_shape_c, out_shape_h, out_shape_w}};
+}
+
+std::vector<Type> InferDtypeForDepthwisePointwiseConv2d(const std::vector<Type> &inputs_type,
+                                                        const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  std::vector<Type> res{inputs_type[0]};
+  return res;
+}
+
+std::vector<std::vector<std::string>> InferLayoutForDepthwisePointwiseConv2d(
+    const std::vector<framework::shape_t> &input_shapes,
+    const std::vector<std::string> &input_layouts,
+    const framework::NodeAttr &attrs,
+    const Target &target) {
+  CHECK_EQ(input_layouts.size(), 4U) << "The input's layouts size is not 4! Please check again.";
+  auto new_input_layouts = input_layouts;
+  if (input_shapes[0].size() > 4) {
+    // the input in NCHWxc is transformed back to NCHW
+    new_input_layouts[0] = "NCHW";
+  }
+  return {{"NCHW"}, new_input_layouts};
+}
+
 std::shared_ptr<OpStrategy> StrategyForBatchNorm(const framework::NodeAttr &attrs,
                                                  const std::vector<ir::Tensor> &inputs,
                                                  const std::vector<Type> &out_type,
@@ -1144,6 +1390,12 @@ std::shared_ptr<OpStrategy> StrategyForPool1d(const framework::NodeAttr &attrs,
       stages[Out.as_tensor_ref()]->Split(1, 2);
       stages[Out.as_tensor_ref()]->Bind(0, "blockIdx.x");
       stages[Out.as_tensor_ref()]->Bind(1, "threadIdx.x");
+    } else if (target.arch == Target::Arch::X86) {
+      CHECK(Out.as_tensor());
+      // the channel of NWC is contiguous in the input, so it is vectorized
+      bool channel_last = attrs.attr_store.count("data_format") &&
+                          absl::get<std::string>(attrs.attr_store.at("data_format")) == "NWC";
+      pe::PoolScheduleCPU(stages, Out.as_tensor_ref(), channel_last, target);
     }
     *ret = CINNValuePack{{CINNValue(Out), CINNValue(stages)}};
   });
@@ -1276,6 +1528,17 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
     padding_size.insert(padding_size.end(), padding_size.begin(), padding_size.end());
   }
 
+  // On x86, the innermost axis of the pooling can be vectorized if it is contiguous in the input: the channel block of
+  // NCHWc, the channel of NHWC, or the width pooled with stride 1. The global pooling of NCHWc is a single vectorized
+  // reduction per channel block.
+  bool channel_last = A_tensor->shape.size() == 5U || data_format == "NHWC";
+  bool unit_stride  = !global_pooling && !adaptive && stride_size.size() == 2U && stride_size[1] == 1;
+  // The large windows are pooled in separable row and column passes, which read kernel_h + stride_h * kernel_w
+  // elements per output instead of kernel_h * kernel_w.
+  bool use_separable = target.arch == Target::Arch::X86 && !global_pooling && !adaptive && kernel_size.size() == 2U &&
+                       stride_size.size() == 2U && padding_size.size() == 4U &&
+                       kernel_size[0] + stride_size[0] * kernel_size[1] < kernel_size[0] * kernel_size[1];
+
   framework::CINNCompute global_pool2d_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of pool2d compute is empty! Please check.\n";
     CINNValuePack a = args[0];
@@ -1307,19 +1570,33 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
     CHECK(A.as_tensor());
     ir::Tensor A_tensor = A.as_tensor_ref();
 
-    auto out = pe::Pool2d(A_tensor,
-                          kernel_size,
-                          stride_size,
-                          padding_size,
-                          pool_type,
-                          ceil_mode,
-                          exclusive,
-                          data_format,
-                          adaptive,
-                          UniqName("T_Pool2d_out"));
+    std::vector<ir::Tensor> out;
+    if (use_separable) {
+      out = pe::SeparablePool2d(A_tensor,
+                                kernel_size,
+                                stride_size,
+                                padding_size,
+                                pool_type,
+                                ceil_mode,
+                                exclusive,
+                                data_format,
+                                UniqName("T_Pool2d_out"));
+      CHECK(out.size() == 2U || out.size() == 3U) << "The size of pe::SeparablePool2d's output should be 2 or 3.";
+    } else {
+      out = pe::Pool2d(A_tensor,
+                       kernel_size,
+                       stride_size,
+                       padding_size,
+                       pool_type,
+                       ceil_mode,
+                       exclusive,
+                       data_format,
+                       adaptive,
+                       UniqName("T_Pool2d_out"));
+      CHECK(out.size() == 1U || out.size() == 2U) << "The size of pe::Pool2d's output should be 1 or 2.";
+    }
 
     auto stages = CreateStages({A_tensor});
-    CHECK(out.size() == 1U || out.size() == 2U) << "The size of pe::Pool2d's output should be 1 or 2.";
     std::vector<CINNValue> res;
     for (auto &t : out) {
       stages->InsertLazily(t);
@@ -1333,12 +1610,14 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
   framework::CINNSchedule pool2d_schedule([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of pool2d schedule is empty! Please check.\n";
     CINNValuePack arg_pack = args[0];
-    CHECK(arg_pack.size() == 2UL || arg_pack.size() == 3UL);
+    CHECK(arg_pack.size() >= 2UL && arg_pack.size() <= 4UL);
     Expr Out = arg_pack[0];
     CHECK(Out.as_tensor());
     poly::StageMap stages = arg_pack[arg_pack.size() - 1];
-    if (arg_pack.size() == 3UL) {
-      Expr input_pad = arg_pack[1];
+    // {out, pad, stages} or {out, row, pad, stages} of the separable pooling
+    int pad_index = use_separable ? 2 : 1;
+    if (arg_pack.size() == pad_index + 2) {
+      Expr input_pad = arg_pack[pad_index];
       CHECK(input_pad.as_tensor());
       stages[input_pad.as_tensor_ref()]->ComputeInline();
     }
@@ -1346,6 +1625,16 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
     if (target.arch == Target::Arch::NVGPU) {
       pe::PoolScheduleGPU(stages, temp_out, target);
       arg_pack[arg_pack.size() - 2] = Expr(temp_out);
+    } else if (target.arch == Target::Arch::X86) {
+      if (use_separable) {
+        Expr row = arg_pack[1];
+        CHECK(row.as_tensor());
+        pe::PoolScheduleCPU(stages, row.as_tensor_ref(), channel_last || stride_size[1] == 1, target);
+        // the rows are stored with the pooled width innermost, which is contiguous for the column pass
+        pe::PoolScheduleCPU(stages, temp_out, true, target);
+      } else {
+        pe::PoolScheduleCPU(stages, temp_out, channel_last || unit_stride, target);
+      }
     }
     *ret = CINNValuePack{{CINNValue(Out), CINNValue(stages)}};
   });
@@ -1533,6 +1822,12 @@ std::shared_ptr<OpStrategy> StrategyForPool3d(const framework::NodeAttr &attrs,
       stages[Out.as_tensor_ref()]->Split(1, 2);
       stages[Out.as_tensor_ref()]->Bind(0, "blockIdx.x");
       stages[Out.as_tensor_ref()]->Bind(1, "threadIdx.x");
+    } else if (target.arch == Target::Arch::X86) {
+      CHECK(Out.as_tensor());
+      // the channel of NDHWC is contiguous in the input, so it is vectorized
+      bool channel_last = attrs.attr_store.count("data_format") &&
+                          absl::get<std::string>(attrs.attr_store.at("data_format")) == "NDHWC";
+      pe::PoolScheduleCPU(stages, Out.as_tensor_ref(), channel_last, target);
     }
     *ret = CINNValuePack{{CINNValue(Out), CINNValue(stages)}};
   });
@@ -1643,6 +1938,9 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
   if (attrs.attr_store.count("use_mkldnn")) {
     use_mkldnn = absl::get<bool>(attrs.attr_store.at("use_mkldnn"));
   }
+  // pe::Softmax also returns the row max, it is a temporary tensor rather than an output of the op, so it is handed
+  // from the compute to the schedule here instead of through the pack whose tensors become arguments of the kernel
+  auto row_max = std::make_shared<ir::Tensor>();
   framework::CINNCompute softmax_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input arguments of softmax compute is empty! Please check.";
     CINNValuePack a = args[0];
@@ -1668,9 +1966,12 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
     std::vector<CINNValue> res;
     for (auto &t : out) {
       stages->InsertLazily(t);
-      res.push_back(CINNValue(t));
     }
-    CHECK_EQ(out.size(), 2U) << "The size of pe::Softmax's output should be 2.";
+    CHECK_GE(out.size(), 2U) << "The size of pe::Softmax's output should be no less than 2.";
+    // softmax of mkldnn has no row max
+    *row_max = out.size() > 2 ? out[2] : ir::Tensor();
+    res.push_back(CINNValue(out[0]));
+    res.push_back(CINNValue(out[1]));
     CHECK(!out_type.empty()) << "Output type of Softmax is empty! Please check.\n";
     res.push_back(CINNValue(stages));
     *ret = CINNValuePack{res};
@@ -1688,16 +1989,23 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
     CHECK(out2.as_tensor());
     ir::Tensor tensor_a = out1.as_tensor_ref();
     ir::Tensor tensor_b = out2.as_tensor_ref();
+    if (!row_max->defined()) {
+      // the mkldnn kernel is an extern call, there is nothing to schedule
+      *ret = arg_pack;
+      return;
+    }
+    ir::Tensor tensor_max = *row_max;
     if (target.arch == Target::Arch::NVGPU) {
       if (tensor_a->shape.size() > 1) {
         stages[tensor_a]->Split(1, 5);
         stages[tensor_a]->Bind(0, "blockIdx.x");
         stages[tensor_a]->Bind(1, "threadIdx.x");
         int shape_size = tensor_a->shape.size();
+        stages[tensor_max]->ComputeAt(stages[tensor_a], shape_size);
         stages[tensor_b]->ComputeAt(stages[tensor_a], shape_size);
       }
     } else if (target.arch == Target::Arch::X86) {
-      pe::SoftmaxScheduleCPU(stages, tensor_a, tensor_b, axis);
+      pe::SoftmaxScheduleCPU(stages, tensor_a, tensor_b, tensor_max, axis, target);
     }
     *ret = arg_pack;
   });
@@ -1733,6 +2041,124 @@ std::vector<std::vector<std::string>> InferLayoutForSoftmax(const std::vector<fr
   return {{input_layouts[0], input_layouts[0]}, input_layouts};
 }
 
+std::shared_ptr<OpStrategy> StrategyForLayerNorm(const framework::NodeAttr &attrs,
+                                                 const std::vector<ir::Tensor> &inputs,
+                                                 const std::vector<Type> &out_type,
+                                                 const std::vector<std::vector<int>> &output_shapes,
+                                                 const Target &target) {
+  float epsilon       = 1e-5f;
+  int begin_norm_axis = 1;
+  if (attrs.attr_store.count("epsilon")) {
+    epsilon = absl::get<float>(attrs.attr_store.at("epsilon"));
+  }
+  if (attrs.attr_store.count("begin_norm_axis")) {
+    begin_norm_axis = absl::get<int>(attrs.attr_store.at("begin_norm_axis"));
+  }
+  framework::CINNCompute layer_norm_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of layer_norm compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK_EQ(a.size(), 3U) << "The input tensors' size of layer_norm compute should be 3! Please check.";
+    Expr A = a[0];
+    Expr B = a[1];
+    Expr C = a[2];
+    CHECK(A.as_tensor());
+    CHECK(B.as_tensor());
+    CHECK(C.as_tensor());
+    auto out    = pe::LayerNorm(A.as_tensor_ref(),
+                                B.as_tensor_ref(),
+                                C.as_tensor_ref(),
+                                epsilon,
+                                begin_norm_axis,
+                                UniqName("LayerNorm_output"));
+    auto stages = CreateStages({A.as_tensor_ref(), B.as_tensor_ref(), C.as_tensor_ref()});
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    CHECK(!out_type.empty()) << "Output type of LayerNorm is empty! Please check.\n";
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule layer_norm_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of layer_norm schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 4UL) << "The input tensor's size of layer_norm schedule is " << arg_pack.size()
+                                   << "and it should be equal to 4! Please check.";
+    Expr out      = arg_pack[0];
+    Expr mean     = arg_pack[1];
+    Expr variance = arg_pack[2];
+    CHECK(out.as_tensor());
+    CHECK(mean.as_tensor());
+    CHECK(variance.as_tensor());
+    poly::StageMap stages      = arg_pack[3];
+    ir::Tensor tensor_out      = out.as_tensor_ref();
+    ir::Tensor tensor_mean     = mean.as_tensor_ref();
+    ir::Tensor tensor_variance = variance.as_tensor_ref();
+    if (target.arch == Target::Arch::NVGPU) {
+      if (tensor_out->shape.size() > 1) {
+        stages[tensor_out]->Split(1, 5);
+        stages[tensor_out]->Bind(0, "blockIdx.x");
+        stages[tensor_out]->Bind(1, "threadIdx.x");
+        int shape_size = tensor_out->shape.size();
+        stages[tensor_mean]->ComputeAt(stages[tensor_out], shape_size);
+        stages[tensor_variance]->ComputeAt(stages[tensor_out], shape_size);
+      }
+    } else if (target.arch == Target::Arch::X86) {
+      pe::LayerNormScheduleCPU(stages, tensor_out, tensor_mean, tensor_variance, begin_norm_axis, target);
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(layer_norm_compute, layer_norm_schedule, "strategy.layer_norm.x86", 1);
+
+  return strategy;
+}
+
+std::vector<std::vector<int>> InferShapeForLayerNorm(const std::vector<std::vector<int>> &inputs_shape,
+                                                     const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 3U) << "The input's size of layer_norm should be 3! Please check again.";
+  int begin_norm_axis = 1;
+  if (attrs.count("begin_norm_axis")) {
+    begin_norm_axis = absl::get<int>(attrs.at("begin_norm_axis"));
+  }
+  int rank = inputs_shape[0].size();
+  if (begin_norm_axis < 0) {
+    begin_norm_axis += rank;
+  }
+  CHECK(begin_norm_axis >= 0 && begin_norm_axis < rank) << "The begin_norm_axis of layer_norm is out of range.";
+  std::vector<int> stat_shape(inputs_shape[0].begin(), inputs_shape[0].begin() + begin_norm_axis);
+  if (stat_shape.empty()) {
+    stat_shape.push_back(1);
+  }
+  int norm_size = std::accumulate(
+      inputs_shape[0].begin() + begin_norm_axis, inputs_shape[0].end(), 1, [](int a, int b) { return a * b; });
+  CHECK_EQ(inputs_shape[1], std::vector<int>{norm_size}) << "The scale's shape of layer_norm is not valid.";
+  CHECK_EQ(inputs_shape[2], std::vector<int>{norm_size}) << "The bias's shape of layer_norm is not valid.";
+  std::vector<std::vector<int>> res{inputs_shape[0], stat_shape, stat_shape};
+  return res;
+}
+
+std::vector<Type> InferDtypeForLayerNorm(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  std::vector<Type> res{inputs_type[0], inputs_type[0], inputs_type[0]};
+  return res;
+}
+
+std::vector<std::vector<std::string>> InferLayoutForLayerNorm(const std::vector<framework::shape_t> &input_shapes,
+                                                              const std::vector<std::string> &input_layouts,
+                                                              const framework::NodeAttr &attrs,
+                                                              const Target &target) {
+  CHECK_EQ(input_layouts.size(), 3U) << "The input's layout size is not 3! Please check again.";
+  if (input_shapes[0].size() > 4) {
+    // the normalized dimensions are defined on the original layout
+    return {{"NCHW", "", ""}, {"NCHW", input_layouts[1], input_layouts[2]}};
+  }
+  return {{input_layouts[0], "", ""}, input_layouts};
+}
+
 std::shared_ptr<OpStrategy> StrategyForSlice(const framework::NodeAttr &attrs,
                                              const std::vector<ir::Tensor> &inputs,
                                              const std::vector<Type> &out_type,
@@ -2087,13 +2513,18 @@ std::shared_ptr<OpStrategy> StrategyForGradOp(const framework::NodeAttr &attrs,
 // batch norm grad
 std::vector<framework::shape_t> InferShapeForBatchNormGrad(const std::vector<framework::shape_t> &inputs_shape,
                                                            const framework::AttrMapType &attrs) {
-  CHECK_EQ(inputs_shape.size(), 5U) << "The input's layout size is not 5! Please check again.";
+  // the 6th input is the output of the relu after batch norm, when the grad of relu is fused into batch_norm_grad
+  CHECK(inputs_shape.size() == 5U || inputs_shape.size() == 6U)
+      << "The input's layout size is not 5 or 6! Please check again.";
   std::string data_layout = "";
   if (attrs.find("data_layout") != attrs.end()) {
     data_layout = absl::get<std::string>(attrs.at("data_layout"));
   } else {
     LOG(FATAL) << "data_layout is not found, please check!";
   }
+  if (inputs_shape.size() == 6U) {
+    CHECK(inputs_shape[0] == inputs_shape[5]) << "dy and relu out shape is not equal!";
+  }
 
   CHECK_EQ(inputs_shape[0].size(), 4) << "dy dimension size is not required!";
   CHECK_EQ(inputs_shape[1].size(), 4) << "x dimension size is not required!";
@@ -2219,6 +2650,51 @@ CINN_REGISTER_HELPER(nn_ops) {
 #endif
       .set_support_level(4);
 
+  CINN_REGISTER_OP(depthwise_pointwise_pack)
+      .describe("Pack the depthwise and 1x1 weights of depthwise_pointwise_conv2d in the NCHWc layout.")
+      .set_num_inputs(2)  // depthwise weight and pointwise weight
+      .set_num_outputs(3)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy",
+                                                         cinn::hlir::op::StrategyForDepthwisePointwisePack)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForDepthwisePointwisePack))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForDepthwisePointwisePack))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForDepthwisePointwisePack))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(depthwise_pointwise_pack_bn)
+      .describe("Pack the depthwise and 1x1 weights of depthwise_pointwise_conv2d in the NCHWc layout and fold the "
+                "batch norm into the depthwise weights and bias.")
+      .set_num_inputs(6)  // depthwise weight, pointwise weight, scale, bias, mean and variance
+      .set_num_outputs(3)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy",
+                                                         cinn::hlir::op::StrategyForDepthwisePointwisePack)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForDepthwisePointwisePack))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForDepthwisePointwisePack))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForDepthwisePointwisePack))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(depthwise_pointwise_conv2d)
+      .describe("Do a 2-D depthwise convolution, a bias, an optional activation and a 1x1 convolution in one kernel "
+                "with an NCHW layout.")
+      .set_num_inputs(4)  // x and the packed depthwise weight, depthwise bias and pointwise weight
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy",
+                                                         cinn::hlir::op::StrategyForDepthwisePointwiseConv2d)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForDepthwisePointwiseConv2d))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForDepthwisePointwiseConv2d))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForDepthwisePointwiseConv2d))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern",
+                                                      cinn::hlir::framework::OpPatternKind::kOutEWiseFusable)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(batchnorm)
       .describe("Can be used as a normalizer function for convolution or fully_connected operations.")
       .set_num_inputs(5)  // here we consider batchnorm's 4 attrs(mean, variance, scale, bias) as other 4 inputs
@@ -2284,6 +2760,19 @@ CINN_REGISTER_HELPER(nn_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(layer_norm)
+      .describe("This operator implements the layer normalization layer")
+      .set_num_inputs(3)
+      .set_num_outputs(3)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForLayerNorm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForLayerNorm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForLayerNorm))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForLayerNorm))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(slice)
       .describe("This operator implements the slice layer")
       .set_num_inputs(1)
@@ -2345,8 +2834,8 @@ CINN_REGISTER_HELPER(nn_grad_ops) {
       .set_support_level(4);
 
   CINN_REGISTER_OP(batch_norm_grad)
-      .describe("This operator implements the batch normalization backward.")
-      .set_num_inputs(5)
+      .describe("This operator implements the batch normalization backward, maybe with the relu backward.")
+      .set_num_inputs(6)  // dy, x, scale, saved mean, saved variance and the optional relu output
       .set_num_outputs(3)
       .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForBatchNormGrad))
       .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForBatchNormGrad))
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <string>
@@ -202,6 +203,69 @@ TEST(Operator, Operator_Pool2d_Test2) {
   ASSERT_EQ(pool2d->description, "Do pooling on the height and width dimension of the input tensor.");
 }
 
+TEST(Operator, Operator_Pool2d_Separable) {
+  auto pool2d   = Operator::Get("pool2d");
+  auto strategy = Operator::GetAttrs<StrategyFunction>("CINNStrategy");
+
+  // a 3x3 window with stride 1 is pooled in separable row and column passes
+  int n = 1, c = 4, h = 16, w = 16;
+  Placeholder<float> A("A", {Expr(n), Expr(c), Expr(h), Expr(w)});
+
+  NodeAttr attrs;
+  attrs.attr_store["kernel_size"]  = std::vector<int>({3, 3});
+  attrs.attr_store["stride_size"]  = std::vector<int>({1, 1});
+  attrs.attr_store["padding_size"] = std::vector<int>({1, 1, 1, 1});
+  attrs.attr_store["pool_type"]    = std::string("avg");
+  attrs.attr_store["exclusive"]    = true;
+  std::vector<ir::Tensor> inputs{A.tensor()};
+  std::vector<Type> type{Float(32)};
+  common::Target target = common::DefaultHostTarget();
+  auto impl = OpStrategy::SelectImpl(strategy[pool2d](attrs, inputs, type, {{n, c, h, w}}, target));
+  common::CINNValuePack cinn_input = common::CINNValuePack{{common::CINNValue(A)}};
+  common::CINNValuePack rets       = impl->fcompute(cinn_input);
+  ASSERT_EQ(rets.size(), 4UL);
+  rets = impl->fschedule(rets);
+  ASSERT_EQ(rets.size(), 2UL);
+  Expr out = rets[0];
+  inputs.push_back(out.as_tensor_ref());
+  auto func = Lower("pool2d_separable", rets.back(), inputs);
+  LOG(INFO) << "Test Strategy Codegen:\n" << func;
+
+  Module::Builder builder("module0", target);
+  builder.AddFunction(func);
+  auto jit    = backends::ExecutionEngine::Create({});
+  auto module = builder.Build();
+
+  jit->Link(module);
+  auto fn = jit->Lookup("pool2d_separable");
+  CHECK(fn);
+  auto fn_ = reinterpret_cast<void (*)(void *, int32_t)>(fn);
+
+  cinn_buffer_t *A_buf = common::BufferBuilder(Float(32), {n, c, h, w}).set_random().Build();
+  cinn_buffer_t *B_buf = common::BufferBuilder(Float(32), {n, c, h, w}).set_random().Build();
+  cinn_pod_value_t a_arg(A_buf), b_arg(B_buf);
+  cinn_pod_value_t args[] = {a_arg, b_arg};
+  fn_(args, 2);
+
+  auto input  = reinterpret_cast<float *>(A_buf->memory);
+  auto output = reinterpret_cast<float *>(B_buf->memory);
+  for (int i = 0; i < n * c; ++i) {
+    for (int j = 0; j < h; ++j) {
+      for (int k = 0; k < w; ++k) {
+        float sum = 0.f;
+        int count = 0;
+        for (int y = std::max(j - 1, 0); y < std::min(j + 2, h); ++y) {
+          for (int x = std::max(k - 1, 0); x < std::min(k + 2, w); ++x) {
+            sum += input[(i * h + y) * w + x];
+            count++;
+          }
+        }
+        ASSERT_NEAR(output[(i * h + j) * w + k], sum / count, 1e-5);
+      }
+    }
+  }
+}
+
 TEST(Operator, Operator_Pool3d_Test0) {
   auto pool3d   = Operator::Get("pool3d");
   Operator temp = *pool3d;
@@ -542,6 +606,59 @@ TEST(Operator, Operator_Transpose_Test0) {
   ASSERT_EQ(transpose->description, "This operator implements the meta op transpose.");
 }
 
+TEST(Operator, Operator_Transpose_Tiled) {
+  auto transpose = Operator::Get("transpose");
+  auto strategy  = Operator::GetAttrs<StrategyFunction>("CINNStrategy");
+
+  // the dimensions are multiples of the tile size, so the tiled schedule is used
+  int n = 2, h = 64, w = 96;
+  Placeholder<float> A("A", {Expr(n), Expr(h), Expr(w)});
+
+  NodeAttr attrs;
+  attrs.attr_store["axis"] = std::vector<int>({0, 2, 1});
+  std::vector<ir::Tensor> inputs{A.tensor()};
+  std::vector<Type> type{Float(32)};
+  common::Target target = common::DefaultHostTarget();
+  auto input_shape      = {n, h, w};
+  auto output_shape     = {n, w, h};
+
+  auto impl = OpStrategy::SelectImpl(strategy[transpose](attrs, inputs, type, {output_shape}, target));
+  common::CINNValuePack cinn_input = common::CINNValuePack{{common::CINNValue(A)}};
+  common::CINNValuePack rets       = impl->fcompute(cinn_input);
+  rets                             = impl->fschedule(rets);
+  ASSERT_EQ(rets.size(), 2UL);
+  Expr out = rets[0];
+  inputs.push_back(out.as_tensor_ref());
+  auto func = Lower("transpose_tiled", rets.back(), inputs);
+  LOG(INFO) << "Test Strategy Codegen:\n" << func;
+
+  Module::Builder builder("module0", target);
+  builder.AddFunction(func);
+  auto jit    = backends::ExecutionEngine::Create({});
+  auto module = builder.Build();
+
+  jit->Link(module);
+  auto fn = jit->Lookup("transpose_tiled");
+  CHECK(fn);
+  auto fn_ = reinterpret_cast<void (*)(void *, int32_t)>(fn);
+
+  cinn_buffer_t *A_buf = common::BufferBuilder(Float(32), input_shape).set_random().Build();
+  cinn_buffer_t *B_buf = common::BufferBuilder(Float(32), output_shape).set_random().Build();
+  cinn_pod_value_t a_arg(A_buf), b_arg(B_buf);
+  cinn_pod_value_t args[] = {a_arg, b_arg};
+  fn_(args, 2);
+
+  auto input  = reinterpret_cast<float *>(A_buf->memory);
+  auto output = reinterpret_cast<float *>(B_buf->memory);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < w; ++j) {
+      for (int k = 0; k < h; ++k) {
+        ASSERT_EQ(output[i * w * h + j * h + k], input[i * h * w + k * w + j]);
+      }
+    }
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
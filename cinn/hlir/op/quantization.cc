@@ -0,0 +1,425 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/pe/quantization.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/pe/schedule.h"
+#include "cinn/ir/ir_base.h"
+#include "cinn/poly/stage.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+using common::_CINNValuePack_;
+using common::CINNValue;
+using common::CINNValuePack;
+using framework::OpStrategy;
+using framework::shape_t;
+using framework::StrategyFunction;
+
+namespace {
+
+template <typename T>
+T GetAttrOrDefault(const framework::AttrMapType &attrs, const std::string &key, const T &default_value) {
+  auto it = attrs.find(key);
+  if (it != attrs.end()) {
+    return absl::get<T>(it->second);
+  }
+  return default_value;
+}
+
+framework::CINNSchedule MakeInjectiveSchedule(const std::string &op_name,
+                                              const std::vector<std::vector<int>> &output_shapes,
+                                              const Target &target) {
+  return framework::CINNSchedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of " << op_name << " schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 2UL);
+    Expr out              = arg_pack[0];
+    poly::StageMap stages = arg_pack[1];
+    CHECK(out.as_tensor());
+    if (target.arch == Target::Arch::NVGPU) {
+      pe::CudaScheduleInjective(stages[out.as_tensor_ref()], output_shapes.front(), target);
+    } else if (target.arch == Target::Arch::X86) {
+      pe::ScheduleInjectiveCPU(stages[out.as_tensor_ref()], output_shapes.front(), target);
+    }
+    *ret = arg_pack;
+  });
+}
+
+}  // namespace
+
+std::shared_ptr<OpStrategy> StrategyForQuantize(const framework::NodeAttr &attrs,
+                                                const std::vector<ir::Tensor> &inputs,
+                                                const std::vector<Type> &out_type,
+                                                const std::vector<std::vector<int>> &output_shapes,
+                                                const Target &target) {
+  float scale    = GetAttrOrDefault<float>(attrs.attr_store, "scale", 1.f);
+  int zero_point = GetAttrOrDefault<int>(attrs.attr_store, "zero_point", 0);
+  framework::CINNCompute quantize_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of quantize compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK(!a.empty()) << "at least one input tensor for quantize compute\n";
+    Expr A = a[0];
+    CHECK(A.as_tensor());
+    auto out    = pe::Quantize(A.as_tensor_ref(), scale, zero_point, UniqName("Quantize_output"));
+    auto stages = CreateStages({out});
+    *ret        = CINNValuePack{{CINNValue(Expr(out.get())), CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of quantize op is empty! Please check.";
+  strategy->AddImpl(
+      quantize_compute, MakeInjectiveSchedule("quantize", output_shapes, target), "strategy.quantize.x86", 1);
+  return strategy;
+}
+
+std::shared_ptr<OpStrategy> StrategyForDequantize(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<Type> &out_type,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  const Target &target) {
+  float scale    = GetAttrOrDefault<float>(attrs.attr_store, "scale", 1.f);
+  int zero_point = GetAttrOrDefault<int>(attrs.attr_store, "zero_point", 0);
+  framework::CINNCompute dequantize_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of dequantize compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK(!a.empty()) << "at least one input tensor for dequantize compute\n";
+    Expr A = a[0];
+    CHECK(A.as_tensor());
+    auto out    = pe::Dequantize(A.as_tensor_ref(), scale, zero_point, UniqName("Dequantize_output"));
+    auto stages = CreateStages({out});
+    *ret        = CINNValuePack{{CINNValue(Expr(out.get())), CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of dequantize op is empty! Please check.";
+  strategy->AddImpl(
+      dequantize_compute, MakeInjectiveSchedule("dequantize", output_shapes, target), "strategy.dequantize.x86", 1);
+  return strategy;
+}
+
+std::shared_ptr<OpStrategy> StrategyForRequantize(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<Type> &out_type,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  const Target &target) {
+  float in_scale  = GetAttrOrDefault<float>(attrs.attr_store, "in_scale", 1.f);
+  float out_scale = GetAttrOrDefault<float>(attrs.attr_store, "out_scale", 1.f);
+  int zero_point  = GetAttrOrDefault<int>(attrs.attr_store, "zero_point", 0);
+  framework::CINNCompute requantize_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of requantize compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK(!a.empty()) << "at least one input tensor for requantize compute\n";
+    Expr A = a[0];
+    CHECK(A.as_tensor());
+    auto out = pe::Requantize(A.as_tensor_ref(), in_scale, out_scale, zero_point, UniqName("Requantize_output"));
+    auto stages = CreateStages({out});
+    *ret        = CINNValuePack{{CINNValue(Expr(out.get())), CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of requantize op is empty! Please check.";
+  strategy->AddImpl(
+      requantize_compute, MakeInjectiveSchedule("requantize", output_shapes, target), "strategy.requantize.x86", 1);
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForQuantize(const std::vector<shape_t> &inputs_shape,
+                                           const framework::AttrMapType &attrs) {
+  CHECK(!inputs_shape.empty() && !inputs_shape[0].empty()) << "The input's shape size is 0! Please check again.";
+  return {inputs_shape[0]};
+}
+
+std::vector<Type> InferDtypeForQuantize(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {Int(8)};
+}
+
+std::vector<Type> InferDtypeForDequantize(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {Float(32)};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForQuantize(const std::vector<shape_t> &input_shapes,
+                                                             const std::vector<std::string> &input_layouts,
+                                                             const framework::NodeAttr &attrs,
+                                                             const Target &target) {
+  CHECK_EQ(input_layouts.size(), 1U) << "The input's layout size is not 1! Please check again.";
+  return {input_layouts, input_layouts};
+}
+
+std::shared_ptr<OpStrategy> StrategyForQuantizedMatmul(const framework::NodeAttr &attrs,
+                                                       const std::vector<ir::Tensor> &inputs,
+                                                       const std::vector<Type> &out_type,
+                                                       const std::vector<std::vector<int>> &output_shapes,
+                                                       const Target &target) {
+  bool trans_a = GetAttrOrDefault<bool>(attrs.attr_store, "trans_a", false);
+  bool trans_b = GetAttrOrDefault<bool>(attrs.attr_store, "trans_b", false);
+  framework::CINNCompute matmul_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of quantized_matmul compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK_GE(a.size(), 2U) << "at least 2 input tensors for quantized_matmul compute\n";
+    Expr A = a[0];
+    Expr B = a[1];
+    CHECK(A.as_tensor());
+    CHECK(B.as_tensor());
+    auto out = pe::QuantizedMatmul(
+        A.as_tensor_ref(), B.as_tensor_ref(), trans_a, trans_b, UniqName("QuantizedMatmul_output"));
+    auto stages = CreateStages({A.as_tensor_ref(), B.as_tensor_ref(), out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  framework::CINNSchedule matmul_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of quantized_matmul schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 2UL);
+    Expr out              = arg_pack[0];
+    poly::StageMap stages = arg_pack[1];
+    CHECK(out.as_tensor());
+    if (target.arch == Target::Arch::NVGPU) {
+      stages[out.as_tensor_ref()]->Split(1, 2);
+      stages[out.as_tensor_ref()]->Bind(0, "blockIdx.x");
+      stages[out.as_tensor_ref()]->Bind(1, "threadIdx.x");
+    } else if (target.arch == Target::Arch::X86) {
+      pe::QuantizedMatmulScheduleCPU(stages, out.as_tensor_ref(), target);
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(matmul_compute, matmul_schedule, "strategy.quantized_matmul.x86", 1);
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForQuantizedMatmul(const std::vector<shape_t> &inputs_shape,
+                                                  const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The input's shape size should be 2! Please check again.";
+  bool trans_a   = GetAttrOrDefault<bool>(attrs, "trans_a", false);
+  bool trans_b   = GetAttrOrDefault<bool>(attrs, "trans_b", false);
+  auto &shape_a  = inputs_shape[0];
+  auto &shape_b  = inputs_shape[1];
+  int a_dim      = shape_a.size();
+  int b_dim      = shape_b.size();
+  CHECK(a_dim == 2 || a_dim == 3) << "quantized_matmul only supports 2-D or 3-D inputs, but got " << a_dim;
+  CHECK_EQ(a_dim, b_dim) << "The two inputs of quantized_matmul should have the same rank";
+  int k_a = trans_a ? shape_a[a_dim - 2] : shape_a[a_dim - 1];
+  int k_b = trans_b ? shape_b[b_dim - 1] : shape_b[b_dim - 2];
+  CHECK_EQ(k_a, k_b) << "The reduce dims of quantized_matmul's inputs should be equal";
+  shape_t output_shape;
+  if (a_dim == 3) {
+    CHECK(shape_a[0] == shape_b[0] || shape_a[0] == 1 || shape_b[0] == 1)
+        << "The batch sizes of quantized_matmul's inputs can't be broadcast: " << shape_a[0] << " vs " << shape_b[0];
+    output_shape.push_back(std::max(shape_a[0], shape_b[0]));
+  }
+  output_shape.push_back(trans_a ? shape_a[a_dim - 1] : shape_a[a_dim - 2]);
+  output_shape.push_back(trans_b ? shape_b[b_dim - 2] : shape_b[b_dim - 1]);
+  return {output_shape};
+}
+
+std::vector<Type> InferDtypeForQuantizedMatmul(const std::vector<Type> &inputs_type,
+                                               const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 2U) << "The input's type size should be 2! Please check again.";
+  CHECK(inputs_type[0].is_int(8) && inputs_type[1].is_int(8)) << "quantized_matmul only supports int8 inputs";
+  return {Int(32)};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForQuantizedMatmul(const std::vector<shape_t> &input_shapes,
+                                                                    const std::vector<std::string> &input_layouts,
+                                                                    const framework::NodeAttr &attrs,
+                                                                    const Target &target) {
+  CHECK_EQ(input_layouts.size(), 2U) << "The input's layouts size is not 2! Please check again.";
+  std::vector<std::string> new_input_layouts = input_layouts;
+  for (int i = 0; i < input_shapes.size(); i++) {
+    if (input_shapes[i].size() > 4) {
+      // alter input layout back
+      new_input_layouts[i] = "NCHW";
+    }
+  }
+  return {{""}, new_input_layouts};
+}
+
+std::shared_ptr<OpStrategy> StrategyForQuantizedConv2d(const framework::NodeAttr &attrs,
+                                                       const std::vector<ir::Tensor> &inputs,
+                                                       const std::vector<Type> &out_type,
+                                                       const std::vector<std::vector<int>> &output_shapes,
+                                                       const Target &target) {
+  auto padding  = GetAttrOrDefault<std::vector<int>>(attrs.attr_store, "padding", {0, 0});
+  auto stride   = GetAttrOrDefault<std::vector<int>>(attrs.attr_store, "stride", {1, 1});
+  auto dilation = GetAttrOrDefault<std::vector<int>>(attrs.attr_store, "dilation", {1, 1});
+  CHECK_EQ(padding.size(), 2U) << "The size of padding in quantized_conv2d op is not 2! Please check.";
+  CHECK_EQ(stride.size(), 2U) << "The size of stride in quantized_conv2d op is not 2! Please check.";
+  CHECK_EQ(dilation.size(), 2U) << "The size of dilation in quantized_conv2d op is not 2! Please check.";
+  framework::CINNCompute conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of quantized_conv2d compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK_GE(a.size(), 2U) << "at least 2 input tensors for quantized_conv2d compute\n";
+    Expr A = a[0];
+    Expr B = a[1];
+    CHECK(A.as_tensor());
+    CHECK(B.as_tensor());
+    auto out    = pe::QuantizedConv2d_NCHW(A.as_tensor_ref(),
+                                        B.as_tensor_ref(),
+                                        padding[0],
+                                        padding[1],
+                                        stride[0],
+                                        stride[1],
+                                        dilation[0],
+                                        dilation[1],
+                                        UniqName("QuantizedConv2d_output"));
+    auto stages = CreateStages({A.as_tensor_ref(), B.as_tensor_ref()});
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule conv2d_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of quantized_conv2d schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 3UL);
+    Expr out              = arg_pack[0];
+    Expr input_pad        = arg_pack[1];
+    poly::StageMap stages = arg_pack[2];
+    CHECK(out.as_tensor());
+    CHECK(input_pad.as_tensor());
+    if (target.arch == Target::Arch::X86) {
+      // the padded int8 input is a plain copy
+      pe::ScheduleInjectiveCPU(stages[input_pad.as_tensor_ref()], output_shapes[1], target);
+      pe::QuantizedConv2dScheduleCPU(stages, out.as_tensor_ref(), target);
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(conv2d_compute, conv2d_schedule, "strategy.quantized_conv2d.x86", 1);
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForQuantizedConv2d(const std::vector<shape_t> &inputs_shape,
+                                                  const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The input's shape size should be 2! Please check again.";
+  CHECK_EQ(inputs_shape[0].size(), 4U) << "quantized_conv2d only supports NCHW input";
+  CHECK_EQ(inputs_shape[1].size(), 4U) << "quantized_conv2d only supports OIHW weight";
+  auto padding  = GetAttrOrDefault<std::vector<int>>(attrs, "padding", {0, 0});
+  auto stride   = GetAttrOrDefault<std::vector<int>>(attrs, "stride", {1, 1});
+  auto dilation = GetAttrOrDefault<std::vector<int>>(attrs, "dilation", {1, 1});
+  auto &x       = inputs_shape[0];
+  auto &w       = inputs_shape[1];
+  int out_h     = (x[2] - ((w[2] - 1) * dilation[0] + 1) + 2 * padding[0]) / stride[0] + 1;
+  int out_w     = (x[3] - ((w[3] - 1) * dilation[1] + 1) + 2 * padding[1]) / stride[1] + 1;
+  shape_t output_shape{x[0], w[0], out_h, out_w};
+  shape_t input_pad_shape{x[0], x[1], x[2] + 2 * padding[0], x[3] + 2 * padding[1]};
+  return {output_shape, input_pad_shape};
+}
+
+std::vector<Type> InferDtypeForQuantizedConv2d(const std::vector<Type> &inputs_type,
+                                               const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 2U) << "The input's type size should be 2! Please check again.";
+  CHECK(inputs_type[0].is_int(8) && inputs_type[1].is_int(8)) << "quantized_conv2d only supports int8 inputs";
+  return {Int(32), Int(8)};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForQuantizedConv2d(const std::vector<shape_t> &input_shapes,
+                                                                    const std::vector<std::string> &input_layouts,
+                                                                    const framework::NodeAttr &attrs,
+                                                                    const Target &target) {
+  CHECK_EQ(input_layouts.size(), 2U) << "The input's layouts size is not 2! Please check again.";
+  // the int8 kernel is written for NCHW, so a blocked input is transformed back first
+  return {{"NCHW", "NCHW"}, {"NCHW", "OIHW"}};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(quantization_ops) {
+  CINN_REGISTER_OP(quantize)
+      .describe("Quantize a float32 tensor to int8 with a per-tensor scale and zero point.")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForQuantize)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantize))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForQuantize))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantize))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(dequantize)
+      .describe("Dequantize an int8 or int32 tensor to float32 with a per-tensor scale and zero point.")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForDequantize)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantize))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForDequantize))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantize))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(requantize)
+      .describe("Rescale an int32 accumulator to int8.")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForRequantize)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantize))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForQuantize))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantize))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(quantized_matmul)
+      .describe("Multiply two int8 matrices and accumulate the result in int32.")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForQuantizedMatmul)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantizedMatmul))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForQuantizedMatmul))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantizedMatmul))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(quantized_conv2d)
+      .describe("Do a 2-D convolution on int8 NCHW tensors and accumulate the result in int32.")
+      .set_num_inputs(2)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForQuantizedConv2d)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantizedConv2d))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForQuantizedConv2d))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantizedConv2d))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
+  return true;
+}
@@ -23,7 +23,9 @@
 #include "cinn/hlir/pe/broadcast.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/hlir/pe/transform.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_operators.h"
+#include "cinn/lang/compute.h"
 
 namespace cinn {
 namespace hlir {
@@ -83,6 +85,20 @@ std::shared_ptr<OpStrategy> StrategyForBnMeanVariance(const framework::NodeAttr
     CHECK(A.as_tensor());
     auto x = A.as_tensor_ref();
 
+    if (target.arch == Target::Arch::X86) {
+      // both sums are accumulated in one pass over x by MultiReduceScheduleCPU
+      auto stages       = CreateStages({x});
+      auto x_square     = pe::Multiply(x, x, UniqName("bn_mean_variance_x_square"));
+      auto x_sum        = pe::ReduceSum(x, {0, 2, 3}, false, Expr(0.0f), UniqName("bn_mean_variance_out0"));
+      auto x_square_sum = pe::ReduceSum(x_square, {0, 2, 3}, false, Expr(0.0f), UniqName("bn_mean_variance_out1"));
+      stages->InsertLazily(x_square);
+      stages->InsertLazily(x_sum);
+      stages->InsertLazily(x_square_sum);
+      stages[x_square]->ComputeInline();
+      *ret = CINNValuePack{{CINNValue(x_sum), CINNValue(x_square_sum), CINNValue(stages)}};
+      return;
+    }
+
     auto stages     = CreateStages({x});
     auto x_reshape  = pe::Reshape(x, new_shape, stages, UniqName("bn_mean_variance_x_reshape_out"));
     auto x_square   = pe::Multiply(x_reshape, x_reshape, UniqName("bn_mean_variance_x_square"));
@@ -121,8 +137,8 @@ std::shared_ptr<OpStrategy> StrategyForBnMeanVariance(const framework::NodeAttr
   framework::CINNSchedule bn_mean_variance_schedule([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of bn_mean_variance schedule is empty! Please check.";
     CINNValuePack arg_pack = args[0];
-    CHECK_EQ(arg_pack.size(), 7UL);
     if (target.arch == Target::Arch::NVGPU) {
+      CHECK_EQ(arg_pack.size(), 7UL);
       Expr x_sum_local        = arg_pack[0];
       Expr x_square_sum_local = arg_pack[1];
       Expr x_sum_tmp          = arg_pack[2];
@@ -154,10 +170,13 @@ std::shared_ptr<OpStrategy> StrategyForBnMeanVariance(const framework::NodeAttr
       stages[x_square_sum_tmp.as_tensor_ref()]->SimpleComputeAt(stages[x_sum_tmp.as_tensor_ref()], 1);
       stages[x_square_sum.as_tensor_ref()]->SimpleComputeAt(stages[x_sum.as_tensor_ref()], 0);
     } else if (target.arch == Target::Arch::X86) {
-      Expr out              = arg_pack[0];
-      poly::StageMap stages = arg_pack[1];
-      CHECK(out.as_tensor());
-      pe::ScheduleInjectiveCPU(stages[out.as_tensor_ref()], output_shapes.front(), target);
+      CHECK_EQ(arg_pack.size(), 3UL);
+      Expr x_sum            = arg_pack[0];
+      Expr x_square_sum     = arg_pack[1];
+      poly::StageMap stages = arg_pack[2];
+      CHECK(x_sum.as_tensor());
+      CHECK(x_square_sum.as_tensor());
+      pe::MultiReduceScheduleCPU(stages, {x_sum.as_tensor_ref(), x_square_sum.as_tensor_ref()}, target);
     }
     *ret = arg_pack;
   });
@@ -177,7 +196,7 @@ std::shared_ptr<OpStrategy> StrategyForBnGradBiasScale(const framework::NodeAttr
                                                        const std::vector<Type> &out_type,
                                                        const std::vector<std::vector<int>> &output_shapes,
                                                        const Target &target) {
-  CHECK_EQ(inputs.size(), 3) << "bn_grad_bias_scale should has 3 input!";
+  CHECK(inputs.size() == 3 || inputs.size() == 4) << "bn_grad_bias_scale should has 3 or 4 inputs!";
   auto input = inputs[0];
   CHECK_EQ(input->shape.size(), 4) << "bn_grad_bias_scale input shape should be 4 dimension!";
   // compute the new shape for reduce.
@@ -198,7 +217,42 @@ std::shared_ptr<OpStrategy> StrategyForBnGradBiasScale(const framework::NodeAttr
     auto x_mean = Mean.as_tensor_ref();
     auto y_grad = Grad.as_tensor_ref();
 
-    auto stages         = CreateStages({x, x_mean, y_grad});
+    auto stages = CreateStages({x, x_mean, y_grad});
+    if (a.size() > 3) {
+      // the 4th input is the output of the relu after batch norm, whose grad is fused into the reductions
+      Expr Out = a[3];
+      CHECK(Out.as_tensor());
+      auto relu_out = Out.as_tensor_ref();
+      stages->InsertLazily(relu_out);
+      auto relu_grad = lang::Compute(
+          y_grad->shape,
+          [=](const std::vector<Expr> &indice) {
+            return ir::Select::Make(relu_out(indice) > Expr(0.0f), y_grad(indice), Expr(0.0f));
+          },
+          UniqName("bn_grad_bias_scale_relu_grad"));
+      stages->InsertLazily(relu_grad);
+      stages[relu_grad]->ComputeInline();
+      y_grad = relu_grad;
+    }
+
+    if (target.arch == Target::Arch::X86) {
+      // both sums are accumulated in one pass over x and y_grad by MultiReduceScheduleCPU
+      auto x_mean_diff      = pe::Substract(x, x_mean, UniqName("bn_grad_bias_scale_mean_diff"), Expr(1));
+      auto grad_x_mean_diff = pe::Multiply(y_grad, x_mean_diff, UniqName("bn_grad_bias_scale_grad_mean_diff"));
+
+      auto bias_sum = pe::ReduceSum(y_grad, {0, 2, 3}, false, Expr(0.0f), UniqName("bn_grad_bias_scale_out0"));
+      auto diff_sum =
+          pe::ReduceSum(grad_x_mean_diff, {0, 2, 3}, false, Expr(0.0f), UniqName("bn_grad_bias_scale_out1"));
+      stages->InsertLazily(x_mean_diff);
+      stages->InsertLazily(grad_x_mean_diff);
+      stages->InsertLazily(bias_sum);
+      stages->InsertLazily(diff_sum);
+      stages[x_mean_diff]->ComputeInline();
+      stages[grad_x_mean_diff]->ComputeInline();
+      *ret = CINNValuePack{{CINNValue(bias_sum), CINNValue(diff_sum), CINNValue(stages)}};
+      return;
+    }
+
     auto x_reshape      = pe::Reshape(x, new_shape, stages, UniqName("bn_grad_bias_scale_x_reshape_out"));
     auto y_grad_reshape = pe::Reshape(y_grad, new_shape, stages, UniqName("bn_grad_bias_scale_grad_reshape_out"));
 
@@ -245,8 +299,8 @@ std::shared_ptr<OpStrategy> StrategyForBnGradBiasScale(const framework::NodeAttr
   framework::CINNSchedule bn_grad_bias_scale_schedule([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of bn_grad_bias_scale schedule is empty! Please check.\n";
     CINNValuePack arg_pack = args[0];
-    CHECK_EQ(arg_pack.size(), 7UL);
     if (target.arch == Target::Arch::NVGPU) {
+      CHECK_EQ(arg_pack.size(), 7UL);
       Expr reduce_local_bias   = arg_pack[0];
       Expr reduce_local_diff   = arg_pack[1];
       Expr reduce_sum_bias_tmp = arg_pack[2];
@@ -278,10 +332,13 @@ std::shared_ptr<OpStrategy> StrategyForBnGradBiasScale(const framework::NodeAttr
       stages[reduce_sum_diff_tmp.as_tensor_ref()]->SimpleComputeAt(stages[reduce_sum_bias_tmp.as_tensor_ref()], 1);
       stages[reduce_sum_diff.as_tensor_ref()]->SimpleComputeAt(stages[reduce_sum_bias.as_tensor_ref()], 0);
     } else if (target.arch == Target::Arch::X86) {
-      Expr out              = arg_pack[0];
-      poly::StageMap stages = arg_pack[1];
-      CHECK(out.as_tensor());
-      pe::ScheduleInjectiveCPU(stages[out.as_tensor_ref()], output_shapes.front(), target);
+      CHECK_EQ(arg_pack.size(), 3UL);
+      Expr bias_sum         = arg_pack[0];
+      Expr diff_sum         = arg_pack[1];
+      poly::StageMap stages = arg_pack[2];
+      CHECK(bias_sum.as_tensor());
+      CHECK(diff_sum.as_tensor());
+      pe::MultiReduceScheduleCPU(stages, {bias_sum.as_tensor_ref(), diff_sum.as_tensor_ref()}, target);
     }
     *ret = arg_pack;
   });
@@ -350,6 +407,42 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
     }
   }
 
+  // compute the two stage reduce args on x86
+  int lanes        = 1;
+  int num_partials = 1;
+  if (target.arch == Target::Arch::X86) {
+    int rank      = inputs[0]->shape.size();
+    int last_dim  = inputs[0]->shape.back().as_int32();
+    int kept_size = 1, reduce_size = 1;
+    for (int idx = 0; idx < rank; ++idx) {
+      if (std::find(dim.begin(), dim.end(), idx) != dim.end()) {
+        reduce_size *= inputs[0]->shape[idx].as_int32();
+      } else {
+        kept_size *= inputs[0]->shape[idx].as_int32();
+      }
+    }
+    // the reduced last axis is accumulated in vector lanes, and the lanes are summed up at the end
+    if (dim.back() == rank - 1) {
+      int factor = pe::GetVectorizeFactor(last_dim, pe::GetBasicFactor(inputs[0]->type(), target));
+      if (factor > 1 && last_dim >= 2 * factor) {
+        lanes = factor;
+      }
+    }
+    // too few outputs to run in parallel, split the first reduce axis into chunks reduced by different threads
+    if (kept_size < 16 && reduce_size >= 8192) {
+      int first_dim = inputs[0]->shape[dim.front()].as_int32();
+      if (dim.front() == rank - 1) {
+        first_dim /= lanes;
+      }
+      for (int factor = 32; factor >= 4; --factor) {
+        if (first_dim % factor == 0) {
+          num_partials = factor;
+          break;
+        }
+      }
+    }
+  }
+
   framework::CINNCompute reduction_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of " << op_name << " compute is empty! Please check.";
     CINNValuePack a = args[0];
@@ -399,6 +492,13 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
         auto stages = CreateStages({res[0], res[1], out});
         *ret        = CINNValuePack{{CINNValue(res[0]), CINNValue(res[1]), CINNValue(out), CINNValue(stages)}};
       }
+    } else if (target.arch == Target::Arch::X86 && (lanes > 1 || num_partials > 1)) {
+      VLOG(3) << "Do TwoStageReduce Compute with " << num_partials << " partials and " << lanes << " lanes!";
+      auto res = pe::TwoStageReduce(x, dim, pe_func, keep_dim, num_partials, lanes, UniqName(op_name + "_out"));
+      CHECK_EQ(res.size(), 3);
+      // the partial results and the view are temporary tensors rather than outputs of the op
+      auto stages = CreateStages(res);
+      *ret        = CINNValuePack{{CINNValue(res[0]), CINNValue(stages)}};
     } else {
       VLOG(3) << "Do ReduceSum Compute!";
       auto out    = pe_func(x, dim, keep_dim, Expr(), UniqName(op_name + "_out"));
@@ -448,6 +548,27 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
         VLOG(3) << "Do CudaScheduleReduce Schedule!";
         pe::CudaScheduleReduce(stages, out.as_tensor_ref(), inputs[0]->shape.size() - dim.back() - 1, target);
       }
+    } else if (target.arch == Target::Arch::X86) {
+      CHECK_EQ(arg_pack.size(), 2UL);
+      Expr out              = arg_pack[0];
+      poly::StageMap stages = arg_pack.back();
+      CHECK(out.as_tensor());
+      ir::Tensor out_tensor = out.as_tensor_ref();
+      if (lanes > 1 || num_partials > 1) {
+        // get the only tensor loaded by the body of a two stage reduce tensor
+        auto get_loaded_tensor = [](const ir::Tensor &tensor) {
+          auto loaded = ir::CollectLoadTensors(tensor->body(), [](const Expr *x) { return x->as_tensor(); });
+          CHECK_EQ(loaded.size(), 1U) << "Tensor " << tensor->name << " should only load one tensor";
+          return loaded.begin()->as_tensor_ref();
+        };
+        auto partial = get_loaded_tensor(out_tensor);
+        auto view    = get_loaded_tensor(partial);
+        VLOG(3) << "Do TwoStageReduceScheduleCPU Schedule!";
+        pe::TwoStageReduceScheduleCPU(stages, out_tensor, partial, view, num_partials, lanes, target);
+      } else {
+        VLOG(3) << "Do ReduceScheduleCPU Schedule!";
+        pe::ReduceScheduleCPU(stages, out_tensor, dim.back() == inputs[0]->shape.size() - 1, target);
+      }
     }
     *ret = arg_pack;
   });
@@ -460,7 +581,7 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
 
 std::vector<shape_t> InferShapeForReduction(const std::vector<shape_t> &inputs_shape,
                                             const framework::AttrMapType &attrs) {
-  CHECK(inputs_shape.size() == 1UL || inputs_shape.size() == 3UL);
+  CHECK(inputs_shape.size() == 1UL || inputs_shape.size() == 3UL || inputs_shape.size() == 4UL);
   std::vector<int> dim;
   bool keep_dim = false;
   if (attrs.find("dim") != attrs.end()) {
@@ -582,8 +703,8 @@ CINN_REGISTER_HELPER(reduce_ops) {
       .set_support_level(4);
 
   CINN_REGISTER_OP(bn_grad_bias_scale)
-      .describe("This operator implements the optimization of bn grad reduce")
-      .set_num_inputs(3)
+      .describe("This operator implements the optimization of bn grad reduce, maybe with the grad of relu")
+      .set_num_inputs(4)  // x, mean, grad and the optional relu output
       .set_num_outputs(2)
       .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForBnGradBiasScale)
       .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForBnOptimize))
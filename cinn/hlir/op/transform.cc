@@ -1076,6 +1076,8 @@ std::shared_ptr<OpStrategy> StrategyForTranspose(const framework::NodeAttr &attr
     CHECK(out.as_tensor());
     if (target.arch == Target::Arch::NVGPU) {
       pe::CudaScheduleInjective(stages[out.as_tensor_ref()], output_shapes[0], target);
+    } else if (target.arch == Target::Arch::X86) {
+      pe::TransposeScheduleCPU(stages, out.as_tensor_ref(), axis, target);
     }
     *ret = arg_pack;
   });
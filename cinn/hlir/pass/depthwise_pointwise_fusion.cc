@@ -0,0 +1,325 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/hlir/pe/schedule.h"
+
+DEFINE_bool(cinn_fuse_depthwise_pointwise,
+            true,
+            "Whether to fuse the depthwise conv2d, the batch norm and relu/relu6 after it and the 1x1 conv2d reading "
+            "it into one depthwise_pointwise_conv2d op on x86.");
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::GraphNode;
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Operator;
+using framework::shape_t;
+
+namespace {
+
+// depthwise_conv2d -> [batchnorm] -> [relu/relu6] -> conv2d(1x1)
+struct DepthwisePointwiseChain {
+  Node* depthwise{nullptr};
+  Node* batchnorm{nullptr};
+  Node* activation{nullptr};
+  Node* pointwise{nullptr};
+};
+
+template <typename T>
+T GetAttr(const Node* node, const std::string& key, const T& default_value) {
+  auto it = node->attrs.attr_store.find(key);
+  return it == node->attrs.attr_store.end() ? default_value : absl::get<T>(it->second);
+}
+
+class DepthwisePointwiseFuser {
+ public:
+  explicit DepthwisePointwiseFuser(Graph* graph)
+      : graph_(graph),
+        shape_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape")),
+        type_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype")) {
+    for (auto* output : graph->outputs) {
+      kept_var_ids_.insert(output->id());
+    }
+    if (graph->HasAttr("fetch_var_ids")) {
+      auto& fetch_var_ids = graph->GetAttrs<std::unordered_set<std::string>>("fetch_var_ids");
+      kept_var_ids_.insert(fetch_var_ids.begin(), fetch_var_ids.end());
+    }
+  }
+
+  void operator()();
+
+ private:
+  const shape_t& InputShape(Node* node, int index) {
+    return shape_dict_.at(node->inlinks_in_order(true)[index]->source()->id());
+  }
+
+  // NCHW depthwise conv2d with a channel multiplier 1 and no dilation, or the same conv2d with groups equal to the
+  // channels, which is the depthwise conv2d of paddle models on x86.
+  bool IsDepthwise(Node* node);
+
+  // NCHW 1x1 conv2d with stride 1, no padding and no groups.
+  bool IsPointwise(Node* node);
+
+  // Whether any output of `node` is a graph output or fetched, which should not be fused away.
+  bool HasKeptOutput(Node* node);
+
+  // The only op reading the first output of `node` as its first input, or nullptr if the output is read by others or
+  // the other outputs of `node` are read or kept.
+  Node* OnlyConsumer(Node* node);
+
+  // Add a NodeData of `shape` and `type` as the `index`-th output of `node`.
+  NodeData* AddOutput(const std::shared_ptr<Node>& node, int index, const shape_t& shape, const Type& type);
+
+  void Fuse(const DepthwisePointwiseChain& chain);
+
+  Graph* graph_;
+  absl::flat_hash_map<std::string, shape_t>& shape_dict_;
+  absl::flat_hash_map<std::string, Type>& type_dict_;
+  std::unordered_set<std::string> kept_var_ids_;
+};
+
+bool DepthwisePointwiseFuser::IsDepthwise(Node* node) {
+  const auto& op_name = node->op()->name;
+  if (op_name != "depthwise_conv2d" && op_name != "conv2d") return false;
+  if (GetAttr<std::string>(node, "data_format", "NCHW") != "NCHW") return false;
+  if (GetAttr<std::string>(node, "conv_type", "forward") != "forward") return false;
+  if (GetAttr<std::vector<int>>(node, "dilation", {1, 1}) != std::vector<int>({1, 1})) return false;
+  if (node->inlinks_in_order(true).size() != 2U) return false;
+  // x: [N, C, H, W], weight: [C, 1, kh, kw]
+  const auto& x_shape = InputShape(node, 0);
+  const auto& w_shape = InputShape(node, 1);
+  if (x_shape.size() != 4U || w_shape.size() != 4U || w_shape[0] != x_shape[1] || w_shape[1] != 1) return false;
+  return op_name == "depthwise_conv2d" || GetAttr<int>(node, "groups", 1) == x_shape[1];
+}
+
+bool DepthwisePointwiseFuser::IsPointwise(Node* node) {
+  if (node->op()->name != "conv2d") return false;
+  if (GetAttr<std::string>(node, "data_format", "NCHW") != "NCHW") return false;
+  if (GetAttr<std::string>(node, "conv_type", "forward") != "forward") return false;
+  if (GetAttr<int>(node, "groups", 1) != 1) return false;
+  if (GetAttr<std::vector<int>>(node, "stride", {1, 1}) != std::vector<int>({1, 1})) return false;
+  if (GetAttr<std::vector<int>>(node, "padding", {0, 0}) != std::vector<int>({0, 0})) return false;
+  if (GetAttr<std::vector<int>>(node, "dilation", {1, 1}) != std::vector<int>({1, 1})) return false;
+  if (node->inlinks_in_order(true).size() != 2U) return false;
+  // x: [N, C, H, W], weight: [O, C, 1, 1]
+  const auto& x_shape = InputShape(node, 0);
+  const auto& w_shape = InputShape(node, 1);
+  return x_shape.size() == 4U && w_shape.size() == 4U && w_shape[1] == x_shape[1] && w_shape[2] == 1 &&
+         w_shape[3] == 1;
+}
+
+bool DepthwisePointwiseFuser::HasKeptOutput(Node* node) {
+  for (auto& link : node->outlinks_in_order(true)) {
+    if (kept_var_ids_.count(link->sink()->id())) return true;
+  }
+  return false;
+}
+
+Node* DepthwisePointwiseFuser::OnlyConsumer(Node* node) {
+  auto& outlinks = node->outlinks_in_order(true);
+  if (outlinks.empty() || HasKeptOutput(node)) return nullptr;
+  for (size_t i = 1; i < outlinks.size(); i++) {
+    if (!outlinks[i]->sink()->outlinks().empty()) return nullptr;
+  }
+  auto* out = outlinks[0]->sink();
+  if (out->outlinks().size() != 1U) return nullptr;
+  auto* consumer = (*out->outlinks().begin())->sink()->safe_as<Node>();
+  if (!consumer || consumer->inlinks_in_order(true)[0]->source() != out) return nullptr;
+  return consumer;
+}
+
+NodeData* DepthwisePointwiseFuser::AddOutput(const std::shared_ptr<Node>& node,
+                                             int index,
+                                             const shape_t& shape,
+                                             const Type& type) {
+  auto* data = new NodeData(node, index, 0, common::UniqName(node->id() + "_out"));
+  node->LinkTo(data);
+  graph_->RegisterNode(data->id(), data);
+  shape_dict_[data->id()] = shape;
+  type_dict_[data->id()]  = type;
+  return data;
+}
+
+void DepthwisePointwiseFuser::Fuse(const DepthwisePointwiseChain& chain) {
+  auto* x         = chain.depthwise->inlinks_in_order(true)[0]->source();
+  auto* dw_weight = chain.depthwise->inlinks_in_order(true)[1]->source();
+  auto* pw_weight = chain.pointwise->inlinks_in_order(true)[1]->source();
+  auto* out_var   = chain.pointwise->outlinks_in_order(true)[0]->sink()->safe_as<NodeData>();
+  CHECK(out_var);
+  // copied, the dicts are changed when the outputs of the pack op are added
+  shape_t x_shape   = shape_dict_.at(x->id());
+  shape_t dw_shape  = shape_dict_.at(dw_weight->id());
+  shape_t pw_shape  = shape_dict_.at(pw_weight->id());
+  shape_t out_shape = shape_dict_.at(out_var->id());
+  Type type         = type_dict_.at(x->id());
+
+  // the channel blocks are the ones of the pointwise convolution, which does the most of the work
+  int ic = x_shape[1];
+  int oc = pw_shape[0];
+  std::string key =
+      pe::GenerateX86ConvKey({out_shape[0], ic, out_shape[2], out_shape[3]}, pw_shape, {1, 1}, {0, 0}, {1, 1});
+  absl::flat_hash_map<std::string, int> conv2d_factors;
+  pe::GetConv2dFactors(&conv2d_factors, oc, ic, ic, -1, -1, type, graph_->target_, key);
+  CHECK(conv2d_factors.count("ic_bn"));
+  CHECK(conv2d_factors.count("oc_bn"));
+  int ic_bn = conv2d_factors["ic_bn"];
+  int oc_bn = conv2d_factors["oc_bn"];
+
+  // the packed weights only depend on the weights and the batch norm params, ConstPropagate marks the pack op to
+  // pre_run if they are constants
+  std::string pack_type = chain.batchnorm ? "depthwise_pointwise_pack_bn" : "depthwise_pointwise_pack";
+  auto* pack_node       = new Node(Operator::Get(pack_type), pack_type, common::UniqName(pack_type));
+  pack_node->attrs.attr_store["ic_bn"] = ic_bn;
+  pack_node->attrs.attr_store["oc_bn"] = oc_bn;
+  std::vector<GraphNode*> pack_inputs{dw_weight, pw_weight};
+  if (chain.batchnorm) {
+    auto& bn_inlinks = chain.batchnorm->inlinks_in_order(true);
+    for (size_t i = 1; i < bn_inlinks.size(); i++) {
+      pack_inputs.push_back(bn_inlinks[i]->source());
+    }
+    pack_node->attrs.attr_store["epsilon"] = GetAttr<float>(chain.batchnorm, "epsilon", 0.00001f);
+  }
+
+  std::string op_type = "depthwise_pointwise_conv2d";
+  auto* node          = new Node(Operator::Get(op_type), op_type, common::UniqName(op_type));
+  node->attrs.attr_store["padding"] = GetAttr<std::vector<int>>(chain.depthwise, "padding", {0, 0});
+  node->attrs.attr_store["stride"]  = GetAttr<std::vector<int>>(chain.depthwise, "stride", {1, 1});
+  if (chain.activation) {
+    node->attrs.attr_store["activation"] = chain.activation->op()->name;
+  }
+
+  // unlink the chain, only the output of the pointwise conv2d is kept
+  for (auto* old_node : {chain.depthwise, chain.batchnorm, chain.activation, chain.pointwise}) {
+    if (!old_node) continue;
+    auto inlinks  = old_node->inlinks_in_order(true);
+    auto outlinks = old_node->outlinks_in_order(true);
+    for (auto& link : inlinks) {
+      link->source()->UnLinkTo(old_node);
+    }
+    for (auto& link : outlinks) {
+      old_node->UnLinkTo(link->sink());
+    }
+  }
+  for (auto* input : pack_inputs) {
+    input->LinkTo(pack_node);
+  }
+  std::shared_ptr<Node> pack_node_ptr(pack_node);
+  // the packed depthwise weight, the depthwise bias and the packed pointwise weight
+  std::vector<NodeData*> packed{AddOutput(pack_node_ptr, 0, {ic / ic_bn, dw_shape[2], dw_shape[3], ic_bn}, type),
+                                AddOutput(pack_node_ptr, 1, {ic / ic_bn, ic_bn}, type),
+                                AddOutput(pack_node_ptr, 2, {oc / oc_bn, ic / ic_bn, ic_bn, oc_bn}, type)};
+  graph_->RegisterNode(pack_node->id(), pack_node);
+
+  x->LinkTo(node);
+  for (auto* data : packed) {
+    data->LinkTo(node);
+  }
+  std::shared_ptr<Node> node_ptr(node);
+  out_var->source_node = node_ptr;
+  node->LinkTo(out_var);
+  graph_->RegisterNode(node->id(), node);
+  VLOG(3) << "Fuse " << chain.depthwise->id() << " and " << chain.pointwise->id() << " into " << pack_node->id()
+          << " and " << node->id();
+}
+
+void DepthwisePointwiseFuser::operator()() {
+  std::vector<DepthwisePointwiseChain> chains;
+  // a conv2d of 1 channel may be both the pointwise one of a chain and the depthwise one of the next chain
+  std::unordered_set<Node*> pointwise_nodes;
+  for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node || pointwise_nodes.count(node) || !IsDepthwise(node)) continue;
+    DepthwisePointwiseChain chain;
+    chain.depthwise = node;
+    auto* next      = OnlyConsumer(node);
+    if (next && next->op()->name == "batchnorm") {
+      chain.batchnorm = next;
+      next            = OnlyConsumer(next);
+    }
+    if (next && (next->op()->name == "relu" || next->op()->name == "relu6")) {
+      chain.activation = next;
+      next             = OnlyConsumer(next);
+    }
+    if (!next || !IsPointwise(next)) continue;
+    // the other outputs of the pointwise conv2d, e.g. the packed output, should not be read or kept
+    auto& outlinks = next->outlinks_in_order(true);
+    bool only_out  = true;
+    for (size_t i = 1; i < outlinks.size(); i++) {
+      auto* sink = outlinks[i]->sink();
+      if (!sink->outlinks().empty() || kept_var_ids_.count(sink->id())) only_out = false;
+    }
+    if (!only_out) continue;
+    chain.pointwise = next;
+    chains.push_back(chain);
+    pointwise_nodes.insert(next);
+  }
+  for (auto& chain : chains) {
+    Fuse(chain);
+  }
+  if (!chains.empty()) {
+    absl::flat_hash_map<std::string, std::string> layout_dict;
+    graph_->ClearUnlinkedNodes(&shape_dict_, &type_dict_, &layout_dict);
+  }
+  VLOG(2) << "DepthwisePointwiseFusion fuses " << chains.size() << " depthwise and pointwise conv2d.";
+}
+
+}  // namespace
+
+/*
+ * In the depthwise separable conv2d of MobileNet, the output of the depthwise conv2d is written to memory and read
+ * back by the 1x1 conv2d after it, and OpFusion can not fuse them because both are not elementwise.
+ * DepthwisePointwiseFusion replaces the depthwise conv2d, the batch norm and relu/relu6 after it and the 1x1 conv2d
+ * with one depthwise_pointwise_conv2d op, whose kernel computes the depthwise output of one output row into a buffer
+ * in cache and feeds it to the 1x1 conv2d directly. The weights are packed and the batch norm is folded into them by
+ * a depthwise_pointwise_pack op, which ConstPropagate marks to pre_run once if the weights are constants. The ops
+ * whose outputs are graph outputs or in the graph attr "fetch_var_ids" are not fused away. It only works on x86 and
+ * should be applied before AlterLayout, which changes the conv2d to conv2d_NCHWc.
+ */
+void DepthwisePointwiseFusionPass(Graph* graph) {
+  if (!FLAGS_cinn_fuse_depthwise_pointwise || graph->target_.arch != common::Target::Arch::X86) return;
+  DepthwisePointwiseFuser fuser(graph);
+  fuser();
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(DepthwisePointwiseFusion) {
+  CINN_REGISTER_PASS(DepthwisePointwiseFusion)
+      .describe(
+          "This pass fuses the depthwise conv2d, the batch norm and activation after it and the 1x1 conv2d into one "
+          "depthwise_pointwise_conv2d op on x86.")
+      .set_change_structure(true)
+      .set_body(cinn::hlir::pass::DepthwisePointwiseFusionPass);
+
+  return true;
+}
@@ -0,0 +1,188 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+DECLARE_bool(cinn_fuse_depthwise_pointwise);
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+
+constexpr int N = 1, C = 16, H = 10, W = 10, O = 32;
+
+int CountOp(hlir::framework::Graph* graph, const std::string& op_type) {
+  int count = 0;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == op_type) count++;
+  }
+  return count;
+}
+
+// the depthwise separable conv2d of MobileNetV2: out = conv2d_1x1(relu6(batchnorm(depthwise_conv2d(x)))), the ids
+// of the depthwise, batch norm and relu6 outputs are returned in `intermediate_ids`
+std::pair<Program, std::string> CreateProgram(bool use_activation_twice                  = false,
+                                              bool const_weights                         = false,
+                                              std::vector<std::string>* intermediate_ids = nullptr) {
+  NetBuilder builder("net_builder");
+  auto x         = builder.CreateInput(Float(32), {N, C, H, W}, "X");
+  auto dw_weight = builder.CreateInput(Float(32), {C, 1, 3, 3}, "DwWeight");
+  auto scale     = builder.CreateInput(Float(32), {C}, "Scale");
+  auto bias      = builder.CreateInput(Float(32), {C}, "Bias");
+  auto mean      = builder.CreateInput(Float(32), {C}, "Mean");
+  auto variance  = builder.CreateInput(Float(32), {C}, "Variance");
+  auto pw_weight = builder.CreateInput(Float(32), {O, C, 1, 1}, "PwWeight");
+  if (const_weights) {
+    for (auto* weight : {&dw_weight, &scale, &bias, &mean, &variance, &pw_weight}) {
+      weight->set_const(true);
+    }
+  }
+  // the depthwise conv2d of paddle models on x86 is a conv2d whose groups are the channels
+  auto dw  = builder.Conv2d(x, dw_weight, {1, 1}, {1, 1}, {1, 1}, C);
+  auto bn  = builder.BatchNorm(dw, scale, bias, mean, variance, 1e-5f, 0.9f, "NCHW", true)[0];
+  auto act = builder.Relu6(bn);
+  auto out = builder.Conv2d(act, pw_weight);
+  if (use_activation_twice) {
+    builder.Relu(act);
+  }
+  if (intermediate_ids) {
+    *intermediate_ids = {dw->id, bn->id, act->id};
+  }
+  return {builder.Build(), out->id};
+}
+
+std::vector<float> RunProgram(const Program& program, const std::string& out_id, bool fuse) {
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  FLAGS_cinn_fuse_depthwise_pointwise = fuse;
+  hlir::framework::ApplyPass(graph.get(), "DepthwisePointwiseFusion");
+  FLAGS_cinn_fuse_depthwise_pointwise = true;
+  EXPECT_EQ(CountOp(graph.get(), "depthwise_pointwise_conv2d"), fuse ? 1 : 0);
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (auto& name : {"X", "DwWeight", "Scale", "Bias", "Mean", "Variance", "PwWeight"}) {
+    auto tensor = scope->GetTensor(name);
+    auto* data  = tensor->mutable_data<float>(target);
+    for (int i = 0; i < tensor->shape().numel(); i++) {
+      data[i] = std::string(name) == "Variance" ? dist(engine) + 2.f : dist(engine);
+    }
+  }
+  // the packed weights are computed here if the weights are constants
+  runtime_program->PreRun();
+  runtime_program->Execute();
+
+  auto out = scope->GetTensor(out_id);
+  return std::vector<float>(out->data<float>(), out->data<float>() + out->shape().numel());
+}
+
+}  // namespace
+
+TEST(DepthwisePointwiseFusion, fuse) {
+  auto program = CreateProgram().first;
+  auto graph   = std::make_shared<hlir::framework::Graph>(program, common::DefaultHostTarget());
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "DepthwisePointwiseFusion");
+  ASSERT_EQ(CountOp(graph.get(), "depthwise_pointwise_conv2d"), 1);
+  ASSERT_EQ(CountOp(graph.get(), "depthwise_pointwise_pack_bn"), 1);
+  ASSERT_EQ(CountOp(graph.get(), "conv2d"), 0);
+  ASSERT_EQ(CountOp(graph.get(), "batchnorm"), 0);
+  ASSERT_EQ(CountOp(graph.get(), "relu6"), 0);
+}
+
+TEST(DepthwisePointwiseFusion, keep_used_intermediate) {
+  auto program = CreateProgram(true).first;
+  auto graph   = std::make_shared<hlir::framework::Graph>(program, common::DefaultHostTarget());
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "DepthwisePointwiseFusion");
+  ASSERT_EQ(CountOp(graph.get(), "depthwise_pointwise_conv2d"), 0);
+  ASSERT_EQ(CountOp(graph.get(), "conv2d"), 2);
+}
+
+TEST(DepthwisePointwiseFusion, keep_fetched_intermediate) {
+  std::vector<std::string> intermediate_ids;
+  auto program = CreateProgram(false, false, &intermediate_ids).first;
+  for (auto& id : intermediate_ids) {
+    auto graph = std::make_shared<hlir::framework::Graph>(program, common::DefaultHostTarget());
+    graph->attrs["fetch_var_ids"] = std::make_shared<absl::any>(std::unordered_set<std::string>{id});
+    hlir::framework::ApplyPass(graph.get(), "InferShape");
+    hlir::framework::ApplyPass(graph.get(), "DepthwisePointwiseFusion");
+    ASSERT_EQ(CountOp(graph.get(), "depthwise_pointwise_conv2d"), 0) << id << " is fetched";
+    ASSERT_EQ(CountOp(graph.get(), "conv2d"), 2);
+    ASSERT_TRUE(graph->RetrieveNode(id));
+  }
+  for (auto& id : intermediate_ids) {
+    auto graph = std::make_shared<hlir::framework::Graph>(program, common::DefaultHostTarget());
+    graph->outputs.push_back(graph->RetrieveNode(id)->safe_as<hlir::framework::NodeData>());
+    hlir::framework::ApplyPass(graph.get(), "InferShape");
+    hlir::framework::ApplyPass(graph.get(), "DepthwisePointwiseFusion");
+    ASSERT_EQ(CountOp(graph.get(), "depthwise_pointwise_conv2d"), 0) << id << " is a graph output";
+  }
+}
+
+TEST(DepthwisePointwiseFusion, pre_run_pack) {
+  auto program = CreateProgram(false, true).first;
+  auto graph   = std::make_shared<hlir::framework::Graph>(program, common::DefaultHostTarget());
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "DepthwisePointwiseFusion");
+  hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+  int pre_run_packs = 0;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (!node || !node->attrs.attr_store.count("pre_run")) continue;
+    ASSERT_EQ(node->op()->name, "depthwise_pointwise_pack_bn");
+    pre_run_packs++;
+  }
+  ASSERT_EQ(pre_run_packs, 1);
+}
+
+TEST(DepthwisePointwiseFusion, same_results) {
+  for (bool const_weights : {false, true}) {
+    auto program  = CreateProgram(false, const_weights);
+    auto expected = RunProgram(program.first, program.second, false);
+    auto results  = RunProgram(program.first, program.second, true);
+    ASSERT_EQ(results.size(), N * O * H * W);
+    ASSERT_EQ(results.size(), expected.size());
+    for (size_t i = 0; i < results.size(); i++) {
+      ASSERT_NEAR(results[i], expected[i], 1e-4);
+    }
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
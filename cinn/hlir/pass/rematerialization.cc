@@ -0,0 +1,286 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+DEFINE_int64(cinn_remat_memory_budget,
+             0,
+             "The max bytes of the variables alive at the same time, Rematerialization recomputes cheap variables "
+             "instead of keeping them alive to fit in it. 0 means no limit.");
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::GraphNode;
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::OpPatternKind;
+using framework::Operator;
+
+namespace {
+
+// The live range of a variable in the steps, which are the groups in the execution order.
+struct LiveRange {
+  int def;
+  int last_use;
+  int64_t bytes;
+};
+
+// A variable which can be recomputed by a copy of its producer inserted before the step `late_use`, then it is not
+// alive between `early_use` and `late_use`.
+struct Candidate {
+  Node* producer;
+  NodeData* var;
+  int early_use;
+  int late_use;
+  int64_t bytes;
+};
+
+class Rematerializer {
+ public:
+  Rematerializer(Graph* graph, int64_t budget)
+      : graph_(graph),
+        budget_(budget),
+        shape_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape")),
+        type_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype")) {}
+
+  void operator()();
+
+ private:
+  int64_t Bytes(const NodeData* var) const {
+    auto shape_it = shape_dict_.find(var->id());
+    auto type_it  = type_dict_.find(var->id());
+    if (shape_it == shape_dict_.end() || type_it == type_dict_.end()) return 0;
+    int64_t numel = 1;
+    for (int dim : shape_it->second) numel *= dim;
+    return numel * ((type_it->second.bits() + 7) / 8);
+  }
+
+  // Update the steps of the nodes and the live ranges of the variables written by the groups.
+  void Analyze();
+
+  // The step of the max bytes alive and the bytes.
+  std::pair<int, int64_t> Peak() const;
+
+  // The cheap variables not alive at `step` if they are recomputed.
+  std::vector<Candidate> FindCandidates(int step) const;
+
+  void Recompute(const Candidate& candidate);
+
+  Graph* graph_;
+  int64_t budget_;
+  absl::flat_hash_map<std::string, framework::shape_t>& shape_dict_;
+  absl::flat_hash_map<std::string, Type>& type_dict_;
+
+  absl::flat_hash_map<const Node*, int> node_steps_;
+  absl::flat_hash_map<NodeData*, LiveRange> live_ranges_;
+  // the bytes of the variables produced by no group, e.g. the feeds and weights, they are always alive
+  int64_t resident_bytes_{0};
+};
+
+void Rematerializer::Analyze() {
+  node_steps_.clear();
+  live_ranges_.clear();
+  resident_bytes_ = 0;
+  auto& groups    = graph_->groups;
+  for (int step = 0; step < groups.size(); step++) {
+    for (auto* node : groups[step]) {
+      node_steps_[node] = step;
+    }
+  }
+  for (auto* graph_node : graph_->nodes()) {
+    auto* var = graph_node->safe_as<NodeData>();
+    if (!var) continue;
+    auto* producer = var->source_node.get();
+    if (!producer || !node_steps_.count(producer)) {
+      resident_bytes_ += Bytes(var);
+      continue;
+    }
+    LiveRange range{node_steps_.at(producer), -1, Bytes(var)};
+    for (auto& link : var->outlinks()) {
+      auto* consumer = link->sink()->safe_as<Node>();
+      if (consumer && node_steps_.count(consumer)) range.last_use = std::max(range.last_use, node_steps_.at(consumer));
+    }
+    // the variables used by no one are the fetches, alive until the end
+    if (range.last_use < 0) range.last_use = groups.size();
+    live_ranges_[var] = range;
+  }
+}
+
+std::pair<int, int64_t> Rematerializer::Peak() const {
+  std::vector<int64_t> diff(graph_->groups.size() + 2, 0);
+  for (auto& item : live_ranges_) {
+    diff[item.second.def] += item.second.bytes;
+    diff[item.second.last_use + 1] -= item.second.bytes;
+  }
+  std::pair<int, int64_t> peak{-1, 0};
+  int64_t bytes = resident_bytes_;
+  for (int step = 0; step < graph_->groups.size(); step++) {
+    bytes += diff[step];
+    if (bytes > peak.second) peak = {step, bytes};
+  }
+  return peak;
+}
+
+std::vector<Candidate> Rematerializer::FindCandidates(int step) const {
+  static auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  std::vector<Candidate> candidates;
+  for (auto& item : live_ranges_) {
+    auto* var         = item.first;
+    const auto& range = item.second;
+    auto* producer    = var->source_node.get();
+    if (range.def >= step || range.last_use <= step || var->outlinks().empty()) continue;
+    // only the elementwise and broadcast ops are cheap enough to run twice
+    if (!op_pattern_dict.Find(producer->op()) || op_pattern_dict[producer->op()] > framework::kBroadcast) continue;
+    if (producer->outlinks().size() != 1U) continue;
+
+    // the variable is recomputed right before its first use after `step`
+    int early_use = range.def, late_use = range.last_use;
+    for (auto& link : var->outlinks()) {
+      int use = node_steps_.at(link->sink()->safe_as<Node>());
+      if (use <= step) {
+        early_use = std::max(early_use, use);
+      } else {
+        late_use = std::min(late_use, use);
+      }
+    }
+    // the variable produced by the original op should still be used, otherwise the op should be moved instead
+    if (early_use == range.def) continue;
+
+    // the inputs should be alive at the recomputation, otherwise it keeps them alive instead
+    bool inputs_alive = true;
+    for (auto& link : producer->inlinks()) {
+      auto* input = link->source()->safe_as<NodeData>();
+      auto it     = live_ranges_.find(input);
+      if (it != live_ranges_.end() && it->second.last_use < late_use) inputs_alive = false;
+    }
+    if (!inputs_alive) continue;
+    candidates.push_back({producer, var, early_use, late_use, range.bytes});
+  }
+  return candidates;
+}
+
+void Rematerializer::Recompute(const Candidate& candidate) {
+  auto* producer = candidate.producer;
+  auto* copy     = new Node(producer->op(), producer->op()->name, common::UniqName(producer->id() + "_remat"));
+  copy->attrs    = producer->attrs;
+  for (auto& link : producer->inlinks_in_order(true)) {
+    link->source()->LinkTo(copy);
+  }
+  std::shared_ptr<Node> copy_ptr(copy);
+  auto* var = new NodeData(copy_ptr, 0, 0, common::UniqName(candidate.var->id() + "_remat"));
+  copy->LinkTo(var);
+  graph_->RegisterNode(copy->id(), copy);
+  graph_->RegisterNode(var->id(), var);
+  shape_dict_[var->id()] = shape_dict_.at(candidate.var->id());
+  type_dict_[var->id()]  = type_dict_.at(candidate.var->id());
+
+  // the late uses read the recomputed variable, the inputs are relinked in order to keep their positions
+  std::vector<Node*> late_consumers;
+  for (auto& link : candidate.var->outlinks()) {
+    auto* consumer = link->sink()->safe_as<Node>();
+    if (node_steps_.at(consumer) >= candidate.late_use) late_consumers.push_back(consumer);
+  }
+  for (auto* consumer : late_consumers) {
+    std::vector<GraphNode*> sources;
+    for (auto& link : consumer->inlinks_in_order(true)) {
+      sources.push_back(link->source());
+    }
+    for (auto* source : sources) {
+      source->UnLinkTo(consumer);
+    }
+    for (auto* source : sources) {
+      (source == candidate.var ? var : source)->LinkTo(consumer);
+    }
+    consumer->inlinks_in_order(true);
+  }
+
+  auto& groups = graph_->groups;
+  groups.insert(groups.begin() + candidate.late_use, std::vector<Node*>{copy});
+  VLOG(3) << "Recompute " << candidate.var->id() << " (" << candidate.bytes << " bytes) as " << var->id()
+          << " before step " << candidate.late_use << " instead of keeping it alive from step " << candidate.early_use;
+}
+
+void Rematerializer::operator()() {
+  auto& groups = graph_->groups;
+  if (groups.empty()) {
+    // the same as the groups of GraphCompiler without OpFusion
+    for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node) groups.push_back({node});
+    }
+  }
+
+  int recompute_num = 0;
+  while (true) {
+    Analyze();
+    auto peak = Peak();
+    if (peak.second <= budget_) break;
+    auto candidates = FindCandidates(peak.first);
+    if (candidates.empty()) {
+      LOG(WARNING) << "Rematerialization can not fit the peak memory " << peak.second << " bytes at step " << peak.first
+                   << " in the budget " << budget_ << " bytes";
+      break;
+    }
+    // the largest one saves the most, and the earliest late use keeps the recomputed variable alive the shortest
+    auto best = std::max_element(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+      return a.bytes != b.bytes ? a.bytes < b.bytes : a.late_use > b.late_use;
+    });
+    Recompute(*best);
+    recompute_num++;
+  }
+  VLOG(2) << "Rematerialization recomputes " << recompute_num << " variables.";
+}
+
+}  // namespace
+
+/*
+ * A training graph keeps the forward activations alive until their uses in the backward part. Rematerialization
+ * trades compute for memory: when the bytes of the variables alive at the same time exceed
+ * FLAGS_cinn_remat_memory_budget, it recomputes the cheap ones (produced by elementwise or broadcast ops, e.g. relu,
+ * scale and the batch norm apply) right before their late uses instead of keeping them alive in between. A variable is
+ * recomputed only if the inputs of its producer are still alive then. The recomputations are new groups inserted into
+ * graph->groups, so it should be applied after OpFusion, or the groups are the ops in the topological order.
+ */
+void RematerializationPass(Graph* graph) {
+  if (FLAGS_cinn_remat_memory_budget <= 0) return;
+  Rematerializer rematerializer(graph, FLAGS_cinn_remat_memory_budget);
+  rematerializer();
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(Rematerialization) {
+  CINN_REGISTER_PASS(Rematerialization)
+      .describe("This pass recomputes the cheap variables before their late uses to fit in a memory budget.")
+      .set_change_structure(true)
+      .set_body(cinn::hlir::pass::RematerializationPass);
+
+  return true;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+DECLARE_int64(cinn_remat_memory_budget);
+
+namespace cinn {
+namespace frontend {
+
+int CountOp(hlir::framework::Graph* graph, const std::string& op_type) {
+  int count = 0;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == op_type) count++;
+  }
+  return count;
+}
+
+/**
+ * The forward activation y is used by the backward-like tail at the end, so it is alive while p, q and r are
+ * computed. Recomputing it from x, which is alive until the end anyway, lowers the peak from 6 to 5 tensors.
+ *   x = scale(a), y = relu(x), p = scale(y), q = scale(p), r = p + q, s = scale(r), g = y + s, out = g + x
+ */
+TEST(Rematerialization, recompute_activation) {
+  constexpr int M = 64, N = 64;
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {M, N}, "A");
+  auto x       = builder.Scale(a, 2.f, 0.f);
+  auto y       = builder.Relu(x);
+  auto p       = builder.Scale(y, 0.5f, 0.f);
+  auto q       = builder.Scale(p, 3.f, 0.f);
+  auto r       = builder.Add(p, q);
+  auto s       = builder.Scale(r, 1.f, 1.f);
+  auto g       = builder.Add(y, s);
+  auto out     = builder.Add(g, x);
+  auto program = builder.Build();
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+
+  constexpr int64_t kTensorBytes = M * N * sizeof(float);
+  FLAGS_cinn_remat_memory_budget = 5 * kTensorBytes;
+  hlir::framework::ApplyPass(graph.get(), "Rematerialization");
+  FLAGS_cinn_remat_memory_budget = 0;
+  ASSERT_EQ(CountOp(graph.get(), "relu"), 2);
+  ASSERT_EQ(graph->groups.size(), 9UL);
+
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto a_tensor = scope->GetTensor("A");
+  auto* a_data  = a_tensor->mutable_data<float>(target);
+  for (int i = 0; i < M * N; i++) {
+    a_data[i] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+  }
+  runtime_program->Execute();
+
+  auto* out_data = scope->GetTensor(out->id)->data<float>();
+  for (int i = 0; i < M * N; i++) {
+    float y_value = std::max(2.f * a_data[i], 0.f);
+    ASSERT_NEAR(out_data[i], 3.f * y_value + 1.f + 2.f * a_data[i], 1e-5);
+  }
+}
+
+TEST(Rematerialization, no_budget) {
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {16, 16}, "A");
+  auto y       = builder.Relu(a);
+  auto p       = builder.Scale(y, 0.5f, 0.f);
+  auto q       = builder.Scale(p, 3.f, 0.f);
+  auto out     = builder.Add(y, q);
+  auto program = builder.Build();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, common::DefaultHostTarget());
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "Rematerialization");
+  ASSERT_EQ(CountOp(graph.get(), "relu"), 1);
+  ASSERT_TRUE(graph->groups.empty());
+}
+
+}  // namespace frontend
+}  // namespace cinn
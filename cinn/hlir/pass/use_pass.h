@@ -20,3 +20,5 @@ CINN_USE_REGISTER(InferShape)
 CINN_USE_REGISTER(OpFusion)
 CINN_USE_REGISTER(AlterLayout)
 CINN_USE_REGISTER(ConstPropagate)
+CINN_USE_REGISTER(Rematerialization)
+CINN_USE_REGISTER(DepthwisePointwiseFusion)
@@ -655,6 +655,141 @@ std::vector<Tensor> Depthwise_Conv2d_NHWC(const Tensor &input,
   return {res, input_pad};
 }
 
+std::vector<ir::Tensor> DepthwisePointwisePack(const ir::Tensor &dw_weights,
+                                              const ir::Tensor &pw_weights,
+                                              const std::vector<ir::Tensor> &bn_params,
+                                              float epsilon,
+                                              int ic_bn,
+                                              int oc_bn,
+                                              const std::string &output_name) {
+  CHECK_EQ(dw_weights->shape.size(), 4U) << "depthwise weight's shape size should be 4";
+  CHECK_EQ(pw_weights->shape.size(), 4U) << "pointwise weight's shape size should be 4";
+  CHECK(bn_params.empty() || bn_params.size() == 4U) << "the batch norm should have scale, bias, mean and variance";
+  auto type  = dw_weights->type();
+  Expr c_in  = common::AutoSimplify(dw_weights->shape[0]);
+  Expr h_f   = dw_weights->shape[2];
+  Expr w_f   = dw_weights->shape[3];
+  Expr c_out = common::AutoSimplify(pw_weights->shape[0]);
+  int ic     = c_in.as_int32();
+  int oc     = c_out.as_int32();
+  CHECK_EQ(common::AutoSimplify(dw_weights->shape[1]).as_int32(), 1) << "the channel multiplier should be 1";
+  CHECK_EQ(common::AutoSimplify(pw_weights->shape[1]).as_int32(), ic) << "the pointwise weight should be [O, C, 1, 1]";
+  CHECK(ic_bn > 0 && ic % ic_bn == 0) << "ic_bn " << ic_bn << " should divide the channels " << ic;
+  CHECK(oc_bn > 0 && oc % oc_bn == 0) << "oc_bn " << oc_bn << " should divide the output channels " << oc;
+  Expr ic_chunk = Expr(ic / ic_bn);
+  Expr oc_chunk = Expr(oc / oc_bn);
+
+  // the batch norm is y = x * a + b, where a = scale / sqrt(variance + epsilon) and b = bias - mean * a,
+  // a is folded into the depthwise weights
+  auto dw_weights_packed = Compute(
+      {ic_chunk, h_f, w_f, Expr(ic_bn)},
+      [=](Expr cc, Expr yy, Expr xx, Expr cb) {
+        Expr c = cc * ic_bn + cb;
+        if (bn_params.empty()) {
+          return dw_weights(c, Expr(0), yy, xx);
+        }
+        return dw_weights(c, Expr(0), yy, xx) * bn_params[0](c) / lang::Sqrt(bn_params[3](c) + Expr(epsilon));
+      },
+      output_name + "_dw_weights");
+  auto dw_bias = Compute(
+      {ic_chunk, Expr(ic_bn)},
+      [=](Expr cc, Expr cb) {
+        if (bn_params.empty()) {
+          return ir::Zero(type);
+        }
+        Expr c = cc * ic_bn + cb;
+        return bn_params[1](c) - bn_params[2](c) * bn_params[0](c) / lang::Sqrt(bn_params[3](c) + Expr(epsilon));
+      },
+      output_name + "_dw_bias");
+
+  // pack the pointwise weights, [C_out, C, 1, 1]->[C_out_outer, C_outer, C_inner, C_out_inner]
+  auto pw_weights_packed = Compute(
+      {oc_chunk, ic_chunk, Expr(ic_bn), Expr(oc_bn)},
+      [=](Expr occ, Expr cc, Expr cb, Expr ocb) {
+        return pw_weights(occ * oc_bn + ocb, cc * ic_bn + cb, Expr(0), Expr(0));
+      },
+      output_name + "_pw_weights");
+  return {dw_weights_packed, dw_bias, pw_weights_packed};
+}
+
+std::vector<ir::Tensor> DepthwisePointwiseConv2d_NCHW(const ir::Tensor &input,
+                                                      const ir::Tensor &dw_weights_packed,
+                                                      const ir::Tensor &dw_bias,
+                                                      const ir::Tensor &pw_weights_packed,
+                                                      const std::string &activation,
+                                                      int pad_h,
+                                                      int pad_w,
+                                                      int stride_h,
+                                                      int stride_w,
+                                                      const std::string &output_name) {
+  CHECK_EQ(input->shape.size(), 4U) << "input's shape size should be 4";
+  CHECK_EQ(dw_weights_packed->shape.size(), 4U) << "packed depthwise weight's shape size should be 4";
+  CHECK_EQ(dw_bias->shape.size(), 2U) << "depthwise bias's shape size should be 2";
+  CHECK_EQ(pw_weights_packed->shape.size(), 4U) << "packed pointwise weight's shape size should be 4";
+  CHECK(activation.empty() || activation == "relu" || activation == "relu6") << "unsupported activation " << activation;
+  auto type     = input->type();
+  Expr batch    = input->shape[0];
+  Expr h_in     = input->shape[2];
+  Expr w_in     = input->shape[3];
+  Expr ic_chunk = dw_weights_packed->shape[0];
+  Expr h_f      = dw_weights_packed->shape[1];
+  Expr w_f      = dw_weights_packed->shape[2];
+  Expr ic_bn    = dw_weights_packed->shape[3];
+  Expr oc_chunk = pw_weights_packed->shape[0];
+  Expr oc_bn    = pw_weights_packed->shape[3];
+  Expr c_out    = common::AutoSimplify(oc_chunk * oc_bn);
+  Expr h_out    = common::AutoSimplify((h_in - h_f + 2 * pad_h) / stride_h + 1);
+  Expr w_out    = common::AutoSimplify((w_in - w_f + 2 * pad_w) / stride_w + 1);
+  CHECK_EQ(common::AutoSimplify(ic_chunk * ic_bn).as_int32(), common::AutoSimplify(input->shape[1]).as_int32())
+      << "the packed depthwise weight does not match the input channels";
+  VLOG(3) << "ic_bn: " << ic_bn << ", oc_bn: " << oc_bn;
+
+  // pack and pad data, NCHW->NCHWc
+  auto input_pad = Compute(
+      {batch, ic_chunk, common::AutoSimplify(h_in + 2 * pad_h), common::AutoSimplify(w_in + 2 * pad_w), ic_bn},
+      [=](Expr n, Expr cc, Expr yy, Expr xx, Expr cb) {
+        if (pad_h == 0 && pad_w == 0) {
+          return input(n, cc * ic_bn + cb, yy, xx);
+        }
+        auto cond = lang::logic_and({yy >= pad_h, yy < h_in + pad_h, xx >= pad_w, xx < w_in + pad_w});
+        return ir::Select::Make(cond, input(n, cc * ic_bn + cb, yy - pad_h, xx - pad_w), ir::Zero(type));
+      },
+      UniqName("input_pad"));
+
+  Var fy(h_f, UniqName("fy"));
+  Var fx(w_f, UniqName("fx"));
+  auto dw_out = Compute(
+      {batch, ic_chunk, h_out, w_out, ic_bn},
+      [=](Expr n, Expr cc, Expr oh, Expr ow, Expr cb) {
+        return lang::ReduceSum(
+            input_pad(n, cc, oh * stride_h + fy, ow * stride_w + fx, cb) * dw_weights_packed(cc, fy, fx, cb), {fy, fx});
+      },
+      UniqName("depthwise_conv2d_NCHWc_out"));
+
+  // the bias and activation of the depthwise output are applied when it is read by the pointwise convolution
+  Var icc(ic_chunk, UniqName("icc"));
+  Var icb(ic_bn, UniqName("icb"));
+  auto packed_out = Compute(
+      {batch, oc_chunk, h_out, w_out, oc_bn},
+      [=](Expr n, Expr occ, Expr oh, Expr ow, Expr ocb) {
+        Expr mid = dw_out(n, icc, oh, ow, icb) + dw_bias(icc, icb);
+        if (activation == "relu") {
+          mid = lang::Relu<float>(mid);
+        } else if (activation == "relu6") {
+          mid = lang::Relu6<float>(mid);
+        }
+        return lang::ReduceSum(mid * pw_weights_packed(occ, icc, icb, ocb), {icc, icb});
+      },
+      UniqName("conv2d_NCHWc_out"));
+
+  // 5D back to 4D, NCHWc->NCHW
+  auto res = Compute(
+      {batch, c_out, h_out, w_out},
+      [=](Expr n, Expr c, Expr h, Expr w) { return packed_out(n, c / oc_bn, h, w, c % oc_bn); },
+      output_name);
+  return {res, packed_out, dw_out, input_pad};
+}
+
 /**
  * Can be used as a normalizer function for convolution or fully_connected operations.
  * Specified for NCHW layout.
@@ -712,51 +847,155 @@ ir::Tensor BatchNorm_NCHWc(const ir::Tensor &input,
 
 /**
  * This operator implements the softmax layer.
+ * The row max is subtracted before exp for numerical stability. The max, the exp-sum and the normalization all
+ * read the same row, so the schedule computes the statistics at the row loop of the output and the row is only
+ * loaded once from memory.
  * @param A The input tensor.
  * @param axis The axis parameter.
  * @param output_name The name of output tensor.
- * @return The calculated output tensor.
+ * @return The calculated output tensor, the exp-sum tensor and the max tensor.
  */
 std::vector<ir::Tensor> Softmax(const ir::Tensor &A, int axis, const std::string &output_name) {
   if (axis == -1) {
     axis = A->shape.size() - 1;
   }
-  Var reduce_axis(A->shape[axis], UniqName("reduce_axis"));
   std::vector<Expr> new_shapes;
   for (size_t i = 0; i < A->shape.size(); i++) {
     if (static_cast<int>(i) != axis) {
       new_shapes.push_back(A->shape[i]);
     }
   }
+  // get the indice of A from the indice of the statistic tensors and the reduce axis
+  auto get_row_indice = [=](const std::vector<Expr> &indice, Expr reduce_axis) {
+    std::vector<Expr> new_indice;
+    int count = 0;
+    for (size_t i = 0; i < A->shape.size(); i++) {
+      if (static_cast<int>(i) != axis) {
+        new_indice.push_back(indice[count++]);
+      } else {
+        new_indice.push_back(reduce_axis);
+      }
+    }
+    return new_indice;
+  };
+  // get the indice of the statistic tensors from the indice of A
+  auto get_reduced_indice = [=](const std::vector<Expr> &indice) {
+    std::vector<Expr> new_indice;
+    for (size_t i = 0; i < indice.size(); i++) {
+      if (static_cast<int>(i) != axis) {
+        new_indice.push_back(indice[i]);
+      }
+    }
+    return new_indice;
+  };
+
+  Var max_axis(A->shape[axis], UniqName("reduce_axis"));
+  auto max = Compute(
+      new_shapes,
+      [=](const std::vector<Expr> &indice) { return lang::ReduceMax(A(get_row_indice(indice, max_axis)), {max_axis}); },
+      UniqName("softmax_max_out"));
+
+  Var sum_axis(A->shape[axis], UniqName("reduce_axis"));
   auto temp = Compute(
       new_shapes,
       [=](const std::vector<Expr> &indice) {
-        std::vector<Expr> new_indice;
-        int count = 0;
-        for (size_t i = 0; i < A->shape.size(); i++) {
-          if (static_cast<int>(i) != axis) {
-            new_indice.push_back(indice[count++]);
-          } else {
-            new_indice.push_back(reduce_axis);
-          }
-        }
-        return lang::ReduceSum(lang::Exp(A(new_indice)), {reduce_axis});
+        return lang::ReduceSum(lang::Exp(A(get_row_indice(indice, sum_axis)) - max(indice)), {sum_axis});
       },
       UniqName("softmax_temp_out"));
 
   ir::Tensor out = Compute(
       A->shape,
       [=](const std::vector<Expr> &indice) {
-        std::vector<Expr> new_indice;
-        for (size_t i = 0; i < indice.size(); i++) {
-          if (static_cast<int>(i) != axis) {
-            new_indice.push_back(indice[i]);
-          }
-        }
-        return lang::Exp(A(indice)) / temp(new_indice);
+        auto reduced_indice = get_reduced_indice(indice);
+        return lang::Exp(A(indice) - max(reduced_indice)) / temp(reduced_indice);
       },
       UniqName("softmax_out"));
-  return {out, temp};
+  return {out, temp, max};
+}
+
+std::vector<ir::Tensor> LayerNorm(const ir::Tensor &input,
+                                  const ir::Tensor &scale,
+                                  const ir::Tensor &bias,
+                                  float epsilon,
+                                  int begin_norm_axis,
+                                  const std::string &output_name) {
+  int rank = input->shape.size();
+  if (begin_norm_axis < 0) {
+    begin_norm_axis += rank;
+  }
+  CHECK(begin_norm_axis >= 0 && begin_norm_axis < rank)
+      << "The begin_norm_axis of LayerNorm should be in [0, " << rank << "), but got " << begin_norm_axis;
+  std::vector<Expr> stat_shape(input->shape.begin(), input->shape.begin() + begin_norm_axis);
+  int norm_size = 1;
+  for (int i = begin_norm_axis; i < rank; i++) {
+    norm_size *= input->shape[i].as_int32();
+  }
+  CHECK_EQ(scale->shape.size(), 1U) << "The scale of LayerNorm should be 1-D";
+  CHECK_EQ(bias->shape.size(), 1U) << "The bias of LayerNorm should be 1-D";
+  CHECK_EQ(scale->shape[0].as_int32(), norm_size) << "The size of LayerNorm's scale mismatches the normalized size";
+  CHECK_EQ(bias->shape[0].as_int32(), norm_size) << "The size of LayerNorm's bias mismatches the normalized size";
+
+  // normalize all the input to one row when there is no dimension before begin_norm_axis
+  bool single_row = stat_shape.empty();
+  if (single_row) {
+    stat_shape.push_back(Expr(1));
+  }
+  auto get_stat_indice = [=](const std::vector<Expr> &indice) {
+    if (single_row) return std::vector<Expr>({Expr(0)});
+    return std::vector<Expr>(indice.begin(), indice.begin() + begin_norm_axis);
+  };
+  auto make_reduce_axes = [=]() {
+    std::vector<Var> axes;
+    for (int i = begin_norm_axis; i < rank; i++) {
+      axes.push_back(Var(input->shape[i], UniqName("reduce_axis")));
+    }
+    return axes;
+  };
+  // get the indice of the input from the indice of the statistic tensors and the reduce axes
+  auto get_row_indice = [=](const std::vector<Expr> &stat_indice, const std::vector<Var> &axes) {
+    std::vector<Expr> indice;
+    if (!single_row) {
+      indice = stat_indice;
+    }
+    indice.insert(indice.end(), axes.begin(), axes.end());
+    return indice;
+  };
+  Expr inv_norm_size = common::make_const(input->type(), 1.f / norm_size);
+
+  // the variance is computed from the centered values instead of E(x^2) - E(x)^2 for numerical stability, both
+  // statistics read the row just loaded by each other when they are computed at the row loop of the output.
+  auto mean_axes = make_reduce_axes();
+  auto mean      = Compute(
+      stat_shape,
+      [=](const std::vector<Expr> &indice) {
+        return lang::ReduceSum(input(get_row_indice(indice, mean_axes)) * inv_norm_size, mean_axes);
+      },
+      UniqName(output_name + "_mean"));
+
+  auto variance_axes = make_reduce_axes();
+  auto variance      = Compute(
+      stat_shape,
+      [=](const std::vector<Expr> &indice) {
+        auto diff = input(get_row_indice(indice, variance_axes)) - mean(indice);
+        return lang::ReduceSum(diff * diff * inv_norm_size, variance_axes);
+      },
+      UniqName(output_name + "_variance"));
+
+  auto out = Compute(
+      input->shape,
+      [=](const std::vector<Expr> &indice) {
+        auto stat_indice = get_stat_indice(indice);
+        // the offset in the flattened normalized dimensions
+        Expr offset = indice[begin_norm_axis];
+        for (int i = begin_norm_axis + 1; i < rank; i++) {
+          offset = offset * input->shape[i] + indice[i];
+        }
+        Expr normalized =
+            (input(indice) - mean(stat_indice)) * lang::Rsqrt(variance(stat_indice) + Expr(epsilon));
+        return normalized * scale(offset) + bias(offset);
+      },
+      output_name);
+  return {out, mean, variance};
 }
 
 #ifdef CINN_WITH_MKLDNN
@@ -1201,6 +1440,112 @@ std::vector<Tensor> Pool2d(const Tensor &tensor,
                   UniqName(output_name));
 }
 
+std::vector<Tensor> SeparablePool2d(const Tensor &tensor,
+                                    const std::vector<int> &kernel_size,
+                                    const std::vector<int> &stride_size,
+                                    const std::vector<int> &padding_size,
+                                    const std::string &pool_type,
+                                    bool ceil_mode,
+                                    bool exclusive,
+                                    const std::string &data_format,
+                                    const std::string &output_name) {
+  CHECK(pool_type == "max" || pool_type == "avg") << "Unrecognized pool_type: " << pool_type;
+  CHECK_EQ(kernel_size.size(), 2U) << "kernel_size for separable pool2d should be 2.\n";
+  CHECK_EQ(stride_size.size(), 2U) << "stride_size for separable pool2d should be 2.\n";
+  CHECK_EQ(padding_size.size(), 4U) << "padding_size for separable pool2d should be 4.\n";
+  int height_axis = -1;
+  int width_axis  = -1;
+  if (data_format == "NCHW" || data_format == "AnyLayout") {
+    height_axis = 2;
+    width_axis  = 3;
+  } else if (data_format == "NHWC") {
+    height_axis = 1;
+    width_axis  = 2;
+  } else {
+    LOG(FATAL) << "Unsupported data format: " << data_format << std::endl;
+  }
+  CHECK(tensor->shape.size() == 4U || tensor->shape.size() == 5U)
+      << "pool2d requires tensor's shape_size to be 4 or 5\n";
+  std::vector<int> axis = {height_axis, width_axis};
+
+  int x_size = tensor->shape.size();
+  std::vector<Expr> kernel(2);
+  std::vector<Expr> stride(2);
+  std::vector<Expr> pad_head(2);
+  std::vector<Expr> pad_before(x_size, Expr(0));
+  std::vector<Expr> pad_after(x_size, Expr(0));
+  std::vector<Expr> out_shape = tensor->shape;
+  bool do_pad                 = false;
+  for (int i = 0; i < 2; i++) {
+    int ii        = axis[i];
+    kernel[i]     = Expr(kernel_size[i]);
+    stride[i]     = Expr(stride_size[i]);
+    pad_head[i]   = Expr(padding_size[i]);
+    Expr pad_tail = Expr(padding_size[i + 2]);
+    if (ceil_mode) {
+      pad_tail = common::AutoSimplify(pad_tail + stride[i] - 1);
+    }
+    do_pad         = do_pad || padding_size[i] || padding_size[i + 2] || (ceil_mode && stride_size[i] > 1);
+    pad_before[ii] = pad_head[i];
+    pad_after[ii]  = pad_tail;
+    out_shape[ii]  = common::AutoSimplify((tensor->shape[ii] - kernel[i] + pad_head[i] + pad_tail) / stride[i] + 1);
+  }
+
+  bool is_max    = pool_type == "max";
+  Expr min_value = lang::min_value(tensor->type());
+  Tensor temp    = tensor;
+  if (do_pad) {
+    temp = Pad(tensor, pad_before, pad_after, is_max ? min_value : Expr(0), UniqName("pad_temp"));
+  }
+
+  // the first pass: pool the windows along the width for all the (padded) rows
+  std::vector<Expr> row_shape = temp->shape;
+  row_shape[width_axis]       = out_shape[width_axis];
+  Var kernel_w(kernel[1], UniqName("kernel_idx"));
+  auto row = Compute(
+      row_shape,
+      [=](const std::vector<Expr> &output) -> Expr {
+        std::vector<Expr> indices = output;
+        indices[width_axis]       = output[width_axis] * stride[1] + kernel_w;
+        if (is_max) {
+          return lang::ReduceMax(temp(indices), {kernel_w}, min_value);
+        }
+        return lang::ReduceSum(temp(indices), {kernel_w});
+      },
+      UniqName(output_name + "_row"));
+
+  // the second pass: pool the rows along the height, the average is divided here once per window
+  Var kernel_h(kernel[0], UniqName("kernel_idx"));
+  auto res = Compute(
+      out_shape,
+      [=](const std::vector<Expr> &output) -> Expr {
+        std::vector<Expr> indices = output;
+        indices[height_axis]      = output[height_axis] * stride[0] + kernel_h;
+        if (is_max) {
+          return lang::ReduceMax(row(indices), {kernel_h}, min_value);
+        }
+        Expr divide_factor = make_const(Int(32), kernel_size[0] * kernel_size[1]);
+        if (exclusive) {
+          auto temp_factor = make_const(Int(32), 1);
+          for (int i = 0; i < 2; i++) {
+            int ii      = axis[i];
+            Expr start  = common::AutoSimplify(output[ii] * stride[i] - pad_head[i]);
+            Expr end    = Min::Make(start + kernel[i], tensor->shape[ii]);
+            start       = Max::Make(start, make_const(Int(32), 0));
+            temp_factor = temp_factor * (end - start);
+          }
+          divide_factor = Max::Make(temp_factor, make_const(Int(32), 1));
+        }
+        return lang::ReduceSum(ir::Div::Make(row(indices), cast(divide_factor, Float(32))), {kernel_h});
+      },
+      UniqName(output_name));
+
+  if (do_pad) {
+    return {res, row, temp};
+  }
+  return {res, row};
+}
+
 std::vector<Tensor> Pool3d(const Tensor &tensor,
                            const std::vector<int> &kernel_size,
                            const std::vector<int> &stride_size,
@@ -261,6 +261,62 @@ std::vector<ir::Tensor> Depthwise_Conv2d_NHWC(const ir::Tensor &input,
                                               int stride_w,
                                               const std::string output_name = UniqName("T_depthwise_conv2d_nhwc"));
 
+/**
+ * @brief Pack the weights of DepthwisePointwiseConv2d_NCHW in the NCHWc-layout and fold the optional batch norm
+ * into the depthwise weights and a bias. The results only depend on the weights, so they can be computed once
+ * before the run.
+ *
+ * @param dw_weights The 4-D depthwise weight tensor {C, 1, filter_h, filter_w}
+ * @param pw_weights The 4-D 1x1 weight tensor {C_out, C, 1, 1}
+ * @param bn_params The scale, bias, mean and variance of the batch norm, or empty if there is no batch norm
+ * @param epsilon The epsilon of the batch norm
+ * @param ic_bn The channel block of the depthwise convolution and the input channel block of the 1x1 convolution
+ * @param oc_bn The output channel block of the 1x1 convolution
+ * @param output_name The prefix of the names of the output tensors
+ *
+ * @return {the packed depthwise weights {C / ic_bn, filter_h, filter_w, ic_bn}, the depthwise bias
+ * {C / ic_bn, ic_bn}, which is zero if there is no batch norm, the packed 1x1 weights
+ * {C_out / oc_bn, C / ic_bn, ic_bn, oc_bn}}
+ */
+std::vector<ir::Tensor> DepthwisePointwisePack(const ir::Tensor &dw_weights,
+                                              const ir::Tensor &pw_weights,
+                                              const std::vector<ir::Tensor> &bn_params,
+                                              float epsilon,
+                                              int ic_bn,
+                                              int oc_bn,
+                                              const std::string &output_name = UniqName("T_DepthwisePointwisePack"));
+
+/**
+ * @brief Perform a 2-D depthwise convolution followed by a bias, an optional activation and a 1x1 convolution,
+ * with an NCHW-layout. The depthwise output is computed in the NCHWc-layout and read by the 1x1 convolution
+ * directly. The weights are the ones packed by DepthwisePointwisePack.
+ *
+ * @param input The 4-D input tensor {N, C, H, W}
+ * @param dw_weights_packed The packed depthwise weight tensor {C / ic_bn, filter_h, filter_w, ic_bn}
+ * @param dw_bias The bias of the depthwise output {C / ic_bn, ic_bn}
+ * @param pw_weights_packed The packed 1x1 weight tensor {C_out / oc_bn, C / ic_bn, ic_bn, oc_bn}
+ * @param activation The activation after the bias, "relu", "relu6" or empty
+ * @param pad_h padding applied to the height of the image in the depthwise convolution
+ * @param pad_w padding applied to the width of the image in the depthwise convolution
+ * @param stride_h striding applied to the height of the image in the depthwise convolution
+ * @param stride_w striding applied to the width of the image in the depthwise convolution
+ * @param output_name The name of the output tensor
+ *
+ * @return {the output tensor, the NCHWc output of the 1x1 convolution, the NCHWc output of the depthwise convolution,
+ * the padded input}
+ */
+std::vector<ir::Tensor> DepthwisePointwiseConv2d_NCHW(
+    const ir::Tensor &input,
+    const ir::Tensor &dw_weights_packed,
+    const ir::Tensor &dw_bias,
+    const ir::Tensor &pw_weights_packed,
+    const std::string &activation,
+    int pad_h,
+    int pad_w,
+    int stride_h,
+    int stride_w,
+    const std::string &output_name = UniqName("T_DepthwisePointwiseConv2d_NCHW_out"));
+
 ir::Tensor BatchNorm_NCHW(const ir::Tensor &input,
                           const ir::Tensor &scale,
                           const ir::Tensor &bias,
@@ -316,6 +372,26 @@ std::vector<ir::Tensor> Softmax(const ir::Tensor &A,
                                 int axis                       = -1,
                                 const std::string &output_name = UniqName("T_softmax_out"));
 
+/**
+ * @brief Layer normalization over the dimensions starting from begin_norm_axis.
+ * out = (input - mean) / sqrt(variance + epsilon) * scale + bias
+ *
+ * @param input The input tensor
+ * @param scale The 1-D scale tensor, its size is the product of the normalized dimensions
+ * @param bias The 1-D bias tensor, its size is the product of the normalized dimensions
+ * @param epsilon The value added to the variance to avoid dividing by zero
+ * @param begin_norm_axis The first normalized dimension
+ * @param output_name The name of the output tensor
+ *
+ * @return {output, mean, variance}, mean and variance have the shape of the dimensions before begin_norm_axis.
+ */
+std::vector<ir::Tensor> LayerNorm(const ir::Tensor &input,
+                                  const ir::Tensor &scale,
+                                  const ir::Tensor &bias,
+                                  float epsilon,
+                                  int begin_norm_axis,
+                                  const std::string &output_name = UniqName("T_layer_norm_out"));
+
 #ifdef CINN_WITH_MKLDNN
 std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A,
                                       int axis                       = -1,
@@ -380,6 +456,24 @@ std::vector<ir::Tensor> Pool2d(const ir::Tensor &tensor,
                                const std::string &data_format = "NCHW",
                                bool adaptive                  = false,
                                const std::string &output_name = UniqName("T_Pool2d_out"));
+/**
+ * @brief Perform max or avg pooling on the height and width dimension of the tensor in two separable passes: the
+ *        first pass pools the rows along the width, the second one pools the results of the first pass along the
+ *        height. So each output reads kernel_h + stride_h * kernel_w elements instead of kernel_h * kernel_w, and the
+ *        rows pooled in the first pass are reused by the overlapping windows of the second pass.
+ *        The arguments are the same as Pool2d's, except that the adaptive pooling is not supported.
+ *
+ * @return the vector of pooling tensor, row pooling tensor and padding tensor (if padded).
+ */
+std::vector<ir::Tensor> SeparablePool2d(const ir::Tensor &tensor,
+                                        const std::vector<int> &kernel_size,
+                                        const std::vector<int> &stride_size,
+                                        const std::vector<int> &padding_size,
+                                        const std::string &pool_type   = "max",
+                                        bool ceil_mode                 = false,
+                                        bool exclusive                 = true,
+                                        const std::string &data_format = "NCHW",
+                                        const std::string &output_name = UniqName("T_SeparablePool2d_out"));
 std::vector<ir::Tensor> GlobalPool2d(const ir::Tensor &tensor,
                                      const std::string &pool_type,
                                      const std::string &output_name);
@@ -0,0 +1,190 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/pe/quantization.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/lang/builtin.h"
+#include "cinn/lang/compute.h"
+
+namespace cinn {
+namespace hlir {
+namespace pe {
+
+using cinn::lang::Compute;
+using ir::Tensor;
+
+namespace {
+
+// Round a float expression to the nearest integer and saturate it to the int8 range.
+Expr SaturateToInt8(Expr value, int zero_point) {
+  auto rounded = lang::Round(value) + common::make_const(Float(32), zero_point);
+  auto clipped = ir::Min::Make(ir::Max::Make(rounded, common::make_const(Float(32), -128)),
+                               common::make_const(Float(32), 127));
+  return ir::Cast::Make(Int(8), clipped);
+}
+
+}  // namespace
+
+Tensor Quantize(const Tensor &A, float scale, int zero_point, const std::string &output_name) {
+  CHECK(A->type().is_float(32)) << "Quantize only supports float32 input, but got " << A->type();
+  CHECK_GT(scale, 0.f) << "The quantization scale should be positive";
+  // multiply by the reciprocal so that the inner loop has no division
+  Expr inv_scale = common::make_const(Float(32), 1.f / scale);
+  return Compute(
+      A->shape,
+      [=](const std::vector<Expr> &indice) { return SaturateToInt8(A(indice) * inv_scale, zero_point); },
+      output_name);
+}
+
+Tensor Dequantize(const Tensor &A, float scale, int zero_point, const std::string &output_name) {
+  CHECK(A->type().is_int(8) || A->type().is_int(32))
+      << "Dequantize only supports int8 or int32 input, but got " << A->type();
+  return Compute(
+      A->shape,
+      [=](const std::vector<Expr> &indice) {
+        Expr value = ir::Cast::Make(Float(32), A(indice));
+        if (zero_point != 0) {
+          value = value - common::make_const(Float(32), zero_point);
+        }
+        return value * common::make_const(Float(32), scale);
+      },
+      output_name);
+}
+
+Tensor Requantize(const Tensor &A, float in_scale, float out_scale, int zero_point, const std::string &output_name) {
+  CHECK(A->type().is_int(32)) << "Requantize only supports int32 input, but got " << A->type();
+  CHECK_GT(out_scale, 0.f) << "The output quantization scale should be positive";
+  Expr multiplier = common::make_const(Float(32), in_scale / out_scale);
+  return Compute(
+      A->shape,
+      [=](const std::vector<Expr> &indice) {
+        return SaturateToInt8(ir::Cast::Make(Float(32), A(indice)) * multiplier, zero_point);
+      },
+      output_name);
+}
+
+Tensor QuantizedMatmul(const Tensor &A, const Tensor &B, bool trans_a, bool trans_b, const std::string &output_name) {
+  CHECK(A->type().is_int(8)) << "QuantizedMatmul's first input should be int8, but got " << A->type();
+  CHECK(B->type().is_int(8)) << "QuantizedMatmul's second input should be int8, but got " << B->type();
+  std::vector<Expr> shape_A = A->shape;
+  std::vector<Expr> shape_B = B->shape;
+  int a_dim                 = shape_A.size();
+  int b_dim                 = shape_B.size();
+  CHECK(a_dim == 3U || a_dim == 2U) << "tensor_A's dim should be 2 or 3 while current dim is " << a_dim;
+  CHECK_EQ(a_dim, b_dim) << "tensor_A's dim should be same with tensor_B";
+
+  Expr x_width  = trans_a ? shape_A[a_dim - 2] : shape_A.back();
+  Expr y_height = trans_b ? shape_B.back() : shape_B[b_dim - 2];
+  Expr M        = trans_a ? shape_A.back() : shape_A[a_dim - 2];
+  Expr N        = trans_b ? shape_B[b_dim - 2] : shape_B.back();
+  CHECK(is_zero(x_width - y_height)) << "matrix multiplication requires x_width to be same with y_height";
+  std::vector<Expr> output_shape;
+  // a batch of 1 is broadcast to the batch of the other input
+  bool broadcast_a = a_dim == 3 && shape_A[0].as_int32() == 1;
+  bool broadcast_b = a_dim == 3 && shape_B[0].as_int32() == 1;
+  if (a_dim == 3) {
+    CHECK(broadcast_a || broadcast_b || shape_A[0].as_int32() == shape_B[0].as_int32())
+        << "The batch sizes of QuantizedMatmul's inputs can't be broadcast: " << shape_A[0] << " vs " << shape_B[0];
+    output_shape = {Expr(std::max(shape_A[0].as_int32(), shape_B[0].as_int32())), M, N};
+  } else {
+    output_shape = {M, N};
+  }
+  Var reduce_k(x_width, UniqName("reduce_k"));
+  return Compute(
+      output_shape,
+      [=](const std::vector<Expr> &indice) {
+        int out_dim = indice.size();
+        std::vector<Expr> A_indice;
+        std::vector<Expr> B_indice;
+        if (out_dim == 3U) {
+          A_indice.push_back(broadcast_a ? Expr(0) : indice[0]);
+          B_indice.push_back(broadcast_b ? Expr(0) : indice[0]);
+        }
+        A_indice.push_back(indice[out_dim - 2]);
+        A_indice.push_back(reduce_k);
+        B_indice.push_back(reduce_k);
+        B_indice.push_back(indice[out_dim - 1]);
+        if (trans_a) {
+          std::swap(A_indice[out_dim - 2], A_indice[out_dim - 1]);
+        }
+        if (trans_b) {
+          std::swap(B_indice[out_dim - 2], B_indice[out_dim - 1]);
+        }
+        // widen before multiplying so that the products and the sum never overflow
+        return lang::ReduceSum(ir::Cast::Make(Int(32), A(A_indice)) * ir::Cast::Make(Int(32), B(B_indice)),
+                               {reduce_k});
+      },
+      output_name);
+}
+
+std::vector<Tensor> QuantizedConv2d_NCHW(const Tensor &input,
+                                         const Tensor &weights,
+                                         int pad_h,
+                                         int pad_w,
+                                         int stride_h,
+                                         int stride_w,
+                                         int dilation_h,
+                                         int dilation_w,
+                                         const std::string &output_name) {
+  CHECK(input->type().is_int(8)) << "QuantizedConv2d's input should be int8, but got " << input->type();
+  CHECK(weights->type().is_int(8)) << "QuantizedConv2d's weight should be int8, but got " << weights->type();
+  CHECK_EQ(input->shape.size(), 4U) << "Input's dimension of QuantizedConv2d_NCHW op is not 4! Please check.";
+  CHECK_EQ(weights->shape.size(), 4U) << "Weight's dimension of QuantizedConv2d_NCHW op is not 4! Please check.";
+  CHECK(MathEqual(weights->shape[1], input->shape[1])) << "QuantizedConv2d_NCHW doesn't support group convolution";
+  int kh = weights->shape[2].as_int32();
+  int kw = weights->shape[3].as_int32();
+  std::vector<Expr> output_shape{
+      input->shape[0],
+      weights->shape[0],
+      Expr((input->shape[2].as_int32() - ((kh - 1) * dilation_h + 1) + 2 * pad_h) / stride_h + 1),
+      Expr((input->shape[3].as_int32() - ((kw - 1) * dilation_w + 1) + 2 * pad_w) / stride_w + 1)};
+  std::vector<Expr> input_pad_shape{input->shape[0],
+                                    input->shape[1],
+                                    Expr(input->shape[2].as_int32() + 2 * pad_h),
+                                    Expr(input->shape[3].as_int32() + 2 * pad_w)};
+  // real zero is int8 zero under symmetric quantization, so the padding value is 0
+  auto input_pad = Compute(
+      input_pad_shape,
+      [=](Expr nn, Expr cc, Expr yy, Expr xx) {
+        auto cond =
+            lang::logic_and({yy >= pad_h, yy < input->shape[2] + pad_h, xx >= pad_w, xx < input->shape[3] + pad_w});
+        return ir::Select::Make(cond, input(nn, cc, yy - pad_h, xx - pad_w), ir::Zero(input->type()));
+      },
+      UniqName("input_pad"));
+
+  Var rc(weights->shape[1], UniqName("rc"));
+  Var ry(weights->shape[2], UniqName("ry"));
+  Var rx(weights->shape[3], UniqName("rx"));
+  auto res = Compute(
+      output_shape,
+      [=](Expr nn, Expr ff, Expr yy, Expr xx) {
+        return lang::ReduceSum(
+            ir::Cast::Make(Int(32), input_pad(nn, rc, yy * stride_h + ry * dilation_h, xx * stride_w + rx * dilation_w)) *
+                ir::Cast::Make(Int(32), weights(ff, rc, ry, rx)),
+            {rc, ry, rx});
+      },
+      output_name);
+  return {res, input_pad};
+}
+
+}  // namespace pe
+}  // namespace hlir
+}  // namespace cinn
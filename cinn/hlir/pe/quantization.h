@@ -0,0 +1,122 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/ir/ir.h"
+#include "cinn/lang/builtin.h"
+#include "cinn/lang/compute.h"
+
+namespace cinn {
+namespace hlir {
+namespace pe {
+
+/**
+ * @brief Quantize a float tensor to int8 with a symmetric per-tensor scale.
+ * out = clip(round(A / scale) + zero_point, -128, 127)
+ *
+ * @param A The input float tensor
+ * @param scale The quantization step, i.e. the real value of one int8 unit
+ * @param zero_point The int8 value that real zero maps to
+ * @param output_name The name of the output Tensor
+ *
+ * @return The int8 result Tensor.
+ */
+ir::Tensor Quantize(const ir::Tensor &A,
+                    float scale,
+                    int zero_point                 = 0,
+                    const std::string &output_name = UniqName("T_Quantize_out"));
+
+/**
+ * @brief Dequantize an int8 or int32 tensor back to float32.
+ * out = (A - zero_point) * scale
+ *
+ * @param A The input integer tensor
+ * @param scale The quantization step of A
+ * @param zero_point The value in A that real zero maps to
+ * @param output_name The name of the output Tensor
+ *
+ * @return The float32 result Tensor.
+ */
+ir::Tensor Dequantize(const ir::Tensor &A,
+                      float scale,
+                      int zero_point                 = 0,
+                      const std::string &output_name = UniqName("T_Dequantize_out"));
+
+/**
+ * @brief Rescale an int32 accumulator to int8 without going through a float tensor.
+ * out = clip(round(A * in_scale / out_scale) + zero_point, -128, 127)
+ *
+ * @param A The input int32 tensor
+ * @param in_scale The quantization step of A
+ * @param out_scale The quantization step of the output
+ * @param zero_point The int8 value that real zero maps to
+ * @param output_name The name of the output Tensor
+ *
+ * @return The int8 result Tensor.
+ */
+ir::Tensor Requantize(const ir::Tensor &A,
+                      float in_scale,
+                      float out_scale,
+                      int zero_point                 = 0,
+                      const std::string &output_name = UniqName("T_Requantize_out"));
+
+/**
+ * @brief Multiply two int8 matrices and accumulate in int32.
+ *
+ * @param A The first input tensor, [batch, M, K] or [M, K]
+ * @param B The second input tensor, [batch, K, N] or [K, N]
+ * @param trans_a whether A is transposed, default: false
+ * @param trans_b whether B is transposed, default: false
+ * @param output_name The name of the output Tensor
+ *
+ * @return The int32 result Tensor.
+ */
+ir::Tensor QuantizedMatmul(const ir::Tensor &A,
+                           const ir::Tensor &B,
+                           bool trans_a                   = false,
+                           bool trans_b                   = false,
+                           const std::string &output_name = UniqName("T_QuantizedMatmul_out"));
+
+/**
+ * @brief Perform a 2-D convolution on int8 NCHW tensors and accumulate in int32.
+ *
+ * @param input The 4-D int8 input tensor {N, C_in, H, W}
+ * @param weights The 4-D int8 weight tensor {C_out, C_in, filter_h, filter_w}
+ * @param pad_h padding applied to the height of the image
+ * @param pad_w padding applied to the width of the image
+ * @param stride_h striding applied to the height of the image
+ * @param stride_w striding applied to the width of the image
+ * @param dilation_h dilation applied to the height of the image
+ * @param dilation_w dilation applied to the width of the image
+ * @param output_name The name of the output tensors
+ *
+ * @return {int32 output, padded input}
+ */
+std::vector<ir::Tensor> QuantizedConv2d_NCHW(const ir::Tensor &input,
+                                             const ir::Tensor &weights,
+                                             int pad_h,
+                                             int pad_w,
+                                             int stride_h,
+                                             int stride_w,
+                                             int dilation_h,
+                                             int dilation_w,
+                                             const std::string &output_name = UniqName("T_QuantizedConv2d_NCHW_out"));
+
+}  // namespace pe
+}  // namespace hlir
+}  // namespace cinn
@@ -398,6 +398,80 @@ std::vector<ir::Tensor> BlockReduceSum(const ir::Tensor& A,
   return {out, tmp_out};
 }
 
+std::vector<ir::Tensor> TwoStageReduce(const ir::Tensor& A,
+                                       const std::vector<int>& axes,
+                                       const ReduceFunc& reduce_func,
+                                       const bool keep_dim,
+                                       const int num_partials,
+                                       const int lanes,
+                                       const std::string& output_name) {
+  CHECK(num_partials > 1 || lanes > 1) << "TwoStageReduce should split the reduce axes at least once";
+  int ndim = A->shape.size();
+  std::vector<int> real_axes;
+  GetRealAxes(ndim, axes, &real_axes);
+  int first_axis = real_axes.front();
+  if (lanes > 1) {
+    CHECK_EQ(real_axes.back(), ndim - 1) << "Only the last axis can be split into vector lanes";
+  }
+
+  // compute the view shape: {num_partials, A's shape with the first reduce axis divided by num_partials and the last
+  // axis split into {last / lanes, lanes}}
+  int offset = num_partials > 1 ? 1 : 0;
+  std::vector<int> extents;
+  std::vector<Expr> view_shape;
+  if (num_partials > 1) {
+    view_shape.push_back(Expr(num_partials));
+  }
+  for (int idx = 0; idx < ndim; ++idx) {
+    int extent = A->shape[idx].as_int32();
+    if (num_partials > 1 && idx == first_axis) {
+      CHECK_EQ(extent % num_partials, 0) << "The reduce axis can't be split into " << num_partials << " partials";
+      extent /= num_partials;
+    }
+    extents.push_back(extent);
+    if (lanes > 1 && idx == ndim - 1) {
+      CHECK_EQ(extent % lanes, 0) << "The last axis can't be split into " << lanes << " lanes";
+      view_shape.push_back(Expr(extent / lanes));
+      view_shape.push_back(Expr(lanes));
+    } else {
+      view_shape.push_back(Expr(extent));
+    }
+  }
+  auto view = Compute(
+      view_shape,
+      [=](const std::vector<Expr>& indexs) -> Expr {
+        std::vector<Expr> A_indexs;
+        for (int idx = 0; idx < ndim; ++idx) {
+          Expr index = indexs[idx + offset];
+          if (lanes > 1 && idx == ndim - 1) {
+            index = index * Expr(lanes) + indexs[idx + offset + 1];
+          }
+          if (num_partials > 1 && idx == first_axis) {
+            index = indexs[0] * Expr(extents[idx]) + index;
+          }
+          A_indexs.push_back(index);
+        }
+        return A(A_indexs);
+      },
+      UniqName(output_name + "_view"));
+
+  // the partial and lane axes of the view are kept in the first stage and reduced in the second stage
+  std::vector<int> view_axes;
+  for (auto axis : real_axes) {
+    view_axes.push_back(axis + offset);
+  }
+  auto partial = reduce_func(view, view_axes, keep_dim, Expr(), UniqName(output_name + "_partial"));
+  std::vector<int> partial_axes;
+  if (num_partials > 1) {
+    partial_axes.push_back(0);
+  }
+  if (lanes > 1) {
+    partial_axes.push_back(partial->shape.size() - 1);
+  }
+  auto out = reduce_func(partial, partial_axes, false, Expr(), output_name);
+  return {out, partial, view};
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
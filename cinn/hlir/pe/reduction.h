@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -166,6 +167,34 @@ std::vector<ir::Tensor> BlockReduceSum(const ir::Tensor& A,
                                        const bool keep_dim            = false,
                                        const std::string& output_name = "T_Block_Reduce_Sum_out");
 
+using ReduceFunc =
+    std::function<ir::Tensor(const ir::Tensor&, const std::vector<int>&, bool, Expr, const std::string&)>;
+
+/**
+ * @brief reduce in two stages for CPU. The first stage reduces a view of A into partial results, the second stage
+ * reduces the partial results into the output.
+ *        If num_partials > 1, the first reduce axis is split into num_partials chunks which can be reduced in parallel.
+ *        If lanes > 1, the last axis, which must be reduced, is split into {last / lanes, lanes} and only the outer
+ *        part is reduced in the first stage, so that the partial results can be accumulated with vector instructions.
+ *
+ * @param A The input Tensor.
+ * @param axes The axes along which the reduction are performed.
+ * @param reduce_func The reduction PE used by both stages, eg. ReduceSum.
+ * @param keep_dim If it is set true, the axes which are reduced are left in the result as dimensions with size one.
+ * @param num_partials The number of chunks the first reduce axis is split into.
+ * @param lanes The number of vector lanes the last axis is split into.
+ * @param output_name The name of the output Tensor.
+ *
+ * @return {output, partial results, the view of A}.
+ */
+std::vector<ir::Tensor> TwoStageReduce(const ir::Tensor& A,
+                                       const std::vector<int>& axes,
+                                       const ReduceFunc& reduce_func,
+                                       const bool keep_dim,
+                                       const int num_partials,
+                                       const int lanes,
+                                       const std::string& output_name = "T_Two_Stage_Reduce_out");
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -111,8 +111,15 @@ void ScheduleInjectiveCPU(poly::Stage *stage,
   if (vectorizable) {
     poly::Iterator lo;
     poly::Iterator li;
-    int last_shape   = stage->GetDimRange(dims - 1);
-    factor           = GetVectorizeFactor(last_shape, factor);
+    int last_shape    = stage->GetDimRange(dims - 1);
+    int vector_factor = GetVectorizeFactor(last_shape, factor);
+    // no divisor of the last dimension makes a wide vector, e.g. a prime size like 997, so vectorize the whole
+    // dimension and leave the remainder to the scalar loop generated by VectorizeLoops
+    if (dims > 1 && vector_factor * 2 < factor && last_shape > factor) {
+      stage->Vectorize(dims - 1, factor);
+      return;
+    }
+    factor           = vector_factor;
     std::tie(lo, li) = stage->Split(stage->axis(dims - 1), factor);
     stage->Vectorize(li, factor);
     if (dims == 1) {
@@ -315,6 +322,136 @@ void MulScheduleCPU(poly::StageMap stages,
   }
 }
 
+void QuantizedMatmulScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target) {
+  CHECK(output->type().is_int(32)) << "QuantizedMatmulScheduleCPU expects an int32 accumulator, but got "
+                                   << output->type();
+  int out_dims = output->shape.size();
+  CHECK_EQ(stages[output]->n_out_dims(), out_dims + 1) << "the reduce axis k should be the innermost axis";
+  // vectorize along N with int32 lanes, and keep groups of 4 int8 products of k adjacent in the loop body, which is
+  // the shape of an AVX512-VNNI vpdpbusd (4 x int8 -> int32 per lane) that the backend can pattern match.
+  int N     = stages[output]->GetDimRange(out_dims - 1);
+  int K     = stages[output]->GetDimRange(out_dims);
+  int lanes = GetVectorizeFactor(N, GetBasicFactor(output->type(), target));
+  std::vector<poly::Iterator> order;
+  for (int i = 0; i < out_dims - 1; ++i) {
+    order.push_back(stages[output]->axis(i));
+  }
+  poly::Iterator j_axis = stages[output]->axis(out_dims - 1);
+  poly::Iterator k_axis = stages[output]->axis(out_dims);
+  poly::Iterator j_outer, j_inner, k_outer, k_inner;
+  bool is_j_splited = lanes > 1;
+  bool is_k_splited = K > 4 && K % 4 == 0;
+  if (is_j_splited) {
+    std::tie(j_outer, j_inner) = stages[output]->Split(j_axis, lanes);
+    order.push_back(j_outer);
+  } else {
+    order.push_back(j_axis);
+  }
+  if (is_k_splited) {
+    std::tie(k_outer, k_inner) = stages[output]->Split(k_axis, 4);
+    order.push_back(k_outer);
+    order.push_back(k_inner);
+  } else {
+    order.push_back(k_axis);
+  }
+  if (is_j_splited) {
+    order.push_back(j_inner);
+  }
+  stages[output]->Reorder(order);
+  if (is_k_splited) {
+    stages[output]->Unroll(k_inner);
+  }
+  if (is_j_splited) {
+    stages[output]->Vectorize(j_inner, lanes);
+  }
+  stages[output]->Parallel(0);
+}
+
+void QuantizedConv2dScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target) {
+  CHECK(output->type().is_int(32)) << "QuantizedConv2dScheduleCPU expects an int32 accumulator, but got "
+                                   << output->type();
+  CHECK_EQ(output->shape.size(), 4U) << "QuantizedConv2dScheduleCPU only supports NCHW output";
+  CHECK_EQ(stages[output]->n_out_dims(), 7) << "the reduce axes rc, ry and rx should be the innermost axes";
+  // the same treatment as QuantizedMatmulScheduleCPU with the output width as N and the input channel as K: vectorize
+  // along the output width with int32 lanes and keep groups of 4 int8 products of the input channel adjacent.
+  int W     = stages[output]->GetDimRange(3);
+  int C     = stages[output]->GetDimRange(4);
+  int lanes = GetVectorizeFactor(W, GetBasicFactor(output->type(), target));
+  std::vector<poly::Iterator> order{stages[output]->axis(0), stages[output]->axis(1), stages[output]->axis(2)};
+  poly::Iterator x_axis  = stages[output]->axis(3);
+  poly::Iterator rc_axis = stages[output]->axis(4);
+  poly::Iterator ry_axis = stages[output]->axis(5);
+  poly::Iterator rx_axis = stages[output]->axis(6);
+  poly::Iterator x_outer, x_inner, rc_outer, rc_inner;
+  bool is_x_splited  = lanes > 1;
+  bool is_rc_splited = C > 4 && C % 4 == 0;
+  if (is_x_splited) {
+    std::tie(x_outer, x_inner) = stages[output]->Split(x_axis, lanes);
+    order.push_back(x_outer);
+  } else {
+    order.push_back(x_axis);
+  }
+  if (is_rc_splited) {
+    std::tie(rc_outer, rc_inner) = stages[output]->Split(rc_axis, 4);
+    order.insert(order.end(), {rc_outer, ry_axis, rx_axis, rc_inner});
+  } else {
+    order.insert(order.end(), {rc_axis, ry_axis, rx_axis});
+  }
+  if (is_x_splited) {
+    order.push_back(x_inner);
+  }
+  stages[output]->Reorder(order);
+  if (is_rc_splited) {
+    stages[output]->Unroll(rc_inner);
+  }
+  if (is_x_splited) {
+    stages[output]->Vectorize(x_inner, lanes);
+  }
+  // parallelize over the fused batch and output channel axes
+  stages[output]->Fuse(0, 1);
+  stages[output]->Parallel(0);
+}
+
+void TransposeScheduleCPU(poly::StageMap stages,
+                          const ir::Tensor &output,
+                          const std::vector<int> &axis,
+                          const common::Target &target) {
+  auto *stage = stages[output];
+  int dims    = axis.size();
+  CHECK_EQ(stage->n_out_dims(), dims);
+  std::vector<int> output_shape;
+  for (auto &dim : output->shape) {
+    output_shape.push_back(dim.as_int32());
+  }
+  // the output dimension running along the contiguous dimension of the input, it is strided in the output
+  int col  = std::find(axis.begin(), axis.end(), dims - 1) - axis.begin();
+  int tile = GetBasicFactor(output->type(), target);
+  if (col == dims - 1 || tile < 2 || output_shape[col] % tile != 0 || output_shape[dims - 1] % tile != 0) {
+    ScheduleInjectiveCPU(stage, output_shape, target);
+    return;
+  }
+  // copy tile x tile blocks, e.g. 8x8 for float32 in AVX2, so that both the rows read from the input and the rows
+  // written to the output stay in cache. The rows of a block are unrolled and the output rows are vectorized, which
+  // lets LLVM turn the strided loads of a block into vector loads and shuffles.
+  std::vector<poly::Iterator> order;
+  poly::Iterator col_outer, col_inner, row_outer, row_inner;
+  poly::Iterator col_axis = stage->axis(col);
+  poly::Iterator row_axis = stage->axis(dims - 1);
+  for (int i = 0; i < dims - 1; ++i) {
+    order.push_back(stage->axis(i));
+  }
+  std::tie(col_outer, col_inner) = stage->Split(col_axis, tile);
+  std::tie(row_outer, row_inner) = stage->Split(row_axis, tile);
+  order[col]                     = col_outer;
+  order.push_back(row_outer);
+  order.push_back(col_inner);
+  order.push_back(row_inner);
+  stage->Reorder(order);
+  stage->Unroll(col_inner);
+  stage->Vectorize(row_inner, tile);
+  stage->Parallel(0);
+}
+
 int GetThreadBindAxis(const std::vector<ir::Expr> &shape) {
   int thread_axis = shape.size() - 1;
   for (int idx = thread_axis; idx >= 0; --idx) {
@@ -461,7 +598,98 @@ void CudaScheduleBlockReduce(poly::StageMap stages,
   stages[out]->Bind(0, "blockIdx.x");
 }
 
-void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir::Tensor &temp, int axis) {
+void ReduceScheduleCPU(poly::StageMap stages,
+                       const ir::Tensor &output,
+                       bool reduce_last_axis,
+                       const common::Target &target) {
+  int out_dims    = output->shape.size();
+  int reduce_dims = output->reduce_axis.size();
+  CHECK_EQ(stages[output]->n_out_dims(), out_dims + reduce_dims) << "the reduce axes should be the innermost axes";
+  if (reduce_last_axis) {
+    // each output element reads a contiguous row, so only the outer loops are run in parallel
+    int out_size = 1;
+    for (auto &dim : output->shape) {
+      out_size *= dim.as_int32();
+    }
+    if (out_size > 1) {
+      for (int idx = 0; idx < out_dims - 1; ++idx) {
+        stages[output]->Fuse(0, 1);
+      }
+      stages[output]->Parallel(0);
+    }
+    return;
+  }
+  // the last axis is contiguous in memory and not reduced, move the reduce axes outside of it and accumulate along it
+  // with vector instructions
+  std::vector<poly::Iterator> order;
+  for (int idx = out_dims; idx < out_dims + reduce_dims; ++idx) {
+    order.push_back(stages[output]->axis(idx));
+  }
+  order.push_back(stages[output]->axis(out_dims - 1));
+  stages[output]->Reorder(order);
+  if (out_dims > 1) {
+    for (int idx = 0; idx < out_dims - 2; ++idx) {
+      stages[output]->Fuse(0, 1);
+    }
+    stages[output]->Parallel(0);
+  }
+  int factor = GetVectorizeFactor(output->shape.back().as_int32(), GetBasicFactor(output->type(), target));
+  if (factor > 1) {
+    stages[output]->Vectorize(stages[output]->n_out_dims() - 1, factor);
+  }
+}
+
+void MultiReduceScheduleCPU(poly::StageMap stages,
+                            const std::vector<ir::Tensor> &outputs,
+                            const common::Target &target) {
+  CHECK(!outputs.empty());
+  auto &master = outputs.front();
+  int n_dims   = master->shape.size() + master->reduce_axis.size();
+  CHECK_EQ(stages[master]->n_out_dims(), n_dims) << "the reduce axes should be the innermost axes";
+  stages[master]->Parallel(0);
+  for (int i = 1; i < outputs.size(); i++) {
+    CHECK_EQ(stages[outputs[i]]->n_out_dims(), n_dims) << "the reductions should have the same loops";
+    stages[outputs[i]]->SimpleComputeAt(stages[master], n_dims - 1);
+  }
+}
+
+void TwoStageReduceScheduleCPU(poly::StageMap stages,
+                               const ir::Tensor &output,
+                               const ir::Tensor &partial,
+                               const ir::Tensor &view,
+                               int num_partials,
+                               int lanes,
+                               const common::Target &target) {
+  stages[view]->ComputeInline();
+  int partial_dims = partial->shape.size();
+  int reduce_dims  = partial->reduce_axis.size();
+  CHECK_EQ(stages[partial]->n_out_dims(), partial_dims + reduce_dims) << "the reduce axes should be the innermost axes";
+  if (lanes > 1) {
+    // move the lane axis inside the reduce axes, so every lane accumulates its own partial result in a vector register
+    std::vector<poly::Iterator> order;
+    for (int idx = partial_dims; idx < partial_dims + reduce_dims; ++idx) {
+      order.push_back(stages[partial]->axis(idx));
+    }
+    order.push_back(stages[partial]->axis(partial_dims - 1));
+    stages[partial]->Reorder(order);
+    stages[partial]->Vectorize(stages[partial]->n_out_dims() - 1, lanes);
+  }
+  // with num_partials > 1 the first axis indexes the chunks, each thread reduces its own chunk
+  if (num_partials > 1 || partial_dims > 1) {
+    stages[partial]->Parallel(0);
+  }
+  if (lanes > 1) {
+    // the horizontal reduction of the lanes
+    stages[output]->Unroll(stages[output]->n_out_dims() - 1);
+  }
+}
+
+void SoftmaxScheduleCPU(poly::StageMap stage,
+                        const ir::Tensor &output,
+                        const ir::Tensor &temp,
+                        const ir::Tensor &max,
+                        int axis,
+                        const common::Target &target) {
   if (axis == -1) {
     axis += output->shape.size();
   }
@@ -471,7 +699,50 @@ void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir
     fused = stage[output]->Fuse(0, 1);
   }
   CHECK_GT(stage[output]->n_out_dims(), 1);
+  // compute the row statistics inside the row loop of the output, so the row is still in cache when normalized
+  stage[max]->ComputeAt(stage[output], 0);
   stage[temp]->ComputeAt(stage[output], 0);
+  if (axis == static_cast<int>(output->shape.size()) - 1) {
+    int last_dim     = stage[output]->n_out_dims() - 1;
+    int basic_factor = GetBasicFactor(output->type(), target);
+    int factor       = GetVectorizeFactor(output->shape.back().as_int32(), basic_factor);
+    if (factor > 1) {
+      stage[output]->Vectorize(last_dim, factor);
+    }
+  }
+}
+
+void LayerNormScheduleCPU(poly::StageMap stages,
+                          const ir::Tensor &output,
+                          const ir::Tensor &mean,
+                          const ir::Tensor &variance,
+                          int begin_norm_axis,
+                          const common::Target &target) {
+  int rank = output->shape.size();
+  if (begin_norm_axis < 0) {
+    begin_norm_axis += rank;
+  }
+  // fuse the normalized dimensions so that the row is one contiguous loop
+  for (int i = begin_norm_axis + 1; i < rank; i++) {
+    stages[output]->Fuse(begin_norm_axis, begin_norm_axis + 1);
+  }
+  if (begin_norm_axis > 0) {
+    for (int i = 1; i < begin_norm_axis; i++) {
+      stages[output]->Fuse(0, 1);
+    }
+    stages[output]->Parallel(0);
+    // compute the row statistics inside the row loop of the output, so the row is still in cache when normalized
+    stages[mean]->ComputeAt(stages[output], 0);
+    stages[variance]->ComputeAt(stages[output], 0);
+  }
+  int row_size = 1;
+  for (int i = begin_norm_axis; i < rank; i++) {
+    row_size *= output->shape[i].as_int32();
+  }
+  int factor = GetVectorizeFactor(row_size, GetBasicFactor(output->type(), target));
+  if (factor > 1) {
+    stages[output]->Vectorize(stages[output]->n_out_dims() - 1, factor);
+  }
 }
 
 void GlobalPoolScheduleGPU(poly::StageMap stages, const std::vector<ir::Tensor> &output, const common::Target &target) {
@@ -485,10 +756,13 @@ void GlobalPoolScheduleGPU(poly::StageMap stages, const std::vector<ir::Tensor>
   stages[reduce]->SetBuffer("local");
   stages[reduce]->Bind(2, "threadIdx.x");
 }
-void PoolScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target) {
-  CHECK_GE(stages[output]->n_out_dims(), 2);
-  stages[output]->Fuse({0, 1});
-  stages[output]->Parallel(0);
+void PoolScheduleCPU(poly::StageMap stages,
+                     const ir::Tensor &output,
+                     bool vectorize_last_axis,
+                     const common::Target &target) {
+  CHECK_GE(output->shape.size(), 2U);
+  // the window axes are reduced, so the pooling shares the loops of the reduction whose last axis is kept or reduced
+  ReduceScheduleCPU(stages, output, !vectorize_last_axis, target);
 }
 
 void PoolScheduleGPU(poly::StageMap stages, ir::Tensor &output, const common::Target &target) {
@@ -1269,6 +1543,63 @@ void Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
   }
 }
 
+void DepthwisePointwiseConv2d_Schedule_CPU(poly::StageMap stages,
+                                           const ir::Tensor &res,
+                                           const ir::Tensor &packed_out,
+                                           const ir::Tensor &dw_out,
+                                           const ir::Tensor &input_pad,
+                                           const common::Target &target) {
+  CHECK(target.arch == Target::Arch::X86) << "DepthwisePointwiseConv2d_Schedule_CPU schedule only used in x86";
+  CHECK_EQ(packed_out->shape.size(), 5U) << "packed_out's shape size should be 5";
+  CHECK_EQ(dw_out->shape.size(), 5U) << "dw_out's shape size should be 5";
+  int oc_bn_size = packed_out->shape.back().as_int32();
+  int ic_bn_size = dw_out->shape.back().as_int32();
+  VLOG(3) << "oc_bn_size " << oc_bn_size;
+  VLOG(3) << "ic_bn_size " << ic_bn_size;
+
+  // input_pad: [batch, ic_outer, h, w, ic_inner]
+  stages[input_pad]->Vectorize(stages[input_pad]->n_out_dims() - 1, ic_bn_size);
+
+  // packed_out: [batch, oc_outer, oh, ow, oc_inner, ic_outer, ic_inner] ->
+  // [batch, oh, oc_outer, ow, ic_outer, ic_inner, oc_inner]
+  auto oc_outer = stages[packed_out]->axis(1);
+  auto oh       = stages[packed_out]->axis(2);
+  auto ow       = stages[packed_out]->axis(3);
+  auto oc_inner = stages[packed_out]->axis(4);
+  auto ic_outer = stages[packed_out]->axis(5);
+  auto ic_inner = stages[packed_out]->axis(6);
+  stages[packed_out]->Reorder({oh, oc_outer, ow, ic_outer, ic_inner, oc_inner});
+
+  // dw_out: [batch, ic_outer, oh, ow, ic_inner, kh, kw] -> [batch, oh, ic_outer, ow, ic_inner, kh, kw]
+  // compute one row of all the channels in the row loop of packed_out, the buffer is shrunk to the row
+  stages[dw_out]->ComputeAt2(stages[packed_out], 1);
+  VLOG(3) << "stages[dw_out]->transformed_domain()" << stages[dw_out]->transformed_domain();
+  // [batch, oh, ic_outer, ow, ic_inner, kh, kw] -> [batch, oh, ic_outer, ow, kh, kw, ic_inner]
+  int dw_dims      = stages[dw_out]->n_out_dims();
+  auto dw_ic_inner = stages[dw_out]->axis(dw_dims - 3);
+  auto dw_kh       = stages[dw_out]->axis(dw_dims - 2);
+  auto dw_kw       = stages[dw_out]->axis(dw_dims - 1);
+  stages[dw_out]->Reorder({dw_kh, dw_kw, dw_ic_inner});
+  stages[dw_out]->Vectorize(dw_dims - 1, ic_bn_size);
+  auto dw_out_init = dw_out->GetInitTensor(stages, target);
+  stages[dw_out_init]->Vectorize(stages[dw_out_init]->n_out_dims() - 1, ic_bn_size);
+
+  stages[packed_out]->Vectorize(stages[packed_out]->n_out_dims() - 1, oc_bn_size);
+  auto packed_out_init = packed_out->GetInitTensor(stages, target);
+  stages[packed_out_init]->Vectorize(stages[packed_out_init]->n_out_dims() - 1, oc_bn_size);
+
+  // res
+  // n, oc, oh, ow
+  if (res.defined()) {
+    stages[res]->Split(1, oc_bn_size);
+    // Reorder: [n, oc_outer, oc_inner, oh, ow] -> [n, oc_outer, oh, ow, oc_inner]
+    auto oc_inner1 = stages[res]->axis(2);
+    auto oh1       = stages[res]->axis(3);
+    auto ow1       = stages[res]->axis(4);
+    stages[res]->Reorder({oh1, ow1, oc_inner1});
+  }
+}
+
 void CudaScheduleMul(poly::StageMap stages,
                      ir::Tensor output,
                      const std::vector<int> &output_shape,
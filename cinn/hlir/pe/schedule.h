@@ -60,6 +60,8 @@ int GetBasicFactor(const Type &type, const common::Target &target);
 
 int GetBetterSplitFactor(int shape, int split_factor);
 
+int GetVectorizeFactor(int shape, int split_factor);
+
 int GetArrayPackingFactor(int shape, const Type &type, const common::Target &target);
 
 void ScheduleInjectiveCPU(poly::Stage *stage,
@@ -82,7 +84,21 @@ void MulScheduleCPU(poly::StageMap stage,
                     const ir::Tensor &input_tensor,
                     const common::Target &target);
 
-void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir::Tensor &temp, int axis = -1);
+void QuantizedMatmulScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target);
+
+void QuantizedConv2dScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target);
+
+void TransposeScheduleCPU(poly::StageMap stages,
+                          const ir::Tensor &output,
+                          const std::vector<int> &axis,
+                          const common::Target &target);
+
+void SoftmaxScheduleCPU(poly::StageMap stage,
+                        const ir::Tensor &output,
+                        const ir::Tensor &temp,
+                        const ir::Tensor &max,
+                        int axis,
+                        const common::Target &target);
 
 void GetConv2dFactors(absl::flat_hash_map<std::string, int> *factors,
                       int oc,
@@ -112,8 +128,23 @@ void Conv2d_NCHWc_Schedule_CPU(poly::StageMap stages,
                                const common::Target &target,
                                const std::string &key,
                                bool do_padding);
+void LayerNormScheduleCPU(poly::StageMap stages,
+                          const ir::Tensor &output,
+                          const ir::Tensor &mean,
+                          const ir::Tensor &variance,
+                          int begin_norm_axis,
+                          const common::Target &target);
+
 void GlobalPoolScheduleGPU(poly::StageMap stages, const std::vector<ir::Tensor> &output, const common::Target &target);
-void PoolScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target);
+/**
+ * Schedule a pooling on x86. If vectorize_last_axis is true, the innermost output axis (the channel block of NCHWc,
+ * the channel of NHWC or the width with stride 1) is contiguous in the input, the window loops are moved outside of
+ * it and it is accumulated with vector instructions. Otherwise the output axes are fused and run in parallel.
+ */
+void PoolScheduleCPU(poly::StageMap stages,
+                     const ir::Tensor &output,
+                     bool vectorize_last_axis,
+                     const common::Target &target);
 void PoolScheduleGPU(poly::StageMap stages, ir::Tensor &output, const common::Target &target);
 
 void Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
@@ -151,6 +182,18 @@ void Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
                                                 const common::Target &target,
                                                 bool do_padding);
 
+/**
+ * Schedule the depthwise convolution fused with the 1x1 convolution on x86. The depthwise output of one output row of
+ * all channels is computed right before the 1x1 convolution of the row into a buffer of the row size, so it is read
+ * from cache instead of memory. The channel blocks of both convolutions are vectorized.
+ */
+void DepthwisePointwiseConv2d_Schedule_CPU(poly::StageMap stages,
+                                           const ir::Tensor &res,
+                                           const ir::Tensor &packed_out,
+                                           const ir::Tensor &dw_out,
+                                           const ir::Tensor &input_pad,
+                                           const common::Target &target);
+
 void CudaScheduleMul(poly::StageMap stages,
                      ir::Tensor output,
                      const std::vector<int> &output_shape,
@@ -168,6 +211,27 @@ void CudaScheduleBlockReduceInternal(poly::StageMap stages,
 void CudaScheduleBlockReduce(
     poly::StageMap stages, ir::Tensor reduce_tmp_out, ir::Tensor tmp_out, ir::Tensor out, const common::Target &target);
 
+void ReduceScheduleCPU(poly::StageMap stages,
+                       const ir::Tensor &output,
+                       bool reduce_last_axis,
+                       const common::Target &target);
+
+/**
+ * Compute the reductions of the same shape and reduce axes, e.g. the sums of x and x * x of batch norm, in one loop
+ * nest, so their inputs are read once. The outermost axis of the first output is run in parallel.
+ */
+void MultiReduceScheduleCPU(poly::StageMap stages,
+                            const std::vector<ir::Tensor> &outputs,
+                            const common::Target &target);
+
+void TwoStageReduceScheduleCPU(poly::StageMap stages,
+                               const ir::Tensor &output,
+                               const ir::Tensor &partial,
+                               const ir::Tensor &view,
+                               int num_partials,
+                               int lanes,
+                               const common::Target &target);
+
 void CudaScheduleDepthwiseConv(poly::StageMap stages, ir::Tensor &output, const common::Target &target);
 
 void CudaScheduleConv(poly::StageMap stages,
@@ -86,6 +86,8 @@ class _Buffer_ : public ExprNode<_Buffer_> {
   mutable int data_alignment{0};
   //! The memory type of the buffer.
   MemoryType memory_type{MemoryType::Heap};
+  //! Write the buffer with non-temporal stores which bypass the caches.
+  mutable bool streaming_store{false};
 
   //! The data type of the elements.
   //! This is different from `type`, a buffer's type should always be `cinn_buffer_t*`.
@@ -0,0 +1,144 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/ir_arena.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace cinn {
+namespace ir {
+
+namespace {
+
+// Every node is prefixed by the chunk it is allocated from, which is nullptr if it is allocated from the heap, so
+// that operator delete knows how to release it.
+constexpr size_t kHeaderSize = alignof(std::max_align_t);
+constexpr size_t kChunkSize  = 64 * 1024;
+// The larger nodes are rare, allocate them from the heap to waste less of a chunk.
+constexpr size_t kMaxArenaAllocSize = kChunkSize / 16;
+
+constexpr size_t RoundUp(size_t size) { return (size + kHeaderSize - 1) / kHeaderSize * kHeaderSize; }
+
+thread_local IrArenaScope* current_scope = nullptr;
+
+}  // namespace
+
+struct IrArenaScope::Chunk {
+  // One reference for each live node in the chunk, and one held by the arena while it allocates from the chunk. The
+  // nodes can be destroyed on any thread.
+  std::atomic<int64_t> ref_count{1};
+  size_t used{0};
+
+  char* data() { return reinterpret_cast<char*>(this) + RoundUp(sizeof(Chunk)); }
+
+  static Chunk* Create() { return new (::operator new(RoundUp(sizeof(Chunk)) + kChunkSize)) Chunk; }
+
+  static void Release(Chunk* chunk) {
+    if (chunk->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      chunk->~Chunk();
+      ::operator delete(chunk);
+    }
+  }
+};
+
+IrArenaScope::IrArenaScope(bool hash_cons_constants)
+    : parent_(current_scope), hash_cons_constants_(hash_cons_constants) {
+  current_scope = this;
+}
+
+IrArenaScope::~IrArenaScope() {
+  CHECK_EQ(current_scope, this) << "IrArenaScope should be destroyed in the reverse order of creation";
+  // drop the shared immediates first, they may be the last nodes of the current chunk
+  constants_.clear();
+  if (chunk_) Chunk::Release(chunk_);
+  current_scope = parent_;
+  VLOG(4) << "IrArenaScope allocated " << num_allocated_ << " nodes and reused " << num_reused_constants_
+          << " constants";
+}
+
+IrArenaScope* IrArenaScope::Current() { return current_scope; }
+
+IrHeapScope::IrHeapScope() : arena_(current_scope) { current_scope = nullptr; }
+
+IrHeapScope::~IrHeapScope() {
+  CHECK(!current_scope) << "IrArenaScope created in an IrHeapScope should be destroyed before it";
+  current_scope = arena_;
+}
+
+void* IrArenaScope::Allocate(size_t size) {
+  size_t bytes = RoundUp(size) + kHeaderSize;
+  if (bytes > kMaxArenaAllocSize) return nullptr;
+  if (!chunk_ || chunk_->used + bytes > kChunkSize) {
+    if (chunk_) Chunk::Release(chunk_);
+    chunk_ = Chunk::Create();
+  }
+  char* header = chunk_->data() + chunk_->used;
+  chunk_->used += bytes;
+  chunk_->ref_count.fetch_add(1, std::memory_order_relaxed);
+  *reinterpret_cast<Chunk**>(header) = chunk_;
+  num_allocated_++;
+  return header + kHeaderSize;
+}
+
+Expr& IrArenaScope::Constant(IrNodeTy ty, int bits, int64_t value) {
+  auto& constant = constants_[std::make_tuple(ty, bits, value)];
+  if (constant.defined()) num_reused_constants_++;
+  return constant;
+}
+
+void* IrNode::operator new(size_t size) {
+  auto* scope = IrArenaScope::Current();
+  if (scope) {
+    if (void* p = scope->Allocate(size)) return p;
+  }
+  char* header                                     = static_cast<char*>(::operator new(RoundUp(size) + kHeaderSize));
+  *reinterpret_cast<IrArenaScope::Chunk**>(header) = nullptr;
+  return header + kHeaderSize;
+}
+
+void IrNode::operator delete(void* p) {
+  if (!p) return;
+  char* header = static_cast<char*>(p) - kHeaderSize;
+  auto* chunk  = *reinterpret_cast<IrArenaScope::Chunk**>(header);
+  if (chunk) {
+    IrArenaScope::Chunk::Release(chunk);
+  } else {
+    ::operator delete(header);
+  }
+}
+
+IrNode* MakeIntImm(Type t, int64_t v) {
+  auto* scope = IrArenaScope::Current();
+  if (!scope || !scope->hash_cons_constants() || t != Int(t.bits())) return new IntImm(t, v);
+  auto& constant = scope->Constant(IrNodeTy::IntImm, t.bits(), v);
+  if (!constant.defined()) constant = Expr(new IntImm(t, v));
+  return constant.ptr();
+}
+
+IrNode* MakeFloatImm(Type t, float v) {
+  auto* scope = IrArenaScope::Current();
+  if (!scope || !scope->hash_cons_constants() || t != Float(t.bits())) return new FloatImm(t, v);
+  // compare the bits instead of the values, so 0.f and -0.f are different and NaN is equal to itself
+  int32_t v_bits;
+  std::memcpy(&v_bits, &v, sizeof(v));
+  auto& constant = scope->Constant(IrNodeTy::FloatImm, t.bits(), v_bits);
+  if (!constant.defined()) constant = Expr(new FloatImm(t, v));
+  return constant.ptr();
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,106 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <cstdint>
+#include <tuple>
+
+#include "cinn/common/macros.h"
+#include "cinn/ir/ir_base.h"
+
+namespace cinn {
+namespace ir {
+
+/**
+ * While an IrArenaScope is alive, the IR nodes created on its thread are allocated from an arena, so creating a node
+ * is a pointer bump instead of a call to malloc. Lowering creates and drops millions of small nodes in passes like
+ * IRCopy and CasSimplify, which makes it allocation-bound otherwise.
+ *
+ * The nodes keep their reference counting and can outlive the scope, e.g. the lowered functions. The arena memory is
+ * divided into chunks, and a chunk is freed once all the nodes in it are destroyed and the arena has moved on.
+ *
+ * With `hash_cons_constants`, the integer and float immediates created by `Expr(int32_t)`, `common::make_const` and
+ * so on are hash-consed as well: equal immediates share one node, so they can be compared by pointer. A pass must
+ * then create a new node instead of modifying an immediate in place.
+ *
+ * The scopes can be nested, the innermost one is used.
+ *
+ * Usage:
+ * \code
+ * {
+ *   ir::IrArenaScope arena;
+ *   auto funcs = lang::LowerVec(...);
+ * }
+ * \endcode
+ */
+class IrArenaScope {
+ public:
+  explicit IrArenaScope(bool hash_cons_constants = false);
+  ~IrArenaScope();
+
+  //! The innermost scope of the current thread, nullptr if there is none.
+  static IrArenaScope* Current();
+
+  bool hash_cons_constants() const { return hash_cons_constants_; }
+
+  //! The number of nodes allocated from the arena and the number of immediates reused by hash-consing.
+  // @{
+  int64_t num_allocated() const { return num_allocated_; }
+  int64_t num_reused_constants() const { return num_reused_constants_; }
+  // @}
+
+ private:
+  struct Chunk;
+
+  //! Allocate `size` bytes for a node, return nullptr if the node is too large for the arena.
+  void* Allocate(size_t size);
+
+  //! Get the node shared by the immediates of the type `ty` and `bits` with the value `value`.
+  Expr& Constant(IrNodeTy ty, int bits, int64_t value);
+
+  friend class IrNode;
+  friend IrNode* MakeIntImm(Type t, int64_t v);
+  friend IrNode* MakeFloatImm(Type t, float v);
+
+  IrArenaScope* parent_{};
+  bool hash_cons_constants_{false};
+  Chunk* chunk_{};
+  int64_t num_allocated_{0};
+  int64_t num_reused_constants_{0};
+  absl::flat_hash_map<std::tuple<IrNodeTy, int, int64_t>, Expr> constants_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(IrArenaScope);
+};
+
+/**
+ * While an IrHeapScope is alive, the IR nodes created on its thread are allocated from the heap even inside an
+ * IrArenaScope. It is used for the nodes kept much longer than the arena, e.g. by a cache that lives across lowering
+ * sessions, since a single live node keeps its whole chunk from being freed.
+ */
+class IrHeapScope {
+ public:
+  IrHeapScope();
+  ~IrHeapScope();
+
+ private:
+  IrArenaScope* arena_{};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(IrHeapScope);
+};
+
+}  // namespace ir
+}  // namespace cinn
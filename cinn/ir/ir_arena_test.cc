@@ -0,0 +1,100 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/ir_arena.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn::ir {
+
+TEST(IrArenaScope, nodes_outlive_scope) {
+  Var i("i");
+  std::vector<Expr> exprs;
+  {
+    IrArenaScope arena;
+    ASSERT_EQ(IrArenaScope::Current(), &arena);
+    // allocate more nodes than a chunk can hold
+    for (int k = 0; k < 10000; k++) {
+      exprs.push_back(i * Expr(k) + Expr(1));
+    }
+    EXPECT_GE(arena.num_allocated(), 30000);
+  }
+  EXPECT_EQ(IrArenaScope::Current(), nullptr);
+
+  EXPECT_EQ(utils::GetStreamCnt(exprs[7]), "((i * 7) + 1)");
+  // release the nodes in another order and thread than they are allocated in
+  std::thread release([&] {
+    for (int k = 1; k < exprs.size(); k += 2) exprs[k] = Expr();
+  });
+  release.join();
+  exprs.resize(5000);
+  EXPECT_EQ(utils::GetStreamCnt(exprs[4998]), "((i * 4998) + 1)");
+}
+
+TEST(IrArenaScope, nested) {
+  IrArenaScope outer;
+  {
+    IrArenaScope inner;
+    EXPECT_EQ(IrArenaScope::Current(), &inner);
+    Expr a(1);
+    EXPECT_EQ(inner.num_allocated(), 1);
+  }
+  EXPECT_EQ(IrArenaScope::Current(), &outer);
+  Expr b(2);
+  EXPECT_EQ(outer.num_allocated(), 1);
+}
+
+TEST(IrArenaScope, hash_cons_constants) {
+  Expr a;
+  {
+    IrArenaScope arena(true);
+    a = Expr(3);
+    EXPECT_EQ(Expr(3).get(), a.get());
+    EXPECT_EQ(common::make_const(Int(32), 3).get(), a.get());
+    EXPECT_NE(Expr(int64_t(3)).get(), a.get());
+    EXPECT_NE(Expr(4).get(), a.get());
+
+    Expr f(1.5f);
+    EXPECT_EQ(Expr(1.5f).get(), f.get());
+    EXPECT_NE(Expr(-0.f).get(), Expr(0.f).get());
+    EXPECT_EQ(arena.num_reused_constants(), 3);
+  }
+  // the constants are still valid after the scope
+  EXPECT_EQ(a.as_int32(), 3);
+  EXPECT_NE(Expr(3).get(), a.get());
+
+  IrArenaScope arena;
+  EXPECT_NE(Expr(3).get(), Expr(3).get());
+}
+
+TEST(IrArenaScope, heap_scope) {
+  IrArenaScope arena;
+  Expr a(1);
+  {
+    IrHeapScope heap;
+    EXPECT_EQ(IrArenaScope::Current(), nullptr);
+    Expr b(2);
+  }
+  EXPECT_EQ(IrArenaScope::Current(), &arena);
+  EXPECT_EQ(arena.num_allocated(), 1);
+}
+
+}  // namespace cinn::ir
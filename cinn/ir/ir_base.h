@@ -29,7 +29,9 @@
 namespace cinn {
 
 namespace ir {
+using common::BFloat16;
 using common::Float;
+using common::Float16;
 using common::Int;
 using common::Type;
 using common::type_of;
@@ -156,6 +158,12 @@ class IrNode : public common::Object {
   //! Verify the current IR node's correctness.
   virtual void Verify() const { CINN_NOT_IMPLEMENTED }
 
+  //! The nodes are allocated from the arena of the current IrArenaScope if there is one, see ir_arena.h.
+  // @{
+  static void* operator new(size_t size);
+  static void operator delete(void* p);
+  // @}
+
  protected:
   static constexpr char* __type_info__ = "IRNode";
   Type type_;
@@ -271,6 +279,13 @@ struct StringImm : public ExprNode<StringImm> {
   static const IrNodeTy _node_type_ = IrNodeTy::StringImm;
 };
 
+//! Create an integer or float immediate. The immediates are shared if the current IrArenaScope hash-conses
+//! constants, so the returned node should never be modified in place.
+// @{
+IrNode* MakeIntImm(Type t, int64_t v);
+IrNode* MakeFloatImm(Type t, float v);
+// @}
+
 class Var;
 /**
  * An expression that represents some value or the result of some operations.
@@ -285,12 +300,12 @@ struct Expr : public IrNodeRef {
   //! Helper function to construct numeric constants of various types.
   // @{
   explicit Expr(bool x) : IrNodeRef(new UIntImm(UInt(1), x)) {}
-  explicit Expr(int32_t x) : IrNodeRef(new IntImm(Int(32), x)) {}
+  explicit Expr(int32_t x) : IrNodeRef(MakeIntImm(Int(32), x)) {}
   explicit Expr(uint32_t x) : IrNodeRef(new UIntImm(UInt(32), x)) {}
-  explicit Expr(int64_t x) : IrNodeRef(new IntImm(Int(64), x)) {}
+  explicit Expr(int64_t x) : IrNodeRef(MakeIntImm(Int(64), x)) {}
   explicit Expr(uint64_t x) : IrNodeRef(new UIntImm(UInt(64), x)) {}
-  explicit Expr(float x) : IrNodeRef(new FloatImm(Float(32), x)) {}
-  explicit Expr(double x) : IrNodeRef(new FloatImm(Float(64), x)) {}
+  explicit Expr(float x) : IrNodeRef(MakeFloatImm(Float(32), x)) {}
+  explicit Expr(double x) : IrNodeRef(MakeFloatImm(Float(64), x)) {}
   explicit Expr(const std::string& x) : IrNodeRef(new StringImm(x)) {}
   // @}
 
@@ -280,6 +280,10 @@ void IRMutator<T>::Visit(const IntrinsicOp *expr, T op) {
       auto *n = llvm::dyn_cast<intrinsics::PodValueToX>(node);
       Visit(&n->pod_value_ptr, &n->pod_value_ptr);
     } break;
+    case ir::IntrinsicKind::kGetAddr: {
+      auto *n = llvm::dyn_cast<intrinsics::GetAddr>(node);
+      Visit(&n->data, &n->data);
+    } break;
     case ir::IntrinsicKind::kBuiltinIntrin: {
       auto *n = llvm::dyn_cast<intrinsics::BuiltinIntrin>(node);
       for (auto &expr : n->args) {
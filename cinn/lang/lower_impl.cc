@@ -156,6 +156,18 @@ Expr LowerGroup(const poly::ScheduleGroup& group,
     mutator(&e);
   }
 
+  // insert prefetch.
+  {
+    std::map<std::string, std::map<int, std::vector<poly::StagePrefetchInfo>>> prefetches;
+    for (auto& node : group.nodes) {
+      if (!node->stage->prefetch_info().empty()) {
+        prefetches[node->stage->id()] = node->stage->prefetch_info();
+      }
+    }
+    MarkPrefetchMutator mutator(prefetches);
+    mutator(&e);
+  }
+
   // mark gpu threads
 #ifdef CINN_WITH_CUDA
   {
@@ -587,6 +599,9 @@ std::vector<ir::LoweredFunc> LowerImpl::operator()() {
       CHECK(tensor);
       VLOG(3) << "In store_exprs, its name is : " << tensor->name;
       CHECK(tensor->buffer.defined());
+      if (stages_->Lookup(tensor->name) && stages_->Lookup(tensor->name)->streaming_store()) {
+        tensor->buffer->streaming_store = true;
+      }
       if (tensor->buffer->memory_type != ir::MemoryType::Heap) {
         new_temp_tensors.push_back(store_node->tensor.as_tensor_ref());
       }
@@ -27,10 +27,14 @@
 
 #include "cinn/common/graph_utils.h"
 #include "cinn/ir/buffer.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/intrinsic_ops.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/optim/buffer_assign.h"
 #include "cinn/optim/compute_inline_expand.h"
 #include "cinn/optim/fold_cinn_call_arguments.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/optim/ir_replace.h"
 #include "cinn/optim/optimize.h"
 #include "cinn/optim/remove_nested_block.h"
 #include "cinn/optim/replace_call_with_expr.h"
@@ -296,6 +300,81 @@ struct MarkParallelMutator : public ir::IRMutator<Expr*> {
   std::vector<ir::PolyFor*> stack;
 };
 
+/**
+ * Insert the prefetches called Prefetch in Stage at the beginning of the PolyFor bodies.
+ */
+struct MarkPrefetchMutator : public ir::IRMutator<Expr*> {
+  std::map<std::string, std::map<int /*level*/, std::vector<poly::StagePrefetchInfo>>> prefetches;
+
+  explicit MarkPrefetchMutator(
+      const std::map<std::string, std::map<int, std::vector<poly::StagePrefetchInfo>>>& prefetches)
+      : prefetches(prefetches) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::PolyFor* op, Expr* expr) override {
+    auto* node = expr->As<ir::PolyFor>();
+    stack.push_back(node);
+    ir::IRMutator<>::Visit(op, expr);
+    stack.pop_back();
+
+    auto it = inserted.find(node);
+    if (it != inserted.end()) {
+      it->second.push_back(node->body);
+      node->body = ir::Block::Make(it->second);
+      inserted.erase(it);
+    }
+  }
+
+  // each statement in ISL is bound to a Store node.
+  void Visit(const ir::Store* op, Expr* expr) override {
+    auto* tensor_n = op->tensor.As<ir::_Tensor_>();
+    CHECK(tensor_n);
+    auto it = prefetches.find(tensor_n->name);
+    if (it == prefetches.end()) return;
+    for (auto& item : it->second) {
+      CHECK_LT(item.first, stack.size());
+      for (auto& info : item.second) {
+        auto loads = ir::CollectIRNodes(op->value, [&](const Expr* x) {
+          auto* load = x->As<ir::Load>();
+          return load && load->tensor.as_tensor() && load->tensor.as_tensor()->name == info.tensor;
+        });
+        if (loads.empty()) {
+          LOG(WARNING) << "Tensor " << tensor_n->name << " reads no " << info.tensor << " to prefetch";
+          continue;
+        }
+        VLOG(3) << "Prefetch " << info.tensor << " in level " << item.first << " of " << tensor_n->name;
+        inserted[stack[item.first]].push_back(MakePrefetch(*loads.begin(), item.first, info.distance));
+      }
+    }
+  }
+
+  //! Prefetch the element \p load reads \p distance iterations later in the forloop \p level.
+  Expr MakePrefetch(const Expr& load, int level, int distance) {
+    Expr ahead = optim::IRCopy(load);
+    for (int i = level + 1; i < stack.size(); i++) {
+      optim::IrReplace(&ahead, stack[i]->iterator, stack[i]->init);
+    }
+    optim::IrReplace(&ahead, stack[level]->iterator, Expr(stack[level]->iterator) + distance);
+    // the address past the end is never computed
+    auto* node   = ahead.As<ir::Load>();
+    auto* tensor = node->tensor.as_tensor();
+    for (int i = 0; i < node->indices.size() && i < tensor->shape.size(); i++) {
+      node->indices[i] = ir::Min::Make(node->indices[i], tensor->shape[i] - 1);
+    }
+    return ir::intrinsics::BuiltinIntrin::Make(
+        "prefetch",
+        {ir::intrinsics::GetAddr::Make(ahead), Expr(0) /*read*/, Expr(3) /*locality*/, Expr(1) /*data cache*/},
+        llvm::Intrinsic::prefetch,
+        4,
+        Void());
+  }
+
+  std::vector<ir::PolyFor*> stack;
+  //! The prefetches to insert at the beginning of the forloops.
+  std::map<ir::PolyFor*, std::vector<Expr>> inserted;
+};
+
 }  // namespace detail
 }  // namespace lang
 }  // namespace cinn
@@ -19,6 +19,8 @@
 #include <set>
 
 #include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/intrinsic_ops.h"
 #include "cinn/lang/buffer.h"
 #include "cinn/lang/compute.h"
 #include "cinn/lang/placeholder.h"
@@ -151,5 +153,34 @@ TEST(lower, temp_buffer_collects) {
   }
 }
 
+TEST(lower, prefetch_and_streaming_store) {
+  Expr M(100);
+  Expr N(200);
+
+  Placeholder<float> A("A", {N, M});
+
+  // a transpose reads A in columns, and never reads B again
+  auto B = Compute(
+      {M, N}, [=](Var i, Var j) -> Expr { return A(j, i); }, "B");
+
+  auto stages = CreateStages({B});
+  stages[B]->Prefetch(A, 1, 8);
+  stages[B]->StreamingStore();
+
+  auto fn = Lower("transpose", stages, {A, B});
+  LOG(INFO) << "func:\n" << fn;
+
+  auto prefetches = ir::CollectIRNodes(fn->body, [](const Expr* x) {
+    auto* intrin = x->As<ir::IntrinsicOp>();
+    return intrin && llvm::dyn_cast<ir::intrinsics::BuiltinIntrin>(intrin) &&
+           llvm::dyn_cast<ir::intrinsics::BuiltinIntrin>(intrin)->id == llvm::Intrinsic::prefetch;
+  });
+  EXPECT_EQ(prefetches.size(), 1UL);
+
+  auto stores = ir::CollectIRNodes(fn->body, [](const Expr* x) { return x->As<ir::Store>(); });
+  ASSERT_EQ(stores.size(), 1UL);
+  EXPECT_TRUE(stores.begin()->As<ir::Store>()->tensor.as_tensor()->buffer->streaming_store);
+}
+
 }  // namespace lang
 }  // namespace cinn
@@ -19,6 +19,20 @@
 namespace cinn {
 namespace lang {
 
+namespace {
+
+// The 16-bit floats have no C++ type to instantiate a Placeholder with, so build the tensor from \p type directly.
+ir::Tensor CreatePlaceHolderOfType(const std::vector<Expr> &shape, Type type, const std::string &name) {
+  auto op = ir::PlaceholderOp::Make(name, shape, type);
+
+  ir::Tensor tensor(name, type, shape, shape, op, {});
+  Buffer buffer(tensor->type());
+  tensor->Bind(buffer);
+  return tensor;
+}
+
+}  // namespace
+
 ir::Tensor CreatePlaceHolder(const std::vector<Expr> &shape, Type type, const std::string &name) {
   if (type == Float(32)) {
     return Placeholder<float>(name, shape);
@@ -26,8 +40,17 @@ ir::Tensor CreatePlaceHolder(const std::vector<Expr> &shape, Type type, const st
     return Placeholder<double>(name, shape);
   } else if (type == Int(32)) {
     return Placeholder<int32_t>(name, shape);
+  } else if (type == Int(8)) {
+    return Placeholder<int8_t>(name, shape);
+  } else if (type == UInt(8)) {
+    return Placeholder<uint8_t>(name, shape);
+  } else if (type.is_bool()) {
+    return Placeholder<bool>(name, shape);
+  } else if (type.is_float16() || type.is_bfloat16()) {
+    return CreatePlaceHolderOfType(shape, type, name);
   }
-  CINN_NOT_IMPLEMENTED
+  LOG(FATAL) << "The placeholder " << name << " of type " << type << " is not implemented yet!";
+  return ir::Tensor();
 }
 
 }  // namespace lang
@@ -138,16 +138,17 @@ struct IRCopyVisitor : public ir::IRVisitorBase<Expr> {
     int offset_factor  = op->offset_factor;
     Target target      = op->target;
 
-    auto new_node            = _Buffer_::Make(name, shape);
-    new_node->strides        = strides;
-    new_node->dtype          = op->dtype;  // copy data element's type.
-    new_node->name           = name;
-    new_node->scope          = scope;
-    new_node->data_alignment = data_alignment;
-    new_node->elem_offset    = elem_offset;
-    new_node->offset_factor  = offset_factor;
-    new_node->target         = target;
-    new_node->memory_type    = op->memory_type;
+    auto new_node             = _Buffer_::Make(name, shape);
+    new_node->strides         = strides;
+    new_node->dtype           = op->dtype;  // copy data element's type.
+    new_node->name            = name;
+    new_node->scope           = scope;
+    new_node->data_alignment  = data_alignment;
+    new_node->elem_offset     = elem_offset;
+    new_node->offset_factor   = offset_factor;
+    new_node->target          = target;
+    new_node->memory_type     = op->memory_type;
+    new_node->streaming_store = op->streaming_store;
     new_node->set_type(op->type());
     op->CopyMeta(new_node.As<ir::_Buffer_>());
 
@@ -19,15 +19,20 @@
 #include <algorithm>
 #include <map>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/common/cas.h"
 #include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/intrinsic_ops.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_replace.h"
 #include "cinn/optim/ir_simplify.h"
+#include "cinn/runtime/cinn_runtime.h"
 #include "cinn/utils/functional.h"
 
 namespace cinn {
@@ -50,6 +55,16 @@ Expr Widen(Expr e, int lanes) {
   return ir::Broadcast::Make(e, lanes);
 }
 
+//! Whether \p e is a multiple of \p k for any value of the variables in it.
+bool IsMultipleOf(const Expr &e, int k) {
+  if (k == 1) return true;
+  if (auto *imm = e.As<IntImm>()) return imm->value % k == 0;
+  if (auto *add = e.As<Add>()) return IsMultipleOf(add->a(), k) && IsMultipleOf(add->b(), k);
+  if (auto *sub = e.As<Sub>()) return IsMultipleOf(sub->a(), k) && IsMultipleOf(sub->b(), k);
+  if (auto *mul = e.As<Mul>()) return IsMultipleOf(mul->a(), k) || IsMultipleOf(mul->b(), k);
+  return false;
+}
+
 //! Substitutes a vector for a scalar var in a Stmt.
 class Vectorizer : public IRMutator<Expr *> {
   //! The name of the variable to be vectorized.
@@ -61,6 +76,9 @@ class Vectorizer : public IRMutator<Expr *> {
 
   bool to_vectorize_{false};
 
+  //! Some expression can not be vectorized correctly, the caller should keep the scalar loop.
+  bool failed_{false};
+
   Expr ramp_;
 
   absl::flat_hash_map<std::string, common::CasInterval> var_intervals_;
@@ -75,6 +93,8 @@ class Vectorizer : public IRMutator<Expr *> {
     ramp_ = Ramp::Make(make_zero(), make_one(), lanes_);
   }
 
+  bool failed() const { return failed_; }
+
   void Visit(Expr *expr) {
     CHECK(!need_scalarize_);
     IRMutator<Expr *>::Visit(expr, expr);
@@ -104,8 +124,8 @@ class Vectorizer : public IRMutator<Expr *> {
   void Visit(const Add *op, Expr *expr) override { MutateAddSubOperator(op, expr); }
   void Visit(const Sub *op, Expr *expr) override { MutateAddSubOperator(op, expr); }
   void Visit(const Mul *op, Expr *expr) override { MutateMulDivOperator(op, expr); }
-  void Visit(const Div *op, Expr *expr) override { MutateMulDivOperator(op, expr); }
-  void Visit(const Mod *op, Expr *expr) override { MutateMulDivOperator(op, expr); }
+  void Visit(const Div *op, Expr *expr) override { MutateDivModOperator(op, expr); }
+  void Visit(const Mod *op, Expr *expr) override { MutateDivModOperator(op, expr); }
   void Visit(const Min *op, Expr *expr) override { BinaryOperatorVec(op, expr); }
   void Visit(const Max *op, Expr *expr) override { BinaryOperatorVec(op, expr); }
   void Visit(const EQ *op, Expr *expr) override { BinaryOperatorVec(op, expr); }
@@ -119,6 +139,16 @@ class Vectorizer : public IRMutator<Expr *> {
 
   void Visit(const Ramp *op, Expr *expr) override {}
 
+  void Visit(const IntrinsicOp *op, Expr *expr) override {
+    // the prefetch of the first lane brings the cache line of a dense vector
+    auto *intrin = llvm::dyn_cast<intrinsics::BuiltinIntrin>(op);
+    if (intrin && intrin->id == llvm::Intrinsic::prefetch) {
+      optim::IrReplace(expr, var, make_zero());
+      return;
+    }
+    IRMutator::Visit(op, expr);
+  }
+
   void Visit(const Select *op, Expr *expr) override {
     auto *node        = expr->As<Select>();
     auto condition0   = node->condition;
@@ -155,6 +185,24 @@ class Vectorizer : public IRMutator<Expr *> {
     for (auto &idx : node->indices) {
       lanes = std::max(idx.type().lanes(), lanes);
     }
+    // all the lanes read the same element, e.g. the bias of broadcast_to or elementwise_add with axis, so load it once
+    std::vector<Expr> scalar_indices;
+    for (auto &idx : node->indices) {
+      if (idx.type().lanes() == 1) {
+        scalar_indices.push_back(idx);
+      } else if (auto *broadcast = idx.As<Broadcast>()) {
+        scalar_indices.push_back(broadcast->value);
+      } else if (idx.As<Ramp>() && common::is_zero(idx.As<Ramp>()->stride)) {
+        scalar_indices.push_back(idx.As<Ramp>()->base);
+      } else {
+        break;
+      }
+    }
+    if (scalar_indices.size() == node->indices.size()) {
+      *expr = Broadcast::Make(Load::Make(node->tensor, scalar_indices), lanes);
+      return;
+    }
+
     std::vector<Expr> new_indices;
     for (auto &idx : node->indices) {
       new_indices.push_back(Widen(idx, lanes));
@@ -327,6 +375,50 @@ class Vectorizer : public IRMutator<Expr *> {
     *expr = T::Make(Widen(node->a(), lanes), Widen(node->b(), lanes));
   }
 
+  //! The lanes of Ramp(base,stride,lanes) / c share a quotient only in some cases, the others fail the vectorization
+  //! for the codegen can not emit a general vector index.
+  template <typename T>
+  void MutateDivModOperator(const T *op, Expr *expr) {
+    auto *node = expr->As<T>();
+    Visit(&node->a());
+    Visit(&node->b());
+
+    int lanes = std::max(node->a().type().lanes(), node->b().type().lanes());
+    if (lanes == 1) return;
+
+    const Ramp *ramp = node->a().template As<Ramp>();
+    const IntImm *c  = node->b().template As<IntImm>();
+    const IntImm *s  = ramp ? ramp->stride.template As<IntImm>() : nullptr;
+    if (!ramp || !c || !s || c->value <= 0 || s->value < 0) {
+      if (node->a().template As<Ramp>() || node->b().template As<Ramp>()) failed_ = true;
+      *expr = T::Make(Widen(node->a(), lanes), Widen(node->b(), lanes));
+      return;
+    }
+
+    constexpr bool is_div = std::is_same<T, Div>::value;
+    if (s->value % c->value == 0) {
+      // (base + i*stride) / c = base / c + i*(stride/c), (base + i*stride) % c = base % c
+      if (is_div) {
+        *expr = Ramp::Make(Div::Make(ramp->base, node->b()), make_const(s->value / c->value), ramp->lanes);
+      } else {
+        *expr = Broadcast::Make(Mod::Make(ramp->base, node->b()), ramp->lanes);
+      }
+      return;
+    }
+    int span = s->value * ramp->lanes;
+    if (c->value % span == 0 && IsMultipleOf(ramp->base, span)) {
+      // all the lanes lie in the same block of c elements
+      if (is_div) {
+        *expr = Broadcast::Make(Div::Make(ramp->base, node->b()), ramp->lanes);
+      } else {
+        *expr = Ramp::Make(Mod::Make(ramp->base, node->b()), ramp->stride, ramp->lanes);
+      }
+      return;
+    }
+    failed_ = true;
+    *expr   = T::Make(Widen(node->a(), lanes), Widen(node->b(), lanes));
+  }
+
   template <typename T>
   void BinaryOperatorVec(const T *op, Expr *expr) {
     auto *node = expr->As<T>();
@@ -341,12 +433,26 @@ class Vectorizer : public IRMutator<Expr *> {
   }
 };
 
+//! The width in bits of the widest vector registers of the cpu \p target compiles for, 0 if unknown or not a cpu.
+int GetVectorBits(const Target &target) {
+  switch (target.arch) {
+    case Target::Arch::X86:
+      // the LLVM backend compiles for the cpu set by the cinn_llvm_target_* flags, which may not be the host
+      return backends::GetVectorBits(backends::OptimizeOptions::FromFlags());
+    case Target::Arch::ARM:
+      return 128;
+    default:
+      return 0;
+  }
+}
+
 struct VectorizeLoops_ : public IRMutator<Expr *> {
   const Target &target;
+  const int vector_bits;
   absl::flat_hash_map<std::string, common::CasInterval> var_intervals;
   bool vectorizable_ = true;
 
-  explicit VectorizeLoops_(const Target &t) : target(t) {}
+  explicit VectorizeLoops_(const Target &t) : target(t), vector_bits(GetVectorBits(t)) {}
 
   void operator()(Expr *expr) { IRMutator::Visit(expr, expr); }
 
@@ -425,7 +531,29 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
         return;
       }
 
-      auto _new_forloop = SplitForLoop(node, forloop->vectorize_info().factor);
+      int factor       = forloop->vectorize_info().factor;
+      auto *extent_imm = for_extent.As<IntImm>();
+      if (extent_imm) {
+        int lanes = VectorLanes(node, factor, extent_imm->value);
+        if (lanes != factor || extent_imm->value % lanes != 0) {
+          Expr vectorized;
+          if (lanes > 1) {
+            int peel   = AlignmentPeel(node, lanes);
+            vectorized = VectorizeWithTail(node, lanes, peel);
+            // the base of the vectors after peeling may break the rules of div/mod
+            if (!vectorized.defined() && peel > 0) vectorized = VectorizeWithTail(node, lanes, 0);
+          }
+          if (vectorized.defined()) {
+            *expr = vectorized;
+          } else {
+            node->reset_vectorize_info();
+          }
+          var_intervals.erase(loopvar_name);
+          return;
+        }
+      }
+
+      auto _new_forloop = SplitForLoop(node, factor);
       if (!_new_forloop.defined()) {
         IRMutator<>::Visit(&node->body, &node->body);
         var_intervals.erase(forloop->loop_var->name);
@@ -453,7 +581,16 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       VLOG(2) << "Vectorizing " << new_forloop->loop_var << " extent " << extent;
       VLOG(2) << "body:\n" << node->body;
 
-      Vectorizer(new_forloop->loop_var, extent, var_intervals).Visit(&new_forloop->body);
+      Vectorizer vectorizer(new_forloop->loop_var, extent, var_intervals);
+      Expr vectorized_body = IRCopy(new_forloop->body);
+      vectorizer.Visit(&vectorized_body);
+      if (vectorizer.failed()) {
+        // keep the split loops scalar
+        new_forloop->reset_vectorize_info();
+        var_intervals.erase(loopvar_name);
+        return;
+      }
+      new_forloop->body = vectorized_body;
 
       VLOG(2) << "after vectorize body:\n" << node->body;
 
@@ -534,6 +671,101 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     return false;
   }
 
+  //! The lanes to vectorize \p forloop of the constant \p extent scheduled with \p factor. An odd factor, e.g. the
+  //! divisor of an odd dimension, is replaced by the lanes of the target's vector registers.
+  int VectorLanes(const For *forloop, int factor, int extent) {
+    int lanes = factor;
+    if (vector_bits > 0) {
+      int element_bits = 0;
+      for (auto &store : ir::CollectIRNodes(forloop->body, [](const Expr *x) { return x->As<Store>(); })) {
+        element_bits = std::max(element_bits, store.As<Store>()->value.type().ElementOf().bits());
+      }
+      int native_lanes = std::max(vector_bits / (element_bits > 0 ? element_bits : 32), 1);
+      if (lanes % native_lanes != 0 && native_lanes % lanes != 0) lanes = native_lanes;
+    }
+    return std::min(lanes, extent);
+  }
+
+  //! The number of scalar iterations to run before the vectors, so that the store of \p forloop is aligned to the
+  //! buffer in the vectors. It is 0 if the alignment is unknown or peeling is not worthwhile.
+  int AlignmentPeel(const For *forloop, int lanes) {
+    if (vector_bits <= 0 || forloop->extent.as_int32() < 4 * lanes) return 0;
+    auto stores = ir::CollectIRNodes(forloop->body, [](const Expr *x) { return x->As<Store>(); });
+    if (stores.size() != 1) return 0;
+    auto *store = stores.begin()->As<Store>();
+    if (!store->tensor.As<_Tensor_>()) return 0;
+    int element_bytes = (store->value.type().ElementOf().bits() + 7) / 8;
+    int align         = CINN_BUFFER_MIN_HOST_ALIGNMENT / element_bytes;
+    if (align <= 1) return 0;
+
+    auto offset_at = [&](int value) {
+      Expr offset = IRCopy(store->index());
+      optim::IrReplace(&offset, forloop->loop_var, make_const(value));
+      Simplify(&offset);
+      return offset;
+    };
+    Expr offset = offset_at(0);
+    Expr stride = offset_at(1) - offset;
+    Simplify(&stride);
+    if (!stride.is_constant() || stride.get_constant() != 1) return 0;
+
+    // offset = rest + c, the peel is known if rest is a multiple of the alignment
+    int c     = 0;
+    Expr rest = offset;
+    if (offset.As<IntImm>()) {
+      c    = offset.as_int32();
+      rest = make_zero();
+    } else if (offset.As<Add>() && offset.As<Add>()->b().As<IntImm>()) {
+      c    = offset.As<Add>()->b().as_int32();
+      rest = offset.As<Add>()->a();
+    }
+    if (!IsMultipleOf(rest, align)) return 0;
+    return ((-c) % align + align) % align;
+  }
+
+  //! Vectorize the iterations of the constant-extent \p forloop from \p peel by \p lanes, the iterations before
+  //! \p peel and the ones left after the last vector run in scalar loops.
+  //! @return The block of the loops, or an undefined Expr if the body can not be vectorized.
+  Expr VectorizeWithTail(const For *forloop, int lanes, int peel) {
+    int extent = forloop->extent.as_int32();
+    int times  = (extent - peel) / lanes;
+    if (times < 1) return Expr();
+
+    Var vi(Context::Global().NewName("vi"));
+    Expr index = Expr(vi);
+    if (times > 1) index = Expr(forloop->loop_var) * lanes + index;
+    if (peel > 0) index = make_const(peel) + index;
+    Expr body = IRCopy(forloop->body);
+    optim::IrReplace(&body, forloop->loop_var, index);
+
+    Vectorizer vectorizer(vi, lanes, var_intervals);
+    vectorizer.Visit(&body);
+    if (vectorizer.failed()) return Expr();
+    VLOG(2) << "Vectorizing " << forloop->loop_var << " with " << lanes << " lanes, peel " << peel << " and tail "
+            << (extent - peel) % lanes;
+
+    std::vector<Expr> stmts;
+    if (peel > 0) stmts.push_back(ScalarFor(forloop, 0, peel, "_prologue"));
+    if (times > 1) {
+      stmts.push_back(
+          For::Make(forloop->loop_var, make_zero(), make_const(times), ForType::Serial, DeviceAPI::UNK, body));
+    } else {
+      stmts.push_back(body);
+    }
+    int end = peel + times * lanes;
+    if (end < extent) stmts.push_back(ScalarFor(forloop, end, extent, "_epilogue"));
+    return Block::Make(stmts);
+  }
+
+  //! A copy of \p forloop over [begin, end) with a new loop var named with \p suffix, the prologue and the epilogue
+  //! of one loop use different suffixes so that their vars are distinct.
+  Expr ScalarFor(const For *forloop, int begin, int end, const std::string &suffix) {
+    Var var(forloop->loop_var->name + suffix);
+    Expr body = IRCopy(forloop->body);
+    optim::IrReplace(&body, forloop->loop_var, Expr(var));
+    return For::Make(var, make_const(begin), make_const(end), ForType::Serial, DeviceAPI::UNK, body);
+  }
+
   //! Split the forloop with size \p factor.
   //! @return The new forloop.
   Expr SplitForLoop(For *forloop, int factor) {
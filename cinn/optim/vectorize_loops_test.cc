@@ -21,6 +21,7 @@
 #include "cinn/cinn.h"
 #include "cinn/common/common.h"
 #include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/optimize.h"
@@ -79,9 +80,12 @@ void matmul(void* _args, int32_t num_args)
   const float* B = ((const float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 100; i += 1) {
-    for (int32_t j = 0; j < 32; j += 1) {
+    for (int32_t j = 0; j < 31; j += 1) {
       C[StackVec<16,int32_t>::Ramp(((500 * i) + (16 * j)), 1, 16)] = (StackedVec<float,16>::Load(A,((500 * i) + (16 * j))) * StackedVec<float,16>::Load(B,((500 * i) + (16 * j))));
     };
+    for (int32_t j_epilogue = 496; j_epilogue < 500; j_epilogue += 1) {
+      C[((500 * i) + j_epilogue)] = (A[((500 * i) + j_epilogue)] * B[((500 * i) + j_epilogue)]);
+    };
   };
   cinn_buffer_free((void*)(0), _C);
 }
@@ -204,6 +208,64 @@ TEST(Vectorize, vectorize) {
   }
 }
 
+TEST(Vectorize, div_mod) {
+  Var a("a");
+  Var b("b");
+
+  {
+    // the 4 lanes of a*4+b are in the same block of 8
+    Expr d = (a * 4 + b) / 8;
+    detail::Vectorize(b, 4, &d);
+    ASSERT_TRUE(d.As<ir::Broadcast>());
+    EXPECT_EQ(d.As<ir::Broadcast>()->lanes, 4);
+  }
+
+  {
+    Expr d = (a * 4 + b) % 8;
+    detail::Vectorize(b, 4, &d);
+    ASSERT_TRUE(d.As<ir::Ramp>());
+    EXPECT_EQ(d.As<ir::Ramp>()->stride.as_int32(), 1);
+  }
+
+  {
+    // the elementwise_add with axis reads the same element of B in all the lanes
+    Placeholder<float> B("B", std::vector<int>{{10}});
+    Expr expr = Load::Make(ir::Tensor(B), {b / 4});
+    detail::Vectorize(b, 4, &expr);
+    ASSERT_TRUE(expr.As<ir::Broadcast>());
+    EXPECT_TRUE(expr.As<ir::Broadcast>()->value.As<ir::Load>());
+  }
+}
+
+TEST(Vectorize, tail) {
+  Expr N(19);
+  Placeholder<float> A("A", {N});
+  Placeholder<float> B("B", {N});
+
+  Tensor C = Compute(
+      {N}, [&](Var i) { return A(i) + B(i); }, "C");
+
+  auto stages = CreateStages({C});
+  stages[C]->Vectorize(0, 8);
+
+  auto func = Lower("add", stages, {A, B, C});
+  optim::TransformPolyForToFor(&func->body);
+  optim::VectorizeLoops(&func->body, Target());
+  optim::Simplify(&func->body);
+  LOG(INFO) << "vectorized:\n" << func->body;
+
+  // 2 vectors of 8 lanes and a scalar loop over the last 3 elements, which are not overrun
+  auto vector_stores = ir::CollectIRNodes(
+      func->body, [](const Expr *x) { return x->As<ir::Store>() && x->As<ir::Store>()->type().lanes() == 8; });
+  EXPECT_EQ(vector_stores.size(), 1UL);
+  auto tail_loops = ir::CollectIRNodes(func->body, [](const Expr *x) {
+    auto *op = x->As<ir::For>();
+    return op && op->min.is_constant() && op->min.get_constant() == 16 && op->extent.is_constant() &&
+           op->extent.get_constant() == 19;
+  });
+  EXPECT_EQ(tail_loops.size(), 1UL);
+}
+
 TEST(Vectorize, single_for) {
   Placeholder<float> A("A", std::vector<int>{{10}});
   Placeholder<float> B("B", std::vector<int>{{10}});
@@ -409,7 +409,8 @@ void IslAstExprToCinnExpr(const isl::ast_expr& node, ir::Expr* expr) {
   switch (isl_ast_expr_get_type(node.get())) {
     case isl_ast_expr_int: {
       isl::val val = isl::manage(isl_ast_expr_get_val(node.get()));
-      *expr        = ir::Expr(static_cast<int>(isl_val_get_num_si(val.get())));
+      // not a shared immediate, the type of the operands is reset below
+      *expr = ir::Expr(new ir::IntImm(Int(32), static_cast<int>(isl_val_get_num_si(val.get()))));
     } break;
     case isl_ast_expr_id: {
       isl::id id = isl::manage(isl_ast_expr_get_id(node.get()));
@@ -1071,6 +1071,27 @@ void Stage::Unroll(const Iterator &level) {
   Unroll(l);
 }
 
+void Stage::Prefetch(const ir::Tensor &tensor, int level, int distance) {
+  CHECK_GE(level, 0);
+  CHECK_LT(level, n_out_dims());
+  CHECK_GT(distance, 0) << "The prefetch distance should be positive";
+  AssertAxisIsNotLocked(level);
+  auto transformed_domain = this->transformed_domain();
+  if (isl_is_removed_axis(transformed_domain.get(), level)) {
+    VLOG(3) << "Prefetching in for-1 has no sense, skip it";
+    return;
+  }
+  int removed_axes_counts = isl_get_precending_removed_axes_counts(transformed_domain.get(), level);
+  prefetch_info_[level - removed_axes_counts].push_back(StagePrefetchInfo{tensor->name, distance});
+}
+
+void Stage::Prefetch(const ir::Tensor &tensor, const Iterator &level, int distance) {
+  auto dim_names = axis_names();
+  auto it        = std::find(dim_names.begin(), dim_names.end(), level.id);
+  CHECK(it != dim_names.end()) << "No dimension called " << level.id;
+  Prefetch(tensor, std::distance(dim_names.begin(), it), distance);
+}
+
 std::vector<std::string> Stage::axis_names() const { return isl_get_dim_names(transformed_domain()); }
 
 std::vector<std::string> Stage::origin_reduce_axis_names() {
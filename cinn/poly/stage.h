@@ -58,6 +58,12 @@ struct StageForloopInfo {
   ir::DeviceAPI device;
 };
 
+//! A prefetch of the elements of \p tensor read `distance` iterations ahead in a forloop level.
+struct StagePrefetchInfo {
+  std::string tensor;
+  int distance{};
+};
+
 //! Store the infomations about some other tensor `compute_at` this tensor.
 struct ComputeAtInfo {
   ComputeAtInfo(const std::string& consumer_tensor_name,
@@ -219,6 +225,20 @@ class Stage : public Object {
 
   void Bind(int level, const std::string& axis);
 
+  /**
+   * Prefetch the elements of \p tensor this stage reads \p distance iterations ahead in the forloop \p level. The
+   * prefetch is inserted at the beginning of the forloop body, taking the inner forloops at their first iterations.
+   * It is a hint for the CPU backends and never faults.
+   */
+  void Prefetch(const ir::Tensor& tensor, int level, int distance);
+  void Prefetch(const ir::Tensor& tensor, const Iterator& level, int distance);
+
+  /**
+   * Write this stage's tensor with non-temporal stores which bypass the caches, for the large outputs not read again
+   * soon, e.g. the transposes, layout transforms and concats.
+   */
+  void StreamingStore() { streaming_store_ = true; }
+
   enum ComputeAtKind {
     kComputeAtAuto,
     kComputeAtBefore,
@@ -371,6 +391,8 @@ class Stage : public Object {
   inline const ir::VectorizeInfo& vectorize_info() const { return vectorize_info_; }
   inline const std::set<int>& unroll_info() const { return unroll_info_; }
   inline const std::set<int>& parallel_info() const { return parallel_info_; }
+  inline const std::map<int, std::vector<StagePrefetchInfo>>& prefetch_info() const { return prefetch_info_; }
+  inline bool streaming_store() const { return streaming_store_; }
   inline std::map<std::string, ComputeAtRelation>& GetComputeAts() { return compute_ats_; }
   inline void SetComputeAts(const std::map<std::string, ComputeAtRelation>& compute_ats) { compute_ats_ = compute_ats; }
 
@@ -442,6 +464,10 @@ class Stage : public Object {
   std::set<int> unroll_info_;
   //! The for-loop levels to parallel.
   std::set<int> parallel_info_;
+  //! The prefetches in each for-loop level.
+  std::map<int, std::vector<StagePrefetchInfo>> prefetch_info_;
+  //! Whether to store the tensor with non-temporal stores.
+  bool streaming_store_{false};
   //! Record some forloop levels' information.
   std::map<int /*level*/, StageForloopInfo> forloop_infos_;
   //! A weak reference to the tensor.
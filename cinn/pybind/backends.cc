@@ -29,16 +29,27 @@ namespace cinn::pybind {
 using backends::Compiler;
 using backends::ExecutionEngine;
 using backends::ExecutionOptions;
+using backends::OptimizeOptions;
 
 namespace {
 
 void BindExecutionEngine(py::module *);
 
 void BindExecutionEngine(py::module *m) {
+  py::class_<OptimizeOptions> optimize_options(*m, "OptimizeOptions");
+  optimize_options.def(py::init(&OptimizeOptions::FromFlags))
+      .def_readwrite("fast_math", &OptimizeOptions::fast_math)
+      .def_readwrite("target_cpu", &OptimizeOptions::target_cpu)
+      .def_readwrite("target_features", &OptimizeOptions::target_features)
+      .def_readwrite("vectorize_width", &OptimizeOptions::vectorize_width)
+      .def_readwrite("interleave_count", &OptimizeOptions::interleave_count)
+      .def_readwrite("time_passes", &OptimizeOptions::time_passes);
+
   py::class_<ExecutionOptions> options(*m, "ExecutionOptions");
   options.def(py::init<>())
       .def_readwrite("opt_level", &ExecutionOptions::opt_level)
-      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info);
+      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info)
+      .def_readwrite("optimize_options", &ExecutionOptions::optimize_options);
 
   auto lookup = [](ExecutionEngine &self, absl::string_view name) {
     auto *function_ptr    = reinterpret_cast<void (*)(void **, int32_t)>(self.Lookup(name));
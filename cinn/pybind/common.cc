@@ -99,6 +99,8 @@ void BindType(py::module *m) {
   DEFINE_TYPE_METHOD(is_vector);
   DEFINE_TYPE_METHOD(is_scalar);
   DEFINE_TYPE_METHOD(is_float);
+  DEFINE_TYPE_METHOD(is_float16);
+  DEFINE_TYPE_METHOD(is_bfloat16);
   DEFINE_TYPE_METHOD(is_int);
   DEFINE_TYPE_METHOD(is_uint);
   DEFINE_TYPE_METHOD(is_string);
@@ -142,6 +144,8 @@ void BindType(py::module *m) {
       .def("Int", &common::Int, py::arg("bits"), py::arg("lanes") = 1)
       .def("UInt", &common::UInt, py::arg("bits"), py::arg("lanes") = 1)
       .def("Float", &common::Float, py::arg("bits"), py::arg("lanes") = 1)
+      .def("Float16", &common::Float16, py::arg("lanes") = 1)
+      .def("BFloat16", &common::BFloat16, py::arg("lanes") = 1)
       .def("Bool", &common::Bool, py::arg("lanes") = 1)
       .def("String", &common::String);
 
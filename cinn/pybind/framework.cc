@@ -25,6 +25,7 @@
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/pybind/bind.h"
+#include "cinn/pybind/tensor_interop.h"
 
 namespace cinn::pybind {
 
@@ -95,26 +96,7 @@ void BindFramework(pybind11::module *m) {
       .def(py::init<>())  //
       .def("get_tensor",
            [](Scope &self, const std::string &name, const Target &target) {
-             py::dtype dt = py::dtype::of<float>();
-             auto t       = self.GetTensor(name);
-             py::array::ShapeContainer shape(t->shape().data().begin(), t->shape().data().end());
-             py::array array(std::move(dt), std::move(shape));
-             auto *mutable_data = array.mutable_data();
-             if (target.arch == Target::Arch::X86) {
-               std::memcpy(mutable_data, t->data<float>(), t->shape().numel() * sizeof(float));
-             } else if (target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-               CUDA_CALL(cudaMemcpy(mutable_data,
-                                    reinterpret_cast<void *>(t->mutable_data<float>(target)),
-                                    t->shape().numel() * sizeof(float),
-                                    cudaMemcpyDeviceToHost));
-#else
-               LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
-#endif
-             } else {
-               CINN_NOT_IMPLEMENTED
-             }
-             return array;
+             return ToNumpy(self.GetTensor(name), target);
            })
       .def("var_names", &Scope::var_names);
 
@@ -123,53 +105,11 @@ void BindFramework(pybind11::module *m) {
       .def(py::init<>())
       .def("shape", [](hlir::framework::Tensor &self) { return self->shape().data(); })
       .def("set_type", [](hlir::framework::Tensor &self, Type type) { self->set_type(type); })
-      .def("numpy",
-           [](hlir::framework::Tensor &self, const common::Target &target) {
-             py::dtype dt;
-             // set float by default
-             dt = py::dtype::of<float>();
-             py::array::ShapeContainer shape(self->shape().data().begin(), self->shape().data().end());
-             py::array array(std::move(dt), std::move(shape));
-             void *array_data = array.mutable_data();
-             if (target.arch == Target::Arch::X86) {
-               std::memcpy(array_data, self->data<float>(), self->shape().numel() * sizeof(float));
-             } else if (target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-               CUDA_CALL(cudaMemcpy(array_data,
-                                    reinterpret_cast<void *>(self->mutable_data<float>(target)),
-                                    self->shape().numel() * sizeof(float),
-                                    cudaMemcpyDeviceToHost));
-#else
-               LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
-#endif
-             } else {
-               CINN_NOT_IMPLEMENTED
-             }
-             return array;
-           })
-      .def("from_numpy", [](hlir::framework::Tensor &self, py::array array, const common::Target &target) {
-        CHECK(array.dtype().is(py::dtype::of<float>())) << "currently only support float32 data type as input";
-        hlir::framework::shape_t shape;
-        std::copy_n(array.shape(), array.ndim(), std::back_inserter(shape));
-        CHECK_EQ(std::accumulate(shape.begin(), shape.end(), 1, [](int32_t a, int32_t b) { return a * b; }),
-                 self->shape().numel());
-        auto *data = self->mutable_data<float>(target);
-        if (target.arch == Target::Arch::X86) {
-          for (int i = 0; i < self->shape().numel(); i++) {
-            data[i] = reinterpret_cast<const float *>(array.data())[i];
-          }
-        } else if (target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-          CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
-                               reinterpret_cast<const float *>(array.data()),
-                               self->shape().numel() * sizeof(float),
-                               cudaMemcpyHostToDevice));
-#else
-               LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
-#endif
-        } else {
-          CINN_NOT_IMPLEMENTED
-        }
-      });
+      .def("numpy", &ToNumpy, py::arg("target"))
+      // share=True binds the memory of the array directly when it is compact and aligned
+      .def("from_numpy", &FromNumpy, py::arg("array"), py::arg("target"), py::arg("share") = false)
+      .def("__dlpack__", [](Tensor &self, py::object stream) { return ToDLPack(self); }, py::arg("stream") = py::none())
+      .def("__dlpack_device__", &DLPackDevice)
+      .def("from_dlpack", &FromDLPack, py::arg("obj"), py::arg("target"));
 }
 }  // namespace cinn::pybind
@@ -33,6 +33,7 @@
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/pybind/bind.h"
+#include "cinn/pybind/tensor_interop.h"
 #include "cinn/utils/string.h"
 #include "cinn/utils/timer.h"
 
@@ -139,27 +140,8 @@ void BindFrontend(pybind11::module *m) {
              hlir::framework::GraphCompiler gc(target, scope, g);
              auto program = gc.Build();
              for (size_t i = 0; i < tensor_inputs.size(); i++) {
-               auto in_tensor = scope->GetTensor(tensor_inputs[i]->id);
-               auto *data     = in_tensor->mutable_data<float>(target);
-               CHECK_EQ(input_data[i].size(), in_tensor->shape().numel())
-                   << "The size of tensor [" << tensor_inputs[i]->id
-                   << "] is different with the input data's size! Please check.";
-               if (target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-                 CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
-                                      input_data[i].data(),
-                                      in_tensor->shape().numel() * sizeof(float),
-                                      cudaMemcpyHostToDevice));
-#else
-                 LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
-#endif
-               } else if (target.arch == Target::Arch::X86) {
-                 for (size_t j = 0; j < in_tensor->shape().numel(); j++) {
-                   data[j] = reinterpret_cast<const float *>(input_data[i].data())[j];  // All random data
-                 }
-               } else {
-                 CINN_NOT_IMPLEMENTED
-               }
+               // the inputs are only used by the runs below, so bind their memory instead of copying it
+               FromNumpy(scope->GetTensor(tensor_inputs[i]->id), input_data[i], target, true);
              }
              program->Execute();
 
@@ -204,27 +186,8 @@ void BindFrontend(pybind11::module *m) {
              hlir::framework::GraphCompiler gc(target, scope, g);
              auto program = gc.Build();
              for (size_t i = 0; i < tensor_inputs.size(); i++) {
-               auto in_tensor = scope->GetTensor(tensor_inputs[i]->id);
-               auto *data     = in_tensor->mutable_data<float>(target);
-               CHECK_EQ(input_data[i].size(), in_tensor->shape().numel())
-                   << "The size of tensor [" << tensor_inputs[i]->id
-                   << "] is different with the input data's size! Please check.";
-               if (target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-                 CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
-                                      input_data[i].data(),
-                                      in_tensor->shape().numel() * sizeof(float),
-                                      cudaMemcpyHostToDevice));
-#else
-                 LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
-#endif
-               } else if (target.arch == Target::Arch::X86) {
-                 for (size_t j = 0; j < in_tensor->shape().numel(); j++) {
-                   data[j] = reinterpret_cast<const float *>(input_data[i].data())[j];  // All random data
-                 }
-               } else {
-                 CINN_NOT_IMPLEMENTED
-               }
+               // the inputs are only used by the runs below, so bind their memory instead of copying it
+               FromNumpy(scope->GetTensor(tensor_inputs[i]->id), input_data[i], target, true);
              }
              VLOG(3) << info;
              program->ExecuteTest(repeat_);
@@ -246,27 +209,8 @@ void BindFrontend(pybind11::module *m) {
              hlir::framework::GraphCompiler gc(target, scope, g);
              auto program = gc.Build(code);
              for (size_t i = 0; i < tensor_inputs.size(); i++) {
-               auto in_tensor = scope->GetTensor(tensor_inputs[i]->id);
-               auto *data     = in_tensor->mutable_data<float>(target);
-               CHECK_EQ(input_data[i].size(), in_tensor->shape().numel())
-                   << "The size of tensor [" << tensor_inputs[i]->id
-                   << "] is different with the input data's size! Please check.";
-               if (target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-                 CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
-                                      input_data[i].data(),
-                                      in_tensor->shape().numel() * sizeof(float),
-                                      cudaMemcpyHostToDevice));
-#else
-                 LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
-#endif
-               } else if (target.arch == Target::Arch::X86) {
-                 for (size_t j = 0; j < in_tensor->shape().numel(); j++) {
-                   data[j] = reinterpret_cast<const float *>(input_data[i].data())[j];  // All random data
-                 }
-               } else {
-                 CINN_NOT_IMPLEMENTED
-               }
+               // the inputs are only used by the runs below, so bind their memory instead of copying it
+               FromNumpy(scope->GetTensor(tensor_inputs[i]->id), input_data[i], target, true);
              }
              VLOG(3) << info;
              program->ExecuteTest(repeat_);
@@ -298,8 +242,14 @@ void BindFrontend(pybind11::module *m) {
            py::arg("model_name") = "")
       .def("run", &frontend::Interpreter::Run)
       .def("get_tensor", &frontend::Interpreter::GetTensor)
+      .def("create_execution_context", &frontend::Interpreter::CreateExecutionContext)
       .def("scope", &frontend::Interpreter::scope);
 
+  py::class_<frontend::Interpreter::ExecutionContext>(*m, "ExecutionContext")
+      // release the GIL so that the contexts can run on many threads at the same time
+      .def("run", &frontend::Interpreter::ExecutionContext::Run, py::call_guard<py::gil_scoped_release>())
+      .def("get_tensor", &frontend::Interpreter::ExecutionContext::GetTensor);
+
   py::enum_<ComparisonKind>(*m, "ComparisonKind")
       .value("kUnk", ComparisonKind::kUnk)
       .value("kEq", ComparisonKind::kEq)
@@ -458,6 +408,13 @@ void BindFrontend(pybind11::module *m) {
            py::arg("bias")             = 0.0f,
            py::arg("bias_after_scale") = true)
       .def("softmax", &NetBuilder::Softmax, py::arg("a"), py::arg("axis") = -1, py::arg("data_format") = "AnyLayout")
+      .def("layer_norm",
+           &NetBuilder::LayerNorm,
+           py::arg("a"),
+           py::arg("scale"),
+           py::arg("bias"),
+           py::arg("epsilon")         = 1e-5f,
+           py::arg("begin_norm_axis") = 1)
       .def("dropout_infer",
            &NetBuilder::DropoutInfer,
            py::arg("a"),
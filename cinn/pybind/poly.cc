@@ -103,6 +103,9 @@ void BindStage(py::module *m) {
       .def("parallel", py::overload_cast<int>(&Stage::Parallel))
       .def("parallel", py::overload_cast<const std::string &>(&Stage::Parallel))
       .def("parallel", py::overload_cast<const Iterator &>(&Stage::Parallel))
+      .def("prefetch", py::overload_cast<const ir::Tensor &, int, int>(&Stage::Prefetch))
+      .def("prefetch", py::overload_cast<const ir::Tensor &, const Iterator &, int>(&Stage::Prefetch))
+      .def("streaming_store", &Stage::StreamingStore)
       .def("compute_at", &Stage::ComputeAtSchedule, arg("other"), arg("level"), arg("kind") = Stage::kComputeAtAuto)
       .def("skew", &Stage::Skew)
       .def("ctrl_depend", &Stage::CtrlDepend)
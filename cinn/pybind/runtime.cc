@@ -40,6 +40,8 @@ cinn_type_t NumpyTypeToCinn(py::dtype dt) {
     return cinn_uint32_t();
   } else if (dt.is(py::dtype::of<uint64_t>())) {
     return cinn_uint64_t();
+  } else if (dt.is(py::dtype("float16"))) {
+    return cinn_float16_t();
   } else if (dt.is(py::dtype::of<float>())) {
     return cinn_float32_t();
   } else if (dt.is(py::dtype::of<double>())) {
@@ -74,6 +76,8 @@ py::array BufferHostMemoryToNumpy(cinn_buffer_t &buffer) {  // NOLINT
     dt = py::dtype::of<uint32_t>();
   } else if (buffer.type == cinn_uint64_t()) {
     dt = py::dtype::of<uint64_t>();
+  } else if (buffer.type == cinn_float16_t()) {
+    dt = py::dtype("float16");
   } else if (buffer.type == cinn_float32_t()) {
     dt = py::dtype::of<float>();
   } else if (buffer.type == cinn_float64_t()) {
@@ -128,6 +132,7 @@ void BindCinnRuntime(py::module *m) {
       .value("cinn_type_uint", cinn_type_uint)
       .value("cinn_type_float", cinn_type_float)
       .value("cinn_type_handle", cinn_type_handle)
+      .value("cinn_type_bfloat", cinn_type_bfloat)
       .export_values();
 
   py::class_<cinn_type_t> cinn_type(*m, "cinn_type_t");
@@ -147,6 +152,8 @@ void BindCinnRuntime(py::module *m) {
       .def("cinn_int64_t", &cinn_int64_t)
       .def("cinn_uint32_t", &cinn_uint32_t)
       .def("cinn_uint64_t", &cinn_uint64_t)
+      .def("cinn_float16_t", &cinn_float16_t)
+      .def("cinn_bfloat16_t", &cinn_bfloat16_t)
       .def("cinn_float32_t", &cinn_float32_t)
       .def("cinn_float64_t", &cinn_float64_t);
 
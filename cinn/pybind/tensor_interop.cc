@@ -0,0 +1,272 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/pybind/tensor_interop.h"
+
+#include <dlpack/dlpack.h>
+#include <glog/logging.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/backends/cuda_util.h"
+
+namespace cinn::pybind {
+
+using common::Target;
+using hlir::framework::Buffer;
+using hlir::framework::Shape;
+using hlir::framework::Tensor;
+
+namespace {
+
+constexpr char kDLTensorName[]     = "dltensor";
+constexpr char kUsedDLTensorName[] = "used_dltensor";
+
+// The type of the tensor which is not set yet is float32, as the tensors in the scope have no type before they are
+// allocated.
+Type ElementType(Tensor tensor) { return tensor->type().is_unk() ? Float(32) : tensor->type(); }
+
+int ElementBytes(const Type& type) { return (type.bits() + 7) / 8 * type.lanes(); }
+
+Type TypeOfNumpy(const py::dtype& dtype) {
+  int bits = dtype.itemsize() * 8;
+  switch (dtype.kind()) {
+    case 'f':
+      return Float(bits);
+    case 'i':
+      return Int(bits);
+    case 'u':
+      return UInt(bits);
+    case 'b':
+      return Bool();
+    default:
+      LOG(FATAL) << "Not supported numpy dtype kind: " << dtype.kind();
+  }
+  return Type();
+}
+
+py::dtype NumpyOfType(const Type& type) {
+  if (type.is_bool()) return py::dtype("bool");
+  if (type.is_float()) return py::dtype("float" + std::to_string(type.bits()));
+  if (type.is_int()) return py::dtype("int" + std::to_string(type.bits()));
+  if (type.is_uint()) return py::dtype("uint" + std::to_string(type.bits()));
+  LOG(FATAL) << "Not supported type to numpy: " << type;
+  return py::dtype();
+}
+
+DLDataType DLDataTypeOf(const Type& type) {
+  DLDataType dtype;
+  if (type.is_float()) {
+    dtype.code = kDLFloat;
+  } else if (type.is_int()) {
+    dtype.code = kDLInt;
+  } else if (type.is_uint() || type.is_bool()) {
+    dtype.code = kDLUInt;
+  } else {
+    LOG(FATAL) << "Not supported type to DLPack: " << type;
+  }
+  dtype.bits  = type.is_bool() ? 8 : type.bits();
+  dtype.lanes = type.lanes();
+  return dtype;
+}
+
+Type TypeOfDLDataType(const DLDataType& dtype) {
+  CHECK_EQ(dtype.lanes, 1) << "Not supported DLPack tensor of vector type";
+  switch (dtype.code) {
+    case kDLFloat:
+      return Float(dtype.bits);
+    case kDLInt:
+      return Int(dtype.bits);
+    case kDLUInt:
+      return UInt(dtype.bits);
+    default:
+      LOG(FATAL) << "Not supported DLPack type code: " << static_cast<int>(dtype.code);
+  }
+  return Type();
+}
+
+// Set the shape of `tensor` if it is empty, otherwise check the number of elements is not changed.
+void ResizeOrCheck(Tensor tensor, const std::vector<int>& shape) {
+  if (tensor->shape().size() == 0) {
+    tensor->Resize(Shape(shape));
+    return;
+  }
+  uint32_t numel = 1;
+  for (int dim : shape) numel *= dim;
+  CHECK_EQ(numel, tensor->shape().numel()) << "The number of elements of the data [" << utils::Join(shape, ",")
+                                           << "] is different with the tensor's ["
+                                           << utils::Join(tensor->shape().data(), ",") << "]";
+}
+
+void CopyData(void* dst, bool dst_on_gpu, const void* src, bool src_on_gpu, size_t bytes) {
+  if (!dst_on_gpu && !src_on_gpu) {
+    std::memcpy(dst, src, bytes);
+    return;
+  }
+#ifdef CINN_WITH_CUDA
+  auto kind = dst_on_gpu ? (src_on_gpu ? cudaMemcpyDeviceToDevice : cudaMemcpyHostToDevice) : cudaMemcpyDeviceToHost;
+  CUDA_CALL(cudaMemcpy(dst, src, bytes, kind));
+#else
+  LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+#endif
+}
+
+bool IsAligned(const void* data) { return reinterpret_cast<uintptr_t>(data) % Buffer::kMinHostAlignment == 0; }
+
+// Bind `data` to `tensor` if `can_bind`, otherwise copy it to the memory owned by `tensor`.
+void SetData(Tensor tensor,
+             const Type& type,
+             void* data,
+             bool on_gpu,
+             bool can_bind,
+             std::shared_ptr<void> owner,
+             const Target& target) {
+  CHECK(tensor->type().is_unk() || tensor->type() == type)
+      << "The type of the data " << type << " is different with the tensor's " << tensor->type();
+  CHECK(target.arch == Target::Arch::X86 || target.arch == Target::Arch::NVGPU) << "Not supported target: " << target;
+  size_t bytes = tensor->shape().numel() * ElementBytes(type);
+  if (can_bind) {
+    tensor->set_type(type);
+    tensor->get_buffer()->BindExternal(data, bytes, target, std::move(owner));
+    return;
+  }
+  // never write the copy to the memory bound before
+  if (tensor->get_buffer()->is_external()) tensor->get_buffer()->Free();
+  void* dst = tensor->mutable_data(target, type);
+  CopyData(dst, target.arch == Target::Arch::NVGPU, data, on_gpu, bytes);
+}
+
+struct DLPackContext {
+  Tensor tensor;
+  std::vector<int64_t> shape;
+  DLManagedTensor managed;
+};
+
+void DeleteDLPackContext(DLManagedTensor* self) { delete static_cast<DLPackContext*>(self->manager_ctx); }
+
+// Only the capsule which is not consumed owns the DLManagedTensor.
+void DeleteDLPackCapsule(PyObject* capsule) {
+  if (!PyCapsule_IsValid(capsule, kDLTensorName)) return;
+  auto* managed = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule, kDLTensorName));
+  if (managed->deleter) managed->deleter(managed);
+}
+
+}  // namespace
+
+py::capsule ToDLPack(Tensor tensor) {
+  CHECK(tensor->buffer()->memory) << "The tensor has no memory to be exported";
+  auto* ctx   = new DLPackContext;
+  ctx->tensor = tensor;
+  ctx->shape.assign(tensor->shape().data().begin(), tensor->shape().data().end());
+
+  DLTensor& dl_tensor          = ctx->managed.dl_tensor;
+  dl_tensor.data               = tensor->buffer()->memory;
+  dl_tensor.device.device_type = tensor->get_buffer()->target().arch == Target::Arch::NVGPU ? kDLCUDA : kDLCPU;
+  dl_tensor.device.device_id   = 0;
+  dl_tensor.ndim               = ctx->shape.size();
+  dl_tensor.dtype              = DLDataTypeOf(ElementType(tensor));
+  dl_tensor.shape              = ctx->shape.data();
+  dl_tensor.strides            = nullptr;
+  dl_tensor.byte_offset        = 0;
+  ctx->managed.manager_ctx     = ctx;
+  ctx->managed.deleter         = DeleteDLPackContext;
+
+  PyObject* capsule = PyCapsule_New(&ctx->managed, kDLTensorName, DeleteDLPackCapsule);
+  if (!capsule) {
+    delete ctx;
+    throw py::error_already_set();
+  }
+  return py::reinterpret_steal<py::capsule>(capsule);
+}
+
+py::tuple DLPackDevice(Tensor tensor) {
+  bool on_gpu = tensor->get_buffer()->target().arch == Target::Arch::NVGPU;
+  return py::make_tuple(static_cast<int>(on_gpu ? kDLCUDA : kDLCPU), 0);
+}
+
+void FromDLPack(Tensor tensor, py::object obj, const Target& target) {
+  py::object capsule = py::hasattr(obj, "__dlpack__") ? obj.attr("__dlpack__")() : obj;
+  CHECK(PyCapsule_IsValid(capsule.ptr(), kDLTensorName))
+      << "Expect a dltensor capsule or an object with __dlpack__, note that a capsule can be consumed only once";
+  auto* managed = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule.ptr(), kDLTensorName));
+  PyCapsule_SetName(capsule.ptr(), kUsedDLTensorName);
+  // the producer may release Python objects in the deleter
+  std::shared_ptr<void> owner(managed, [](void* p) {
+    auto* self = static_cast<DLManagedTensor*>(p);
+    if (!self->deleter) return;
+    py::gil_scoped_acquire gil;
+    self->deleter(self);
+  });
+
+  const DLTensor& dl_tensor = managed->dl_tensor;
+  CHECK(dl_tensor.device.device_type == kDLCPU || dl_tensor.device.device_type == kDLCUDA)
+      << "Not supported DLPack device type: " << dl_tensor.device.device_type;
+  std::vector<int> shape(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  if (dl_tensor.strides) {
+    int64_t stride = 1;
+    for (int i = dl_tensor.ndim - 1; i >= 0; i--) {
+      CHECK(shape[i] == 1 || dl_tensor.strides[i] == stride) << "Only compact DLPack tensors are supported";
+      stride *= shape[i];
+    }
+  }
+  ResizeOrCheck(tensor, shape);
+
+  void* data  = static_cast<char*>(dl_tensor.data) + dl_tensor.byte_offset;
+  bool on_gpu = dl_tensor.device.device_type == kDLCUDA;
+  // the device of the data should be the one the instructions run on
+  bool can_bind = on_gpu == (target.arch == Target::Arch::NVGPU) && dl_tensor.device.device_id == 0 && IsAligned(data);
+  SetData(tensor, TypeOfDLDataType(dl_tensor.dtype), data, on_gpu, can_bind, std::move(owner), target);
+}
+
+void FromNumpy(Tensor tensor, py::array array, const Target& target, bool share) {
+  // convert the array to the tensor's type and layout first, binding the temporary array saves a second copy
+  if (!tensor->type().is_unk() && TypeOfNumpy(array.dtype()) != tensor->type()) {
+    array = py::array::ensure(array.attr("astype")(NumpyOfType(tensor->type())));
+    share = true;
+  }
+  if (!(array.flags() & py::array::c_style)) {
+    array = py::array::ensure(py::module::import("numpy").attr("ascontiguousarray")(array));
+    share = true;
+  }
+  ResizeOrCheck(tensor, std::vector<int>(array.shape(), array.shape() + array.ndim()));
+
+  void* data    = const_cast<void*>(array.data());
+  bool can_bind = share && target.arch == Target::Arch::X86 && IsAligned(data);
+  std::shared_ptr<void> owner;
+  if (can_bind) {
+    owner.reset(new py::object(array), [](void* p) {
+      py::gil_scoped_acquire gil;
+      delete static_cast<py::object*>(p);
+    });
+  }
+  SetData(tensor, TypeOfNumpy(array.dtype()), data, false, can_bind, std::move(owner), target);
+}
+
+py::array ToNumpy(Tensor tensor, const Target& target) {
+  Type type = ElementType(tensor);
+  py::array::ShapeContainer shape(tensor->shape().data().begin(), tensor->shape().data().end());
+  py::array array(NumpyOfType(type), std::move(shape));
+  CopyData(array.mutable_data(),
+           false,
+           tensor->buffer()->memory,
+           target.arch == Target::Arch::NVGPU,
+           tensor->shape().numel() * ElementBytes(type));
+  return array;
+}
+
+}  // namespace cinn::pybind
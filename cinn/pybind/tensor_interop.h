@@ -0,0 +1,56 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/tensor.h"
+
+/**
+ * The helpers to exchange the data of hlir::framework::Tensor with numpy and the DLPack protocol.
+ *
+ * When the memory of a numpy array or a DLPack tensor is in the target, compact and aligned to
+ * Buffer::kMinHostAlignment, it is bound to the tensor's buffer directly, so feeding an input costs nothing. Otherwise
+ * the data is copied into the memory owned by the tensor.
+ */
+namespace cinn::pybind {
+
+namespace py = pybind11;
+
+//! Export \p tensor as a "dltensor" capsule, which shares the memory of \p tensor and keeps it alive.
+py::capsule ToDLPack(hlir::framework::Tensor tensor);
+
+//! The (device_type, device_id) of \p tensor in DLPack.
+py::tuple DLPackDevice(hlir::framework::Tensor tensor);
+
+/**
+ * Set the data of \p tensor in \p target from \p obj, which is a "dltensor" capsule or an object with a `__dlpack__`
+ * method, e.g. a numpy array or a torch tensor. The shape of \p tensor is set to the one of \p obj if it is empty,
+ * otherwise they should have the same number of elements.
+ */
+void FromDLPack(hlir::framework::Tensor tensor, py::object obj, const common::Target& target);
+
+/**
+ * Set the data of \p tensor in \p target from \p array. If \p share is true, the memory of \p array is bound when
+ * possible, and the later changes to \p array are seen by \p tensor. The shape is handled the same as FromDLPack.
+ */
+void FromNumpy(hlir::framework::Tensor tensor, py::array array, const common::Target& target, bool share);
+
+//! Copy the data of \p tensor in \p target to a new numpy array.
+py::array ToNumpy(hlir::framework::Tensor tensor, const common::Target& target);
+
+}  // namespace cinn::pybind
@@ -45,7 +45,8 @@ typedef enum cinn_type_code_t {
   cinn_type_int    = 0,   //! signed int
   cinn_type_uint   = 1,   //! unsigned int
   cinn_type_float  = 2,   //! floating point
-  cinn_type_handle = 3    //! void*
+  cinn_type_handle = 3,   //! void*
+  cinn_type_bfloat = 4    //! brain floating point, the upper 16 bits of a float32
 } cinn_type_code_t;
 
 #ifndef CINN_ATTRIBUTE_ALIGN
@@ -92,6 +93,8 @@ extern cinn_type_t cinn_int32_t(int num_asterisks = 0);
 extern cinn_type_t cinn_int64_t(int num_asterisks = 0);
 extern cinn_type_t cinn_uint32_t(int num_asterisks = 0);
 extern cinn_type_t cinn_uint64_t(int num_asterisks = 0);
+extern cinn_type_t cinn_float16_t(int num_asterisks = 0);
+extern cinn_type_t cinn_bfloat16_t(int num_asterisks = 0);
 extern cinn_type_t cinn_float32_t(int num_asterisks = 0);
 extern cinn_type_t cinn_float64_t(int num_asterisks = 0);
 // @}
@@ -164,6 +167,10 @@ extern void* cinn_buffer_get_data_const_handle(const struct cinn_buffer_t* buf);
 //! Create a new default cinn_buffer.
 extern cinn_buffer_t* cinn_buffer_new_default(int target, uint64_t memory_size, int align = 32);
 
+//! The alignment the generated host code assumes for the memory of a buffer. The host runtime allocates the memory
+//! with malloc or aligned_alloc, which is aligned to at least 16 bytes on all the supported platforms.
+#define CINN_BUFFER_MIN_HOST_ALIGNMENT 16
+
 //! The raw representation of a buffer,used in the generated code/lib.
 #define CINN_BUFFER_MAX_DIMS 8
 typedef struct cinn_buffer_t {
@@ -16,9 +16,11 @@
 
 #include <glog/logging.h>
 #include <math.h>
+#include <string.h>
 
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/function_prototype.h"
+#include "cinn/backends/llvm/runtime_symbol_registry.h"
 
 #ifdef CINN_WITH_MKL_CBLAS
 #include "cinn/runtime/cpu/mkl_math.h"
@@ -35,6 +37,65 @@ void __cinn_host_tanh_v(const cinn_buffer_t* x, cinn_buffer_t* out) {
     out_data[i] = tanhf(x_data[i]);
   }
 }
+
+float cinn_host_float16_to_float32(uint16_t x) {
+  uint32_t sign     = (x & 0x8000u) << 16;
+  uint32_t exponent = (x >> 10) & 0x1fu;
+  uint32_t mantissa = x & 0x3ffu;
+  uint32_t bits;
+  if (exponent == 0x1fu) {
+    // inf or nan
+    bits = sign | 0x7f800000u | (mantissa << 13);
+  } else if (exponent != 0) {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    bits = sign;
+  } else {
+    // subnormal float16 is a normal float32, shift the mantissa until the hidden bit shows up
+    exponent = 113;
+    while (!(mantissa & 0x400u)) {
+      mantissa <<= 1;
+      exponent--;
+    }
+    bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+  }
+  float res;
+  memcpy(&res, &bits, sizeof(res));
+  return res;
+}
+
+uint16_t cinn_host_float32_to_float16(float x) {
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  uint16_t sign     = (bits >> 16) & 0x8000u;
+  uint32_t exponent = (bits >> 23) & 0xffu;
+  uint32_t mantissa = bits & 0x7fffffu;
+  if (exponent == 0xffu) {
+    // inf keeps inf, nan becomes a quiet nan
+    return sign | 0x7c00u | (mantissa ? 0x200u : 0u);
+  }
+  int new_exponent = static_cast<int>(exponent) - 112;
+  if (new_exponent >= 0x1f) {
+    // overflow to inf
+    return sign | 0x7c00u;
+  }
+  if (new_exponent <= 0) {
+    // subnormal or zero in float16
+    if (new_exponent < -10) return sign;
+    mantissa |= 0x800000u;
+    int shift          = 14 - new_exponent;
+    uint32_t half_bits = mantissa >> shift;
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway   = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half_bits & 1u))) half_bits++;
+    return sign | half_bits;
+  }
+  uint32_t half_bits = (static_cast<uint32_t>(new_exponent) << 10) | (mantissa >> 13);
+  uint32_t remainder = mantissa & 0x1fffu;
+  // round to nearest even, a carry into the exponent is still correct
+  if (remainder > 0x1000u || (remainder == 0x1000u && (half_bits & 1u))) half_bits++;
+  return sign | half_bits;
+}
 }
 
 CINN_REGISTER_HELPER(host_intrinsics) {
@@ -54,5 +115,11 @@ CINN_REGISTER_HELPER(host_intrinsics) {
   REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(atanf);
   REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(atanhf);
 
+  // the libcalls LLVM emits for fpext/fptrunc of half on targets without F16C
+  cinn::backends::RuntimeSymbolRegistry::Global().RegisterFn("__gnu_h2f_ieee",
+                                                             reinterpret_cast<void*>(&cinn_host_float16_to_float32));
+  cinn::backends::RuntimeSymbolRegistry::Global().RegisterFn("__gnu_f2h_ieee",
+                                                             reinterpret_cast<void*>(&cinn_host_float32_to_float16));
+
   return true;
 }
@@ -24,4 +24,10 @@ extern "C" {
 //@{
 void __cinn_host_tanh_v(const cinn_buffer_t* x, cinn_buffer_t* out);
 //@}
+
+//! float16 conversions, LLVM calls them when the target has no F16C instructions.
+//@{
+float cinn_host_float16_to_float32(uint16_t x);
+uint16_t cinn_host_float32_to_float16(float x);
+//@}
 }
@@ -65,6 +65,63 @@ TEST(tanh, basic) {
   }
 }
 
+TEST(float16, conversion) {
+  ASSERT_EQ(cinn_host_float32_to_float16(1.f), 0x3c00);
+  ASSERT_EQ(cinn_host_float32_to_float16(-2.f), 0xc000);
+  ASSERT_EQ(cinn_host_float32_to_float16(65520.f), 0x7c00);
+  ASSERT_EQ(cinn_host_float16_to_float32(0x3555), 0.333251953125f);
+  ASSERT_EQ(cinn_host_float16_to_float32(0x0001), 5.9604644775390625e-8f);
+  for (uint32_t x = 0; x < 0x7c00; x++) {
+    ASSERT_EQ(cinn_host_float32_to_float16(cinn_host_float16_to_float32(x)), x);
+  }
+}
+
+TEST(half, cast) {
+  Expr M(10), N(20);
+  Placeholder<float> x("x", {M, N});
+  // store as the 16-bit types and read back as float
+  auto fp16 = Compute(
+      {M, N}, [&](Expr i, Expr j) { return ir::Cast::Make(Float16(), x(i, j)); }, "fp16");
+  auto bf16 = Compute(
+      {M, N}, [&](Expr i, Expr j) { return ir::Cast::Make(BFloat16(), x(i, j)); }, "bf16");
+  auto y = Compute(
+      {M, N},
+      [&](Expr i, Expr j) { return ir::Cast::Make(Float(32), fp16(i, j)) - ir::Cast::Make(Float(32), bf16(i, j)); },
+      "y");
+
+  auto stages = CreateStages({fp16, bf16, y});
+
+  auto jit = backends::SimpleJIT::Create();
+
+  ir::Module::Builder builder("module2", common::DefaultHostTarget());
+
+  auto fn = Lower("fn_half", stages, {x, y}, {}, {fp16, bf16});
+  LOG(INFO) << "fn:\n" << fn;
+
+  builder.AddFunction(fn);
+
+  jit->Link(builder.Build());
+
+  auto fn_ptr = jit->Lookup("fn_half");
+  auto fnp    = reinterpret_cast<lower_func_ptr_t>(fn_ptr);
+  ASSERT_TRUE(fnp);
+
+  auto* x_buf   = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_random().Build();
+  auto* out_buf = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_zero().Build();
+  auto args     = common::ArgsBuilder().Add(x_buf).Add(out_buf).Build();
+  fnp(args.data(), args.size());
+
+  auto* x_buf_data   = reinterpret_cast<float*>(x_buf->memory);
+  auto* out_buf_data = reinterpret_cast<float*>(out_buf->memory);
+
+  for (int i = 0; i < x_buf->num_elements(); i++) {
+    float fp16_ref = cinn_host_float16_to_float32(cinn_host_float32_to_float16(x_buf_data[i]));
+    // bfloat16 keeps 8 significant bits, float16 keeps 11
+    ASSERT_NEAR(fp16_ref, x_buf_data[i], std::abs(x_buf_data[i]) / 1024);
+    ASSERT_NEAR(out_buf_data[i], fp16_ref - x_buf_data[i], std::abs(x_buf_data[i]) / 128);
+  }
+}
+
 }  // namespace cpu
 }  // namespace runtime
 }  // namespace cinn
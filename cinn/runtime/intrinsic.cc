@@ -27,6 +27,10 @@ cinn_type_t ToRuntimeType(Type type) {
     return cinn_int64_t();
   } else if (type == UInt(32)) {
     return cinn_uint64_t();
+  } else if (type == Float16()) {
+    return cinn_float16_t();
+  } else if (type == BFloat16()) {
+    return cinn_bfloat16_t();
   } else if (type == Float(32)) {
     return cinn_float32_t();
   } else if (type == Float(64)) {
@@ -29,6 +29,37 @@ class TensorTest(unittest.TestCase):
 
         self.assertTrue(np.allclose(tensor.numpy(), data))
 
+    def get_target(self):
+        target = Target()
+        target.arch = Target.Arch.X86
+        target.bits = Target.Bit.k64
+        target.os = Target.OS.Linux
+        return target
+
+    def test_share_numpy(self):
+        target = self.get_target()
+        data = np.random.random([10, 5]).astype("float32")
+        tensor = Tensor()
+        tensor.from_numpy(data, target, share=True)
+        self.assertTrue(np.allclose(tensor.numpy(target), data))
+        # the memory is bound only if it is aligned
+        if data.ctypes.data % 16 == 0:
+            data[0, 0] = 2.0
+            self.assertEqual(tensor.numpy(target)[0, 0], 2.0)
+
+    def test_dlpack(self):
+        target = self.get_target()
+        data = np.random.random([10, 5]).astype("float32")
+        tensor = Tensor()
+        tensor.from_numpy(data, target)
+        self.assertEqual(tensor.__dlpack_device__(), (1, 0))
+
+        other = Tensor()
+        other.from_dlpack(tensor, target)
+        self.assertTrue(np.allclose(other.numpy(target), data))
+        if hasattr(np, "from_dlpack"):
+            self.assertTrue(np.allclose(np.from_dlpack(tensor), data))
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,135 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmark/roofline.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace tests {
+
+namespace {
+
+int GetNumThreads() {
+  for (const char* env : {"CINN_NUM_THREADS", "OMP_NUM_THREADS"}) {
+    const char* value = std::getenv(env);
+    if (value && std::atoi(value) > 0) return std::atoi(value);
+  }
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+// Run `func(thread_id)` on `num_threads` threads and return the elapsed time in ms.
+template <typename FuncT>
+double RunParallel(int num_threads, FuncT func) {
+  std::vector<std::thread> threads;
+  std::atomic<int> ready{0};
+  std::atomic<bool> start{false};
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      ready++;
+      while (!start) std::this_thread::yield();
+      func(t);
+    });
+  }
+  while (ready < num_threads) std::this_thread::yield();
+  utils::Timer timer;
+  timer.Start();
+  start = true;
+  for (auto& thread : threads) thread.join();
+  return timer.Stop();
+}
+
+// Eight independent accumulator chains of 16 lanes hide the FMA latency and let the
+// compiler keep all of them in vector registers.
+constexpr int kFmaChains = 8;
+constexpr int kFmaLanes  = 16;
+
+float FmaKernel(int iters, float seed) {
+  float acc[kFmaChains][kFmaLanes];
+  for (int c = 0; c < kFmaChains; c++) {
+    for (int l = 0; l < kFmaLanes; l++) acc[c][l] = seed + c + l;
+  }
+  const float a = 0.999999f, b = 1e-7f;
+  for (int i = 0; i < iters; i++) {
+    for (int c = 0; c < kFmaChains; c++) {
+      for (int l = 0; l < kFmaLanes; l++) acc[c][l] = acc[c][l] * a + b;
+    }
+  }
+  float sum = 0;
+  for (int c = 0; c < kFmaChains; c++) {
+    for (int l = 0; l < kFmaLanes; l++) sum += acc[c][l];
+  }
+  return sum;
+}
+
+double MeasurePeakGflops(int num_threads) {
+  const int iters = 1 << 20;
+  std::vector<float> sink(num_threads);
+  double best_ms = -1;
+  for (int run = 0; run < 5; run++) {
+    double ms = RunParallel(num_threads, [&](int t) { sink[t] = FmaKernel(iters, t); });
+    if (best_ms < 0 || ms < best_ms) best_ms = ms;
+  }
+  VLOG(3) << "fma sink: " << sink[0];
+  double flops = 2.0 * kFmaChains * kFmaLanes * iters * num_threads;
+  return flops / best_ms / 1e6;
+}
+
+double MeasurePeakGbps(int num_threads) {
+  // 3 arrays of 32M floats, far larger than any last level cache
+  const size_t n = size_t(1) << 25;
+  std::vector<float> a(n), b(n, 1.f), c(n, 2.f);
+  const size_t chunk = (n + num_threads - 1) / num_threads;
+
+  auto triad = [&](int t) {
+    size_t begin = t * chunk, end = std::min(n, begin + chunk);
+    for (size_t i = begin; i < end; i++) a[i] = b[i] + 3.f * c[i];
+  };
+  // touch the pages from the same threads before timing
+  RunParallel(num_threads, triad);
+  double best_ms = -1;
+  for (int run = 0; run < 5; run++) {
+    double ms = RunParallel(num_threads, triad);
+    if (best_ms < 0 || ms < best_ms) best_ms = ms;
+  }
+  double bytes = 3.0 * sizeof(float) * n;
+  return bytes / best_ms / 1e6;
+}
+
+}  // namespace
+
+double MachineRoofline::Attainable(double arithmetic_intensity) const {
+  return std::min(peak_gflops, arithmetic_intensity * peak_gbps);
+}
+
+MachineRoofline MeasureRoofline() {
+  int num_threads = GetNumThreads();
+  MachineRoofline roofline;
+  roofline.peak_gflops = MeasurePeakGflops(num_threads);
+  roofline.peak_gbps   = MeasurePeakGbps(num_threads);
+  LOG(INFO) << "Machine roofline with " << num_threads << " threads: peak " << roofline.peak_gflops << " GFLOP/s, "
+            << roofline.peak_gbps << " GB/s";
+  return roofline;
+}
+
+}  // namespace tests
+}  // namespace cinn
@@ -0,0 +1,37 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace cinn {
+namespace tests {
+
+/**
+ * The two ceilings of the roofline model of the host machine: the peak float32 arithmetic
+ * throughput and the peak main memory bandwidth. A kernel with arithmetic intensity `ai`
+ * (flops per byte) can reach at most `min(peak_gflops, ai * peak_gbps)` GFLOP/s.
+ */
+struct MachineRoofline {
+  double peak_gflops{0};
+  double peak_gbps{0};
+
+  double Attainable(double arithmetic_intensity) const;
+};
+
+// Measure the ceilings with a FMA microkernel and a STREAM triad, using as many threads
+// as the CINN runtime would (CINN_NUM_THREADS, then OMP_NUM_THREADS, then the core count).
+MachineRoofline MeasureRoofline();
+
+}  // namespace tests
+}  // namespace cinn
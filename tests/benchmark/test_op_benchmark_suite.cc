@@ -0,0 +1,269 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <absl/container/flat_hash_map.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/runtime/cpu/use_extern_funcs.h"
+#include "tests/benchmark/roofline.h"
+#include "tests/benchmark/test_utils.h"
+
+DEFINE_string(benchmark_json, "op_benchmark_result.json", "The file to save the benchmark results in json format.");
+
+namespace cinn {
+namespace tests {
+
+using hlir::framework::AttrType;
+
+namespace {
+
+struct BenchmarkCase {
+  std::string name;
+  std::string op_name;
+  std::vector<std::vector<int>> input_shapes;
+  absl::flat_hash_map<std::string, AttrType> attr_store;
+  // the float32 operations and the compulsory DRAM traffic in bytes of one run
+  double flops{0};
+  double bytes{0};
+  // whether the op has a `use_mkldnn` implementation to compare with
+  bool has_mkldnn{false};
+};
+
+struct BenchmarkResult {
+  std::string name;
+  std::string op_name;
+  double time_ms;
+  double gflops;
+  double gbps;
+  double arithmetic_intensity;
+  double attainable_gflops;
+  double efficiency;
+};
+
+double Numel(const std::vector<int>& shape) {
+  double numel = 1;
+  for (int dim : shape) numel *= dim;
+  return numel;
+}
+
+int OutSize(int in, int kernel, int stride, int pad) { return (in + 2 * pad - kernel) / stride + 1; }
+
+// input: [N, C, H, W], weight: [F, C / groups, K, K]
+BenchmarkCase Conv2d(const std::string& name, std::vector<int> input, std::vector<int> weight, int stride, int pad) {
+  bool depthwise = weight[1] == 1 && input[1] > 1;
+  int oh         = OutSize(input[2], weight[2], stride, pad);
+  int ow         = OutSize(input[3], weight[3], stride, pad);
+  double out     = double(input[0]) * weight[0] * oh * ow;
+  BenchmarkCase c;
+  c.name         = name;
+  c.op_name      = depthwise ? "depthwise_conv2d" : "conv2d";
+  c.input_shapes = {input, weight};
+  c.attr_store   = {{"padding", std::vector<int>{pad, pad}},
+                   {"stride", std::vector<int>{stride, stride}},
+                   {"dilation", std::vector<int>{1, 1}}};
+  c.flops        = 2 * out * weight[1] * weight[2] * weight[3];
+  c.bytes        = 4 * (Numel(input) + Numel(weight) + out);
+  c.has_mkldnn   = !depthwise;
+  return c;
+}
+
+BenchmarkCase Pool2d(const std::string& name, std::vector<int> input, int kernel, int stride, int pad) {
+  double out = double(input[0]) * input[1] * OutSize(input[2], kernel, stride, pad) *
+               OutSize(input[3], kernel, stride, pad);
+  BenchmarkCase c;
+  c.name         = name;
+  c.op_name      = "pool2d";
+  c.input_shapes = {input};
+  c.attr_store   = {{"kernel_size", std::vector<int>{kernel, kernel}},
+                   {"stride_size", std::vector<int>{stride, stride}},
+                   {"padding_size", std::vector<int>{pad, pad, pad, pad}},
+                   {"pool_type", std::string("max")}};
+  c.flops        = out * kernel * kernel;
+  c.bytes        = 4 * (Numel(input) + out);
+  return c;
+}
+
+// relu and elementwise_add, one operation per output element
+BenchmarkCase Elementwise(const std::string& name, const std::string& op_name, std::vector<int> shape) {
+  BenchmarkCase c;
+  c.name         = name;
+  c.op_name      = op_name;
+  c.input_shapes = op_name == "relu" ? std::vector<std::vector<int>>{shape}
+                                     : std::vector<std::vector<int>>{shape, shape};
+  c.flops        = Numel(shape);
+  c.bytes        = 4 * Numel(shape) * (c.input_shapes.size() + 1);
+  return c;
+}
+
+// matmul: [M, K] x [K, N], mul: [M, K] x [N, K]^T
+BenchmarkCase Matmul(const std::string& name, const std::string& op_name, int m, int n, int k) {
+  BenchmarkCase c;
+  c.name         = name;
+  c.op_name      = op_name;
+  c.input_shapes = op_name == "mul" ? std::vector<std::vector<int>>{{m, k}, {n, k}}
+                                    : std::vector<std::vector<int>>{{m, k}, {k, n}};
+  c.flops        = 2.0 * m * n * k;
+  c.bytes        = 4.0 * (double(m) * k + double(k) * n + double(m) * n);
+  return c;
+}
+
+BenchmarkCase Softmax(const std::string& name, std::vector<int> shape) {
+  BenchmarkCase c;
+  c.name         = name;
+  c.op_name      = "softmax";
+  c.input_shapes = {shape};
+  c.flops        = 5 * Numel(shape);  // max, subtract, exp, sum and divide
+  c.bytes        = 4 * 2 * Numel(shape);
+  c.has_mkldnn   = true;
+  return c;
+}
+
+BenchmarkCase ReduceSum(const std::string& name, std::vector<int> shape, std::vector<int> dim) {
+  double out = Numel(shape);
+  for (int axis : dim) out /= shape[axis];
+  BenchmarkCase c;
+  c.name         = name;
+  c.op_name      = "reduce_sum";
+  c.input_shapes = {shape};
+  c.attr_store   = {{"dim", dim}, {"keep_dim", false}};
+  c.flops        = Numel(shape);
+  c.bytes        = 4 * (Numel(shape) + out);
+  return c;
+}
+
+// The layers which dominate the inference time of the classic CNNs with batch size 1.
+std::vector<BenchmarkCase> ModelCases() {
+  return {
+      // ResNet-18 / ResNet-50
+      Conv2d("resnet_conv1", {1, 3, 224, 224}, {64, 3, 7, 7}, 2, 3),
+      Pool2d("resnet_maxpool", {1, 64, 112, 112}, 3, 2, 1),
+      Conv2d("resnet18_conv2_3x3", {1, 64, 56, 56}, {64, 64, 3, 3}, 1, 1),
+      Conv2d("resnet18_conv5_3x3", {1, 512, 7, 7}, {512, 512, 3, 3}, 1, 1),
+      Conv2d("resnet50_conv2_1x1_reduce", {1, 256, 56, 56}, {64, 256, 1, 1}, 1, 0),
+      Conv2d("resnet50_conv2_1x1_expand", {1, 64, 56, 56}, {256, 64, 1, 1}, 1, 0),
+      Conv2d("resnet50_conv4_3x3", {1, 256, 14, 14}, {256, 256, 3, 3}, 1, 1),
+      Elementwise("resnet50_conv2_relu", "relu", {1, 256, 56, 56}),
+      Elementwise("resnet50_conv2_shortcut_add", "elementwise_add", {1, 256, 56, 56}),
+      ReduceSum("resnet50_global_pool", {1, 2048, 7, 7}, {2, 3}),
+      Matmul("resnet50_fc", "mul", 1, 1000, 2048),
+      Softmax("resnet_softmax", {1, 1000}),
+      // MobileNetV2
+      Conv2d("mobilenetv2_conv1", {1, 3, 224, 224}, {32, 3, 3, 3}, 2, 1),
+      Conv2d("mobilenetv2_dw_112", {1, 32, 112, 112}, {32, 1, 3, 3}, 1, 1),
+      Conv2d("mobilenetv2_pw_project_112", {1, 32, 112, 112}, {16, 32, 1, 1}, 1, 0),
+      Conv2d("mobilenetv2_pw_expand_56", {1, 24, 56, 56}, {144, 24, 1, 1}, 1, 0),
+      Conv2d("mobilenetv2_dw_56_s2", {1, 144, 56, 56}, {144, 1, 3, 3}, 2, 1),
+      Conv2d("mobilenetv2_dw_14", {1, 576, 14, 14}, {576, 1, 3, 3}, 1, 1),
+      Elementwise("mobilenetv2_relu_112", "relu", {1, 96, 112, 112}),
+      Elementwise("mobilenetv2_residual_add", "elementwise_add", {1, 24, 56, 56}),
+      Matmul("mobilenetv2_fc", "mul", 1, 1000, 1280),
+      // EfficientNet-B0
+      Conv2d("efficientnet_dw_5x5_28", {1, 240, 28, 28}, {240, 1, 5, 5}, 1, 2),
+      Conv2d("efficientnet_dw_5x5_14", {1, 672, 14, 14}, {672, 1, 5, 5}, 1, 2),
+      Conv2d("efficientnet_pw_head", {1, 320, 7, 7}, {1280, 320, 1, 1}, 1, 0),
+      ReduceSum("efficientnet_se_squeeze", {1, 240, 28, 28}, {2, 3}),
+      Matmul("efficientnet_fc_batch32", "matmul", 32, 1000, 1280),
+      Softmax("efficientnet_softmax_batch32", {32, 1000}),
+  };
+}
+
+BenchmarkResult RunCase(const BenchmarkCase& c, const MachineRoofline& roofline, bool use_mkldnn) {
+  OpBenchmarkTester tester(c.op_name, c.input_shapes);
+  hlir::framework::NodeAttr attrs;
+  attrs.attr_store = c.attr_store;
+  if (use_mkldnn) attrs.attr_store["use_mkldnn"] = true;
+  auto input_tensors = tester.CreateInputTensors<float>();
+  std::vector<Type> input_types(c.input_shapes.size(), Float(32));
+  // all the outputs and the temporary buffers of these ops are float32
+  std::vector<Type> out_types{Float(32)};
+
+  BenchmarkResult res;
+  res.name                 = use_mkldnn ? c.name + "_mkldnn" : c.name;
+  res.op_name              = c.op_name;
+  res.time_ms              = tester.TestOp(res.name, input_tensors, attrs, input_types, out_types);
+  res.gflops               = c.flops / res.time_ms / 1e6;
+  res.gbps                 = c.bytes / res.time_ms / 1e6;
+  res.arithmetic_intensity = c.flops / c.bytes;
+  res.attainable_gflops    = roofline.Attainable(res.arithmetic_intensity);
+  res.efficiency           = res.gflops / res.attainable_gflops;
+  return res;
+}
+
+void Report(const MachineRoofline& roofline, const std::vector<BenchmarkResult>& results) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "\n"
+     << std::left << std::setw(36) << "case" << std::right << std::setw(12) << "time(ms)" << std::setw(12) << "GFLOP/s"
+     << std::setw(12) << "GB/s" << std::setw(12) << "flop/byte" << std::setw(14) << "roof(GFLOP/s)" << std::setw(12)
+     << "efficiency"
+     << "\n";
+  for (auto& res : results) {
+    ss << std::left << std::setw(36) << res.name << std::right << std::setw(12) << res.time_ms << std::setw(12)
+       << res.gflops << std::setw(12) << res.gbps << std::setw(12) << res.arithmetic_intensity << std::setw(14)
+       << res.attainable_gflops << std::setw(11) << res.efficiency * 100 << "%\n";
+  }
+  LOG(INFO) << ss.str();
+
+  std::ofstream os(FLAGS_benchmark_json);
+  CHECK(os.is_open()) << "Failed to open file " << FLAGS_benchmark_json;
+  os << std::setprecision(6);
+  os << "{\n  \"peak_gflops\": " << roofline.peak_gflops << ",\n  \"peak_gbps\": " << roofline.peak_gbps
+     << ",\n  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    auto& res = results[i];
+    os << "    {\"name\": \"" << res.name << "\", \"op\": \"" << res.op_name << "\", \"time_ms\": " << res.time_ms
+       << ", \"gflops\": " << res.gflops << ", \"gbps\": " << res.gbps
+       << ", \"arithmetic_intensity\": " << res.arithmetic_intensity
+       << ", \"attainable_gflops\": " << res.attainable_gflops << ", \"efficiency\": " << res.efficiency << "}"
+       << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n}\n";
+  LOG(INFO) << "Benchmark results are saved to " << FLAGS_benchmark_json;
+}
+
+}  // namespace
+
+/**
+ * Run the layers of ResNet-18/50, MobileNetV2 and EfficientNet-B0 with the default CINN
+ * schedules and place every kernel on the roofline of this machine, so that a schedule
+ * change can be judged by how close it gets to the attainable performance instead of by
+ * the raw time only. With MKLDNN the library kernels of conv2d and softmax are measured
+ * as well as a baseline.
+ */
+TEST(OpBenchmarkSuite, model_layers) {
+  auto roofline = MeasureRoofline();
+  ASSERT_GT(roofline.peak_gflops, 0);
+  ASSERT_GT(roofline.peak_gbps, 0);
+
+  std::vector<BenchmarkResult> results;
+  for (auto& c : ModelCases()) {
+    results.push_back(RunCase(c, roofline, false));
+#ifdef CINN_WITH_MKLDNN
+    if (c.has_mkldnn) results.push_back(RunCase(c, roofline, true));
+#endif
+  }
+  Report(roofline, results);
+}
+
+}  // namespace tests
+}  // namespace cinn
@@ -30,12 +30,12 @@ std::unique_ptr<backends::ExecutionEngine> OpBenchmarkTester::CreateExecutionEng
   return engine;
 }
 
-void OpBenchmarkTester::TestOp(const std::string& test_name,
-                               const std::vector<Tensor>& input_tensors,
-                               const hlir::framework::NodeAttr& attrs,
-                               const std::vector<Type>& input_types,
-                               const std::vector<Type>& out_types,
-                               bool use_default_stragegy) {
+double OpBenchmarkTester::TestOp(const std::string& test_name,
+                                 const std::vector<Tensor>& input_tensors,
+                                 const hlir::framework::NodeAttr& attrs,
+                                 const std::vector<Type>& input_types,
+                                 const std::vector<Type>& out_types,
+                                 bool use_default_stragegy) {
   auto module        = CreateCinnModule(input_tensors, attrs, out_types, use_default_stragegy);
   auto engine        = CreateExecutionEngine(module);
   auto test_func_ptr = reinterpret_cast<void (*)(void**, int32_t)>(engine->Lookup(op_name_));
@@ -55,6 +55,7 @@ void OpBenchmarkTester::TestOp(const std::string& test_name,
   }
   test_op_time = timer.Stop() / repeat_;
   LOG(INFO) << "repeat times: " << repeat_ << ", kernel run time: " << test_op_time << " ms";
+  return test_op_time;
 }
 
 Module OpBenchmarkTester::CreateCinnModule(const std::vector<Tensor>& input_tensors,
@@ -128,10 +129,13 @@ void OpBenchmarkTester::CreateBuffer() {
     all_args_.push_back(arg);
   }
   CHECK(!output_shapes_.empty()) << "output shapes shouldn't be empty\n";
-  CHECK_EQ(output_shapes_.size(), out_types_.size());
+  CHECK(!out_types_.empty()) << "output types shouldn't be empty\n";
+  CHECK_LE(out_types_.size(), output_shapes_.size());
   for (size_t i = 0; i < output_shapes_.size(); i++) {
-    if (out_types_[i].is_void()) continue;
-    auto* buffer = common::BufferBuilder(out_types_[i], output_shapes_[i]).set_align(32).set_zero().Build();
+    // the temporary tensors which are not listed in out_types share the type of the last output
+    Type out_type = i < out_types_.size() ? out_types_[i] : out_types_.back();
+    if (out_type.is_void()) continue;
+    auto* buffer = common::BufferBuilder(out_type, output_shapes_[i]).set_align(32).set_zero().Build();
     CHECK(buffer);
     out_dims_ = buffer->num_elements();
     cinn_pod_value_t arg(buffer);
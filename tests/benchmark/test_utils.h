@@ -38,12 +38,13 @@ class OpBenchmarkTester {
 
   virtual ~OpBenchmarkTester() = default;
 
-  void TestOp(const std::string &test_name,
-              const std::vector<ir::Tensor> &input_tensors,
-              const hlir::framework::NodeAttr &attrs,
-              const std::vector<Type> &input_types,
-              const std::vector<Type> &out_types,
-              bool use_default_stragegy = true);
+  // return the average kernel run time in ms
+  double TestOp(const std::string &test_name,
+                const std::vector<ir::Tensor> &input_tensors,
+                const hlir::framework::NodeAttr &attrs,
+                const std::vector<Type> &input_types,
+                const std::vector<Type> &out_types,
+                bool use_default_stragegy = true);
 
   virtual Module CreateCinnModule(const std::vector<ir::Tensor> &input_tensors,
                                   const hlir::framework::NodeAttr &attrs,